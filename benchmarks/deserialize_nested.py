@@ -0,0 +1,181 @@
+# -*- coding: utf-8 -*-
+##########################################################################
+# Copyright 2013-2016 Aerospike, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+##########################################################################
+
+"""
+Compares reading nested list and map bins with the read and batch policy
+'deserialize' set to True and to False.
+
+With deserialize=True the C client first builds as_list and as_map values
+that are then converted to Python, with deserialize=False the bins are
+decoded from their msgpack straight into list and dict.
+"""
+
+from __future__ import print_function
+
+import aerospike
+import sys
+import time
+
+from optparse import OptionParser
+
+##########################################################################
+# Options Parsing
+##########################################################################
+
+usage = "usage: %prog [options]"
+
+optparser = OptionParser(usage=usage, add_help_option=False)
+
+optparser.add_option(
+    "--help", dest="help", action="store_true",
+    help="Displays this message.")
+
+optparser.add_option(
+    "-U", "--username", dest="username", type="string", metavar="<USERNAME>",
+    help="Username to connect to database.")
+
+optparser.add_option(
+    "-P", "--password", dest="password", type="string", metavar="<PASSWORD>",
+    help="Password to connect to database.")
+
+optparser.add_option(
+    "-h", "--host", dest="host", type="string", default="127.0.0.1", metavar="<ADDRESS>",
+    help="Address of Aerospike server.")
+
+optparser.add_option(
+    "-p", "--port", dest="port", type="int", default=3000, metavar="<PORT>",
+    help="Port of the Aerospike server.")
+
+optparser.add_option(
+    "-n", "--namespace", dest="namespace", type="string", default="test", metavar="<NS>",
+    help="Namespace to use.")
+
+optparser.add_option(
+    "-s", "--set", dest="set", type="string", default="demo", metavar="<SET>",
+    help="Set to use.")
+
+optparser.add_option(
+    "--records", dest="records", type="int", default=100,
+    help="Number of records written and read.")
+
+optparser.add_option(
+    "--width", dest="width", type="int", default=20,
+    help="Number of items in each nested list and map.")
+
+optparser.add_option(
+    "--depth", dest="depth", type="int", default=3,
+    help="Nesting depth of the list and map bins.")
+
+optparser.add_option(
+    "--rounds", dest="rounds", type="int", default=20,
+    help="Number of times every record is read for each setting.")
+
+(options, args) = optparser.parse_args()
+
+if options.help:
+    optparser.print_help()
+    print()
+    sys.exit(1)
+
+config = {
+    'hosts': [(options.host, options.port)]
+}
+
+
+def nested_list(depth):
+    if depth == 0:
+        return [i for i in range(options.width)]
+    return [nested_map(depth - 1) if i % 2 else nested_list(depth - 1)
+            for i in range(options.width)]
+
+
+def nested_map(depth):
+    if depth == 0:
+        return dict(('k%d' % i, 'v%d' % i) for i in range(options.width))
+    return dict(('k%d' % i, nested_list(depth - 1) if i % 2 else nested_map(depth - 1))
+                for i in range(options.width))
+
+
+def write_records(client):
+    keys = [(options.namespace, options.set, 'nested_%d' % i)
+            for i in range(options.records)]
+    bins = {'l': nested_list(options.depth - 1),
+            'm': nested_map(options.depth - 1)}
+    for key in keys:
+        client.put(key, bins)
+    return keys, bins
+
+
+def time_get(client, keys, deserialize):
+    policy = {'deserialize': deserialize}
+    start = time.time()
+    for _ in range(options.rounds):
+        for key in keys:
+            client.get(key, policy)
+    return time.time() - start
+
+
+def time_get_many(client, keys, deserialize):
+    policy = {'deserialize': deserialize}
+    start = time.time()
+    for _ in range(options.rounds):
+        client.get_many(keys, policy)
+    return time.time() - start
+
+
+def compare(client, keys, bins):
+    # Both settings must return the same values
+    for deserialize in (True, False):
+        _, _, record = client.get(keys[0], {'deserialize': deserialize})
+        if record != bins:
+            raise Exception("deserialize={0} returned other bins".format(deserialize))
+
+    reads = options.rounds * len(keys)
+    for name, timer in (('get', time_get), ('get_many', time_get_many)):
+        results = {}
+        for deserialize in (True, False):
+            results[deserialize] = timer(client, keys, deserialize)
+            print("{0:8} deserialize={1!s:5}: {2} records in {3:.2f}s, {4:.0f} records/s".format(
+                name, deserialize, reads, results[deserialize],
+                reads / results[deserialize] if results[deserialize] else 0))
+        if results[False]:
+            print("{0:8} speedup: {1:.2f}x".format(name, results[True] / results[False]))
+
+
+try:
+    client = aerospike.client(config).connect(
+        options.username, options.password)
+except Exception as eargs:
+    print("error: {0}".format(eargs), file=sys.stderr)
+    sys.exit(2)
+
+keys = []
+try:
+    keys, bins = write_records(client)
+    compare(client, keys, bins)
+except Exception as eargs:
+    print("error: {0}".format(eargs), file=sys.stderr)
+    sys.exit(3)
+finally:
+    for key in keys:
+        try:
+            client.remove(key)
+        except Exception:
+            pass
+    client.close()
+
+sys.exit(0)
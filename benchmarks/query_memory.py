@@ -0,0 +1,164 @@
+# -*- coding: utf-8 -*-
+##########################################################################
+# Copyright 2013-2016 Aerospike, Inc.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+##########################################################################
+
+"""
+Measures the memory held by prepared Query objects and the cost of
+select_many() run from many threads with unicode bin names.
+
+Each Query used to embed a fixed table of 32767 object pointers (256KB),
+and every select_many() call put another such table on the stack.
+"""
+
+from __future__ import print_function
+
+import aerospike
+import resource
+import sys
+import threading
+import time
+
+from optparse import OptionParser
+
+##########################################################################
+# Options Parsing
+##########################################################################
+
+usage = "usage: %prog [options]"
+
+optparser = OptionParser(usage=usage, add_help_option=False)
+
+optparser.add_option(
+    "--help", dest="help", action="store_true",
+    help="Displays this message.")
+
+optparser.add_option(
+    "-U", "--username", dest="username", type="string", metavar="<USERNAME>",
+    help="Username to connect to database.")
+
+optparser.add_option(
+    "-P", "--password", dest="password", type="string", metavar="<PASSWORD>",
+    help="Password to connect to database.")
+
+optparser.add_option(
+    "-h", "--host", dest="host", type="string", default="127.0.0.1", metavar="<ADDRESS>",
+    help="Address of Aerospike server.")
+
+optparser.add_option(
+    "-p", "--port", dest="port", type="int", default=3000, metavar="<PORT>",
+    help="Port of the Aerospike server.")
+
+optparser.add_option(
+    "-n", "--namespace", dest="namespace", type="string", default="test", metavar="<NS>",
+    help="Namespace to use.")
+
+optparser.add_option(
+    "-s", "--set", dest="set", type="string", default="demo", metavar="<SET>",
+    help="Set to use.")
+
+optparser.add_option(
+    "--queries", dest="queries", type="int", default=5000,
+    help="Number of Query objects to hold.")
+
+optparser.add_option(
+    "--threads", dest="threads", type="int", default=32,
+    help="Number of threads calling select_many().")
+
+optparser.add_option(
+    "--calls", dest="calls", type="int", default=1000,
+    help="Number of select_many() calls per thread.")
+
+(options, args) = optparser.parse_args()
+
+if options.help:
+    optparser.print_help()
+    print()
+    sys.exit(1)
+
+config = {
+    'hosts': [(options.host, options.port)]
+}
+
+BINS = [u'name', u'age', u'addr']
+
+
+def max_rss_kb():
+    # ru_maxrss is in kilobytes on Linux and in bytes on OS X
+    rss = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    return rss // 1024 if sys.platform == 'darwin' else rss
+
+
+def hold_queries(client):
+    before = max_rss_kb()
+    queries = []
+    for _ in range(options.queries):
+        query = client.query(options.namespace, options.set)
+        query.select(*BINS)
+        queries.append(query)
+    after = max_rss_kb()
+
+    print("Query object size:        {0} bytes".format(
+        sys.getsizeof(queries[0])))
+    print("RSS growth for {0} queries: {1} KB".format(
+        options.queries, after - before))
+    return queries
+
+
+def select_many_threads(client):
+    keys = [(options.namespace, options.set, i) for i in range(10)]
+    for key in keys:
+        client.put(key, {'name': 'name', 'age': 1, 'addr': 'addr'})
+
+    def worker():
+        for _ in range(options.calls):
+            client.select_many(keys, BINS)
+
+    before = max_rss_kb()
+    start = time.time()
+    threads = [threading.Thread(target=worker)
+               for _ in range(options.threads)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    elapsed = time.time() - start
+    after = max_rss_kb()
+
+    for key in keys:
+        client.remove(key)
+
+    print("select_many: {0} threads x {1} calls in {2:.2f}s".format(
+        options.threads, options.calls, elapsed))
+    print("RSS growth during select_many: {0} KB".format(after - before))
+
+
+try:
+    client = aerospike.client(config).connect(
+        options.username, options.password)
+except Exception as eargs:
+    print("error: {0}".format(eargs), file=sys.stderr)
+    sys.exit(2)
+
+try:
+    queries = hold_queries(client)
+    select_many_threads(client)
+except Exception as eargs:
+    print("error: {0}".format(eargs), file=sys.stderr)
+    sys.exit(3)
+finally:
+    client.close()
+
+sys.exit(0)
@@ -324,6 +324,7 @@ setup(
                 'src/main/log.c',
                 'src/main/client/type.c',
                 'src/main/client/apply.c',
+                'src/main/client/apply_many.c',
                 'src/main/client/close.c',
                 'src/main/client/connect.c',
                 'src/main/client/exists.c',
@@ -336,18 +337,27 @@ setup(
                 'src/main/client/put.c',
                 'src/main/client/operate_list.c',
                 'src/main/client/operate_map.c',
+                'src/main/client/operate_many.c',
                 'src/main/client/operate.c',
                 'src/main/client/query.c',
+                'src/main/client/query_many.c',
                 'src/main/client/remove.c',
                 'src/main/client/scan.c',
                 'src/main/client/select.c',
                 'src/main/client/truncate.c',
+                'src/main/client/task.c',
+                'src/main/client/load_file.c',
+                'src/main/client/counter_batcher.c',
                 'src/main/client/admin.c',
                 'src/main/client/udf.c',
                 'src/main/client/sec_index.c',
                 'src/main/serializer.c',
                 'src/main/client/remove_bin.c',
                 'src/main/client/get_key_digest.c',
+                'src/main/client/stats.c',
+                'src/main/client/cluster_stats.c',
+                'src/main/client/group_keys.c',
+                'src/main/client/tracing.c',
                 'src/main/client/llist.c',
                 'src/main/query/type.c',
                 'src/main/query/apply.c',
@@ -359,6 +369,10 @@ setup(
                 'src/main/scan/foreach.c',
                 'src/main/scan/results.c',
                 'src/main/scan/select.c',
+                'src/main/scan/export.c',
+                'src/main/counter_batcher/type.c',
+                'src/main/counter_batcher/operations.c',
+                'src/main/counter_batcher/flush.c',
                 'src/main/llist/type.c',
                 'src/main/llist/llist_operations.c',
                 'src/main/geospatial/type.c',
@@ -366,7 +380,14 @@ setup(
                 'src/main/geospatial/unwrap.c',
                 'src/main/geospatial/loads.c',
                 'src/main/geospatial/dumps.c',
+                'src/main/geospatial/geojson.c',
                 'src/main/conversions.c',
+                'src/main/cache.c',
+                'src/main/hedge.c',
+                'src/main/limiter.c',
+                'src/main/breaker.c',
+                'src/main/tracer.c',
+                'src/main/msgpack_decoder.c',
                 'src/main/policy.c',
                 'src/main/calc_digest.c',
                 'src/main/predicates.c',
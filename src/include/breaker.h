@@ -0,0 +1,111 @@
+/*******************************************************************************
+ * Copyright 2013-2016 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+#include <Python.h>
+#include <pthread.h>
+#include <stdint.h>
+
+#include <aerospike/aerospike.h>
+#include <aerospike/as_error.h>
+#include <aerospike/as_key.h>
+#include <aerospike/as_node.h>
+
+#include "types.h"
+
+#define CIRCUIT_BREAKER_DEFAULT_MAX_TIMEOUTS 5
+#define CIRCUIT_BREAKER_DEFAULT_ERROR_RATE 0.5
+#define CIRCUIT_BREAKER_DEFAULT_WINDOW 20
+#define CIRCUIT_BREAKER_DEFAULT_OPEN_MS 1000
+
+typedef enum {
+	BREAKER_CLOSED,
+	BREAKER_OPEN,
+	// Open, with an info request checking the node in the background
+	BREAKER_PROBING
+} breaker_state;
+
+typedef struct breaker_node_s {
+	char name[AS_NODE_NAME_MAX_SIZE];
+	breaker_state state;
+	uint32_t consecutive_timeouts;
+	// Requests and node errors seen while closed, halved every window
+	uint32_t requests;
+	uint32_t errors;
+	uint64_t opened_ms;
+	uint64_t trips;
+	uint64_t rejected;
+	struct breaker_node_s * next;
+} breaker_node;
+
+/**
+ * Per node circuit breakers from the client config's 'circuit_breaker' dict.
+ * Nodes are added as they are first used and kept until the client is freed.
+ * Used by threads running without the GIL, so every field is guarded by lock.
+ */
+struct circuit_breaker_s {
+	pthread_mutex_t lock;
+	// Signalled when the last probe ends
+	pthread_cond_t probes_done;
+	uint32_t probes_running;
+	uint32_t max_timeouts;
+	double error_rate;
+	uint32_t window;
+	uint32_t open_ms;
+	breaker_node * nodes;
+};
+
+/**
+ * Create the breakers from the client config's 'circuit_breaker' dict.
+ * Returns NULL if the dict is invalid.
+ */
+circuit_breaker * circuit_breaker_new(PyObject * py_breaker_config);
+
+/**
+ * Frees the breakers, after circuit_breaker_wait_idle if probes may run.
+ */
+void circuit_breaker_destroy(circuit_breaker * breaker);
+
+/**
+ * Finds the master node of the key and fails with AEROSPIKE_ERR_INVALID_NODE
+ * while its breaker is open. Once the breaker has been open for open_ms, an
+ * info request probes the node in the background and closes it on success.
+ *
+ * On success *node is a reserved node, or NULL, to pass to
+ * circuit_breaker_record once the command ends. Must be called without the
+ * GIL. A NULL breaker lets every command through.
+ */
+as_status circuit_breaker_check(circuit_breaker * breaker, aerospike * as, as_error * err,
+		const as_key * key, as_node ** node);
+
+/**
+ * Counts the outcome of a command sent to the node, opens its breaker after
+ * max_timeouts timeouts in a row or once node errors reach error_rate of the
+ * last window commands, and releases the node.
+ */
+void circuit_breaker_record(circuit_breaker * breaker, as_node * node, as_status status);
+
+/**
+ * Waits for the probes still using the aerospike object, before a client is
+ * closed.
+ */
+void circuit_breaker_wait_idle(circuit_breaker * breaker);
+
+/**
+ * Return a new dict of the state and counters of each node's breaker.
+ */
+PyObject * circuit_breaker_stats(circuit_breaker * breaker);
@@ -0,0 +1,103 @@
+/*******************************************************************************
+ * Copyright 2013-2016 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+#include <Python.h>
+#include <stdbool.h>
+
+#include <aerospike/as_key.h>
+#include <aerospike/as_policy.h>
+#include <aerospike/as_record.h>
+
+#include "types.h"
+
+#define RECORD_CACHE_DEFAULT_MAX_RECORDS 10000
+#define RECORD_CACHE_DEFAULT_MAX_BYTES (64 * 1024 * 1024)
+#define RECORD_CACHE_DEFAULT_MAX_STALENESS 1000
+// Keys share invalidation counters by the first byte of their digest
+#define RECORD_CACHE_EPOCH_STRIPES 64
+
+typedef struct record_cache_entry_s {
+	char ns[AS_NAMESPACE_MAX_SIZE];
+	as_digest_value digest;
+	// Copy of the record read by get(), converted again on every hit
+	as_record * rec;
+	uint32_t gen;
+	uint32_t ttl;
+	uint64_t fetched_ms;
+	uint64_t expire_ms;
+	size_t size;
+	struct record_cache_entry_s * hash_next;
+	struct record_cache_entry_s * lru_prev;
+	struct record_cache_entry_s * lru_next;
+} record_cache_entry;
+
+/**
+ * Client side cache of get() results, keyed by namespace and digest.
+ * Only used with the GIL held, so it needs no lock of its own.
+ */
+struct record_cache_s {
+	record_cache_entry ** buckets;
+	uint32_t n_buckets;
+	// Most recently used first
+	record_cache_entry * lru_head;
+	record_cache_entry * lru_tail;
+	uint32_t n_records;
+	uint64_t bytes;
+	uint32_t max_records;
+	uint64_t max_bytes;
+	uint32_t max_staleness_ms;
+	bool validate_generation;
+	// Bumped by every invalidation, so a read that overlapped one is not cached
+	uint64_t epochs[RECORD_CACHE_EPOCH_STRIPES];
+};
+
+/**
+ * Create a cache from the client config's 'cache' dict.
+ * Returns NULL if the dict is invalid.
+ */
+record_cache * record_cache_new(PyObject * py_cache_config);
+
+void record_cache_destroy(record_cache * cache);
+
+/**
+ * Return a new (key, meta, bins) tuple for the key if it is cached and
+ * still fresh, or NULL. May release the GIL to validate the generation.
+ */
+PyObject * record_cache_get(AerospikeClient * self, as_key * key, as_policy_read * policy);
+
+/**
+ * Returns the invalidation epoch of the key, taken before get() releases
+ * the GIL to read it.
+ */
+uint64_t record_cache_epoch(record_cache * cache, as_key * key);
+
+/**
+ * Cache a copy of the record read by get(), unless the key was invalidated
+ * since epoch, in which case the record may predate the write.
+ */
+void record_cache_put(record_cache * cache, as_key * key, const as_record * rec, uint64_t epoch);
+
+/**
+ * Drop the key from the cache, after a write through this client.
+ */
+void record_cache_invalidate(record_cache * cache, as_key * key);
+
+/**
+ * Drop every record, after a truncate or a bulk load.
+ */
+void record_cache_clear(record_cache * cache);
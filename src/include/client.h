@@ -18,6 +18,7 @@
 
 #include <Python.h>
 #include <stdbool.h>
+#include <aerospike/aerospike_index.h>
 #include "types.h"
 #include "macros.h"
 
@@ -64,6 +65,11 @@ PyObject * AerospikeClient_is_connected(AerospikeClient * self, PyObject * args,
  */
 PyObject * AerospikeClient_shm_key(AerospikeClient * self, PyObject * args, PyObject * kwds);
 
+/**
+ * Rebuild the connection of a client inherited across fork().
+ */
+PyObject * AerospikeClient_Post_Fork(AerospikeClient * self, PyObject * args, PyObject * kwds);
+
 
 /*******************************************************************************
  * KVS OPERATIONS
@@ -77,6 +83,14 @@ PyObject * AerospikeClient_shm_key(AerospikeClient * self, PyObject * args, PyOb
  */
 PyObject * AerospikeClient_Apply(AerospikeClient * self, PyObject * args, PyObject * kwds);
 
+/**
+ * Apply a UDF on many records in the database.
+ *
+ *		client.apply_many([key1, key2], module, function, args...)
+ *
+ */
+PyObject * AerospikeClient_Apply_Many(AerospikeClient * self, PyObject * args, PyObject * kwds);
+
 PyObject * AerospikeClient_Apply_Invoke(
 		AerospikeClient * self,
 		PyObject * py_key, PyObject * py_module, PyObject * py_function,
@@ -198,6 +212,14 @@ PyObject * AerospikeClient_OperateOrdered(AerospikeClient * self, PyObject * arg
  */
 PyObject * AerospikeClient_ListAppend(AerospikeClient * self, PyObject * args, PyObject * kwds);
 
+/**
+ * Append a single val to the list value in bin of many records.
+ *
+ *		client.list_append_many([key1, key2], bin, val)
+ *
+ */
+PyObject * AerospikeClient_ListAppend_Many(AerospikeClient * self, PyObject * args, PyObject * kwds);
+
 /**
  * Extend the list value in bin with the given items.
  *
@@ -319,6 +341,16 @@ PyObject * AerospikeClient_ListSize(AerospikeClient * self, PyObject * args, PyO
 PyObject * AerospikeClient_MapSetPolicy(AerospikeClient * self, PyObject * args, PyObject * kwds);
 PyObject * AerospikeClient_MapPut(AerospikeClient * self, PyObject * args, PyObject * kwds);
 PyObject * AerospikeClient_MapPutItems(AerospikeClient * self, PyObject * args, PyObject * kwds);
+
+/**
+ * Put one item, or the items of a dict, into the map bin of many records.
+ *
+ *		client.map_put_many([key1, key2], bin, map_key, val)
+ *		client.map_put_items_many([key1, key2], bin, items)
+ *
+ */
+PyObject * AerospikeClient_MapPut_Many(AerospikeClient * self, PyObject * args, PyObject * kwds);
+PyObject * AerospikeClient_MapPutItems_Many(AerospikeClient * self, PyObject * args, PyObject * kwds);
 PyObject * AerospikeClient_MapIncrement(AerospikeClient * self, PyObject * args, PyObject * kwds);
 PyObject * AerospikeClient_MapDecrement(AerospikeClient * self, PyObject * args, PyObject * kwds);
 PyObject * AerospikeClient_MapSize(AerospikeClient * self, PyObject * args, PyObject * kwds);
@@ -401,6 +433,14 @@ PyObject * AerospikeClient_ScanInfo(AerospikeClient * self, PyObject * args, PyO
  */
 AerospikeQuery * AerospikeClient_Query(AerospikeClient * self, PyObject * args, PyObject * kwds);
 PyObject * AerospikeClient_QueryApply(AerospikeClient * self, PyObject * args, PyObject * kwds);
+
+/**
+ * Run several queries at the same time and return their results
+ *
+ *		client.query_many([q1, q2], merge='dedup_by_digest')
+ *
+ */
+PyObject * AerospikeClient_Query_Many(AerospikeClient * self, PyObject * args, PyObject * kwds);
 PyObject * AerospikeClient_JobInfo(AerospikeClient * self, PyObject * args, PyObject * kwds);
 
 /*******************************************************************************
@@ -575,6 +615,14 @@ PyObject * AerospikeClient_Exists_Many(AerospikeClient * self, PyObject *args, P
 */
 PyObject * AerospikeClient_Info(AerospikeClient * self, PyObject * args, PyObject * kwds);
 
+/**
+* Perform info operation on all the nodes in parallel.
+*
+* client.info_all(command, parse)
+*
+*/
+PyObject * AerospikeClient_InfoAll(AerospikeClient * self, PyObject * args, PyObject * kwds);
+
 /**
 * Perform get nodes operation on the database.
 *
@@ -596,6 +644,50 @@ PyObject * AerospikeClient_HasGeo(AerospikeClient * self, PyObject * args, PyObj
 *
 */
 PyObject * AerospikeClient_Get_Key_Digest(AerospikeClient * self, PyObject * args, PyObject * kwds);
+/**
+* Return the counters of the hedged reads.
+*
+* client.hedge_stats()
+*
+*/
+PyObject * AerospikeClient_Hedge_Stats(AerospikeClient * self, PyObject * args, PyObject * kwds);
+/**
+* Return the state of the rate limits, the cache, the hedged reads and the
+* circuit breakers.
+*
+* client.stats()
+*
+*/
+PyObject * AerospikeClient_Stats(AerospikeClient * self, PyObject * args, PyObject * kwds);
+/**
+* Return the nodes, connection pools and thread pool of the C client,
+* without any request to the server.
+*
+* client.cluster_stats()
+*
+*/
+PyObject * AerospikeClient_Cluster_Stats(AerospikeClient * self, PyObject * args, PyObject * kwds);
+/**
+* Group keys by the node owning them, from the client's partition map.
+*
+* client.group_keys_by_node(keys)
+*
+*/
+PyObject * AerospikeClient_Group_Keys_By_Node(AerospikeClient * self, PyObject * args, PyObject * kwds);
+/**
+* Set the callback receiving the spans of sampled calls.
+*
+* client.set_tracer(callback)
+*
+*/
+PyObject * AerospikeClient_Set_Tracer(AerospikeClient * self, PyObject * args, PyObject * kwds);
+/**
+* Pass the buffered spans to the tracer's callback.
+*
+* client.flush_spans()
+*
+*/
+PyObject * AerospikeClient_Flush_Spans(AerospikeClient * self, PyObject * args, PyObject * kwds);
 /**
  * Return search string for host port combination
  */
@@ -603,7 +695,7 @@ char* return_search_string(aerospike *as);
 /**
  * Close the aerospike object depending on the global_hosts entries
  */
-void close_aerospike_object(aerospike *as, as_error *err, char *alias_to_search, PyObject *py_persistent_item, bool do_destroy);
+void close_aerospike_object(AerospikeClient * self, as_error *err, char *alias_to_search, PyObject *py_persistent_item, bool do_destroy);
 /**
  * Check type for 'operate' operation
  */
@@ -615,3 +707,43 @@ int check_type(AerospikeClient * self, PyObject * py_value, int op, as_error *er
  ******************************************************************************/
 
 PyObject* AerospikeClient_Truncate(AerospikeClient * self, PyObject * args, PyObject * kwds);
+
+/*******************************************************************************
+ * TASK OPERATIONS
+ ******************************************************************************/
+/**
+ * Wait for tasks returned by index_*_create() or udf_put() with wait=False
+ *
+ *		client.wait_for_task(task, timeout, poll_interval, policy)
+ *
+ */
+PyObject * AerospikeClient_Wait_For_Task(AerospikeClient * self, PyObject * args, PyObject * kwds);
+
+/**
+ * Convert a pending index build into a task dict
+ */
+PyObject * index_task_to_pyobject(as_index_task * task);
+
+/**
+ * Convert a pending UDF registration into a task dict
+ */
+PyObject * udf_task_to_pyobject(const char * module);
+
+/*******************************************************************************
+ * BULK OPERATIONS
+ ******************************************************************************/
+/**
+ * Load an NDJSON or CSV file into a set
+ *
+ *		client.load_file(path, ns, set, key_field, format, concurrency, rate, reject_path, policy)
+ *
+ */
+PyObject * AerospikeClient_Load_File(AerospikeClient * self, PyObject * args, PyObject * kwds);
+
+/**
+ * Create a batcher merging counter updates into one operate per record
+ *
+ *		client.counter_batcher(flush_interval_ms, max_pending, on_error, policy)
+ *
+ */
+AerospikeCounterBatcher * AerospikeClient_Counter_Batcher(AerospikeClient * self, PyObject * args, PyObject * kwds);
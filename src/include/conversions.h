@@ -93,3 +93,9 @@ void initialize_bin_for_strictypes(AerospikeClient *self, as_error *err, PyObjec
 as_status bin_strict_type_checking(AerospikeClient * self, as_error *err, PyObject *py_bin, char **bin);
 
 as_status check_for_meta(PyObject * py_meta, as_operations * ops, as_error *err);
+
+void unicode_objects_init(UnicodePyObjects * u_objs, int capacity);
+
+PyObject * unicode_objects_add(UnicodePyObjects * u_objs, PyObject * py_obj);
+
+void unicode_objects_destroy(UnicodePyObjects * u_objs);
@@ -0,0 +1,231 @@
+/*******************************************************************************
+ * Copyright 2013-2016 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+#include <Python.h>
+#include <pthread.h>
+#include <stdbool.h>
+
+#include <aerospike/as_arraylist.h>
+#include <aerospike/as_error.h>
+#include <aerospike/as_key.h>
+#include <aerospike/as_policy.h>
+
+#include "types.h"
+#include "client.h"
+
+#define COUNTER_BATCHER_DEFAULT_FLUSH_INTERVAL 1000
+#define COUNTER_BATCHER_DEFAULT_MAX_PENDING 10000
+// Failures kept for on_error between calls, beyond that they are only counted
+#define COUNTER_BATCHER_MAX_FAILURES 1000
+// Pending records beyond this many per bucket share hash chains
+#define COUNTER_BATCHER_MAX_BUCKETS (1 << 14)
+
+// Merged updates to one bin of a pending record
+typedef struct {
+	char name[AS_BIN_NAME_MAX_SIZE];
+	bool has_increment;
+	bool is_double;
+	int64_t int_value;
+	double double_value;
+	as_arraylist * appends;
+} counter_batcher_bin;
+
+// A pending record, keyed by its digest
+typedef struct counter_batcher_entry_s {
+	as_key key;
+	counter_batcher_bin * bins;
+	uint32_t n_bins;
+	uint32_t capacity;
+	struct counter_batcher_entry_s * hash_next;
+} counter_batcher_entry;
+
+typedef struct {
+	counter_batcher_entry ** buckets;
+	// Entries in the order they were first updated
+	counter_batcher_entry ** entries;
+	uint32_t n_entries;
+	uint32_t capacity;
+} counter_batcher_table;
+
+typedef struct {
+	as_key key;
+	as_error error;
+} counter_batcher_failure;
+
+/**
+ * State shared by the Python object and the flush threads. Everything
+ * below lock is guarded by it.
+ */
+struct counter_batcher_state_s {
+	aerospike * as;
+	// Cache of the client, invalidated with the GIL once records are written
+	record_cache * cache;
+	// Interpreter of the client, entered for the invalidation
+	PyInterpreterState * interp;
+	as_policy_operate policy;
+	uint32_t flush_interval_ms;
+	uint32_t max_pending;
+	uint32_t n_buckets;
+	bool has_thread;
+	pthread_t thread;
+
+	// Next batcher of the client and the batcher object, used with the GIL
+	counter_batcher_state * next;
+	PyObject * py_batcher;
+
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	bool closed;
+	// Closed because the client was closed or forked, flushes write nothing
+	bool detached;
+	uint32_t n_flushing;
+	counter_batcher_table * pending;
+	// Emptied table kept for the next flush, if any
+	counter_batcher_table * spare;
+	counter_batcher_failure * failures;
+	uint32_t n_failures;
+
+	uint64_t updates;
+	uint64_t flushes;
+	uint64_t records;
+	uint64_t errors;
+	uint64_t last_flush_us;
+	uint64_t max_flush_us;
+	uint64_t total_flush_us;
+};
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+PyTypeObject * AerospikeCounterBatcher_Ready(void);
+
+AerospikeCounterBatcher * AerospikeCounterBatcher_New(AerospikeClient * client, PyObject * args, PyObject * kwds);
+
+/**
+ * Create the shared state and start the flush thread, if there is an
+ * interval.
+ */
+counter_batcher_state * counter_batcher_state_new(aerospike * as, record_cache * cache,
+		PyInterpreterState * interp, as_policy_operate * policy, uint32_t flush_interval_ms,
+		uint32_t max_pending);
+
+/**
+ * Stop the flush thread and write what is pending. Must be called
+ * without the GIL.
+ */
+void counter_batcher_stop(counter_batcher_state * state);
+
+/**
+ * Stop writing through the client's connection, waiting for the flushes in
+ * progress. Later updates raise ClusterError. Must be called without the
+ * GIL, after counter_batcher_stop() for a final flush.
+ */
+void counter_batcher_disconnect(counter_batcher_state * state);
+
+/**
+ * Close a batcher inherited across fork(). Its flush thread only exists in
+ * the parent, which also writes what was pending, so both are dropped.
+ */
+void counter_batcher_abandon(counter_batcher_state * state);
+
+/**
+ * Stop the batcher if needed and free the state. Must be called without
+ * the GIL.
+ */
+void counter_batcher_state_destroy(counter_batcher_state * state);
+
+/**
+ * Merge an increment into the pending updates. Returns the number of
+ * pending records.
+ */
+uint32_t counter_batcher_add_increment(counter_batcher_state * state, as_key * key, const char * bin_name,
+		bool is_double, int64_t int_value, double double_value);
+
+/**
+ * Queue a value to append to a list bin, taking ownership of it. Returns
+ * the number of pending records.
+ */
+uint32_t counter_batcher_add_append(counter_batcher_state * state, as_key * key, const char * bin_name, as_val * value);
+
+/**
+ * Write every pending record, without the GIL. Returns the number of
+ * records written or failed.
+ */
+uint32_t counter_batcher_flush(counter_batcher_state * state);
+
+/**
+ * Add the batcher to the client's, to be closed along with the client.
+ */
+void counter_batcher_attach(AerospikeClient * client, counter_batcher_state * state);
+
+/**
+ * Remove the batcher from the client's.
+ */
+void counter_batcher_detach(AerospikeClient * client, counter_batcher_state * state);
+
+/**
+ * Close every batcher of the client, after a final flush unless the
+ * client was inherited across fork(). Their updates then raise
+ * ClusterError. Must be called with the GIL, which it releases.
+ */
+void counter_batchers_close(AerospikeClient * client, bool inherited);
+
+/*******************************************************************************
+ * OPERATIONS
+ ******************************************************************************/
+
+/**
+ * Add to a bin of a record on the next flush
+ *
+ *		batcher.increment(key, bin, value)
+ *
+ */
+PyObject * AerospikeCounterBatcher_Increment(AerospikeCounterBatcher * self, PyObject * args, PyObject * kwds);
+
+/**
+ * Append to a list bin of a record on the next flush
+ *
+ *		batcher.list_append(key, bin, value)
+ *
+ */
+PyObject * AerospikeCounterBatcher_List_Append(AerospikeCounterBatcher * self, PyObject * args, PyObject * kwds);
+
+/**
+ * Write every pending record now
+ *
+ *		batcher.flush()
+ *
+ */
+PyObject * AerospikeCounterBatcher_Flush(AerospikeCounterBatcher * self, PyObject * args, PyObject * kwds);
+
+/**
+ * Flush and stop the batcher
+ *
+ *		batcher.close()
+ *
+ */
+PyObject * AerospikeCounterBatcher_Close(AerospikeCounterBatcher * self, PyObject * args, PyObject * kwds);
+
+/**
+ * Return the batcher's counters and flush latencies
+ *
+ *		batcher.stats()
+ *
+ */
+PyObject * AerospikeCounterBatcher_Stats(AerospikeCounterBatcher * self, PyObject * args, PyObject * kwds);
@@ -18,5 +18,10 @@
 
 #include <Python.h>
 
-PyObject * AerospikeException_New(void);
+#include "types.h"
+
+/**
+ * Creates the aerospike.exception module and indexes its classes in state.
+ */
+PyObject * AerospikeException_New(aerospike_state * state);
 PyObject* raise_exception(as_error * err);
@@ -48,3 +48,34 @@ AerospikeGeospatial  * Aerospike_Set_Geo_Data(PyObject * parent, PyObject * args
 AerospikeGeospatial  * Aerospike_Set_Geo_Json(PyObject * parent, PyObject * args, PyObject * kwds);
 
 PyObject * AerospikeGeospatial_New(as_error *err, PyObject * value);
+
+/**
+ * Create a GeoJSON object from the text of a geo bin. The text is only
+ * parsed if geo_data is read.
+ */
+PyObject * AerospikeGeospatial_New_GeoJSON(as_error *err, const char * geojson);
+
+/**
+ * Return the geo_data dict, parsing the text the object was read from if
+ * needed. The reference is borrowed.
+ */
+PyObject * AerospikeGeospatial_GetData(AerospikeGeospatial * self, as_error *err);
+
+/**
+ * Return the GeoJSON text of a GeoJSON object, as a string the caller
+ * owns and frees.
+ */
+char * AerospikeGeospatial_GeoJSON(PyObject * py_geo, as_error *err);
+
+/**
+ * Encode to and decode from JSON in C, for the types GeoJSON is made of.
+ * Both return NULL, with no Python error set, for what they can't handle.
+ */
+PyObject * geojson_dumps(PyObject * py_obj);
+
+PyObject * geojson_loads(const char * text, size_t len);
+
+/**
+ * Return the json module, imported on first use. The reference is borrowed.
+ */
+PyObject * geojson_json_module(void);
@@ -21,3 +21,5 @@
 #include "types.h"
 AerospikeGlobalHosts * AerospikeGobalHosts_New(aerospike* as);
 void AerospikeGlobalHosts_Del(PyObject *self);
+
+PyTypeObject * AerospikeGlobalHosts_Ready();
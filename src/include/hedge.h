@@ -0,0 +1,70 @@
+/*******************************************************************************
+ * Copyright 2013-2016 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+#include <stdbool.h>
+
+#include <aerospike/aerospike.h>
+#include <aerospike/as_error.h>
+#include <aerospike/as_key.h>
+#include <aerospike/as_policy.h>
+#include <aerospike/as_record.h>
+
+#include "types.h"
+
+typedef enum {
+	HEDGE_GET,
+	HEDGE_SELECT,
+	HEDGE_EXISTS
+} hedge_op;
+
+#define HEDGE_POOL_MAX_THREADS 16
+
+/**
+ * Create the client's pool of threads for hedged reads. No thread is started
+ * until a read needs one.
+ */
+hedge_pool * hedge_pool_new(void);
+
+/**
+ * Stops the pool's threads and frees it, after hedge_wait_idle.
+ */
+void hedge_pool_destroy(hedge_pool * pool);
+
+/**
+ * Runs a get, select or exists. If it has not answered after hedge_after_ms,
+ * the same read is sent again with AS_POLICY_REPLICA_ANY and the first answer
+ * is kept. Both reads run on the pool's threads and the slower one finishes in
+ * the background. When every thread is busy the read runs on the calling
+ * thread without a hedge.
+ *
+ * Must be called without the GIL. bins is only used by HEDGE_SELECT.
+ */
+as_status hedge_read(hedge_pool * pool, aerospike * as, as_error * err, const as_policy_read * policy,
+		const as_key * key, const char ** bins, hedge_op op, uint32_t hedge_after_ms,
+		as_record ** rec, bool * hedged, bool * hedge_won);
+
+/**
+ * Waits for the client's reads still running in the background, which use
+ * the aerospike object, before it is closed.
+ */
+void hedge_wait_idle(hedge_pool * pool);
+
+/**
+ * Adds the outcome of a hedge_read to the client's counters. Needs the GIL.
+ */
+void hedge_stats_update(AerospikeClient * self, bool hedged, bool hedge_won);
@@ -0,0 +1,94 @@
+/*******************************************************************************
+ * Copyright 2013-2016 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+#include <Python.h>
+#include <pthread.h>
+#include <stdint.h>
+
+#include <aerospike/as_error.h>
+#include <aerospike/as_key.h>
+
+#include "types.h"
+
+typedef enum {
+	LIMITER_READ,
+	LIMITER_WRITE,
+	LIMITER_BATCH,
+	LIMITER_UDF,
+	LIMITER_OPERATIONS
+} limiter_op;
+
+typedef struct {
+	// Namespace, "namespace.set" or operation class limited by the bucket
+	char name[AS_NAMESPACE_MAX_SIZE + AS_SET_MAX_SIZE];
+	// Tokens added per second, also the most the bucket holds. 0 is no limit.
+	double rate;
+	double tokens;
+	uint64_t refilled_us;
+	uint64_t admitted;
+	uint64_t rejected;
+} limiter_bucket;
+
+/**
+ * Admission control from the client config's 'limits' dict: token buckets
+ * per namespace, set and operation class, and a cap on requests in flight.
+ * Used by threads running without the GIL, so every field is guarded by lock.
+ */
+struct request_limiter_s {
+	pthread_mutex_t lock;
+	// Signalled when a request in flight ends
+	pthread_cond_t cond;
+	uint32_t max_in_flight;
+	uint32_t max_wait_ms;
+	uint32_t in_flight;
+	uint64_t admitted;
+	uint64_t queued;
+	uint64_t rejected;
+	limiter_bucket operations[LIMITER_OPERATIONS];
+	limiter_bucket * namespaces;
+	uint32_t n_namespaces;
+	limiter_bucket * sets;
+	uint32_t n_sets;
+};
+
+/**
+ * Create a limiter from the client config's 'limits' dict.
+ * Returns NULL if the dict is invalid.
+ */
+request_limiter * request_limiter_new(PyObject * py_limits_config);
+
+void request_limiter_destroy(request_limiter * limiter);
+
+/**
+ * Admit a request costing cost tokens from the buckets of its operation
+ * class and of the key's namespace and set, and give it a slot in flight.
+ * Waits up to max_wait_ms, failing at once with AEROSPIKE_ERR_NO_MORE_CONNECTIONS
+ * if the tokens would not be there by then. Batches pass their first key.
+ *
+ * Must be called without the GIL. A NULL limiter admits every request.
+ * Each admitted request must end with request_limiter_release.
+ */
+as_status request_limiter_acquire(request_limiter * limiter, as_error * err, limiter_op op,
+		const as_key * key, uint32_t cost);
+
+void request_limiter_release(request_limiter * limiter);
+
+/**
+ * Return a new dict of the limits, the tokens left and the counters.
+ */
+PyObject * request_limiter_stats(request_limiter * limiter);
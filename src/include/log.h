@@ -38,6 +38,8 @@ typedef enum Aerospike_log_level_e {
  */
 typedef struct Aerospike_log_callback {
     PyObject *callback;
+    // Interpreter the callback belongs to, entered by C client threads
+    PyInterpreterState *interp;
 } AerospikeLogCallback;
 
 /**
@@ -43,9 +43,22 @@
 			PyModuleDef_HEAD_INIT, name, doc, -1, methods, }; \
 			ob = PyModule_Create(&moduledef);
 	#define MOD_SUCCESS_VAL(val) val
+	#define MOD_ERROR_VAL NULL
 #else
 	#define MOD_INIT(name) PyMODINIT_FUNC init##name(void)
 	#define MOD_DEF(ob, name, doc, methods) \
 			ob = Py_InitModule3(name, methods, doc);
 	#define MOD_SUCCESS_VAL(val)
+	#define MOD_ERROR_VAL
+#endif
+
+// Python 3.9 and later get multi-phase init, per module state and heap
+// types. Python 2 and older Python 3 keep the static types and one state.
+// 3.8 lacks a public PyInterpreterState_Get() to find the module by.
+#if PY_VERSION_HEX >= 0x03090000
+	#define AS_HEAP_TYPES 1
+	// Instances of heap types hold a reference to their type
+	#define AS_TYPE_RELEASE(type) Py_DECREF(type)
+#else
+	#define AS_TYPE_RELEASE(type)
 #endif
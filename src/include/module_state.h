@@ -0,0 +1,102 @@
+/*******************************************************************************
+ * Copyright 2013-2016 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+#include <Python.h>
+#include <stdbool.h>
+
+#include "macros.h"
+#include "types.h"
+
+// Status codes the exception table can index, client codes are negative
+#define EXCEPTION_CODE_MIN -64
+#define EXCEPTION_CODE_MAX 2047
+
+/**
+ * State of the aerospike module. With AS_HEAP_TYPES it lives in the module
+ * object, so every interpreter importing the module gets its own. Otherwise
+ * there is a single one for the process.
+ */
+struct aerospike_state_s {
+	// AerospikeGlobalHosts of the shared connections, by host alias
+	PyObject * global_hosts;
+
+	// Set with aerospike.set_serializer() / set_deserializer()
+	user_serializer_callback serializer;
+	user_serializer_callback deserializer;
+	bool is_serializer_registered;
+	bool is_deserializer_registered;
+
+	PyTypeObject * client_type;
+	PyTypeObject * query_type;
+	PyTypeObject * scan_type;
+	PyTypeObject * llist_type;
+	PyTypeObject * geospatial_type;
+	PyTypeObject * null_object_type;
+	PyTypeObject * counter_batcher_type;
+	PyTypeObject * global_hosts_type;
+
+	// The aerospike.exception module, and its class for each status code
+	PyObject * exception_module;
+	PyObject * exception_table[EXCEPTION_CODE_MAX - EXCEPTION_CODE_MIN + 1];
+	PyObject * exception_default;
+
+	// Interpreter that imported the module, NULL without AS_HEAP_TYPES
+	PyInterpreterState * interp;
+};
+
+/**
+ * The GIL taken by aerospike_gil_ensure().
+ */
+typedef struct {
+	PyGILState_STATE gstate;
+	// Thread state made for a subinterpreter, NULL if gstate is used
+	PyThreadState * tstate;
+	// The thread was already running Python code of the interpreter
+	bool held;
+} aerospike_gil;
+
+/**
+ * The state of the module passed to a module level function. On Python 2
+ * module functions get no module, so it may be NULL.
+ */
+aerospike_state * aerospike_module_state(PyObject * module);
+
+/**
+ * The state of the aerospike module imported by the calling interpreter.
+ * Needs the GIL.
+ */
+aerospike_state * aerospike_get_state(void);
+
+/**
+ * The aerospike module imported by the calling interpreter, as a borrowed
+ * reference. NULL without AS_HEAP_TYPES, where the state is never freed.
+ */
+PyObject * aerospike_get_module(void);
+
+/**
+ * Takes the GIL to run Python code of interp, from a C client thread or from
+ * a thread that released the GIL. PyGILState_Ensure() only knows the main
+ * interpreter, so a subinterpreter gets a thread state of its own for the
+ * length of the call. A NULL interp is the main interpreter.
+ */
+void aerospike_gil_ensure(PyInterpreterState * interp, aerospike_gil * gil);
+
+/**
+ * Releases the GIL taken by aerospike_gil_ensure().
+ */
+void aerospike_gil_release(aerospike_gil * gil);
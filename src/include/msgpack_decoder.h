@@ -0,0 +1,32 @@
+/*******************************************************************************
+ * Copyright 2013-2016 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+#include <Python.h>
+#include <stdint.h>
+
+#include <aerospike/as_error.h>
+
+#include "types.h"
+
+/**
+ * Decodes the msgpack of a list or map bin, read with the deserialize
+ * policy off, straight into Python lists and dicts. Values convert as
+ * val_to_pyobject() would convert them from the as_val tree.
+ */
+as_status msgpack_to_pyobject(AerospikeClient * self, as_error * err,
+		const uint8_t * buf, uint32_t size, PyObject ** py_obj);
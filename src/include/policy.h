@@ -117,6 +117,12 @@ as_status pyobject_to_policy_read(as_error * err, PyObject * py_policy,
 									as_policy_read ** policy_p,
 									as_policy_read * config_read_policy);
 
+as_status pyobject_to_policy_hedge(as_error * err, PyObject * py_policy,
+									uint32_t * hedge_after_ms);
+
+as_status pyobject_to_policy_not_found(as_error * err, PyObject * py_policy,
+									bool * none_on_miss);
+
 as_status pyobject_to_policy_remove(as_error * err, PyObject * py_policy,
 									as_policy_remove * policy,
 									as_policy_remove ** policy_p,
@@ -86,6 +86,24 @@ PyObject * AerospikeQuery_Foreach(AerospikeQuery * self, PyObject * args, PyObje
  */
 PyObject * AerospikeQuery_Results(AerospikeQuery * self, PyObject * args, PyObject * kwds);
 
+/**
+ * Rebind the predicate values and run the query again, returning a list
+ *
+ *		query.execute((min, max))
+ *
+ */
+PyObject * AerospikeQuery_Execute(AerospikeQuery * self, PyObject * args, PyObject * kwds);
+
+/**
+ * Replace the values of the query's predicate, keeping its bin and type.
+ */
+as_status AerospikeQuery_Where_Bind(AerospikeQuery * self, as_error * err, PyObject * py_params);
+
+/**
+ * Free the values held by the query's predicate and empty it.
+ */
+void AerospikeQuery_Where_Clear(AerospikeQuery * self);
+
 /**
  * Store the Unicode -> UTF8 string converted PyObject into 
  * a pool of PyObjects. So that, they will be decref'ed at later stages
@@ -60,6 +60,7 @@ AerospikeScan * AerospikeScan_Select(AerospikeScan * self, PyObject * args, PyOb
 
 /**
  * Execute the query and call the callback for each result returned.
+ * With a nodename only that node is scanned.
  *
  *    def each_result(result):
  *      print result
@@ -77,3 +78,11 @@ PyObject * AerospikeScan_Foreach(AerospikeScan * self, PyObject * args, PyObject
  *
  */
 PyObject * AerospikeScan_Results(AerospikeScan * self, PyObject * args, PyObject * kwds);
+
+/**
+ * Execute the scan and write the records straight to a file
+ *
+ *    scan.export(path, format, compress, policy)
+ *
+ */
+PyObject * AerospikeScan_Export(AerospikeScan * self, PyObject * args, PyObject * kwds);
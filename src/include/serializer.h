@@ -18,6 +18,7 @@
 
 #include <Python.h>
 #include <stdbool.h>
+#include "aerospike/as_bytes.h"
 #include "aerospike/as_error.h"
 #include "types.h"
 /*typedef struct {
@@ -66,4 +67,79 @@ extern as_status deserialize_based_on_as_bytes_type(AerospikeClient * self,
         as_bytes  *bytes,
 		PyObject  **retval,
 		as_error  *error_p);
+
+/**
+ * The value of a write's serializer argument, as put() reads it. Sets
+ * is_client_put_serializer, and returns SERIALIZER_PYTHON without one.
+ */
+long serializer_option_from_pyobject(AerospikeClient * self, PyObject * py_serializer);
+
+/**
+ * The values of one write, while a serializer registered with batch=True
+ * waits to be called once for all of them.
+ */
+typedef struct {
+	bool active;
+	// The serializer registered when the collection began
+	PyObject * py_callback;
+	// Arguments passed to the serializer, in the order found
+	PyObject * py_values;
+	// The bytes each serialized value is written to, empty until then
+	as_bytes ** bytes;
+	Py_ssize_t capacity;
+} serializer_batch;
+
+/**
+ * Starts collecting the values this thread serializes. Does nothing
+ * without a batch serializer, or inside another collection, whose end
+ * then covers these values too. Must be ended before the write is sent.
+ */
+void serializer_batch_begin(AerospikeClient * self, serializer_batch * batch);
+
+/**
+ * Calls the serializer once with the values collected and fills in their
+ * bytes. Not called if err is already set, as the write will not be sent.
+ * A serializer that raises or returns a list of another length fails the
+ * write, as with a single value.
+ */
+as_status serializer_batch_end(serializer_batch * batch, as_error * err);
+
+/**
+ * Stops collecting on this thread until serializer_batch_resume(), so that
+ * the values converted in between are serialized at once. Map keys need
+ * this, as the map hashes and compares them as soon as they are set.
+ * Returns the collection to resume, if any.
+ */
+serializer_batch * serializer_batch_suspend(void);
+
+void serializer_batch_resume(serializer_batch * batch);
+
+/**
+ * The blobs of one result, while a deserializer registered with batch=True
+ * waits to be called once for all of them.
+ */
+typedef struct {
+	bool active;
+	// The deserializer registered when the collection began
+	PyObject * py_callback;
+	// Arguments passed to the deserializer, in the order found
+	PyObject * py_blobs;
+	// Objects standing in for the blobs in the result until it returns
+	PyObject * py_placeholders;
+} deserializer_batch;
+
+/**
+ * Starts collecting the blobs converted by this thread. Does nothing
+ * without a batch deserializer, or inside another collection, whose end
+ * then covers these blobs too.
+ */
+void deserializer_batch_begin(AerospikeClient * self, deserializer_batch * batch);
+
+/**
+ * Calls the deserializer once with a list of the collected blobs and puts
+ * its results in place of the blobs in py_result, a record, a list of them
+ * or any list, tuple or dict. If it fails, the blobs are left as bytearrays
+ * as with a single value. py_result may be NULL after a failed conversion.
+ */
+as_status deserializer_batch_end(deserializer_batch * batch, PyObject * py_result, as_error * err);
 #endif
@@ -0,0 +1,128 @@
+/*******************************************************************************
+ * Copyright 2013-2016 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#pragma once
+
+#include <Python.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <aerospike/as_error.h>
+#include <aerospike/as_key.h>
+#include <aerospike/as_node.h>
+#include <citrusleaf/cf_clock.h>
+
+#include "types.h"
+
+#define TRACER_DEFAULT_BATCH_SIZE 100
+
+typedef struct {
+	const char * operation;
+	char ns[AS_NAMESPACE_MAX_SIZE];
+	char set[AS_SET_MAX_SIZE];
+	// Master node of a single record, empty for batches
+	char node[AS_NODE_NAME_MAX_SIZE];
+	uint32_t n_keys;
+	as_status status;
+	// Wall clock time the call started
+	uint64_t start_us;
+	uint64_t convert_us;
+	uint64_t network_us;
+	uint64_t result_us;
+} trace_record;
+
+/**
+ * Sampled spans set up by client.set_tracer(). Only used with the GIL held.
+ */
+struct span_tracer_s {
+	PyObject * callback;
+	double sample_rate;
+	// Grows by sample_rate every call, a call is sampled each time it reaches 1
+	double credit;
+	uint32_t batch_size;
+	trace_record * spans;
+	uint32_t n_spans;
+};
+
+/**
+ * Timestamps of one call, on the caller's stack.
+ */
+typedef struct {
+	bool sampled;
+	const char * operation;
+	uint64_t start_us;
+	uint64_t call_us;
+	uint64_t return_us;
+} trace_span;
+
+span_tracer * span_tracer_new(PyObject * callback, double sample_rate, uint32_t batch_size);
+
+/**
+ * Frees the tracer, dropping the spans not yet passed to the callback.
+ */
+void span_tracer_destroy(span_tracer * tracer);
+
+/**
+ * Passes the buffered spans to the callback as a list of dicts.
+ * Returns false with a Python error set if the callback raised.
+ */
+bool span_tracer_flush(span_tracer * tracer);
+
+/**
+ * Starts the span of a call, deciding whether it is sampled. Needs the GIL.
+ * Calls are never sampled without a tracer.
+ */
+void trace_start(AerospikeClient * self, trace_span * span, const char * operation);
+
+/**
+ * Ends the span of a single record call, buffering it if sampled and passing
+ * a full buffer to the callback. key is NULL if it was not converted.
+ * A span only ends once, later trace_end* calls on it do nothing.
+ * Needs the GIL.
+ */
+void trace_end(AerospikeClient * self, trace_span * span, const as_key * key, as_status status);
+
+/**
+ * Ends the span of a batch of n_keys, with first_key giving its namespace
+ * and set. Needs the GIL.
+ */
+void trace_end_batch(AerospikeClient * self, trace_span * span, const as_key * first_key,
+		uint32_t n_keys, as_status status);
+
+/**
+ * Ends the span of a call over a namespace and set rather than keys, such as
+ * a scan, a query or load_file, with n_records the records it returned or
+ * wrote. ns is NULL for calls such as info. Needs the GIL.
+ */
+void trace_end_set(AerospikeClient * self, trace_span * span, const char * ns,
+		const char * set, uint32_t n_records, as_status status);
+
+/**
+ * Mark the network phase of a sampled call. These may be called without the GIL.
+ */
+static inline void trace_call_start(trace_span * span)
+{
+	if (span->sampled) {
+		span->call_us = cf_getus();
+	}
+}
+
+static inline void trace_call_end(trace_span * span)
+{
+	if (span->sampled) {
+		span->return_us = cf_getus();
+	}
+}
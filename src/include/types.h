@@ -18,6 +18,7 @@
 
 #include <Python.h>
 #include <stdbool.h>
+#include <sys/types.h>
 
 #include <aerospike/aerospike.h>
 #include <aerospike/as_key.h>
@@ -30,9 +31,6 @@
 // Bin names can be of type Unicode in Python
 // DB supports 32767 maximum number of bins
 #define MAX_UNICODE_OBJECTS 32767
-extern int counter;
-extern PyObject *py_global_hosts;
-extern bool user_shm_key;
 
 typedef struct {
 	PyObject_HEAD
@@ -43,18 +41,51 @@ typedef struct {
 	aerospike * as;
 	int shm_key;
 	int ref_cnt;
+	pid_t pid;
 } AerospikeGlobalHosts;
 
 typedef struct {
 	as_error error;
 	PyObject * callback;
+	// Called once per result with a list of values, see deserializer_batch
+	bool batch;
 }user_serializer_callback;
 
+// Client side record cache, defined in cache.h
+typedef struct record_cache_s record_cache;
+
+// Client side admission control, defined in limiter.h
+typedef struct request_limiter_s request_limiter;
+
+// Per node circuit breakers, defined in breaker.h
+typedef struct circuit_breaker_s circuit_breaker;
+
+// Sampled spans of client calls, defined in tracer.h
+typedef struct span_tracer_s span_tracer;
+
+// Threads of the hedged reads, defined in hedge.c
+typedef struct hedge_pool_s hedge_pool;
+
+// State of the aerospike module, defined in module_state.h
+typedef struct aerospike_state_s aerospike_state;
+
+// Pending updates and flush thread of a counter batcher, defined in counter_batcher.h
+typedef struct counter_batcher_state_s counter_batcher_state;
+
+// Owned UTF-8 encodings of unicode bin names, grown as bins are added
 typedef struct {
-	PyObject *ob[MAX_UNICODE_OBJECTS];
+	PyObject **ob;
 	int size;
+	int capacity;
 } UnicodePyObjects;
 
+// Counters of the reads sent with a hedge_after_ms policy
+typedef struct {
+	uint64_t reads;
+	uint64_t hedged;
+	uint64_t hedge_wins;
+} hedge_stats;
+
 typedef struct {
 	PyObject_HEAD
 	aerospike * as;
@@ -65,6 +96,19 @@ typedef struct {
 	uint8_t strict_types;
 	bool has_connected;
 	bool use_shared_connection;
+	bool user_shm_key;
+	pid_t connect_pid;
+	record_cache * cache;
+	hedge_stats hedge;
+	hedge_pool * hedge_pool;
+	request_limiter * limiter;
+	circuit_breaker * breaker;
+	span_tracer * tracer;
+	// Counter batchers writing through the client, linked by their next field
+	counter_batcher_state * batchers;
+	// State of the module that created the client, kept alive by py_module
+	aerospike_state * state;
+	PyObject * py_module;
 } AerospikeClient;
 
 typedef struct {
@@ -83,8 +127,17 @@ typedef struct {
 typedef struct {
 	PyObject_HEAD
 	PyObject *geo_data;
+	// GeoJSON text read from the server, until geo_data is first needed
+	char *geojson;
 } AerospikeGeospatial;
 
+typedef struct {
+	PyObject_HEAD
+	AerospikeClient * client;
+	PyObject * on_error;
+	counter_batcher_state * state;
+} AerospikeCounterBatcher;
+
 typedef struct {
     PyObject_HEAD
     AerospikeClient * client;
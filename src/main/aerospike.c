@@ -23,6 +23,7 @@
 #include "query.h"
 #include "geo.h"
 #include "scan.h"
+#include "counter_batcher.h"
 #include "predicates.h"
 #include "exceptions.h"
 #include "llist.h"
@@ -31,12 +32,10 @@
 #include <aerospike/as_operations.h>
 #include "serializer.h"
 #include "module_functions.h"
+#include "module_state.h"
+#include "global_hosts.h"
 #include "nullobject.h"
 
-PyObject *py_global_hosts;
-int counter = 0xA5000000;
-bool user_shm_key = false;
-
 static PyMethodDef Aerospike_Methods[] = {
 
 	//Serialization
@@ -79,38 +78,77 @@ AerospikeConstants operator_constants[] = {
 };
 
 #define OPERATOR_CONSTANTS_ARR_SIZE (sizeof(operator_constants)/sizeof(AerospikeConstants))
-MOD_INIT(aerospike)
+
+// Key of the module in the interpreter's dict, see aerospike_get_state()
+#define AEROSPIKE_MODULE_KEY "aerospike._module"
+
+#ifndef AS_HEAP_TYPES
+static aerospike_state aerospike_process_state;
+#endif
+
+/**
+ * Adds a type to the module, keeping a reference in the state.
+ */
+static int aerospike_add_type(PyObject * aerospike, const char * name, PyTypeObject ** state_type,
+		PyTypeObject * type)
 {
+	if (!type) {
+		return -1;
+	}
+	*state_type = type;
+	Py_INCREF(type);
+	return PyModule_AddObject(aerospike, name, (PyObject *) type);
+}
 
+/**
+ * Populates the module and its state. Runs once per module object, which
+ * with multi-phase init is once per interpreter importing it.
+ */
+static int aerospike_exec(PyObject * aerospike)
+{
 	const char version[8] = "2.1.0";
-	// Makes things "thread-safe"
-	PyEval_InitThreads();
 	int i = 0;
 
-	// aerospike Module
-	PyObject * aerospike;
+	aerospike_state * state = aerospike_module_state(aerospike);
+	memset(state, 0, sizeof(aerospike_state));
 
-	MOD_DEF(aerospike, "aerospike", "Aerospike Python Client", Aerospike_Methods)
+	state->global_hosts = PyDict_New();
+	if (!state->global_hosts) {
+		return -1;
+	}
+
+#ifdef AS_HEAP_TYPES
+	state->interp = PyInterpreterState_Get();
 
-	py_global_hosts = PyDict_New();
+	// A weak reference, so that the module can still be freed
+	PyObject * py_interp_dict = PyInterpreterState_GetDict(state->interp);
+	PyObject * py_ref = py_interp_dict ? PyWeakref_NewRef(aerospike, NULL) : NULL;
+	if (!py_ref) {
+		return -1;
+	}
+	int rc = PyDict_SetItemString(py_interp_dict, AEROSPIKE_MODULE_KEY, py_ref);
+	Py_DECREF(py_ref);
+	if (rc == -1) {
+		return -1;
+	}
+#endif
 
 	PyModule_AddStringConstant(aerospike, "__version__", version);
 
-	PyObject * exception = AerospikeException_New();
+	PyObject * exception = AerospikeException_New(state);
+	if (!exception) {
+		return -1;
+	}
 	Py_INCREF(exception);
 	PyModule_AddObject(aerospike, "exception", exception);
 
-	PyTypeObject * client = AerospikeClient_Ready();
-	Py_INCREF(client);
-	PyModule_AddObject(aerospike, "Client", (PyObject *) client);
-
-	PyTypeObject * query = AerospikeQuery_Ready();
-	Py_INCREF(query);
-	PyModule_AddObject(aerospike, "Query", (PyObject *) query);
-
-	PyTypeObject * scan = AerospikeScan_Ready();
-	Py_INCREF(scan);
-	PyModule_AddObject(aerospike, "Scan", (PyObject *) scan);
+	if (aerospike_add_type(aerospike, "Client", &state->client_type, AerospikeClient_Ready()) == -1 ||
+			aerospike_add_type(aerospike, "Query", &state->query_type, AerospikeQuery_Ready()) == -1 ||
+			aerospike_add_type(aerospike, "Scan", &state->scan_type, AerospikeScan_Ready()) == -1 ||
+			aerospike_add_type(aerospike, "CounterBatcher", &state->counter_batcher_type,
+				AerospikeCounterBatcher_Ready()) == -1) {
+		return -1;
+	}
 
 	/*
 	 * Add constants to module.
@@ -127,17 +165,221 @@ MOD_INIT(aerospike)
 	Py_INCREF(predicates);
 	PyModule_AddObject(aerospike, "predicates", predicates);
 
-	PyTypeObject * llist = AerospikeLList_Ready();
-	Py_INCREF(llist);
-	PyModule_AddObject(aerospike, "llist", (PyObject *) llist);
+	if (aerospike_add_type(aerospike, "llist", &state->llist_type, AerospikeLList_Ready()) == -1 ||
+			aerospike_add_type(aerospike, "GeoJSON", &state->geospatial_type,
+				AerospikeGeospatial_Ready()) == -1 ||
+			aerospike_add_type(aerospike, "null", &state->null_object_type,
+				AerospikeNullObject_Ready()) == -1) {
+		return -1;
+	}
+
+	// Internal, so kept out of the module dict
+	state->global_hosts_type = AerospikeGlobalHosts_Ready();
+	if (!state->global_hosts_type) {
+		return -1;
+	}
+	return 0;
+}
+
+aerospike_state * aerospike_module_state(PyObject * module)
+{
+#ifdef AS_HEAP_TYPES
+	return (aerospike_state *) PyModule_GetState(module);
+#else
+	return &aerospike_process_state;
+#endif
+}
+
+PyObject * aerospike_get_module(void)
+{
+#ifdef AS_HEAP_TYPES
+	PyObject * py_interp_dict = PyInterpreterState_GetDict(PyInterpreterState_Get());
+	PyObject * py_ref = py_interp_dict ? PyDict_GetItemString(py_interp_dict, AEROSPIKE_MODULE_KEY) : NULL;
+	if (!py_ref) {
+		return NULL;
+	}
+#if PY_VERSION_HEX >= 0x030D0000
+	PyObject * py_module = NULL;
+	if (PyWeakref_GetRef(py_ref, &py_module) != 1) {
+		return NULL;
+	}
+	// Whoever keeps the weak reference alive also holds the module
+	Py_DECREF(py_module);
+	return py_module;
+#else
+	PyObject * py_module = PyWeakref_GetObject(py_ref);
+	return py_module == Py_None ? NULL : py_module;
+#endif
+#else
+	return NULL;
+#endif
+}
 
-	PyTypeObject * geospatial = AerospikeGeospatial_Ready();
-	Py_INCREF(geospatial);
-	PyModule_AddObject(aerospike, "GeoJSON", (PyObject *) geospatial);
+#ifdef AS_HEAP_TYPES
+/**
+ * The thread state the calling thread runs Python code with, if any.
+ */
+static PyThreadState * aerospike_current_tstate(void)
+{
+#if PY_VERSION_HEX >= 0x030D0000
+	return PyThreadState_GetUnchecked();
+#else
+	return _PyThreadState_UncheckedGet();
+#endif
+}
+#endif
 
-	PyTypeObject * null_object = AerospikeNullObject_Ready();
-	Py_INCREF(null_object);
-	PyModule_AddObject(aerospike, "null", (PyObject *) null_object);
+void aerospike_gil_ensure(PyInterpreterState * interp, aerospike_gil * gil)
+{
+	gil->tstate = NULL;
+	gil->held = false;
+#ifdef AS_HEAP_TYPES
+	if (interp && interp != PyInterpreterState_Main()) {
+		if (aerospike_current_tstate()) {
+			// Reached from Python code of the interpreter, such as a log
+			// message written by a call that kept the GIL
+			gil->held = true;
+			return;
+		}
+		gil->tstate = PyThreadState_New(interp);
+		PyEval_RestoreThread(gil->tstate);
+		return;
+	}
+#endif
+	gil->gstate = PyGILState_Ensure();
+}
+
+void aerospike_gil_release(aerospike_gil * gil)
+{
+	if (gil->held) {
+		return;
+	}
+	if (gil->tstate) {
+		PyThreadState_Clear(gil->tstate);
+		PyThreadState_DeleteCurrent();
+		return;
+	}
+	PyGILState_Release(gil->gstate);
+}
+
+aerospike_state * aerospike_get_state(void)
+{
+#ifdef AS_HEAP_TYPES
+	PyObject * py_module = aerospike_get_module();
+	return py_module ? aerospike_module_state(py_module) : NULL;
+#else
+	return &aerospike_process_state;
+#endif
+}
+
+#ifdef AS_HEAP_TYPES
+
+static int aerospike_traverse(PyObject * aerospike, visitproc visit, void * arg)
+{
+	aerospike_state * state = aerospike_module_state(aerospike);
+	if (!state) {
+		return 0;
+	}
+	Py_VISIT(state->global_hosts);
+	Py_VISIT(state->serializer.callback);
+	Py_VISIT(state->deserializer.callback);
+	Py_VISIT(state->client_type);
+	Py_VISIT(state->query_type);
+	Py_VISIT(state->scan_type);
+	Py_VISIT(state->llist_type);
+	Py_VISIT(state->geospatial_type);
+	Py_VISIT(state->null_object_type);
+	Py_VISIT(state->counter_batcher_type);
+	Py_VISIT(state->global_hosts_type);
+	Py_VISIT(state->exception_module);
+	return 0;
+}
+
+static int aerospike_clear(PyObject * aerospike)
+{
+	aerospike_state * state = aerospike_module_state(aerospike);
+	if (!state) {
+		return 0;
+	}
+	// The exception table borrows its classes from the exception module
+	memset(state->exception_table, 0, sizeof(state->exception_table));
+	state->exception_default = NULL;
+	state->is_serializer_registered = false;
+	state->is_deserializer_registered = false;
+	Py_CLEAR(state->global_hosts);
+	Py_CLEAR(state->serializer.callback);
+	Py_CLEAR(state->deserializer.callback);
+	Py_CLEAR(state->client_type);
+	Py_CLEAR(state->query_type);
+	Py_CLEAR(state->scan_type);
+	Py_CLEAR(state->llist_type);
+	Py_CLEAR(state->geospatial_type);
+	Py_CLEAR(state->null_object_type);
+	Py_CLEAR(state->counter_batcher_type);
+	Py_CLEAR(state->global_hosts_type);
+	Py_CLEAR(state->exception_module);
+	return 0;
+}
+
+static void aerospike_free(void * aerospike)
+{
+	aerospike_clear((PyObject *) aerospike);
+}
+
+static PyModuleDef_Slot Aerospike_Slots[] = {
+	{Py_mod_exec, aerospike_exec},
+#ifdef Py_mod_multiple_interpreters
+	// Callbacks from C client threads enter the interpreter of their client
+	// with aerospike_gil_ensure(). The C client and its log callback are
+	// shared by the process, so the interpreters must share one GIL.
+	{Py_mod_multiple_interpreters, Py_MOD_MULTIPLE_INTERPRETERS_SUPPORTED},
+#endif
+#ifdef Py_mod_gil
+	// Only concerns free-threaded builds: clients, queries and their caches
+	// still rely on the GIL
+	{Py_mod_gil, Py_MOD_GIL_USED},
+#endif
+	{0, NULL}
+};
+
+static struct PyModuleDef Aerospike_Module = {
+	PyModuleDef_HEAD_INIT,
+	"aerospike",
+	"Aerospike Python Client",
+	sizeof(aerospike_state),
+	Aerospike_Methods,
+	Aerospike_Slots,
+	aerospike_traverse,
+	aerospike_clear,
+	aerospike_free
+};
+
+PyMODINIT_FUNC PyInit_aerospike(void)
+{
+	return PyModuleDef_Init(&Aerospike_Module);
+}
+
+#else
+
+MOD_INIT(aerospike)
+{
+	// Makes things "thread-safe"
+	PyEval_InitThreads();
+
+	// aerospike Module
+	PyObject * aerospike;
+
+	MOD_DEF(aerospike, "aerospike", "Aerospike Python Client", Aerospike_Methods)
+
+	if (aerospike_exec(aerospike) == -1) {
+#if PY_MAJOR_VERSION >= 3
+		// Python 2 only lends the module
+		Py_XDECREF(aerospike);
+#endif
+		return MOD_ERROR_VAL;
+	}
 
 	return MOD_SUCCESS_VAL(aerospike);
 }
+
+#endif
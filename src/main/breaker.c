@@ -0,0 +1,333 @@
+/*******************************************************************************
+ * Copyright 2013-2016 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include <Python.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <aerospike/aerospike_info.h>
+#include <aerospike/as_cluster.h>
+#include <aerospike/as_error.h>
+#include <citrusleaf/cf_clock.h>
+
+#include "breaker.h"
+#include "macros.h"
+
+typedef struct {
+	circuit_breaker * breaker;
+	breaker_node * state;
+	aerospike * as;
+	as_node * node;
+} breaker_probe;
+
+static bool breaker_config_uint(PyObject * py_config, const char * name, uint32_t * value)
+{
+	PyObject * py_value = PyDict_GetItemString(py_config, name);
+	if (!py_value) {
+		return true;
+	}
+	if (!PyInt_Check(py_value) && !PyLong_Check(py_value)) {
+		return false;
+	}
+	long long v = PyLong_AsLongLong(py_value);
+	if (v < 0 || v > UINT32_MAX || PyErr_Occurred()) {
+		PyErr_Clear();
+		return false;
+	}
+	*value = (uint32_t) v;
+	return true;
+}
+
+circuit_breaker * circuit_breaker_new(PyObject * py_breaker_config)
+{
+	uint32_t max_timeouts = CIRCUIT_BREAKER_DEFAULT_MAX_TIMEOUTS;
+	double error_rate = CIRCUIT_BREAKER_DEFAULT_ERROR_RATE;
+	uint32_t window = CIRCUIT_BREAKER_DEFAULT_WINDOW;
+	uint32_t open_ms = CIRCUIT_BREAKER_DEFAULT_OPEN_MS;
+
+	if (!PyDict_Check(py_breaker_config) ||
+			!breaker_config_uint(py_breaker_config, "max_timeouts", &max_timeouts) ||
+			!breaker_config_uint(py_breaker_config, "window", &window) ||
+			!breaker_config_uint(py_breaker_config, "open_ms", &open_ms) ||
+			window == 0) {
+		return NULL;
+	}
+
+	PyObject * py_error_rate = PyDict_GetItemString(py_breaker_config, "error_rate");
+	if (py_error_rate) {
+		if (!PyFloat_Check(py_error_rate) && !PyInt_Check(py_error_rate) && !PyLong_Check(py_error_rate)) {
+			return NULL;
+		}
+		error_rate = PyFloat_AsDouble(py_error_rate);
+		if (error_rate < 0 || error_rate > 1) {
+			return NULL;
+		}
+	}
+
+	circuit_breaker * breaker = (circuit_breaker *) calloc(1, sizeof(circuit_breaker));
+	pthread_mutex_init(&breaker->lock, NULL);
+	pthread_cond_init(&breaker->probes_done, NULL);
+	breaker->max_timeouts = max_timeouts;
+	breaker->error_rate = error_rate;
+	breaker->window = window;
+	breaker->open_ms = open_ms;
+	return breaker;
+}
+
+void circuit_breaker_destroy(circuit_breaker * breaker)
+{
+	if (!breaker) {
+		return;
+	}
+
+	breaker_node * state = breaker->nodes;
+	while (state) {
+		breaker_node * next = state->next;
+		free(state);
+		state = next;
+	}
+	pthread_cond_destroy(&breaker->probes_done);
+	pthread_mutex_destroy(&breaker->lock);
+	free(breaker);
+}
+
+/*******************************************************************************
+ * BREAKERS
+ ******************************************************************************/
+
+/**
+ * Returns the breaker of the node, adding a closed one the first time.
+ * Called with the lock held.
+ */
+static breaker_node * breaker_node_get(circuit_breaker * breaker, const char * name)
+{
+	breaker_node * state = breaker->nodes;
+	while (state && strcmp(state->name, name)) {
+		state = state->next;
+	}
+	if (!state) {
+		state = (breaker_node *) calloc(1, sizeof(breaker_node));
+		strcpy(state->name, name);
+		state->next = breaker->nodes;
+		breaker->nodes = state;
+	}
+	return state;
+}
+
+static void breaker_close(breaker_node * state)
+{
+	state->state = BREAKER_CLOSED;
+	state->consecutive_timeouts = 0;
+	state->requests = 0;
+	state->errors = 0;
+}
+
+static void * breaker_probe_run(void * udata)
+{
+	breaker_probe * probe = (breaker_probe *) udata;
+	circuit_breaker * breaker = probe->breaker;
+	char * res = NULL;
+	as_error err;
+	as_error_init(&err);
+
+	aerospike_info_node(probe->as, &err, NULL, probe->node, "node", &res);
+	if (res) {
+		free(res);
+	}
+	as_node_release(probe->node);
+
+	pthread_mutex_lock(&breaker->lock);
+	if (err.code == AEROSPIKE_OK) {
+		breaker_close(probe->state);
+	} else {
+		// Still failing, wait another open_ms before the next probe
+		probe->state->state = BREAKER_OPEN;
+		probe->state->opened_ms = cf_getms();
+	}
+	if (--breaker->probes_running == 0) {
+		pthread_cond_broadcast(&breaker->probes_done);
+	}
+	pthread_mutex_unlock(&breaker->lock);
+
+	free(probe);
+	return NULL;
+}
+
+/**
+ * Starts probing the node in the background. Called with the lock held.
+ */
+static void breaker_probe_start(circuit_breaker * breaker, breaker_node * state,
+		aerospike * as, as_node * node)
+{
+	breaker_probe * probe = (breaker_probe *) malloc(sizeof(breaker_probe));
+	probe->breaker = breaker;
+	probe->state = state;
+	probe->as = as;
+	probe->node = node;
+	as_node_reserve(node);
+
+	pthread_t thread;
+	pthread_attr_t attr;
+	pthread_attr_init(&attr);
+	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+	if (pthread_create(&thread, &attr, breaker_probe_run, probe) == 0) {
+		state->state = BREAKER_PROBING;
+		breaker->probes_running++;
+	} else {
+		// Try again on the next command
+		as_node_release(node);
+		free(probe);
+	}
+	pthread_attr_destroy(&attr);
+}
+
+as_status circuit_breaker_check(circuit_breaker * breaker, aerospike * as, as_error * err,
+		const as_key * key, as_node ** node)
+{
+	*node = NULL;
+
+	if (!breaker) {
+		return AEROSPIKE_OK;
+	}
+
+	// The digest is computed here once and reused by the command
+	if (!as_key_digest(err, (as_key *) key)) {
+		as_error_reset(err);
+		return AEROSPIKE_OK;
+	}
+
+	as_node * master = as_node_get(as->cluster, key->ns, key->digest.value, true, AS_POLICY_REPLICA_MASTER);
+	if (!master) {
+		return AEROSPIKE_OK;
+	}
+
+	pthread_mutex_lock(&breaker->lock);
+	breaker_node * state = breaker_node_get(breaker, master->name);
+
+	if (state->state == BREAKER_OPEN && cf_getms() - state->opened_ms >= breaker->open_ms) {
+		breaker_probe_start(breaker, state, as, master);
+	}
+	if (state->state != BREAKER_CLOSED) {
+		state->rejected++;
+		as_error_update(err, AEROSPIKE_ERR_INVALID_NODE, "Circuit breaker open for node %s", state->name);
+	}
+	pthread_mutex_unlock(&breaker->lock);
+
+	if (err->code != AEROSPIKE_OK) {
+		as_node_release(master);
+		return err->code;
+	}
+	*node = master;
+	return AEROSPIKE_OK;
+}
+
+static bool breaker_node_error(as_status status)
+{
+	switch (status) {
+		case AEROSPIKE_ERR_TIMEOUT:
+		case AEROSPIKE_ERR_CONNECTION:
+		case AEROSPIKE_ERR_INVALID_NODE:
+		case AEROSPIKE_ERR_NO_MORE_CONNECTIONS:
+		case AEROSPIKE_ERR_SERVER:
+		case AEROSPIKE_ERR_DEVICE_OVERLOAD:
+			return true;
+		default:
+			return false;
+	}
+}
+
+void circuit_breaker_record(circuit_breaker * breaker, as_node * node, as_status status)
+{
+	if (!breaker || !node) {
+		return;
+	}
+
+	pthread_mutex_lock(&breaker->lock);
+	breaker_node * state = breaker_node_get(breaker, node->name);
+
+	// Commands sent before the breaker opened do not count
+	if (state->state == BREAKER_CLOSED) {
+		state->consecutive_timeouts = status == AEROSPIKE_ERR_TIMEOUT ? state->consecutive_timeouts + 1 : 0;
+		state->requests++;
+		if (breaker_node_error(status)) {
+			state->errors++;
+		}
+
+		bool trip = (breaker->max_timeouts && state->consecutive_timeouts >= breaker->max_timeouts) ||
+				(breaker->error_rate > 0 && state->requests >= breaker->window &&
+					state->errors >= breaker->error_rate * state->requests);
+
+		if (trip) {
+			breaker_close(state);
+			state->state = BREAKER_OPEN;
+			state->opened_ms = cf_getms();
+			state->trips++;
+		} else if (state->requests >= 2 * breaker->window) {
+			// Older commands weigh less and less
+			state->requests /= 2;
+			state->errors /= 2;
+		}
+	}
+	pthread_mutex_unlock(&breaker->lock);
+
+	as_node_release(node);
+}
+
+void circuit_breaker_wait_idle(circuit_breaker * breaker)
+{
+	if (!breaker) {
+		return;
+	}
+	pthread_mutex_lock(&breaker->lock);
+	while (breaker->probes_running) {
+		pthread_cond_wait(&breaker->probes_done, &breaker->lock);
+	}
+	pthread_mutex_unlock(&breaker->lock);
+}
+
+/*******************************************************************************
+ * STATS
+ ******************************************************************************/
+
+static void breaker_stats_set(PyObject * py_stats, const char * name, PyObject * py_value)
+{
+	PyDict_SetItemString(py_stats, name, py_value);
+	Py_DECREF(py_value);
+}
+
+PyObject * circuit_breaker_stats(circuit_breaker * breaker)
+{
+	static const char * state_names[] = {"closed", "open", "probing"};
+	PyObject * py_stats = PyDict_New();
+
+	pthread_mutex_lock(&breaker->lock);
+	for (breaker_node * state = breaker->nodes; state; state = state->next) {
+		PyObject * py_node = PyDict_New();
+		breaker_stats_set(py_node, "state", PyString_FromString(state_names[state->state]));
+		breaker_stats_set(py_node, "consecutive_timeouts", PyLong_FromUnsignedLong(state->consecutive_timeouts));
+		breaker_stats_set(py_node, "requests", PyLong_FromUnsignedLong(state->requests));
+		breaker_stats_set(py_node, "errors", PyLong_FromUnsignedLong(state->errors));
+		breaker_stats_set(py_node, "trips", PyLong_FromUnsignedLongLong(state->trips));
+		breaker_stats_set(py_node, "rejected", PyLong_FromUnsignedLongLong(state->rejected));
+		breaker_stats_set(py_stats, state->name, py_node);
+	}
+	pthread_mutex_unlock(&breaker->lock);
+
+	return py_stats;
+}
@@ -0,0 +1,481 @@
+/*******************************************************************************
+ * Copyright 2013-2016 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include <Python.h>
+#include <stdbool.h>
+
+#include <aerospike/aerospike_key.h>
+#include <aerospike/as_bytes.h>
+#include <aerospike/as_error.h>
+#include <aerospike/as_geojson.h>
+#include <aerospike/as_key.h>
+#include <aerospike/as_list.h>
+#include <aerospike/as_map.h>
+#include <aerospike/as_record.h>
+#include <aerospike/as_record_iterator.h>
+#include <aerospike/as_string.h>
+#include <citrusleaf/cf_clock.h>
+
+#include "cache.h"
+#include "conversions.h"
+#include "macros.h"
+
+#define RECORD_CACHE_MAX_BUCKETS (1 << 20)
+// Rough per-entry and per-value overheads of the cached records
+#define RECORD_CACHE_ENTRY_OVERHEAD 256
+#define RECORD_CACHE_VALUE_OVERHEAD 32
+
+// TTL the server reports for records that never expire
+#define RECORD_TTL_NEVER_EXPIRE ((uint32_t) -1)
+
+static bool cache_config_uint(PyObject * py_config, const char * name, uint64_t * value)
+{
+	PyObject * py_value = PyDict_GetItemString(py_config, name);
+	if (!py_value) {
+		return true;
+	}
+	if (!PyInt_Check(py_value) && !PyLong_Check(py_value)) {
+		return false;
+	}
+	long long v = PyLong_AsLongLong(py_value);
+	if (v < 0 || PyErr_Occurred()) {
+		PyErr_Clear();
+		return false;
+	}
+	*value = (uint64_t) v;
+	return true;
+}
+
+record_cache * record_cache_new(PyObject * py_cache_config)
+{
+	uint64_t max_records = RECORD_CACHE_DEFAULT_MAX_RECORDS;
+	uint64_t max_bytes = RECORD_CACHE_DEFAULT_MAX_BYTES;
+	uint64_t max_staleness = RECORD_CACHE_DEFAULT_MAX_STALENESS;
+	bool validate_generation = false;
+
+	if (!PyDict_Check(py_cache_config) ||
+			!cache_config_uint(py_cache_config, "max_records", &max_records) ||
+			!cache_config_uint(py_cache_config, "max_bytes", &max_bytes) ||
+			!cache_config_uint(py_cache_config, "max_staleness", &max_staleness) ||
+			max_records == 0 || max_records > UINT32_MAX || max_staleness > UINT32_MAX) {
+		return NULL;
+	}
+
+	PyObject * py_validate = PyDict_GetItemString(py_cache_config, "validate");
+	if (py_validate && py_validate != Py_None) {
+		if (!PyString_Check(py_validate) || strcmp(PyString_AsString(py_validate), "generation")) {
+			return NULL;
+		}
+		validate_generation = true;
+	}
+
+	record_cache * cache = (record_cache *) calloc(1, sizeof(record_cache));
+	cache->n_buckets = 1;
+	while (cache->n_buckets < max_records && cache->n_buckets < RECORD_CACHE_MAX_BUCKETS) {
+		cache->n_buckets <<= 1;
+	}
+	cache->buckets = (record_cache_entry **) calloc(cache->n_buckets, sizeof(record_cache_entry *));
+	cache->max_records = (uint32_t) max_records;
+	cache->max_bytes = max_bytes;
+	cache->max_staleness_ms = (uint32_t) max_staleness;
+	cache->validate_generation = validate_generation;
+	return cache;
+}
+
+void record_cache_destroy(record_cache * cache)
+{
+	if (!cache) {
+		return;
+	}
+	record_cache_clear(cache);
+	free(cache->buckets);
+	free(cache);
+}
+
+/*******************************************************************************
+ * ENTRIES
+ ******************************************************************************/
+
+static record_cache_entry ** cache_slot(record_cache * cache, const char * ns, const uint8_t * digest)
+{
+	// Digests are uniformly distributed, so any 4 bytes make a good hash
+	uint32_t hash;
+	memcpy(&hash, digest, sizeof(hash));
+
+	record_cache_entry ** slot = &cache->buckets[hash & (cache->n_buckets - 1)];
+	while (*slot && (memcmp((*slot)->digest, digest, AS_DIGEST_VALUE_SIZE) || strcmp((*slot)->ns, ns))) {
+		slot = &(*slot)->hash_next;
+	}
+	return slot;
+}
+
+static void cache_lru_unlink(record_cache * cache, record_cache_entry * entry)
+{
+	if (entry->lru_prev) {
+		entry->lru_prev->lru_next = entry->lru_next;
+	} else {
+		cache->lru_head = entry->lru_next;
+	}
+	if (entry->lru_next) {
+		entry->lru_next->lru_prev = entry->lru_prev;
+	} else {
+		cache->lru_tail = entry->lru_prev;
+	}
+	entry->lru_prev = NULL;
+	entry->lru_next = NULL;
+}
+
+static void cache_lru_push(record_cache * cache, record_cache_entry * entry)
+{
+	entry->lru_next = cache->lru_head;
+	if (cache->lru_head) {
+		cache->lru_head->lru_prev = entry;
+	}
+	cache->lru_head = entry;
+	if (!cache->lru_tail) {
+		cache->lru_tail = entry;
+	}
+}
+
+static void cache_remove_slot(record_cache * cache, record_cache_entry ** slot)
+{
+	record_cache_entry * entry = *slot;
+
+	*slot = entry->hash_next;
+	cache_lru_unlink(cache, entry);
+	cache->n_records--;
+	cache->bytes -= entry->size;
+
+	as_record_destroy(entry->rec);
+	free(entry);
+}
+
+static bool cache_key_digest(as_key * key)
+{
+	as_error err;
+	as_error_init(&err);
+	return as_key_digest(&err, key) != NULL;
+}
+
+/**
+ * Approximates the memory used by the converted value.
+ */
+static size_t cache_val_size(const as_val * val);
+
+static bool cache_list_size_each(as_val * val, void * udata)
+{
+	*(size_t *) udata += cache_val_size(val);
+	return true;
+}
+
+static bool cache_map_size_each(const as_val * key, const as_val * val, void * udata)
+{
+	*(size_t *) udata += cache_val_size(key) + cache_val_size(val);
+	return true;
+}
+
+static size_t cache_val_size(const as_val * val)
+{
+	size_t size = RECORD_CACHE_VALUE_OVERHEAD;
+
+	if (!val) {
+		return size;
+	}
+	switch (as_val_type(val)) {
+		case AS_STRING:
+			size += as_string_len(as_string_fromval(val));
+			break;
+		case AS_BYTES:
+			size += as_bytes_size(as_bytes_fromval(val));
+			break;
+		case AS_LIST:
+			as_list_foreach(as_list_fromval((as_val *) val), cache_list_size_each, &size);
+			break;
+		case AS_MAP:
+			as_map_foreach(as_map_fromval(val), cache_map_size_each, &size);
+			break;
+		default:
+			break;
+	}
+	return size;
+}
+
+static size_t cache_record_size(const as_record * rec)
+{
+	size_t size = RECORD_CACHE_ENTRY_OVERHEAD;
+	as_record_iterator it;
+
+	as_record_iterator_init(&it, rec);
+	while (as_record_iterator_has_next(&it)) {
+		as_bin * bin = as_record_iterator_next(&it);
+		size += strlen(as_bin_get_name(bin)) + cache_val_size((as_val *) as_bin_get_value(bin));
+	}
+	as_record_iterator_destroy(&it);
+	return size;
+}
+
+/*******************************************************************************
+ * OPERATIONS
+ ******************************************************************************/
+
+/**
+ * Copies the bins of a record, so the cache owns every value it keeps.
+ * Lists and maps are never changed once read, so they are shared.
+ */
+static as_record * cache_record_copy(const as_record * rec)
+{
+	as_record * copy = as_record_new(rec->bins.size);
+	as_record_iterator it;
+
+	as_record_iterator_init(&it, rec);
+	while (as_record_iterator_has_next(&it)) {
+		as_bin * bin = as_record_iterator_next(&it);
+		const char * name = as_bin_get_name(bin);
+		as_val * val = (as_val *) as_bin_get_value(bin);
+
+		switch (as_val_type(val)) {
+			case AS_INTEGER:
+				as_record_set_int64(copy, name, as_integer_get(as_integer_fromval(val)));
+				break;
+			case AS_DOUBLE:
+				as_record_set_double(copy, name, as_double_get(as_double_fromval(val)));
+				break;
+			case AS_STRING:
+				as_record_set_strp(copy, name, strdup(as_string_get(as_string_fromval(val))), true);
+				break;
+			case AS_GEOJSON:
+				as_record_set_geojson_strp(copy, name, strdup(as_geojson_get(as_geojson_fromval(val))), true);
+				break;
+			case AS_BYTES: {
+				as_bytes * bytes = as_bytes_fromval(val);
+				uint32_t size = as_bytes_size(bytes);
+				uint8_t * value = (uint8_t *) malloc(size ? size : 1);
+				memcpy(value, as_bytes_get(bytes), size);
+				as_record_set_raw_typep(copy, name, value, size, as_bytes_get_type(bytes), true);
+				break;
+			}
+			case AS_LIST:
+				as_val_reserve(val);
+				as_record_set_list(copy, name, as_list_fromval(val));
+				break;
+			case AS_MAP:
+				as_val_reserve(val);
+				as_record_set_map(copy, name, as_map_fromval(val));
+				break;
+			default:
+				as_record_set_nil(copy, name);
+				break;
+		}
+	}
+	as_record_iterator_destroy(&it);
+	return copy;
+}
+
+/**
+ * Converts the cached record again, so callers never share the lists,
+ * dicts and bytearrays they are given.
+ */
+static PyObject * cache_entry_to_pyobject(AerospikeClient * self, record_cache_entry * entry, as_key * key,
+		uint64_t now)
+{
+	as_error err;
+	as_error_init(&err);
+
+	// Report the TTL left, as a fresh read would
+	uint32_t ttl = entry->ttl;
+	if (ttl && ttl != RECORD_TTL_NEVER_EXPIRE) {
+		uint64_t elapsed = (now - entry->fetched_ms) / 1000;
+		ttl = elapsed < ttl ? ttl - (uint32_t) elapsed : 1;
+	}
+	entry->rec->ttl = ttl;
+	entry->rec->gen = (uint16_t) entry->gen;
+
+	PyObject * py_rec = NULL;
+	if (record_to_pyobject(self, &err, entry->rec, key, &py_rec) != AEROSPIKE_OK) {
+		// Read from the server instead
+		PyErr_Clear();
+		Py_XDECREF(py_rec);
+		return NULL;
+	}
+	return py_rec;
+}
+
+static uint64_t cache_expire_ms(record_cache * cache, uint32_t ttl, uint64_t now)
+{
+	uint64_t expire = 0;
+
+	if (ttl && ttl != RECORD_TTL_NEVER_EXPIRE) {
+		expire = now + (uint64_t) ttl * 1000;
+	}
+	if (cache->max_staleness_ms && (!expire || now + cache->max_staleness_ms < expire)) {
+		expire = now + cache->max_staleness_ms;
+	}
+	return expire;
+}
+
+PyObject * record_cache_get(AerospikeClient * self, as_key * key, as_policy_read * policy)
+{
+	record_cache * cache = self->cache;
+
+	if (!cache || !cache_key_digest(key)) {
+		return NULL;
+	}
+
+	record_cache_entry ** slot = cache_slot(cache, key->ns, key->digest.value);
+	if (!*slot) {
+		return NULL;
+	}
+
+	uint64_t now = cf_getms();
+	if ((*slot)->expire_ms && (*slot)->expire_ms <= now) {
+		cache_remove_slot(cache, slot);
+		return NULL;
+	}
+
+	if (cache->validate_generation) {
+		uint32_t gen = (*slot)->gen;
+		as_error err;
+		as_record * rec = NULL;
+		as_error_init(&err);
+
+		// A header only read, no bins are sent back
+		Py_BEGIN_ALLOW_THREADS
+		aerospike_key_exists(self->as, &err, policy, key, &rec);
+		Py_END_ALLOW_THREADS
+
+		// Other threads may have changed the cache without the GIL
+		slot = cache_slot(cache, key->ns, key->digest.value);
+		bool valid = err.code == AEROSPIKE_OK && rec && rec->gen == gen && *slot && (*slot)->gen == gen;
+
+		if (valid) {
+			now = cf_getms();
+			(*slot)->ttl = rec->ttl;
+			(*slot)->fetched_ms = now;
+			(*slot)->expire_ms = cache_expire_ms(cache, rec->ttl, now);
+		}
+		if (rec) {
+			as_record_destroy(rec);
+		}
+		if (!valid) {
+			if (*slot) {
+				cache_remove_slot(cache, slot);
+			}
+			return NULL;
+		}
+	}
+
+	record_cache_entry * entry = *slot;
+	cache_lru_unlink(cache, entry);
+	cache_lru_push(cache, entry);
+	return cache_entry_to_pyobject(self, entry, key, now);
+}
+
+static uint64_t * cache_epoch(record_cache * cache, as_key * key)
+{
+	return &cache->epochs[key->digest.value[0] % RECORD_CACHE_EPOCH_STRIPES];
+}
+
+uint64_t record_cache_epoch(record_cache * cache, as_key * key)
+{
+	if (!cache || !cache_key_digest(key)) {
+		return 0;
+	}
+	return *cache_epoch(cache, key);
+}
+
+void record_cache_put(record_cache * cache, as_key * key, const as_record * rec, uint64_t epoch)
+{
+	if (!cache || !cache_key_digest(key)) {
+		return;
+	}
+	if (*cache_epoch(cache, key) != epoch) {
+		return;
+	}
+
+	record_cache_entry ** slot = cache_slot(cache, key->ns, key->digest.value);
+	if (*slot) {
+		cache_remove_slot(cache, slot);
+	}
+
+	size_t size = cache_record_size(rec);
+	if (cache->max_bytes && size > cache->max_bytes) {
+		return;
+	}
+
+	record_cache_entry * entry = (record_cache_entry *) calloc(1, sizeof(record_cache_entry));
+	if (!entry) {
+		return;
+	}
+	uint64_t now = cf_getms();
+	strcpy(entry->ns, key->ns);
+	memcpy(entry->digest, key->digest.value, AS_DIGEST_VALUE_SIZE);
+	entry->rec = cache_record_copy(rec);
+	entry->gen = rec->gen;
+	entry->ttl = rec->ttl;
+	entry->fetched_ms = now;
+	entry->expire_ms = cache_expire_ms(cache, rec->ttl, now);
+	entry->size = size;
+
+	if (!entry->rec) {
+		free(entry);
+		return;
+	}
+
+	*slot = entry;
+	cache_lru_push(cache, entry);
+	cache->n_records++;
+	cache->bytes += size;
+
+	// Evict the least recently used records, never the one just added
+	while ((cache->n_records > cache->max_records ||
+			(cache->max_bytes && cache->bytes > cache->max_bytes)) && cache->lru_tail != entry) {
+		record_cache_entry * lru = cache->lru_tail;
+		cache_remove_slot(cache, cache_slot(cache, lru->ns, lru->digest));
+	}
+}
+
+void record_cache_invalidate(record_cache * cache, as_key * key)
+{
+	if (!cache || !cache_key_digest(key)) {
+		return;
+	}
+
+	// Even with nothing cached, a get() in flight may be about to add the key
+	(*cache_epoch(cache, key))++;
+	if (!cache->n_records) {
+		return;
+	}
+
+	record_cache_entry ** slot = cache_slot(cache, key->ns, key->digest.value);
+	if (*slot) {
+		cache_remove_slot(cache, slot);
+	}
+}
+
+void record_cache_clear(record_cache * cache)
+{
+	if (!cache) {
+		return;
+	}
+
+	for (int i = 0; i < RECORD_CACHE_EPOCH_STRIPES; i++) {
+		cache->epochs[i]++;
+	}
+	while (cache->lru_tail) {
+		record_cache_entry * lru = cache->lru_tail;
+		cache_remove_slot(cache, cache_slot(cache, lru->ns, lru->digest));
+	}
+}
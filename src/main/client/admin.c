@@ -29,6 +29,7 @@
 #include "exceptions.h"
 #include "policy.h"
 #include "global_hosts.h"
+#include "module_state.h"
 
 /**
  *******************************************************************************************************
@@ -218,9 +219,9 @@ PyObject * AerospikeClient_Admin_Drop_User( AerospikeClient *self, PyObject *arg
 	alias_to_search = return_search_string(self->as);
 	PyObject *py_persistent_item = NULL;
 
-	py_persistent_item = PyDict_GetItemString(py_global_hosts, alias_to_search); 
+	py_persistent_item = PyDict_GetItemString(self->state->global_hosts, alias_to_search); 
 	if (py_persistent_item) {
-		PyDict_DelItemString(py_global_hosts, alias_to_search);
+		PyDict_DelItemString(self->state->global_hosts, alias_to_search);
 		AerospikeGlobalHosts_Del(py_persistent_item);
 	}
 	PyMem_Free(alias_to_search);
@@ -419,9 +420,9 @@ PyObject * AerospikeClient_Admin_Change_Password( AerospikeClient *self, PyObjec
 	alias_to_search = return_search_string(self->as);
 	PyObject *py_persistent_item = NULL;
 
-	py_persistent_item = PyDict_GetItemString(py_global_hosts, alias_to_search); 
+	py_persistent_item = PyDict_GetItemString(self->state->global_hosts, alias_to_search); 
 	if (py_persistent_item) {
-		PyDict_DelItemString(py_global_hosts, alias_to_search);
+		PyDict_DelItemString(self->state->global_hosts, alias_to_search);
 		AerospikeGlobalHosts_Del(py_persistent_item);
 	}
 	PyMem_Free(alias_to_search);
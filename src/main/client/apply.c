@@ -22,10 +22,14 @@
 #include <aerospike/as_error.h>
 #include <aerospike/as_record.h>
 
+#include "breaker.h"
+#include "cache.h"
 #include "client.h"
 #include "conversions.h"
 #include "exceptions.h"
+#include "limiter.h"
 #include "policy.h"
+#include "tracer.h"
 
 /**
  *******************************************************************************************************
@@ -70,6 +74,9 @@ PyObject * AerospikeClient_Apply_Invoke(
 	// Initialize error
 	as_error_init(&err);
 
+	trace_span span;
+	trace_start(self, &span, "apply");
+
 	if (!PyList_Check(py_arglist)) {
 		PyErr_SetString(PyExc_TypeError, "expected UDF method arguments in a 'list'");
 		return NULL;
@@ -133,8 +140,18 @@ PyObject * AerospikeClient_Apply_Invoke(
 
 	// Invoke operation
 	Py_BEGIN_ALLOW_THREADS
-	aerospike_key_apply(self->as, &err, apply_policy_p, &key, module, function, arglist, &result);
+	trace_call_start(&span);
+	if (request_limiter_acquire(self->limiter, &err, LIMITER_UDF, &key, 1) == AEROSPIKE_OK) {
+		as_node * node = NULL;
+		if (circuit_breaker_check(self->breaker, self->as, &err, &key, &node) == AEROSPIKE_OK) {
+			aerospike_key_apply(self->as, &err, apply_policy_p, &key, module, function, arglist, &result);
+			circuit_breaker_record(self->breaker, node, err.code);
+		}
+		request_limiter_release(self->limiter);
+	}
+	trace_call_end(&span);
 	Py_END_ALLOW_THREADS
+	record_cache_invalidate(self->cache, &key);
 
 	if (err.code == AEROSPIKE_OK) {
 		val_to_pyobject(self, &err, result, &py_result);
@@ -143,6 +160,7 @@ PyObject * AerospikeClient_Apply_Invoke(
 	}
 
 CLEANUP:
+	trace_end(self, &span, key_initialised ? &key : NULL, err.code);
 
 	if (py_umodule) {
 		Py_DECREF(py_umodule);
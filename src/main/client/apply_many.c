@@ -0,0 +1,334 @@
+/*******************************************************************************
+ * Copyright 2013-2016 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include <Python.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <aerospike/aerospike_key.h>
+#include <aerospike/as_error.h>
+#include <aerospike/as_key.h>
+#include <aerospike/as_list.h>
+#include <aerospike/as_val.h>
+
+#include "breaker.h"
+#include "cache.h"
+#include "client.h"
+#include "conversions.h"
+#include "exceptions.h"
+#include "limiter.h"
+#include "policy.h"
+#include "serializer.h"
+#include "tracer.h"
+
+// UDF calls in flight at the same time unless the caller asks for fewer
+#define APPLY_MANY_MAX_CONCURRENCY 16
+
+typedef struct {
+	aerospike * as;
+	request_limiter * limiter;
+	circuit_breaker * breaker;
+	as_policy_apply * policy;
+	const char * module;
+	const char * function;
+	as_list * arglist;
+	as_key * keys;
+	as_val ** results;
+	as_error * errors;
+	uint32_t n_keys;
+	uint32_t next;
+	pthread_mutex_t lock;
+} apply_many_job;
+
+static void * apply_many_worker(void * udata)
+{
+	apply_many_job * job = (apply_many_job *) udata;
+
+	while (true) {
+		pthread_mutex_lock(&job->lock);
+		uint32_t i = job->next++;
+		pthread_mutex_unlock(&job->lock);
+
+		if (i >= job->n_keys) {
+			break;
+		}
+
+		if (request_limiter_acquire(job->limiter, &job->errors[i], LIMITER_UDF,
+				&job->keys[i], 1) != AEROSPIKE_OK) {
+			continue;
+		}
+		as_node * node = NULL;
+		if (circuit_breaker_check(job->breaker, job->as, &job->errors[i], &job->keys[i],
+				&node) == AEROSPIKE_OK) {
+			aerospike_key_apply(job->as, &job->errors[i], job->policy, &job->keys[i],
+					job->module, job->function, job->arglist, &job->results[i]);
+			circuit_breaker_record(job->breaker, node, job->errors[i].code);
+		}
+		request_limiter_release(job->limiter);
+	}
+	return NULL;
+}
+
+static void apply_many_run(apply_many_job * job, uint32_t concurrency)
+{
+	pthread_t threads[APPLY_MANY_MAX_CONCURRENCY - 1];
+	uint32_t n_threads = 0;
+
+	// The calling thread runs UDF calls too
+	while (n_threads + 1 < concurrency && n_threads + 1 < job->n_keys) {
+		if (pthread_create(&threads[n_threads], NULL, apply_many_worker, job) != 0) {
+			break;
+		}
+		n_threads++;
+	}
+	apply_many_worker(job);
+	for (uint32_t i = 0; i < n_threads; i++) {
+		pthread_join(threads[i], NULL);
+	}
+}
+
+/**
+ * Builds the exception of a failed UDF call, with the key, module and
+ * function set on the instance rather than on the shared class.
+ */
+static PyObject * apply_many_exception(as_error * err, PyObject * py_key,
+		PyObject * py_module, PyObject * py_function)
+{
+	PyObject * py_err = NULL;
+	error_to_pyobject(err, &py_err);
+	PyObject * exception_type = raise_exception(err);
+	PyObject * py_exception = PyObject_CallObject(exception_type, py_err);
+	Py_XDECREF(py_err);
+
+	if (!py_exception) {
+		return NULL;
+	}
+	if (PyObject_HasAttrString(exception_type, "key")) {
+		PyObject_SetAttrString(py_exception, "key", py_key);
+	}
+	if (PyObject_HasAttrString(exception_type, "bin")) {
+		PyObject_SetAttrString(py_exception, "bin", Py_None);
+	}
+	if (PyObject_HasAttrString(exception_type, "module")) {
+		PyObject_SetAttrString(py_exception, "module", py_module);
+	}
+	if (PyObject_HasAttrString(exception_type, "func")) {
+		PyObject_SetAttrString(py_exception, "func", py_function);
+	}
+	return py_exception;
+}
+
+/**
+ *******************************************************************************************************
+ * Applies a registered UDF module on many records, keeping up to concurrency
+ * calls in flight with the GIL released.
+ *
+ *		client.apply_many(keys, module, function, args, policy, concurrency=16, serializer)
+ *
+ * The arguments are converted once and shared by every call. Returns a list
+ * with the UDF result or the exception of each key in turn.
+ * In case of error,appropriate exceptions will be raised.
+ *******************************************************************************************************
+ */
+PyObject * AerospikeClient_Apply_Many(AerospikeClient * self, PyObject * args, PyObject * kwds)
+{
+	PyObject * py_keys = NULL;
+	PyObject * py_module = NULL;
+	PyObject * py_function = NULL;
+	PyObject * py_arglist = NULL;
+	PyObject * py_policy = NULL;
+	PyObject * py_umodule = NULL;
+	PyObject * py_ufunction = NULL;
+	PyObject * py_fast = NULL;
+	PyObject * py_results = NULL;
+	PyObject * py_serializer = NULL;
+	int concurrency = APPLY_MANY_MAX_CONCURRENCY;
+	uint32_t n_keys = 0;
+
+	static char * kwlist[] = {"keys", "module", "function", "args", "policy", "concurrency", "serializer", NULL};
+
+	if (PyArg_ParseTupleAndKeywords(args, kwds, "OOOO|OiO:apply_many", kwlist,
+				&py_keys, &py_module, &py_function, &py_arglist, &py_policy, &concurrency,
+				&py_serializer) == false) {
+		return NULL;
+	}
+
+	if (!PyList_Check(py_arglist)) {
+		PyErr_SetString(PyExc_TypeError, "expected UDF method arguments in a 'list'");
+		return NULL;
+	}
+
+	as_error err;
+	as_error_init(&err);
+	trace_span span;
+	trace_start(self, &span, "apply_many");
+	as_policy_apply apply_policy;
+	as_policy_apply * apply_policy_p = NULL;
+	as_list * arglist = NULL;
+	apply_many_job job;
+	memset(&job, 0, sizeof(job));
+
+	as_static_pool static_pool;
+	memset(&static_pool, 0, sizeof(static_pool));
+
+	if (!self || !self->as) {
+		as_error_update(&err, AEROSPIKE_ERR_PARAM, "Invalid aerospike object");
+		goto CLEANUP;
+	}
+	if (!self->is_conn_16) {
+		as_error_update(&err, AEROSPIKE_ERR_CLUSTER, "No connection to aerospike cluster");
+		goto CLEANUP;
+	}
+
+	if (concurrency < 1 || concurrency > APPLY_MANY_MAX_CONCURRENCY) {
+		as_error_update(&err, AEROSPIKE_ERR_PARAM, "concurrency should be between 1 and 16");
+		goto CLEANUP;
+	}
+
+	if (PyUnicode_Check(py_module)) {
+		py_umodule = PyUnicode_AsUTF8String(py_module);
+		job.module = PyBytes_AsString(py_umodule);
+	}
+	else if (PyString_Check(py_module)) {
+		job.module = PyString_AsString(py_module);
+	}
+	else {
+		as_error_update(&err, AEROSPIKE_ERR_CLIENT, "udf module argument must be a string or unicode string");
+		goto CLEANUP;
+	}
+
+	if (PyUnicode_Check(py_function)) {
+		py_ufunction = PyUnicode_AsUTF8String(py_function);
+		job.function = PyBytes_AsString(py_ufunction);
+	}
+	else if (PyString_Check(py_function)) {
+		job.function = PyString_AsString(py_function);
+	}
+	else {
+		as_error_update(&err, AEROSPIKE_ERR_CLIENT, "function name must be a string or unicode string");
+		goto CLEANUP;
+	}
+
+	pyobject_to_policy_apply(&err, py_policy, &apply_policy, &apply_policy_p,
+			&self->as->config.policies.apply);
+	if (err.code != AEROSPIKE_OK) {
+		goto CLEANUP;
+	}
+
+	long serializer_option = serializer_option_from_pyobject(self, py_serializer);
+	serializer_batch values;
+	serializer_batch_begin(self, &values);
+	pyobject_to_list(self, &err, py_arglist, &arglist, &static_pool, serializer_option);
+	if (serializer_batch_end(&values, &err) != AEROSPIKE_OK) {
+		goto CLEANUP;
+	}
+
+	py_fast = PySequence_Fast(py_keys, "keys should be a list");
+	if (!py_fast) {
+		PyErr_Clear();
+		as_error_update(&err, AEROSPIKE_ERR_PARAM, "keys should be a list of keys");
+		goto CLEANUP;
+	}
+
+	Py_ssize_t size = PySequence_Fast_GET_SIZE(py_fast);
+	job.as = self->as;
+	job.limiter = self->limiter;
+	job.breaker = self->breaker;
+	job.policy = apply_policy_p;
+	job.arglist = arglist;
+	job.keys = (as_key *) malloc(sizeof(as_key) * (size ? size : 1));
+	job.results = (as_val **) calloc(size ? size : 1, sizeof(as_val *));
+	job.errors = (as_error *) malloc(sizeof(as_error) * (size ? size : 1));
+	job.n_keys = (uint32_t) size;
+
+	// The keys may point into the Python keys, which py_fast keeps alive
+	for (n_keys = 0; n_keys < job.n_keys; n_keys++) {
+		if (pyobject_to_key(&err, PySequence_Fast_GET_ITEM(py_fast, n_keys),
+				&job.keys[n_keys]) != AEROSPIKE_OK) {
+			goto CLEANUP;
+		}
+		as_error_init(&job.errors[n_keys]);
+	}
+
+	pthread_mutex_init(&job.lock, NULL);
+	Py_BEGIN_ALLOW_THREADS
+	trace_call_start(&span);
+	apply_many_run(&job, (uint32_t) concurrency);
+	trace_call_end(&span);
+	Py_END_ALLOW_THREADS
+	pthread_mutex_destroy(&job.lock);
+
+	py_results = PyList_New(job.n_keys);
+	for (uint32_t i = 0; i < job.n_keys; i++) {
+		record_cache_invalidate(self->cache, &job.keys[i]);
+
+		PyObject * py_result = NULL;
+		if (job.errors[i].code == AEROSPIKE_OK && !job.results[i]) {
+			Py_INCREF(Py_None);
+			py_result = Py_None;
+		} else if (job.errors[i].code == AEROSPIKE_OK) {
+			val_to_pyobject(self, &err, job.results[i], &py_result);
+			if (err.code != AEROSPIKE_OK) {
+				Py_CLEAR(py_results);
+				goto CLEANUP;
+			}
+		} else {
+			py_result = apply_many_exception(&job.errors[i],
+					PySequence_Fast_GET_ITEM(py_fast, i), py_module, py_function);
+		}
+		if (!py_result) {
+			Py_CLEAR(py_results);
+			goto CLEANUP;
+		}
+		PyList_SET_ITEM(py_results, i, py_result);
+	}
+
+CLEANUP:
+	if (err.code == AEROSPIKE_OK && py_results) {
+		// The span carries the first failure of the keys
+		as_status status = AEROSPIKE_OK;
+		for (uint32_t i = 0; i < job.n_keys && status == AEROSPIKE_OK; i++) {
+			status = job.errors[i].code;
+		}
+		trace_end_batch(self, &span, job.n_keys ? &job.keys[0] : NULL, job.n_keys, status);
+	} else {
+		trace_end_batch(self, &span, n_keys ? &job.keys[0] : NULL, n_keys, err.code);
+	}
+	for (uint32_t i = 0; i < n_keys; i++) {
+		as_key_destroy(&job.keys[i]);
+		as_val_destroy(job.results[i]);
+	}
+	free(job.keys);
+	free(job.results);
+	free(job.errors);
+	as_list_destroy(arglist);
+	Py_XDECREF(py_umodule);
+	Py_XDECREF(py_ufunction);
+	Py_XDECREF(py_fast);
+
+	if (err.code != AEROSPIKE_OK) {
+		PyObject * py_err = NULL;
+		error_to_pyobject(&err, &py_err);
+		PyObject *exception_type = raise_exception(&err);
+		PyErr_SetObject(exception_type, py_err);
+		Py_DECREF(py_err);
+		return NULL;
+	}
+
+	return py_results;
+}
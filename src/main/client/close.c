@@ -15,14 +15,19 @@
  ******************************************************************************/
 
 #include <Python.h>
+#include <unistd.h>
 
 #include <aerospike/aerospike.h>
 #include <aerospike/as_error.h>
 
+#include "breaker.h"
 #include "client.h"
 #include "conversions.h"
+#include "counter_batcher.h"
 #include "exceptions.h"
 #include "global_hosts.h"
+#include "module_state.h"
+#include "hedge.h"
 
 #define MAX_PORT_SIZE 6
 #define MAX_SHM_SIZE 19
@@ -59,23 +64,42 @@ PyObject * AerospikeClient_Close(AerospikeClient * self, PyObject * args, PyObje
 		goto CLEANUP;
 	}
 
+	// The connection was inherited across fork() and never rebuilt with
+	// post_fork(). Its tend thread only exists in the parent, so just drop it.
+	if (self->connect_pid != getpid()) {
+		counter_batchers_close(self, true);
+		self->is_conn_16 = false;
+		goto CLEANUP;
+	}
+
+	// Pending counter updates are written before the connection goes away
+	counter_batchers_close(self, false);
+
+	// Hedged reads that lost and node probes may still be using the connection
+	Py_BEGIN_ALLOW_THREADS
+	hedge_wait_idle(self->hedge_pool);
+	circuit_breaker_wait_idle(self->breaker);
+	Py_END_ALLOW_THREADS
+
 	if (self->use_shared_connection) {
 		alias_to_search = return_search_string(self->as);
-		py_persistent_item = PyDict_GetItemString(py_global_hosts, alias_to_search);
+		py_persistent_item = PyDict_GetItemString(self->state->global_hosts, alias_to_search);
 
 		if (py_persistent_item) {
 			global_host = (AerospikeGlobalHosts*)py_persistent_item;
 			// It is only safe to do a reference counted close if the
 			// local as is pointing to the global as
 			if (self->as == global_host->as) {
-				close_aerospike_object(self->as, &err, alias_to_search, py_persistent_item, false);
+				close_aerospike_object(self, &err, alias_to_search, py_persistent_item, false);
 			}
 		}
 
 		PyMem_Free(alias_to_search);
 		alias_to_search = NULL;
 	} else {
+		Py_BEGIN_ALLOW_THREADS
 		aerospike_close(self->as, &err);
+		Py_END_ALLOW_THREADS
 	}
 	self->is_conn_16 = false;
 
@@ -141,12 +165,14 @@ char* return_search_string(aerospike *as)
 	return alias_to_search;
 }
 
-void close_aerospike_object(aerospike *as, as_error *err, char *alias_to_search, PyObject *py_persistent_item, bool do_destroy)
+void close_aerospike_object(AerospikeClient * self, as_error *err, char *alias_to_search, PyObject *py_persistent_item, bool do_destroy)
 {
 	if (((AerospikeGlobalHosts*)py_persistent_item)->ref_cnt == 1) {
-		PyDict_DelItemString(py_global_hosts, alias_to_search);
+		PyDict_DelItemString(self->state->global_hosts, alias_to_search);
 		AerospikeGlobalHosts_Del(py_persistent_item);
-		aerospike_close(as, err);
+		Py_BEGIN_ALLOW_THREADS
+		aerospike_close(self->as, err);
+		Py_END_ALLOW_THREADS
 	} else {
 		((AerospikeGlobalHosts*)py_persistent_item)->ref_cnt--;
 	}
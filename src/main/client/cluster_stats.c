@@ -0,0 +1,132 @@
+/*******************************************************************************
+ * Copyright 2013-2016 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include <Python.h>
+#include <pthread.h>
+#include <stdbool.h>
+
+#include <aerospike/aerospike.h>
+#include <aerospike/as_cluster.h>
+#include <aerospike/as_error.h>
+#include <aerospike/as_node.h>
+#include <aerospike/as_queue.h>
+#include <citrusleaf/cf_queue.h>
+
+#include "client.h"
+#include "conversions.h"
+#include "exceptions.h"
+#include "macros.h"
+
+static void cluster_stats_set(PyObject * py_stats, const char * name, PyObject * py_value)
+{
+	PyDict_SetItemString(py_stats, name, py_value);
+	Py_DECREF(py_value);
+}
+
+/**
+ * Reads the node's connection pools, taking each pool's lock only long
+ * enough to copy its counts.
+ */
+static PyObject * cluster_stats_node(as_cluster * cluster, as_node * node)
+{
+	uint32_t pooled = 0;
+	uint32_t total = 0;
+
+	for (uint32_t i = 0; i < cluster->conn_pools_per_node; i++) {
+		as_queue_lock * pool = &node->conn_qs[i];
+		pthread_mutex_lock(&pool->lock);
+		pooled += as_queue_size(&pool->queue);
+		total += pool->queue.total;
+		pthread_mutex_unlock(&pool->lock);
+	}
+
+	PyObject * py_node = PyDict_New();
+	as_address * address = as_node_get_address(node);
+	cluster_stats_set(py_node, "address", PyString_FromString(address ? address->name : ""));
+	cluster_stats_set(py_node, "active", PyBool_FromLong(node->active));
+	cluster_stats_set(py_node, "connections_in_use", PyLong_FromUnsignedLong(total > pooled ? total - pooled : 0));
+	cluster_stats_set(py_node, "connections_pooled", PyLong_FromUnsignedLong(pooled));
+	cluster_stats_set(py_node, "tend_failures", PyLong_FromUnsignedLong(node->failures));
+	cluster_stats_set(py_node, "partition_generation", PyLong_FromUnsignedLong(node->partition_generation));
+	return py_node;
+}
+
+/**
+ *******************************************************************************************************
+ * Returns the client side state of the cluster, read from the C client's
+ * memory without any request to the server.
+ *
+ *		client.cluster_stats()
+ *
+ * 'nodes' maps each node name to its address, connection counts, consecutive
+ * tend failures and partition map generation. 'thread_pool' gives the
+ * number of threads and commands queued for them.
+ * In case of error,appropriate exceptions will be raised.
+ *******************************************************************************************************
+ */
+PyObject * AerospikeClient_Cluster_Stats(AerospikeClient * self, PyObject * args, PyObject * kwds)
+{
+	static char * kwlist[] = {NULL};
+
+	if (PyArg_ParseTupleAndKeywords(args, kwds, ":cluster_stats", kwlist) == false) {
+		return NULL;
+	}
+
+	as_error err;
+	as_error_init(&err);
+	PyObject * py_stats = NULL;
+
+	if (!self || !self->as) {
+		as_error_update(&err, AEROSPIKE_ERR_PARAM, "Invalid aerospike object");
+		goto CLEANUP;
+	}
+	if (!self->is_conn_16) {
+		as_error_update(&err, AEROSPIKE_ERR_CLUSTER, "No connection to aerospike cluster");
+		goto CLEANUP;
+	}
+
+	as_cluster * cluster = self->as->cluster;
+	as_nodes * nodes = as_nodes_reserve(cluster);
+	PyObject * py_nodes = PyDict_New();
+	for (uint32_t i = 0; i < nodes->size; i++) {
+		cluster_stats_set(py_nodes, nodes->array[i]->name, cluster_stats_node(cluster, nodes->array[i]));
+	}
+	as_nodes_release(nodes);
+
+	PyObject * py_pool = PyDict_New();
+	as_thread_pool * thread_pool = &cluster->thread_pool;
+	pthread_mutex_lock(&thread_pool->lock);
+	cluster_stats_set(py_pool, "threads", PyLong_FromUnsignedLong(thread_pool->thread_size));
+	cluster_stats_set(py_pool, "queued", PyLong_FromLong(
+				thread_pool->dispatch_queue ? cf_queue_sz(thread_pool->dispatch_queue) : 0));
+	pthread_mutex_unlock(&thread_pool->lock);
+
+	py_stats = PyDict_New();
+	cluster_stats_set(py_stats, "nodes", py_nodes);
+	cluster_stats_set(py_stats, "thread_pool", py_pool);
+
+CLEANUP:
+	if (err.code != AEROSPIKE_OK) {
+		PyObject * py_err = NULL;
+		error_to_pyobject(&err, &py_err);
+		PyObject *exception_type = raise_exception(&err);
+		PyErr_SetObject(exception_type, py_err);
+		Py_DECREF(py_err);
+		return NULL;
+	}
+
+	return py_stats;
+}
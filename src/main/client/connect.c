@@ -15,16 +15,23 @@
  ******************************************************************************/
 
 #include <Python.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 
 #include <aerospike/aerospike.h>
 #include <aerospike/as_error.h>
 
 #include "client.h"
 #include "conversions.h"
+#include "counter_batcher.h"
 #include "global_hosts.h"
+#include "module_state.h"
 #include "exceptions.h"
 
 #define MAX_PORT_SIZE 6
+// First shm_key tried when the user did not configure one
+#define DEFAULT_SHM_KEY 0xA5000000
 /**
  *******************************************************************************************************
  * Establishes a connection to the Aerospike DB instance.
@@ -66,7 +73,7 @@ PyObject * AerospikeClient_Connect(AerospikeClient * self, PyObject * args, PyOb
 	alias_to_search = return_search_string(self->as);
 
 	if (self->use_shared_connection) {
-		PyObject * py_persistent_item = PyDict_GetItemString(py_global_hosts, alias_to_search);
+		PyObject * py_persistent_item = PyDict_GetItemString(self->state->global_hosts, alias_to_search);
 		if (py_persistent_item) {
 			aerospike *as = ((AerospikeGlobalHosts*)py_persistent_item)->as;
 			//Destroy the initial aerospike object as it has to point to the one in
@@ -100,15 +107,15 @@ PyObject * AerospikeClient_Connect(AerospikeClient * self, PyObject * args, PyOb
 	int flag = 0;
 	int shm_key;
 	if (self->as->config.use_shm) {
-		if (user_shm_key) {
+		if (self->user_shm_key) {
 			shm_key = self->as->config.shm_key;
-			user_shm_key = false;
+			self->user_shm_key = false;
 		} else {
-			shm_key = counter;
+			shm_key = DEFAULT_SHM_KEY;
 		}
 		while (1) {
 			flag = 0;
-			while (PyDict_Next(py_global_hosts, &pos, &py_key, &py_value)) {
+			while (PyDict_Next(self->state->global_hosts, &pos, &py_key, &py_value)) {
 				if (((AerospikeGlobalHosts*)py_value)->as->config.use_shm) {
 					if (((AerospikeGlobalHosts*)py_value)->shm_key == shm_key) {
 						flag = 1;
@@ -125,13 +132,15 @@ PyObject * AerospikeClient_Connect(AerospikeClient * self, PyObject * args, PyOb
 		self->as->config.shm_key = shm_key;
 	}
 
+	Py_BEGIN_ALLOW_THREADS
 	aerospike_connect(self->as, &err);
+	Py_END_ALLOW_THREADS
 	if (err.code != AEROSPIKE_OK) {
 		goto CLEANUP;
 	}
 	if (self->use_shared_connection) {
 		PyObject * py_newobject = (PyObject *)AerospikeGobalHosts_New(self->as);
-		PyDict_SetItemString(py_global_hosts, alias_to_search, py_newobject);
+		PyDict_SetItemString(self->state->global_hosts, alias_to_search, py_newobject);
 	}
 	PyMem_Free(alias_to_search);
 	alias_to_search = NULL;
@@ -148,10 +157,201 @@ CLEANUP:
 	}
 	self->is_conn_16 = true;
 	self->has_connected = true;
+	self->connect_pid = getpid();
 	Py_INCREF(self);
 	return (PyObject *) self;
 }
 
+/**
+ *******************************************************************************************************
+ * Builds a fresh aerospike object in a forked child from the configuration of
+ * the one inherited from the parent, and connects it.
+ *
+ * The inherited object is deliberately leaked: its tend thread does not exist
+ * in the child, so aerospike_close() would block joining it, and its pooled
+ * sockets are still in use by the parent. The new object keeps the parent's
+ * shm_key, so with shared memory tending the child attaches to the existing
+ * cluster map instead of re-running seed discovery.
+ *
+ * @param stale                 The aerospike object inherited from the parent.
+ * @param err                   The as_error to be populated on failure.
+ *
+ * Returns the connected aerospike object, or NULL on error.
+ *******************************************************************************************************
+ */
+static aerospike * rebuild_aerospike_object(aerospike * stale, as_error * err)
+{
+	as_config config;
+	memcpy(&config, &stale->config, sizeof(as_config));
+
+	// as_config_destroy() frees the hosts, ip_map, cluster_name and TLS
+	// strings, so the new object gets its own copies and destroying it on
+	// failure leaves the stale config intact for a retry. The lua paths and
+	// credentials are arrays and were copied above.
+	config.hosts = NULL;
+	config.ip_map = NULL;
+	config.ip_map_size = 0;
+	config.cluster_name = NULL;
+	config.tls.cafile = NULL;
+	config.tls.capath = NULL;
+	config.tls.protocols = NULL;
+	config.tls.cipher_suite = NULL;
+	config.tls.cert_blacklist = NULL;
+	config.tls.keyfile = NULL;
+	config.tls.certfile = NULL;
+
+	as_config_tls * stale_tls = &stale->config.tls;
+	if (stale_tls->cafile) {
+		as_config_tls_set_cafile(&config, stale_tls->cafile);
+	}
+	if (stale_tls->capath) {
+		as_config_tls_set_capath(&config, stale_tls->capath);
+	}
+	if (stale_tls->protocols) {
+		as_config_tls_set_protocols(&config, stale_tls->protocols);
+	}
+	if (stale_tls->cipher_suite) {
+		as_config_tls_set_cipher_suite(&config, stale_tls->cipher_suite);
+	}
+	if (stale_tls->cert_blacklist) {
+		as_config_tls_set_cert_blacklist(&config, stale_tls->cert_blacklist);
+	}
+	if (stale_tls->keyfile) {
+		as_config_tls_set_keyfile(&config, stale_tls->keyfile);
+	}
+	if (stale_tls->certfile) {
+		as_config_tls_set_certfile(&config, stale_tls->certfile);
+	}
+	if (stale->config.cluster_name) {
+		as_config_set_cluster_name(&config, stale->config.cluster_name);
+	}
+	if (stale->config.ip_map) {
+		config.ip_map_size = stale->config.ip_map_size;
+		config.ip_map = (as_addr_map *) calloc(config.ip_map_size, sizeof(as_addr_map));
+		for (uint32_t i = 0; i < config.ip_map_size; i++) {
+			config.ip_map[i].orig = strdup(stale->config.ip_map[i].orig);
+			config.ip_map[i].alt = strdup(stale->config.ip_map[i].alt);
+		}
+	}
+
+	for (uint32_t i = 0; i < stale->config.hosts->size; i++) {
+		as_host * host = (as_host *) as_vector_get(stale->config.hosts, i);
+		if (host->tls_name) {
+			as_config_tls_add_host(&config, host->name, host->tls_name, host->port);
+		} else {
+			as_config_add_host(&config, host->name, host->port);
+		}
+	}
+
+	aerospike * as = aerospike_new(&config);
+
+	Py_BEGIN_ALLOW_THREADS
+	aerospike_connect(as, err);
+	Py_END_ALLOW_THREADS
+
+	if (err->code != AEROSPIKE_OK) {
+		aerospike_destroy(as);
+		return NULL;
+	}
+	return as;
+}
+
+/**
+ *******************************************************************************************************
+ * Re-establishes the connection of a client inherited across fork().
+ *
+ * Pre-fork servers (gunicorn, uWSGI) should call this from their post-fork
+ * hook in every worker. It is a no-op when the client is not connected or
+ * was connected by the calling process. Shared connections are rebuilt once
+ * per process; later clients with the same alias reuse the rebuilt object.
+ *
+ * @param self                  AerospikeClient object
+ * @param args                  The args is a tuple object containing an argument
+ *                              list passed from Python to a C function
+ * @param kwds                  Dictionary of keywords
+ *
+ * Returns None.
+ * In case of error,appropriate exceptions will be raised.
+ *******************************************************************************************************
+ */
+PyObject * AerospikeClient_Post_Fork(AerospikeClient * self, PyObject * args, PyObject * kwds)
+{
+	as_error err;
+	as_error_init(&err);
+	char *alias_to_search = NULL;
+	aerospike * as = NULL;
+
+	static char * kwlist[] = {NULL};
+
+	if (PyArg_ParseTupleAndKeywords(args, kwds, ":post_fork", kwlist) == false) {
+		return NULL;
+	}
+
+	if (!self || !self->as) {
+		as_error_update(&err, AEROSPIKE_ERR_PARAM, "Invalid aerospike object");
+		goto CLEANUP;
+	}
+
+	if (!self->is_conn_16 || self->connect_pid == getpid()) {
+		goto CLEANUP;
+	}
+
+	// Their flush threads stayed in the parent, along with the old connection
+	counter_batchers_close(self, true);
+
+	if (self->use_shared_connection) {
+		alias_to_search = return_search_string(self->as);
+		AerospikeGlobalHosts * global_host =
+			(AerospikeGlobalHosts *) PyDict_GetItemString(self->state->global_hosts, alias_to_search);
+
+		if (global_host && global_host->pid == getpid()) {
+			// Another client in this process already rebuilt the shared object
+			self->as = global_host->as;
+			global_host->ref_cnt++;
+		} else {
+			as = rebuild_aerospike_object(self->as, &err);
+			if (err.code != AEROSPIKE_OK) {
+				goto CLEANUP;
+			}
+			if (global_host) {
+				// Clients still holding the inherited object no longer count
+				global_host->as = as;
+				global_host->shm_key = as->config.shm_key;
+				global_host->ref_cnt = 1;
+				global_host->pid = getpid();
+			} else {
+				PyObject * py_newobject = (PyObject *)AerospikeGobalHosts_New(as);
+				PyDict_SetItemString(self->state->global_hosts, alias_to_search, py_newobject);
+			}
+			self->as = as;
+		}
+	} else {
+		as = rebuild_aerospike_object(self->as, &err);
+		if (err.code != AEROSPIKE_OK) {
+			goto CLEANUP;
+		}
+		self->as = as;
+	}
+	self->connect_pid = getpid();
+
+CLEANUP:
+	if (alias_to_search) {
+		PyMem_Free(alias_to_search);
+	}
+
+	if (err.code != AEROSPIKE_OK) {
+		PyObject * py_err = NULL;
+		error_to_pyobject(&err, &py_err);
+		PyObject *exception_type = raise_exception(&err);
+		PyErr_SetObject(exception_type, py_err);
+		Py_DECREF(py_err);
+		return NULL;
+	}
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
 /**
  *******************************************************************************************************
  * Tests the connection to the Aerospike DB
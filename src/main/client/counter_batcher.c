@@ -0,0 +1,107 @@
+/*******************************************************************************
+ * Copyright 2013-2016 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include <Python.h>
+#include <stdbool.h>
+
+#include <aerospike/as_error.h>
+
+#include "client.h"
+#include "counter_batcher.h"
+#include "conversions.h"
+#include "exceptions.h"
+
+/**
+ *******************************************************************************************************
+ * Creates a CounterBatcher writing through this client.
+ *
+ * @param self                  AerospikeClient object
+ * @param args                  The args is a tuple object containing an argument
+ *                              list passed from Python to a C function
+ * @param kwds                  Dictionary of keywords
+ *
+ * Returns the new CounterBatcher on success.
+ * In case of error,appropriate exceptions will be raised.
+ *******************************************************************************************************
+ */
+AerospikeCounterBatcher * AerospikeClient_Counter_Batcher(AerospikeClient * self, PyObject * args, PyObject * kwds)
+{
+	as_error err;
+	as_error_init(&err);
+
+	if (!self || !self->as) {
+		as_error_update(&err, AEROSPIKE_ERR_PARAM, "Invalid aerospike object");
+	} else if (!self->is_conn_16) {
+		as_error_update(&err, AEROSPIKE_ERR_CLUSTER, "No connection to aerospike cluster");
+	}
+
+	if (err.code != AEROSPIKE_OK) {
+		PyObject * py_err = NULL;
+		error_to_pyobject(&err, &py_err);
+		PyObject *exception_type = raise_exception(&err);
+		PyErr_SetObject(exception_type, py_err);
+		Py_DECREF(py_err);
+		return NULL;
+	}
+
+	return AerospikeCounterBatcher_New(self, args, kwds);
+}
+
+void counter_batcher_attach(AerospikeClient * client, counter_batcher_state * state)
+{
+	state->next = client->batchers;
+	client->batchers = state;
+}
+
+void counter_batcher_detach(AerospikeClient * client, counter_batcher_state * state)
+{
+	counter_batcher_state ** link = &client->batchers;
+	while (*link && *link != state) {
+		link = &(*link)->next;
+	}
+	if (*link) {
+		*link = state->next;
+	}
+	state->next = NULL;
+}
+
+void counter_batchers_close(AerospikeClient * client, bool inherited)
+{
+	if (!client->batchers) {
+		return;
+	}
+
+	// Keeps the batchers, and so their states, alive without the GIL
+	PyObject * py_batchers = PyList_New(0);
+	for (counter_batcher_state * state = client->batchers; state; state = state->next) {
+		PyList_Append(py_batchers, state->py_batcher);
+	}
+	Py_ssize_t n_batchers = PyList_GET_SIZE(py_batchers);
+
+	Py_BEGIN_ALLOW_THREADS
+	for (Py_ssize_t i = 0; i < n_batchers; i++) {
+		counter_batcher_state * state = ((AerospikeCounterBatcher *) PyList_GET_ITEM(py_batchers, i))->state;
+		if (inherited) {
+			counter_batcher_abandon(state);
+		} else {
+			counter_batcher_stop(state);
+			counter_batcher_disconnect(state);
+		}
+	}
+	Py_END_ALLOW_THREADS
+
+	Py_DECREF(py_batchers);
+}
@@ -22,10 +22,14 @@
 #include <aerospike/as_error.h>
 #include <aerospike/as_record.h>
 
+#include "breaker.h"
 #include "client.h"
 #include "conversions.h"
 #include "exceptions.h"
+#include "hedge.h"
+#include "limiter.h"
 #include "policy.h"
+#include "tracer.h"
 
 /**
  *******************************************************************************************************
@@ -54,10 +58,16 @@ extern PyObject * AerospikeClient_Exists_Invoke(
 
 	// Initialisation flags
 	bool key_initialised = false;
+	uint32_t hedge_after_ms = 0;
+	bool hedged = false;
+	bool hedge_won = false;
 
 	// Initialize error
 	as_error_init(&err);
 
+	trace_span span;
+	trace_start(self, &span, "exists");
+
 	if (!self || !self->as) {
 		as_error_update(&err, AEROSPIKE_ERR_PARAM, "Invalid aerospike object");
 		goto CLEANUP;
@@ -82,11 +92,31 @@ extern PyObject * AerospikeClient_Exists_Invoke(
 	if (err.code != AEROSPIKE_OK) {
 		goto CLEANUP;
 	}
+	if (pyobject_to_policy_hedge(&err, py_policy, &hedge_after_ms) != AEROSPIKE_OK) {
+		goto CLEANUP;
+	}
 
 	// Invoke operation
 	Py_BEGIN_ALLOW_THREADS
-	aerospike_key_exists(self->as, &err, read_policy_p, &key, &rec);
+	trace_call_start(&span);
+	if (request_limiter_acquire(self->limiter, &err, LIMITER_READ, &key, 1) == AEROSPIKE_OK) {
+		as_node * node = NULL;
+		if (circuit_breaker_check(self->breaker, self->as, &err, &key, &node) == AEROSPIKE_OK) {
+			if (hedge_after_ms) {
+				hedge_read(self->hedge_pool, self->as, &err, read_policy_p, &key, NULL, HEDGE_EXISTS,
+						hedge_after_ms, &rec, &hedged, &hedge_won);
+			} else {
+				aerospike_key_exists(self->as, &err, read_policy_p, &key, &rec);
+			}
+			circuit_breaker_record(self->breaker, node, err.code);
+		}
+		request_limiter_release(self->limiter);
+	}
+	trace_call_end(&span);
 	Py_END_ALLOW_THREADS
+	if (hedge_after_ms) {
+		hedge_stats_update(self, hedged, hedge_won);
+	}
 
 	if (err.code == AEROSPIKE_OK) {
 		PyObject * py_result_key = NULL;
@@ -117,6 +147,7 @@ extern PyObject * AerospikeClient_Exists_Invoke(
 	}
 
 CLEANUP:
+	trace_end(self, &span, key_initialised ? &key : NULL, err.code);
 
 	if (key_initialised == true) {
 		// Destroy the key if it is initialised successfully.
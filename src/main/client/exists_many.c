@@ -27,7 +27,15 @@
 #include "client.h"
 #include "conversions.h"
 #include "exceptions.h"
+#include "limiter.h"
 #include "policy.h"
+#include "tracer.h"
+#include "module_state.h"
+
+typedef struct {
+	PyObject * py_recs;
+	AerospikeClient * client;
+} LocalData;
 
 /**
  *******************************************************************************************************
@@ -44,12 +52,13 @@
 static
 bool batch_exists_cb(const as_batch_read* results, uint32_t n, void* udata)
 {
-	// Typecast udata back to PyObject
-	PyObject * py_recs = (PyObject *) udata;
+	// Typecast udata back to LocalData
+	LocalData * data = (LocalData *) udata;
+	PyObject * py_recs = data->py_recs;
 
 	// Lock Python State
-	PyGILState_STATE gstate;
-	gstate = PyGILState_Ensure();
+	aerospike_gil gil;
+	aerospike_gil_ensure(data->client->state->interp, &gil);
 
 	// Loop over results array
 	for (uint32_t i =0; i < n; i++) {
@@ -100,7 +109,7 @@ bool batch_exists_cb(const as_batch_read* results, uint32_t n, void* udata)
 			PyTuple_SetItem(py_rec, 1, rec);
 			if (PyList_SetItem( py_recs, i, py_rec )) {
 				// Release Python State
-				PyGILState_Release(gstate);
+				aerospike_gil_release(&gil);
 				return false;
 			}
 		} else if (results[i].result == AEROSPIKE_ERR_RECORD_NOT_FOUND) {
@@ -110,13 +119,13 @@ bool batch_exists_cb(const as_batch_read* results, uint32_t n, void* udata)
 
 			if (PyList_SetItem( py_recs, i, py_rec)) {
 				// Release Python State
-				PyGILState_Release(gstate);
+				aerospike_gil_release(&gil);
 				return false;
 			}
 		}
 	}
 	// Release Python State
-	PyGILState_Release(gstate);
+	aerospike_gil_release(&gil);
 	return true;
 }
 
@@ -210,6 +219,10 @@ void batch_exists_recs(as_error *err, as_batch_read_records* records, PyObject *
 static PyObject * batch_exists_aerospike_batch_read(as_error *err, AerospikeClient * self, PyObject *py_keys, as_policy_batch * batch_policy_p)
 {
 	PyObject * py_recs = NULL;
+	as_key * first_key = NULL;
+
+	trace_span span;
+	trace_start(self, &span, "exists_many");
 
 	as_batch_read_records records;
 
@@ -277,9 +290,18 @@ static PyObject * batch_exists_aerospike_batch_read(as_error *err, AerospikeClie
 		goto CLEANUP;
 	}
 
+	first_key = records.list.size ?
+		&((as_batch_read_record *) as_vector_get(&records.list, 0))->key : NULL;
+
 	// Invoke C-client API
 	Py_BEGIN_ALLOW_THREADS
-	aerospike_batch_read(self->as, err, batch_policy_p, &records);
+	trace_call_start(&span);
+	if (request_limiter_acquire(self->limiter, err, LIMITER_BATCH, first_key,
+			records.list.size) == AEROSPIKE_OK) {
+		aerospike_batch_read(self->as, err, batch_policy_p, &records);
+		request_limiter_release(self->limiter);
+	}
+	trace_call_end(&span);
 	Py_END_ALLOW_THREADS
 	if (err->code != AEROSPIKE_OK) {
 		goto CLEANUP;
@@ -287,6 +309,7 @@ static PyObject * batch_exists_aerospike_batch_read(as_error *err, AerospikeClie
 	batch_exists_recs(err, &records, &py_recs);
 
 CLEANUP:
+	trace_end_batch(self, &span, first_key, first_key ? records.list.size : 0, err->code);
 	if (batch_initialised == true) {
 		// We should destroy batch object as we are using 'as_batch_init' for initialisation
 		// Also, pyobject_to_key is soing strdup() in case of Unicode. So, object destruction
@@ -312,6 +335,10 @@ CLEANUP:
 static PyObject * batch_exists_aerospike_batch_exists(as_error *err, AerospikeClient * self, PyObject *py_keys, as_policy_batch * batch_policy_p)
 {
 	PyObject * py_recs = NULL;
+	as_key * first_key = NULL;
+
+	trace_span span;
+	trace_start(self, &span, "exists_many");
 
 	as_batch batch;
 	bool batch_initialised = false;
@@ -371,16 +398,29 @@ static PyObject * batch_exists_aerospike_batch_exists(as_error *err, AerospikeCl
 		goto CLEANUP;
 	}
 
+	first_key = as_batch_keyat(&batch, 0);
+
+	LocalData data;
+	data.py_recs = py_recs;
+	data.client = self;
+
 	// Invoke C-client API
 	Py_BEGIN_ALLOW_THREADS
-	aerospike_batch_exists(self->as, err, batch_policy_p, &batch,
-			(aerospike_batch_read_callback) batch_exists_cb, py_recs);
+	trace_call_start(&span);
+	if (request_limiter_acquire(self->limiter, err, LIMITER_BATCH, first_key,
+			batch.keys.size) == AEROSPIKE_OK) {
+		aerospike_batch_exists(self->as, err, batch_policy_p, &batch,
+				(aerospike_batch_read_callback) batch_exists_cb, &data);
+		request_limiter_release(self->limiter);
+	}
+	trace_call_end(&span);
 	Py_END_ALLOW_THREADS
 	if (err->code != AEROSPIKE_OK) {
 		as_error_update(err, err->code, NULL);
 	}
 
 CLEANUP:
+	trace_end_batch(self, &span, first_key, first_key ? batch.keys.size : 0, err->code);
 	if (batch_initialised == true) {
 		// We should destroy batch object as we are using 'as_batch_init' for initialisation
 		// Also, pyobject_to_key is soing strdup() in case of Unicode. So, object destruction
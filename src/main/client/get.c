@@ -22,10 +22,15 @@
 #include <aerospike/as_error.h>
 #include <aerospike/as_record.h>
 
+#include "breaker.h"
+#include "cache.h"
 #include "client.h"
 #include "conversions.h"
 #include "exceptions.h"
+#include "hedge.h"
+#include "limiter.h"
 #include "policy.h"
+#include "tracer.h"
 
 /**
  *******************************************************************************************************
@@ -57,10 +62,17 @@ PyObject * AerospikeClient_Get_Invoke(
 	// Initialised flags
 	bool key_initialised = false;
 	bool record_initialised = false;
+	bool none_on_miss = false;
+	uint32_t hedge_after_ms = 0;
+	bool hedged = false;
+	bool hedge_won = false;
 
 	// Initialize error
 	as_error_init(&err);
 
+	trace_span span;
+	trace_start(self, &span, "get");
+
 	if (!self || !self->as) {
 		as_error_update(&err, AEROSPIKE_ERR_PARAM, "Invalid aerospike object");
 		goto CLEANUP;
@@ -85,18 +97,52 @@ PyObject * AerospikeClient_Get_Invoke(
 	if (err.code != AEROSPIKE_OK) {
 		goto CLEANUP;
 	}
+	if (pyobject_to_policy_not_found(&err, py_policy, &none_on_miss) != AEROSPIKE_OK) {
+		goto CLEANUP;
+	}
+	if (pyobject_to_policy_hedge(&err, py_policy, &hedge_after_ms) != AEROSPIKE_OK) {
+		goto CLEANUP;
+	}
 
-	// Initialize record
-	as_record_init(rec, 0);
-	// Record initialised successfully.
-	record_initialised = true;
-
-	// Invoke operation
-	Py_BEGIN_ALLOW_THREADS
-	aerospike_key_get(self->as, &err, read_policy_p, &key, &rec);
-	Py_END_ALLOW_THREADS
+	py_rec = record_cache_get(self, &key, read_policy_p);
+
+	if (!py_rec) {
+		// Initialize record
+		as_record_init(rec, 0);
+		// Record initialised successfully.
+		record_initialised = true;
+		// A write through this client while the GIL is released makes the read stale
+		uint64_t cache_epoch = record_cache_epoch(self->cache, &key);
+
+		// Invoke operation
+		Py_BEGIN_ALLOW_THREADS
+		trace_call_start(&span);
+		if (request_limiter_acquire(self->limiter, &err, LIMITER_READ, &key, 1) == AEROSPIKE_OK) {
+			as_node * node = NULL;
+			if (circuit_breaker_check(self->breaker, self->as, &err, &key, &node) == AEROSPIKE_OK) {
+				if (hedge_after_ms) {
+					hedge_read(self->hedge_pool, self->as, &err, read_policy_p, &key, NULL, HEDGE_GET,
+							hedge_after_ms, &rec, &hedged, &hedge_won);
+				} else {
+					aerospike_key_get(self->as, &err, read_policy_p, &key, &rec);
+				}
+				circuit_breaker_record(self->breaker, node, err.code);
+			}
+			request_limiter_release(self->limiter);
+		}
+		trace_call_end(&span);
+		Py_END_ALLOW_THREADS
+		if (hedge_after_ms) {
+			hedge_stats_update(self, hedged, hedge_won);
+		}
+		if (err.code == AEROSPIKE_OK) {
+			record_to_pyobject(self, &err, rec, &key, &py_rec);
+			if (err.code == AEROSPIKE_OK) {
+				record_cache_put(self->cache, &key, rec, cache_epoch);
+			}
+		}
+	}
 	if (err.code == AEROSPIKE_OK) {
-		record_to_pyobject(self, &err, rec, &key, &py_rec);
 		if (!read_policy_p ||
 				( read_policy_p && read_policy_p->key == AS_POLICY_KEY_DIGEST)) {
 			// This is a special case.
@@ -114,6 +160,7 @@ PyObject * AerospikeClient_Get_Invoke(
 	}
 
 CLEANUP:
+	trace_end(self, &span, key_initialised ? &key : NULL, err.code);
 
 	if (key_initialised == true) {
 		// Destroy key only if it is initialised.
@@ -124,6 +171,10 @@ CLEANUP:
 		as_record_destroy(rec);
 	}
 
+	if (err.code == AEROSPIKE_ERR_RECORD_NOT_FOUND && none_on_miss) {
+		Py_RETURN_NONE;
+	}
+
 	if (err.code != AEROSPIKE_OK) {
 		PyObject * py_err = NULL;
 		error_to_pyobject(&err, &py_err);
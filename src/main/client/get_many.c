@@ -27,7 +27,11 @@
 #include "client.h"
 #include "conversions.h"
 #include "exceptions.h"
+#include "limiter.h"
 #include "policy.h"
+#include "serializer.h"
+#include "tracer.h"
+#include "module_state.h"
 
 #define MAX_STACK_ALLOCATION 20000
 
@@ -58,8 +62,13 @@ static bool batch_get_cb(const as_batch_read* results, uint32_t n, void* udata)
 	as_error_init(&err);
 
 	// Lock Python State
-	PyGILState_STATE gstate;
-	gstate = PyGILState_Ensure();
+	aerospike_gil gil;
+	aerospike_gil_ensure(data->client->state->interp, &gil);
+
+	// Deserialize the blobs of every record at once
+	deserializer_batch blobs;
+	deserializer_batch_begin(data->client, &blobs);
+
 	/*// Typecast udata back to PyObject
 	PyObject * py_recs = (PyObject *) udata;
 
@@ -124,8 +133,9 @@ static bool batch_get_cb(const as_batch_read* results, uint32_t n, void* udata)
 
 			// Set return value in return Dict
 			if (PyList_SetItem(py_recs, i, py_rec)) {
+				deserializer_batch_end(&blobs, NULL, &err);
 				// Release Python State
-				PyGILState_Release(gstate);
+				aerospike_gil_release(&gil);
 				return false;
 			}
 			Py_DECREF(rec);
@@ -136,14 +146,16 @@ static bool batch_get_cb(const as_batch_read* results, uint32_t n, void* udata)
 			Py_INCREF(Py_None);
 			PyTuple_SetItem(py_rec, 2, Py_None);
 			if (PyList_SetItem(py_recs, i, py_rec)) {
+				deserializer_batch_end(&blobs, NULL, &err);
 				// Release Python State
-				PyGILState_Release(gstate);
+				aerospike_gil_release(&gil);
 				return false;
 			}
 		}
 	}
+	deserializer_batch_end(&blobs, py_recs, &err);
 	// Release Python State
-	PyGILState_Release(gstate);
+	aerospike_gil_release(&gil);
 	return true;
 }
 
@@ -159,6 +171,10 @@ static bool batch_get_cb(const as_batch_read* results, uint32_t n, void* udata)
 static void batch_get_recs(AerospikeClient *self, as_error *err, as_batch_read_records* records, PyObject **py_recs)
 {
 	as_vector* list = &records->list;
+	deserializer_batch blobs;
+
+	// Deserialize the blobs of every record at once
+	deserializer_batch_begin(self, &blobs);
 	for (uint32_t i = 0; i < list->size; i++) {
 		as_batch_read_record* batch = as_vector_get(list, i);
 
@@ -217,6 +233,7 @@ static void batch_get_recs(AerospikeClient *self, as_error *err, as_batch_read_r
 			PyList_SetItem( *py_recs, i, py_rec);
 		}
 	}
+	deserializer_batch_end(&blobs, *py_recs, err);
 }
 /**
  *******************************************************************************************************
@@ -233,6 +250,10 @@ static void batch_get_recs(AerospikeClient *self, as_error *err, as_batch_read_r
 static PyObject * batch_get_aerospike_batch_read(as_error *err, AerospikeClient * self, PyObject *py_keys, as_policy_batch * batch_policy_p)
 {
 	PyObject * py_recs = NULL;
+	as_key * first_key = NULL;
+
+	trace_span span;
+	trace_start(self, &span, "get_many");
 
 	as_batch_read_records records;
 
@@ -309,9 +330,18 @@ static PyObject * batch_get_aerospike_batch_read(as_error *err, AerospikeClient
 		goto CLEANUP;
 	}
 
+	first_key = records.list.size ?
+		&((as_batch_read_record *) as_vector_get(&records.list, 0))->key : NULL;
+
 	// Invoke C-client API
 	Py_BEGIN_ALLOW_THREADS
-	aerospike_batch_read(self->as, err, batch_policy_p, &records);
+	trace_call_start(&span);
+	if (request_limiter_acquire(self->limiter, err, LIMITER_BATCH, first_key,
+			records.list.size) == AEROSPIKE_OK) {
+		aerospike_batch_read(self->as, err, batch_policy_p, &records);
+		request_limiter_release(self->limiter);
+	}
+	trace_call_end(&span);
 	Py_END_ALLOW_THREADS
 	if (err->code != AEROSPIKE_OK)
 	{
@@ -320,6 +350,7 @@ static PyObject * batch_get_aerospike_batch_read(as_error *err, AerospikeClient
 	batch_get_recs(self, err, &records, &py_recs);
 
 CLEANUP:
+	trace_end_batch(self, &span, first_key, first_key ? records.list.size : 0, err->code);
 	if (batch_initialised == true) {
 		// We should destroy batch object as we are using 'as_batch_init' for initialisation
 		// Also, pyobject_to_key is soing strdup() in case of Unicode. So, object destruction
@@ -353,6 +384,10 @@ CLEANUP:
 static PyObject * batch_get_aerospike_batch_get(as_error *err, AerospikeClient * self, PyObject *py_keys, as_policy_batch * batch_policy_p)
 {
 	PyObject * py_recs = NULL;
+	as_key * first_key = NULL;
+
+	trace_span span;
+	trace_start(self, &span, "get_many");
 
 	LocalData data;
 	data.client = self;
@@ -416,14 +451,23 @@ static PyObject * batch_get_aerospike_batch_get(as_error *err, AerospikeClient *
 		goto CLEANUP;
 	}
 
+	first_key = as_batch_keyat(&batch, 0);
+
 	// Invoke C-client API
 	Py_BEGIN_ALLOW_THREADS
-	aerospike_batch_get(self->as, err, batch_policy_p,
-		&batch, (aerospike_batch_read_callback) batch_get_cb,
-		&data);
+	trace_call_start(&span);
+	if (request_limiter_acquire(self->limiter, err, LIMITER_BATCH, first_key,
+			batch.keys.size) == AEROSPIKE_OK) {
+		aerospike_batch_get(self->as, err, batch_policy_p,
+			&batch, (aerospike_batch_read_callback) batch_get_cb,
+			&data);
+		request_limiter_release(self->limiter);
+	}
+	trace_call_end(&span);
 	Py_END_ALLOW_THREADS
 
 CLEANUP:
+	trace_end_batch(self, &span, first_key, first_key ? batch.keys.size : 0, err->code);
 	if (batch_initialised == true) {
 		// We should destroy batch object as we are using 'as_batch_init' for initialisation
 		// Also, pyobject_to_key is soing strdup() in case of Unicode. So, object destruction
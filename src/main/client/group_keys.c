@@ -0,0 +1,176 @@
+/*******************************************************************************
+ * Copyright 2013-2016 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include <Python.h>
+#include <stdbool.h>
+
+#include <aerospike/aerospike.h>
+#include <aerospike/as_cluster.h>
+#include <aerospike/as_error.h>
+#include <aerospike/as_key.h>
+#include <aerospike/as_node.h>
+#include <aerospike/as_policy.h>
+
+#include "client.h"
+#include "conversions.h"
+#include "exceptions.h"
+#include "macros.h"
+
+/**
+ * Appends py_item to the list of py_name in py_groups, adding the list the
+ * first time the name is seen.
+ */
+static bool group_keys_append(PyObject * py_groups, PyObject * py_name, PyObject * py_item)
+{
+	PyObject * py_group = PyDict_GetItem(py_groups, py_name);
+	if (!py_group) {
+		py_group = PyList_New(0);
+		if (!py_group || PyDict_SetItem(py_groups, py_name, py_group) == -1) {
+			Py_XDECREF(py_group);
+			return false;
+		}
+		Py_DECREF(py_group);
+	}
+	return PyList_Append(py_group, py_item) == 0;
+}
+
+/**
+ *******************************************************************************************************
+ * Groups keys by the node that owns them, from the partition map the client
+ * already holds, without any request to the server.
+ *
+ *		client.group_keys_by_node(keys, replica=aerospike.POLICY_REPLICA_MASTER, indexes=False)
+ *
+ * Returns a dict from node name to the keys, or their indexes in keys, that
+ * the node serves for the replica policy. Keys of partitions the client has
+ * no node for are grouped under None. POLICY_REPLICA_ANY groups by master.
+ * In case of error,appropriate exceptions will be raised.
+ *******************************************************************************************************
+ */
+PyObject * AerospikeClient_Group_Keys_By_Node(AerospikeClient * self, PyObject * args, PyObject * kwds)
+{
+	PyObject * py_keys = NULL;
+	PyObject * py_fast = NULL;
+	PyObject * py_groups = NULL;
+	int replica = AS_POLICY_REPLICA_MASTER;
+	PyObject * py_indexes = Py_False;
+
+	static char * kwlist[] = {"keys", "replica", "indexes", NULL};
+
+	if (PyArg_ParseTupleAndKeywords(args, kwds, "O|iO:group_keys_by_node", kwlist,
+				&py_keys, &replica, &py_indexes) == false) {
+		return NULL;
+	}
+
+	as_error err;
+	as_error_init(&err);
+
+	if (!self || !self->as) {
+		as_error_update(&err, AEROSPIKE_ERR_PARAM, "Invalid aerospike object");
+		goto CLEANUP;
+	}
+	if (!self->is_conn_16) {
+		as_error_update(&err, AEROSPIKE_ERR_CLUSTER, "No connection to aerospike cluster");
+		goto CLEANUP;
+	}
+
+	if (replica != AS_POLICY_REPLICA_MASTER && replica != AS_POLICY_REPLICA_ANY &&
+			replica != AS_POLICY_REPLICA_SEQUENCE) {
+		as_error_update(&err, AEROSPIKE_ERR_PARAM, "replica should be one of the aerospike.POLICY_REPLICA_* values");
+		goto CLEANUP;
+	}
+	if (replica == AS_POLICY_REPLICA_ANY) {
+		// ANY moves to the next replica on every lookup, which would spread
+		// the keys of one partition over several groups
+		replica = AS_POLICY_REPLICA_MASTER;
+	}
+
+	int indexes = PyObject_IsTrue(py_indexes);
+	if (indexes == -1) {
+		PyErr_Clear();
+		as_error_update(&err, AEROSPIKE_ERR_PARAM, "indexes should be a boolean");
+		goto CLEANUP;
+	}
+
+	py_fast = PySequence_Fast(py_keys, "keys should be a list");
+	if (!py_fast) {
+		PyErr_Clear();
+		as_error_update(&err, AEROSPIKE_ERR_PARAM, "keys should be a list of keys");
+		goto CLEANUP;
+	}
+
+	py_groups = PyDict_New();
+	Py_ssize_t size = PySequence_Fast_GET_SIZE(py_fast);
+
+	for (Py_ssize_t i = 0; i < size; i++) {
+		PyObject * py_key = PySequence_Fast_GET_ITEM(py_fast, i);
+		as_key key;
+
+		if (pyobject_to_key(&err, py_key, &key) != AEROSPIKE_OK) {
+			Py_CLEAR(py_groups);
+			goto CLEANUP;
+		}
+		if (!as_key_digest(&err, &key)) {
+			as_key_destroy(&key);
+			Py_CLEAR(py_groups);
+			goto CLEANUP;
+		}
+
+		PyObject * py_name = NULL;
+		as_node * node = as_node_get(self->as->cluster, key.ns, key.digest.value, false,
+				(as_policy_replica) replica);
+		if (node) {
+			py_name = PyString_FromString(node->name);
+			as_node_release(node);
+		} else {
+			Py_INCREF(Py_None);
+			py_name = Py_None;
+		}
+		as_key_destroy(&key);
+
+		PyObject * py_item = NULL;
+		if (indexes) {
+			py_item = PyInt_FromLong((long) i);
+		} else {
+			Py_INCREF(py_key);
+			py_item = py_key;
+		}
+		bool appended = group_keys_append(py_groups, py_name, py_item);
+		Py_DECREF(py_item);
+		Py_DECREF(py_name);
+
+		if (!appended) {
+			PyErr_Clear();
+			as_error_update(&err, AEROSPIKE_ERR_CLIENT, "Unable to group the keys");
+			Py_CLEAR(py_groups);
+			goto CLEANUP;
+		}
+	}
+
+CLEANUP:
+	Py_XDECREF(py_fast);
+
+	if (err.code != AEROSPIKE_OK) {
+		PyObject * py_err = NULL;
+		error_to_pyobject(&err, &py_err);
+		PyObject *exception_type = raise_exception(&err);
+		PyErr_SetObject(exception_type, py_err);
+		Py_DECREF(py_err);
+		return NULL;
+	}
+
+	return py_groups;
+}
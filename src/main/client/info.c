@@ -15,12 +15,17 @@
  ******************************************************************************/
 
 #include <Python.h>
+#include <ctype.h>
+#include <errno.h>
+#include <pthread.h>
 #include <stdbool.h>
+#include <stdlib.h>
 
 #include <aerospike/aerospike_info.h>
 #include <aerospike/aerospike_key.h>
 #include <aerospike/as_key.h>
 #include <aerospike/as_error.h>
+#include <aerospike/as_cluster.h>
 #include <aerospike/as_node.h>
 #include <aerospike/as_record.h>
 #include <aerospike/as_config.h>
@@ -29,12 +34,25 @@
 #include "policy.h"
 #include "conversions.h"
 #include "exceptions.h"
+#include "tracer.h"
+#include "module_state.h"
 #include <arpa/inet.h>
 
+typedef struct info_all_request_t {
+	aerospike      *as;
+	as_policy_info *policy;
+	as_node        *node;
+	const char     *req;
+	char           *res;
+	as_error       error;
+	bool           started;
+} info_all_request;
+
 typedef struct foreach_callback_info_udata_t {
 	PyObject       *udata_p;
 	PyObject       *host_lookup_p;
 	as_error       error;
+	PyInterpreterState *interp;
 } foreach_callback_info_udata;
 
 /**
@@ -77,7 +95,8 @@ static bool AerospikeClient_Info_each(as_error * err, const as_node * node, cons
 	as_address* addr = NULL;
 
 	// Need to make sure we have the GIL since we're back in python land now
-	PyGILState_STATE gil_state = PyGILState_Ensure();
+	aerospike_gil gil;
+	aerospike_gil_ensure(udata_ptr->interp, &gil);
 
 	if (err && err->code != AEROSPIKE_OK) {
 		as_error_update(err, err->code, NULL);
@@ -130,7 +149,7 @@ static bool AerospikeClient_Info_each(as_error * err, const as_node * node, cons
 							if (py_res) {
 								Py_DECREF(py_res);
 							}
-							PyGILState_Release(gil_state);
+							aerospike_gil_release(&gil);
 							return false;
 						}
 						if (PyInt_Check(py_port)) {
@@ -189,7 +208,7 @@ CLEANUP:
 		PyObject *exception_type = raise_exception(&udata_ptr->error);
 		PyErr_SetObject(exception_type, py_err);
 		Py_DECREF(py_err);
-		PyGILState_Release(gil_state);
+		aerospike_gil_release(&gil);
 		return NULL;
 	}
 	if (err->code != AEROSPIKE_OK) {
@@ -198,11 +217,11 @@ CLEANUP:
 		PyObject *exception_type = raise_exception(err);
 		PyErr_SetObject(exception_type, py_err);
 		Py_DECREF(py_err);
-		PyGILState_Release(gil_state);
+		aerospike_gil_release(&gil);
 		return NULL;
 	}
 
-	PyGILState_Release(gil_state);
+	aerospike_gil_release(&gil);
 	return true;
 }
 
@@ -242,8 +261,12 @@ PyObject * AerospikeClient_Info(AerospikeClient * self, PyObject * args, PyObjec
 	py_nodes = PyDict_New();
 	info_callback_udata.udata_p = py_nodes;
 	info_callback_udata.host_lookup_p = py_hosts;
+	info_callback_udata.interp = self->state->interp;
 	as_error_init(&info_callback_udata.error);
 
+	trace_span span;
+	trace_start(self, &span, "info");
+
 	if (!self || !self->as) {
 		as_error_update(&err, AEROSPIKE_ERR_PARAM, "Invalid aerospike object");
 		goto CLEANUP;
@@ -271,9 +294,11 @@ PyObject * AerospikeClient_Info(AerospikeClient * self, PyObject * args, PyObjec
 	}
 
 	Py_BEGIN_ALLOW_THREADS
+	trace_call_start(&span);
 	aerospike_info_foreach(self->as, &err, info_policy_p, req,
 					(aerospike_info_foreach_callback)AerospikeClient_Info_each,
 					&info_callback_udata);
+	trace_call_end(&span);
 	Py_END_ALLOW_THREADS
 
 	if (&info_callback_udata.error.code != AEROSPIKE_OK) {
@@ -281,6 +306,9 @@ PyObject * AerospikeClient_Info(AerospikeClient * self, PyObject * args, PyObjec
 		goto CLEANUP;
 	}
 CLEANUP:
+	trace_end_set(self, &span, NULL, NULL, 0, info_callback_udata.error.code != AEROSPIKE_OK ?
+			info_callback_udata.error.code : err.code);
+
 	if (py_ustr) {
 		Py_DECREF(py_ustr);
 	}
@@ -311,6 +339,382 @@ CLEANUP:
 }
 
 
+/**
+ *******************************************************************************************************
+ * Converts a single info value into an int, float or bool where the whole
+ * value parses as one, otherwise into a string.
+ *******************************************************************************************************
+ */
+static PyObject * info_scalar_to_pyobject(const char * value)
+{
+	char * end = NULL;
+
+	const char * digits = (*value == '-') ? value + 1 : value;
+
+	// Only plain decimal numbers, so node ids and hex digests stay strings
+	if (isdigit((unsigned char) *digits) && !strpbrk(value, "xX")) {
+		errno = 0;
+		long long int_value = strtoll(value, &end, 10);
+		if (*end == '\0' && errno != ERANGE) {
+			return PyLong_FromLongLong(int_value);
+		}
+		if (*end == '\0' && *value != '-') {
+			// Counters above LLONG_MAX
+			return PyLong_FromUnsignedLongLong(strtoull(value, NULL, 10));
+		}
+
+		// Only digits around a single '.' make a float, so values such as
+		// 1234E5678 or 1.2.3 stay strings
+		const char * dot = strchr(digits, '.');
+		if (dot && !strchr(dot + 1, '.') && strspn(digits, "0123456789.") == strlen(digits)) {
+			double double_value = strtod(value, &end);
+			if (*end == '\0') {
+				return PyFloat_FromDouble(double_value);
+			}
+		}
+	}
+
+	if (!strcmp(value, "true")) {
+		Py_INCREF(Py_True);
+		return Py_True;
+	}
+	if (!strcmp(value, "false")) {
+		Py_INCREF(Py_False);
+		return Py_False;
+	}
+
+	return PyString_FromString(value);
+}
+
+/**
+ *******************************************************************************************************
+ * Returns true if every ':' separated field of item is a key=value pair, as
+ * in the entries of "sets" or "sindex".
+ *******************************************************************************************************
+ */
+static bool info_item_is_record(const char * item)
+{
+	const char * field = item;
+	int fields = 0;
+
+	while (field) {
+		const char * next = strchr(field, ':');
+		const char * eq = strchr(field, '=');
+		if (!eq || (next && eq > next)) {
+			return false;
+		}
+		fields++;
+		field = next ? next + 1 : NULL;
+	}
+	return fields > 1;
+}
+
+/**
+ *******************************************************************************************************
+ * Adds "key=value" to py_dict, converting the value. Modifies pair in place.
+ *******************************************************************************************************
+ */
+static void info_pair_to_dict(char * pair, PyObject * py_dict)
+{
+	char * eq = strchr(pair, '=');
+	*eq = '\0';
+	PyObject * py_value = info_scalar_to_pyobject(eq + 1);
+	PyDict_SetItemString(py_dict, pair, py_value);
+	Py_DECREF(py_value);
+}
+
+/**
+ *******************************************************************************************************
+ * Parses the value of one info command.
+ *
+ * "k1=v1;k2=v2" becomes a dict, "a;b" a list of values and
+ * "k1=v1:k2=v2;k1=v3:k2=v4" a list of dicts. Modifies value in place.
+ *******************************************************************************************************
+ */
+static PyObject * info_value_to_pyobject(char * value)
+{
+	char * saved = NULL;
+	bool all_pairs = true;
+	Py_ssize_t items = 0;
+
+	// Decide the shape first so the common statistics case builds one dict
+	char * copy = strdup(value);
+	if (!copy) {
+		return PyErr_NoMemory();
+	}
+	for (char * item = strtok_r(copy, ";", &saved); item; item = strtok_r(NULL, ";", &saved)) {
+		items++;
+		if (!strchr(item, '=') || info_item_is_record(item)) {
+			all_pairs = false;
+		}
+	}
+	free(copy);
+
+	if (items == 0 || (items == 1 && !strchr(value, '='))) {
+		return info_scalar_to_pyobject(value);
+	}
+
+	if (all_pairs) {
+		PyObject * py_dict = PyDict_New();
+		for (char * item = strtok_r(value, ";", &saved); item; item = strtok_r(NULL, ";", &saved)) {
+			info_pair_to_dict(item, py_dict);
+		}
+		return py_dict;
+	}
+
+	PyObject * py_list = PyList_New(0);
+	for (char * item = strtok_r(value, ";", &saved); item; item = strtok_r(NULL, ";", &saved)) {
+		PyObject * py_item = NULL;
+		if (info_item_is_record(item)) {
+			char * field_saved = NULL;
+			py_item = PyDict_New();
+			for (char * field = strtok_r(item, ":", &field_saved); field; field = strtok_r(NULL, ":", &field_saved)) {
+				info_pair_to_dict(field, py_item);
+			}
+		} else if (strchr(item, '=')) {
+			py_item = PyDict_New();
+			info_pair_to_dict(item, py_item);
+		} else {
+			py_item = info_scalar_to_pyobject(item);
+		}
+		PyList_Append(py_list, py_item);
+		Py_DECREF(py_item);
+	}
+	return py_list;
+}
+
+/**
+ *******************************************************************************************************
+ * Converts a node's info response, "command\tvalue\n" per command, into a
+ * Python object. A single command returns its value, several commands a dict
+ * keyed by command. Modifies res in place.
+ *******************************************************************************************************
+ */
+static PyObject * info_response_to_pyobject(char * res, bool parse)
+{
+	char * saved = NULL;
+	PyObject * py_commands = PyDict_New();
+	Py_ssize_t commands = 0;
+
+	for (char * line = strtok_r(res, "\n", &saved); line; line = strtok_r(NULL, "\n", &saved)) {
+		char * value = strchr(line, '\t');
+		if (value) {
+			*value++ = '\0';
+		} else {
+			value = line;
+		}
+		PyObject * py_value = parse ? info_value_to_pyobject(value) : PyString_FromString(value);
+		if (!py_value) {
+			Py_DECREF(py_commands);
+			return NULL;
+		}
+		PyDict_SetItemString(py_commands, line, py_value);
+		Py_DECREF(py_value);
+		commands++;
+	}
+
+	if (commands == 0) {
+		Py_DECREF(py_commands);
+		return PyString_FromString("");
+	}
+
+	if (commands == 1) {
+		PyObject * py_key = NULL;
+		PyObject * py_value = NULL;
+		Py_ssize_t pos = 0;
+		PyDict_Next(py_commands, &pos, &py_key, &py_value);
+		Py_INCREF(py_value);
+		Py_DECREF(py_commands);
+		return py_value;
+	}
+
+	return py_commands;
+}
+
+static void * info_all_worker(void * udata)
+{
+	info_all_request * request = (info_all_request *) udata;
+	as_error_init(&request->error);
+	aerospike_info_node(request->as, &request->error, request->policy, request->node,
+			request->req, &request->res);
+	return NULL;
+}
+
+/**
+ *******************************************************************************************************
+ * Sends an info request to all the nodes in a cluster in parallel.
+ *
+ * Each node is queried on its own thread with the GIL released. Responses
+ * are split into commands, and with parse=True their values are parsed
+ * into dicts and lists of ints, floats, bools and strings.
+ *
+ * @param self                  AerospikeClient object
+ * @param args                  The args is a tuple object containing an argument
+ *                              list passed from Python to a C function
+ * @param kwds                  Dictionary of keywords
+ *
+ * Returns a dict of {node name: (error, response)}. A node that fails to
+ * respond has its error tuple set and a response of None.
+ * In case of error,appropriate exceptions will be raised.
+ *******************************************************************************************************
+ */
+PyObject * AerospikeClient_InfoAll(AerospikeClient * self, PyObject * args, PyObject * kwds)
+{
+	PyObject * py_req = NULL;
+	PyObject * py_parse = NULL;
+	PyObject * py_policy = NULL;
+	PyObject * py_ustr = NULL;
+	PyObject * py_nodes = NULL;
+	as_nodes * nodes = NULL;
+	info_all_request * requests = NULL;
+	pthread_t * threads = NULL;
+	char * req = NULL;
+
+	static char * kwlist[] = {"command", "parse", "policy", NULL};
+
+	if (PyArg_ParseTupleAndKeywords(args, kwds, "O|OO:info_all", kwlist, &py_req, &py_parse, &py_policy) == false) {
+		return NULL;
+	}
+
+	as_error err;
+	as_error_init(&err);
+
+	as_policy_info info_policy;
+	as_policy_info* info_policy_p = NULL;
+	int parse = py_parse ? PyObject_IsTrue(py_parse) : 1;
+	if (parse == -1) {
+		return NULL;
+	}
+
+	trace_span span;
+	trace_start(self, &span, "info_all");
+
+	if (!self || !self->as) {
+		as_error_update(&err, AEROSPIKE_ERR_PARAM, "Invalid aerospike object");
+		goto CLEANUP;
+	}
+	if (!self->is_conn_16) {
+		as_error_update(&err, AEROSPIKE_ERR_CLUSTER, "No connection to aerospike cluster");
+		goto CLEANUP;
+	}
+
+	pyobject_to_policy_info(&err, py_policy, &info_policy, &info_policy_p,
+					&self->as->config.policies.info);
+	if (err.code != AEROSPIKE_OK) {
+		goto CLEANUP;
+	}
+
+	if (PyUnicode_Check(py_req)) {
+		py_ustr = PyUnicode_AsUTF8String(py_req);
+		req = PyBytes_AsString(py_ustr);
+	} else if (PyString_Check(py_req)) {
+		req = PyString_AsString(py_req);
+	} else {
+		as_error_update(&err, AEROSPIKE_ERR_PARAM, "Request must be a string");
+		goto CLEANUP;
+	}
+
+	nodes = as_nodes_reserve(self->as->cluster);
+	if (nodes->size == 0) {
+		as_error_update(&err, AEROSPIKE_ERR_SERVER, "Cluster is empty");
+		goto CLEANUP;
+	}
+
+	requests = (info_all_request *) calloc(nodes->size, sizeof(info_all_request));
+	threads = (pthread_t *) calloc(nodes->size, sizeof(pthread_t));
+	if (!requests || !threads) {
+		as_error_update(&err, AEROSPIKE_ERR_CLIENT, "Failed to allocate the node requests");
+		goto CLEANUP;
+	}
+
+	Py_BEGIN_ALLOW_THREADS
+	trace_call_start(&span);
+	for (uint32_t i = 0; i < nodes->size; i++) {
+		requests[i].as = self->as;
+		requests[i].policy = info_policy_p;
+		requests[i].node = nodes->array[i];
+		requests[i].req = req;
+		requests[i].started = pthread_create(&threads[i], NULL, info_all_worker, &requests[i]) == 0;
+		if (!requests[i].started) {
+			// Fall back to querying this node on the calling thread
+			info_all_worker(&requests[i]);
+		}
+	}
+	for (uint32_t i = 0; i < nodes->size; i++) {
+		if (requests[i].started) {
+			pthread_join(threads[i], NULL);
+		}
+	}
+	trace_call_end(&span);
+	Py_END_ALLOW_THREADS
+
+	py_nodes = PyDict_New();
+	for (uint32_t i = 0; i < nodes->size; i++) {
+		PyObject * py_err = NULL;
+		PyObject * py_out = NULL;
+
+		if (requests[i].error.code != AEROSPIKE_OK) {
+			error_to_pyobject(&requests[i].error, &py_err);
+		} else if (requests[i].res) {
+			py_out = info_response_to_pyobject(requests[i].res, parse);
+			if (!py_out) {
+				Py_DECREF(py_nodes);
+				py_nodes = NULL;
+				as_error_update(&err, AEROSPIKE_ERR_CLIENT, "Failed to parse the response of node %s",
+						requests[i].node->name);
+				goto CLEANUP;
+			}
+		}
+
+		if (!py_err) {
+			Py_INCREF(Py_None);
+			py_err = Py_None;
+		}
+		if (!py_out) {
+			Py_INCREF(Py_None);
+			py_out = Py_None;
+		}
+
+		PyObject * py_res = PyTuple_New(2);
+		PyTuple_SetItem(py_res, 0, py_err);
+		PyTuple_SetItem(py_res, 1, py_out);
+		PyDict_SetItemString(py_nodes, requests[i].node->name, py_res);
+		Py_DECREF(py_res);
+	}
+
+CLEANUP:
+	trace_end_set(self, &span, NULL, NULL, 0, err.code);
+
+	if (requests) {
+		for (uint32_t i = 0; i < nodes->size; i++) {
+			if (requests[i].res) {
+				free(requests[i].res);
+			}
+		}
+		free(requests);
+	}
+	if (threads) {
+		free(threads);
+	}
+	if (nodes) {
+		as_nodes_release(nodes);
+	}
+	if (py_ustr) {
+		Py_DECREF(py_ustr);
+	}
+	if (err.code != AEROSPIKE_OK) {
+		PyObject * py_err = NULL;
+		error_to_pyobject(&err, &py_err);
+		PyObject *exception_type = raise_exception(&err);
+		PyErr_SetObject(exception_type, py_err);
+		Py_DECREF(py_err);
+		return NULL;
+	}
+
+	return py_nodes;
+}
+
+
 PyObject * AerospikeClient_HasGeo(AerospikeClient * self, PyObject * args, PyObject * kwds)
 {
 	// Initialize error
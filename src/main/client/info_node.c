@@ -27,6 +27,7 @@
 #include "conversions.h"
 #include "exceptions.h"
 #include "policy.h"
+#include "tracer.h"
 
 /**
  ********************************************************************************************************
@@ -47,12 +48,13 @@
  * @param request_str_p         Request string sent from the python client
  * @param py_host               Optional host sent from the python client
  * @param py_policy             The policy sent from the python client
+ * @param span                  Span of client.info_node(), NULL for internal requests
  *
  * Returns information about a host.
  ********************************************************************************************************/
 static PyObject * AerospikeClient_InfoNode_Invoke(
 	as_error * err, AerospikeClient * self,
-	PyObject * py_request_str, PyObject * py_host, PyObject * py_policy) {
+	PyObject * py_request_str, PyObject * py_host, PyObject * py_policy, trace_span * span) {
 
 	PyObject * py_response = NULL;
 	PyObject * py_ustr = NULL;
@@ -132,9 +134,15 @@ static PyObject * AerospikeClient_InfoNode_Invoke(
 	}
 
 	Py_BEGIN_ALLOW_THREADS
+	if (span) {
+		trace_call_start(span);
+	}
 	status = aerospike_info_host(self->as, err, info_policy_p,
 		(const char *) address, (uint16_t) port_no, request_str_p,
 		&response_p);
+	if (span) {
+		trace_call_end(span);
+	}
 	Py_END_ALLOW_THREADS
 	if (err->code == AEROSPIKE_OK) {
 		if (response_p && status == AEROSPIKE_OK) {
@@ -153,6 +161,9 @@ static PyObject * AerospikeClient_InfoNode_Invoke(
 	}
 
 CLEANUP:
+	if (span) {
+		trace_end_set(self, span, NULL, NULL, 0, err->code);
+	}
 
 	if (py_ustr) {
 		Py_DECREF(py_ustr);
@@ -200,7 +211,10 @@ PyObject * AerospikeClient_InfoNode(AerospikeClient * self, PyObject * args, PyO
 		return NULL;
 	}
 
-	return AerospikeClient_InfoNode_Invoke(&err, self, py_request, py_host, py_policy);
+	trace_span span;
+	trace_start(self, &span, "info_node");
+
+	return AerospikeClient_InfoNode_Invoke(&err, self, py_request, py_host, py_policy, &span);
 
 }
 /**
@@ -320,7 +334,7 @@ static PyObject * AerospikeClient_GetNodes_Invoke(
 
 	PyObject * py_req_str = NULL;
 	py_req_str = PyString_FromString("services");
-	response_services_p = AerospikeClient_InfoNode_Invoke(&err, self, py_req_str, NULL, NULL);
+	response_services_p = AerospikeClient_InfoNode_Invoke(&err, self, py_req_str, NULL, NULL, NULL);
 	Py_DECREF(py_req_str);
 	if (!response_services_p) {
 		if (err.code == AEROSPIKE_OK) {
@@ -330,7 +344,7 @@ static PyObject * AerospikeClient_GetNodes_Invoke(
 	}
 
 	py_req_str = PyString_FromString("service");
-	response_service_p = AerospikeClient_InfoNode_Invoke(&err, self, py_req_str, NULL, NULL);
+	response_service_p = AerospikeClient_InfoNode_Invoke(&err, self, py_req_str, NULL, NULL, NULL);
 	Py_DECREF(py_req_str);
 	if (!response_service_p) {
 		if (err.code == AEROSPIKE_OK) {
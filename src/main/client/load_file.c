@@ -0,0 +1,874 @@
+/*******************************************************************************
+ * Copyright 2013-2016 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include <Python.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <aerospike/aerospike_key.h>
+#include <aerospike/as_arraylist.h>
+#include <aerospike/as_double.h>
+#include <aerospike/as_error.h>
+#include <aerospike/as_hashmap.h>
+#include <aerospike/as_hashmap_iterator.h>
+#include <aerospike/as_integer.h>
+#include <aerospike/as_key.h>
+#include <aerospike/as_nil.h>
+#include <aerospike/as_pair.h>
+#include <aerospike/as_record.h>
+#include <aerospike/as_string.h>
+#include <citrusleaf/cf_clock.h>
+
+#include "breaker.h"
+#include "cache.h"
+#include "client.h"
+#include "conversions.h"
+#include "exceptions.h"
+#include "limiter.h"
+#include "policy.h"
+#include "tracer.h"
+
+#define LOAD_FORMAT_NDJSON 0
+#define LOAD_FORMAT_CSV 1
+#define LOAD_DEFAULT_CONCURRENCY 16
+#define LOAD_MAX_CONCURRENCY 256
+#define LOAD_JSON_MAX_DEPTH 64
+
+// Shared state of a load, used from the writer threads without the GIL
+typedef struct {
+	aerospike * as;
+	request_limiter * limiter;
+	circuit_breaker * breaker;
+	as_policy_write * policy;
+	const char * ns;
+	const char * set;
+	const char * key_field;
+	int format;
+
+	// CSV column names, from the first line of the file
+	char ** columns;
+	uint32_t n_columns;
+
+	pthread_mutex_t read_lock;
+	FILE * file;
+	uint64_t line_no;
+	bool eof;
+
+	// Rate limiting: the time at which the next write may start
+	uint32_t rate;
+	uint64_t next_us;
+
+	pthread_mutex_t stats_lock;
+	FILE * reject_file;
+	uint64_t records;
+	uint64_t errors;
+} load_state;
+
+/*******************************************************************************
+ * NDJSON
+ ******************************************************************************/
+
+typedef struct {
+	const char * p;
+	const char * end;
+	int depth;
+} json_parser;
+
+static as_val * json_parse_value(json_parser * jp);
+
+static void json_skip_ws(json_parser * jp)
+{
+	while (jp->p < jp->end && (*jp->p == ' ' || *jp->p == '\t' || *jp->p == '\n' || *jp->p == '\r')) {
+		jp->p++;
+	}
+}
+
+static bool json_consume(json_parser * jp, char c)
+{
+	json_skip_ws(jp);
+	if (jp->p < jp->end && *jp->p == c) {
+		jp->p++;
+		return true;
+	}
+	return false;
+}
+
+static int json_hex4(const char * p)
+{
+	int value = 0;
+	for (int i = 0; i < 4; i++) {
+		char c = p[i];
+		value <<= 4;
+		if (c >= '0' && c <= '9') value |= c - '0';
+		else if (c >= 'a' && c <= 'f') value |= c - 'a' + 10;
+		else if (c >= 'A' && c <= 'F') value |= c - 'A' + 10;
+		else return -1;
+	}
+	return value;
+}
+
+static char * json_utf8_encode(char * out, uint32_t cp)
+{
+	if (cp < 0x80) {
+		*out++ = (char) cp;
+	} else if (cp < 0x800) {
+		*out++ = (char) (0xc0 | (cp >> 6));
+		*out++ = (char) (0x80 | (cp & 0x3f));
+	} else if (cp < 0x10000) {
+		*out++ = (char) (0xe0 | (cp >> 12));
+		*out++ = (char) (0x80 | ((cp >> 6) & 0x3f));
+		*out++ = (char) (0x80 | (cp & 0x3f));
+	} else {
+		*out++ = (char) (0xf0 | (cp >> 18));
+		*out++ = (char) (0x80 | ((cp >> 12) & 0x3f));
+		*out++ = (char) (0x80 | ((cp >> 6) & 0x3f));
+		*out++ = (char) (0x80 | (cp & 0x3f));
+	}
+	return out;
+}
+
+/**
+ * Parses a JSON string into a malloc'd, NUL terminated UTF-8 buffer.
+ * The decoded string is never longer than the escaped input. Strings
+ * holding a NUL, raw or as \u0000, are rejected, as as_string would
+ * silently cut them short.
+ */
+static char * json_parse_string(json_parser * jp)
+{
+	if (!json_consume(jp, '"')) {
+		return NULL;
+	}
+
+	const char * start = jp->p;
+	char * str = (char *) malloc(jp->end - start + 1);
+	if (!str) {
+		return NULL;
+	}
+	char * out = str;
+
+	while (jp->p < jp->end && *jp->p != '"') {
+		char c = *jp->p++;
+		if (c == '\0') {
+			free(str);
+			return NULL;
+		}
+		if (c != '\\') {
+			*out++ = c;
+			continue;
+		}
+		if (jp->p >= jp->end) {
+			break;
+		}
+		c = *jp->p++;
+		switch (c) {
+			case '"':  *out++ = '"'; break;
+			case '\\': *out++ = '\\'; break;
+			case '/':  *out++ = '/'; break;
+			case 'b':  *out++ = '\b'; break;
+			case 'f':  *out++ = '\f'; break;
+			case 'n':  *out++ = '\n'; break;
+			case 'r':  *out++ = '\r'; break;
+			case 't':  *out++ = '\t'; break;
+			case 'u': {
+				int cp = jp->end - jp->p >= 4 ? json_hex4(jp->p) : -1;
+				if (cp <= 0) {
+					free(str);
+					return NULL;
+				}
+				jp->p += 4;
+				// Surrogate pair
+				if (cp >= 0xd800 && cp <= 0xdbff && jp->end - jp->p >= 6 &&
+						jp->p[0] == '\\' && jp->p[1] == 'u') {
+					int low = json_hex4(jp->p + 2);
+					if (low >= 0xdc00 && low <= 0xdfff) {
+						cp = 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
+						jp->p += 6;
+					}
+				}
+				out = json_utf8_encode(out, (uint32_t) cp);
+				break;
+			}
+			default:
+				free(str);
+				return NULL;
+		}
+	}
+
+	if (jp->p >= jp->end) {
+		free(str);
+		return NULL;
+	}
+	jp->p++;
+	*out = '\0';
+	return str;
+}
+
+static as_val * json_parse_number(json_parser * jp)
+{
+	const char * start = jp->p;
+	bool is_float = false;
+
+	if (jp->p < jp->end && *jp->p == '-') {
+		jp->p++;
+	}
+	while (jp->p < jp->end) {
+		char c = *jp->p;
+		if (c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-') {
+			is_float = true;
+		} else if (c < '0' || c > '9') {
+			break;
+		}
+		jp->p++;
+	}
+
+	char number[64];
+	size_t len = jp->p - start;
+	if (len == 0 || len >= sizeof(number)) {
+		return NULL;
+	}
+	memcpy(number, start, len);
+	number[len] = '\0';
+
+	char * number_end = NULL;
+	errno = 0;
+	if (!is_float) {
+		long long value = strtoll(number, &number_end, 10);
+		if (errno == 0 && *number_end == '\0') {
+			return (as_val *) as_integer_new(value);
+		}
+	}
+	errno = 0;
+	double value = strtod(number, &number_end);
+	if (*number_end != '\0') {
+		return NULL;
+	}
+	return (as_val *) as_double_new(value);
+}
+
+static as_val * json_parse_object(json_parser * jp)
+{
+	as_hashmap * map = as_hashmap_new(8);
+
+	if (json_consume(jp, '}')) {
+		return (as_val *) map;
+	}
+	do {
+		json_skip_ws(jp);
+		char * name = json_parse_string(jp);
+		if (!name || !json_consume(jp, ':')) {
+			free(name);
+			goto ERROR;
+		}
+		as_val * value = json_parse_value(jp);
+		if (!value) {
+			free(name);
+			goto ERROR;
+		}
+		as_hashmap_set(map, (as_val *) as_string_new(name, true), value);
+	} while (json_consume(jp, ','));
+
+	if (json_consume(jp, '}')) {
+		return (as_val *) map;
+	}
+
+ERROR:
+	as_hashmap_destroy(map);
+	return NULL;
+}
+
+static as_val * json_parse_array(json_parser * jp)
+{
+	as_arraylist * list = as_arraylist_new(8, 8);
+
+	if (json_consume(jp, ']')) {
+		return (as_val *) list;
+	}
+	do {
+		as_val * value = json_parse_value(jp);
+		if (!value) {
+			goto ERROR;
+		}
+		as_arraylist_append(list, value);
+	} while (json_consume(jp, ','));
+
+	if (json_consume(jp, ']')) {
+		return (as_val *) list;
+	}
+
+ERROR:
+	as_arraylist_destroy(list);
+	return NULL;
+}
+
+static bool json_match(json_parser * jp, const char * word)
+{
+	size_t len = strlen(word);
+	if ((size_t) (jp->end - jp->p) >= len && !strncmp(jp->p, word, len)) {
+		jp->p += len;
+		return true;
+	}
+	return false;
+}
+
+/**
+ * Booleans are stored as integers, as put() does for Python bools.
+ * null is returned as as_nil, and dropped when it is a top level field.
+ */
+static as_val * json_parse_value(json_parser * jp)
+{
+	as_val * value = NULL;
+
+	json_skip_ws(jp);
+	if (jp->p >= jp->end || ++jp->depth > LOAD_JSON_MAX_DEPTH) {
+		return NULL;
+	}
+
+	switch (*jp->p) {
+		case '{':
+			jp->p++;
+			value = json_parse_object(jp);
+			break;
+		case '[':
+			jp->p++;
+			value = json_parse_array(jp);
+			break;
+		case '"': {
+			char * str = json_parse_string(jp);
+			value = str ? (as_val *) as_string_new(str, true) : NULL;
+			break;
+		}
+		case 't':
+			value = json_match(jp, "true") ? (as_val *) as_integer_new(1) : NULL;
+			break;
+		case 'f':
+			value = json_match(jp, "false") ? (as_val *) as_integer_new(0) : NULL;
+			break;
+		case 'n':
+			value = json_match(jp, "null") ? as_val_reserve(&as_nil) : NULL;
+			break;
+		default:
+			value = json_parse_number(jp);
+	}
+
+	jp->depth--;
+	return value;
+}
+
+/**
+ * Parses one NDJSON line into a map of field name to value.
+ */
+static as_hashmap * ndjson_parse_line(as_error * err, const char * line, size_t len)
+{
+	json_parser jp = {line, line + len, 0};
+
+	json_skip_ws(&jp);
+	if (jp.p >= jp.end || *jp.p != '{') {
+		as_error_update(err, AEROSPIKE_ERR_PARAM, "Line is not a JSON object");
+		return NULL;
+	}
+
+	as_val * value = json_parse_value(&jp);
+	json_skip_ws(&jp);
+	if (!value || jp.p != jp.end) {
+		if (value) {
+			as_val_destroy(value);
+		}
+		as_error_update(err, AEROSPIKE_ERR_PARAM, "Invalid JSON at offset %d", (int) (jp.p - line));
+		return NULL;
+	}
+	return (as_hashmap *) value;
+}
+
+/*******************************************************************************
+ * CSV
+ ******************************************************************************/
+
+/**
+ * Splits a CSV line in place. Quoted fields may contain commas and doubled
+ * quotes, but not line breaks. Returns the number of fields, or -1 if the
+ * line has more than max_fields fields.
+ */
+static int csv_split_line(char * line, char ** fields, bool * quoted, int max_fields)
+{
+	int n = 0;
+	char * p = line;
+
+	while (true) {
+		if (n == max_fields) {
+			return -1;
+		}
+		quoted[n] = false;
+		if (*p == '"') {
+			char * out = ++p;
+			fields[n] = out;
+			quoted[n] = true;
+			while (*p) {
+				if (*p == '"') {
+					if (p[1] == '"') {
+						*out++ = '"';
+						p += 2;
+						continue;
+					}
+					p++;
+					break;
+				}
+				*out++ = *p++;
+			}
+			// Anything between the closing quote and the comma is dropped
+			while (*p && *p != ',') {
+				p++;
+			}
+			*out = '\0';
+		} else {
+			fields[n] = p;
+			while (*p && *p != ',') {
+				p++;
+			}
+		}
+		n++;
+		if (*p != ',') {
+			break;
+		}
+		*p++ = '\0';
+	}
+	return n;
+}
+
+/**
+ * Unquoted CSV values that are entirely an integer or a float are stored as
+ * numbers, everything else as strings.
+ */
+static as_val * csv_value(const char * field, bool quoted)
+{
+	if (!quoted && *field) {
+		char * end = NULL;
+		errno = 0;
+		long long ivalue = strtoll(field, &end, 10);
+		if (errno == 0 && *end == '\0') {
+			return (as_val *) as_integer_new(ivalue);
+		}
+		errno = 0;
+		double dvalue = strtod(field, &end);
+		if (errno == 0 && *end == '\0') {
+			return (as_val *) as_double_new(dvalue);
+		}
+	}
+	return (as_val *) as_string_new_strdup(field);
+}
+
+static as_hashmap * csv_parse_line(as_error * err, load_state * state, char * line)
+{
+	as_hashmap * map = NULL;
+	char ** fields = (char **) malloc(sizeof(char *) * state->n_columns);
+	bool * quoted = (bool *) malloc(sizeof(bool) * state->n_columns);
+
+	int n = csv_split_line(line, fields, quoted, (int) state->n_columns);
+	if (n != (int) state->n_columns) {
+		as_error_update(err, AEROSPIKE_ERR_PARAM, "Expected %u fields", state->n_columns);
+		goto CLEANUP;
+	}
+
+	map = as_hashmap_new(state->n_columns);
+	for (int i = 0; i < n; i++) {
+		// Empty unquoted fields are left out of the record
+		if (!quoted[i] && !*fields[i]) {
+			continue;
+		}
+		as_hashmap_set(map, (as_val *) as_string_new_strdup(state->columns[i]),
+				csv_value(fields[i], quoted[i]));
+	}
+
+CLEANUP:
+	free(quoted);
+	free(fields);
+	return map;
+}
+
+/*******************************************************************************
+ * WRITERS
+ ******************************************************************************/
+
+/**
+ * Builds the key from the key field and the record from all non-null
+ * fields, then writes it.
+ */
+static as_status load_put_fields(as_error * err, load_state * state, as_hashmap * fields)
+{
+	as_key key;
+	as_record rec;
+	as_string key_name;
+
+	as_string_init(&key_name, (char *) state->key_field, false);
+	as_val * key_val = as_hashmap_get(fields, (as_val *) &key_name);
+
+	if (!key_val || as_val_type(key_val) == AS_NIL) {
+		return as_error_update(err, AEROSPIKE_ERR_PARAM, "Missing key field %s", state->key_field);
+	}
+	if (as_val_type(key_val) == AS_INTEGER) {
+		as_key_init_int64(&key, state->ns, state->set, as_integer_get((as_integer *) key_val));
+	} else if (as_val_type(key_val) == AS_STRING) {
+		as_key_init_strp(&key, state->ns, state->set,
+				strdup(as_string_get((as_string *) key_val)), true);
+	} else {
+		return as_error_update(err, AEROSPIKE_ERR_PARAM, "Key field %s must be an integer or a string", state->key_field);
+	}
+
+	as_record_init(&rec, as_hashmap_size(fields));
+
+	as_hashmap_iterator it;
+	as_hashmap_iterator_init(&it, fields);
+	while (as_hashmap_iterator_has_next(&it)) {
+		as_pair * pair = (as_pair *) as_hashmap_iterator_next(&it);
+		const char * name = as_string_get((as_string *) as_pair_1(pair));
+		as_val * value = as_pair_2(pair);
+
+		if (as_val_type(value) == AS_NIL) {
+			continue;
+		}
+		if (strlen(name) >= AS_BIN_NAME_MAX_SIZE) {
+			as_error_update(err, AEROSPIKE_ERR_BIN_NAME, "Bin name %s too long", name);
+			break;
+		}
+		as_val_reserve(value);
+		as_record_set(&rec, name, (as_bin_value *) value);
+	}
+	as_hashmap_iterator_destroy(&it);
+
+	if (err->code == AEROSPIKE_OK &&
+			request_limiter_acquire(state->limiter, err, LIMITER_WRITE, &key, 1) == AEROSPIKE_OK) {
+		as_node * node = NULL;
+		if (circuit_breaker_check(state->breaker, state->as, err, &key, &node) == AEROSPIKE_OK) {
+			aerospike_key_put(state->as, err, state->policy, &key, &rec);
+			circuit_breaker_record(state->breaker, node, err->code);
+		}
+		request_limiter_release(state->limiter);
+	}
+
+	as_record_destroy(&rec);
+	as_key_destroy(&key);
+	return err->code;
+}
+
+/**
+ * Waits until the next write slot when a rate limit is set.
+ */
+static void load_throttle(load_state * state)
+{
+	if (!state->rate) {
+		return;
+	}
+
+	pthread_mutex_lock(&state->stats_lock);
+	uint64_t now = cf_getus();
+	if (state->next_us < now) {
+		state->next_us = now;
+	}
+	uint64_t slot = state->next_us;
+	state->next_us += 1000000 / state->rate;
+	pthread_mutex_unlock(&state->stats_lock);
+
+	if (slot > now) {
+		usleep((useconds_t) (slot - now));
+	}
+}
+
+/**
+ * Writes "<line number>\t<status>\t<message>\t<input line>" to the
+ * reject file.
+ */
+static void load_reject(load_state * state, uint64_t line_no, as_error * err, const char * line)
+{
+	pthread_mutex_lock(&state->stats_lock);
+	state->errors++;
+	if (state->reject_file) {
+		fprintf(state->reject_file, "%llu\t%d\t%s\t%s\n",
+				(unsigned long long) line_no, err->code, err->message, line);
+	}
+	pthread_mutex_unlock(&state->stats_lock);
+}
+
+static void * load_worker(void * udata)
+{
+	load_state * state = (load_state *) udata;
+	char * line = NULL;
+	size_t capacity = 0;
+
+	while (true) {
+		pthread_mutex_lock(&state->read_lock);
+		ssize_t len = state->eof ? -1 : getline(&line, &capacity, state->file);
+		uint64_t line_no = ++state->line_no;
+		if (len < 0) {
+			state->eof = true;
+		}
+		pthread_mutex_unlock(&state->read_lock);
+
+		if (len < 0) {
+			break;
+		}
+
+		while (len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r')) {
+			line[--len] = '\0';
+		}
+		if (len == 0) {
+			continue;
+		}
+
+		as_error err;
+		as_error_init(&err);
+		as_hashmap * fields = NULL;
+
+		if (state->format == LOAD_FORMAT_NDJSON) {
+			fields = ndjson_parse_line(&err, line, (size_t) len);
+		} else {
+			// Fields are split in place, so keep the input for the reject file
+			char * copy = strdup(line);
+			fields = csv_parse_line(&err, state, copy);
+			free(copy);
+		}
+
+		if (fields) {
+			load_throttle(state);
+			load_put_fields(&err, state, fields);
+			as_hashmap_destroy(fields);
+		}
+
+		if (err.code != AEROSPIKE_OK) {
+			load_reject(state, line_no, &err, line);
+		} else {
+			pthread_mutex_lock(&state->stats_lock);
+			state->records++;
+			pthread_mutex_unlock(&state->stats_lock);
+		}
+	}
+
+	free(line);
+	return NULL;
+}
+
+static as_status load_read_csv_header(as_error * err, load_state * state)
+{
+	char * line = NULL;
+	size_t capacity = 0;
+	ssize_t len = getline(&line, &capacity, state->file);
+
+	if (len <= 0) {
+		free(line);
+		return as_error_update(err, AEROSPIKE_ERR_PARAM, "CSV file has no header line");
+	}
+	state->line_no = 1;
+	while (len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r')) {
+		line[--len] = '\0';
+	}
+
+	// A header can't have more fields than it has commas plus one
+	int max_fields = 1;
+	for (ssize_t i = 0; i < len; i++) {
+		if (line[i] == ',') {
+			max_fields++;
+		}
+	}
+
+	char ** fields = (char **) malloc(sizeof(char *) * max_fields);
+	bool * quoted = (bool *) malloc(sizeof(bool) * max_fields);
+	int n = csv_split_line(line, fields, quoted, max_fields);
+
+	state->columns = (char **) malloc(sizeof(char *) * n);
+	state->n_columns = (uint32_t) n;
+	for (int i = 0; i < n; i++) {
+		state->columns[i] = strdup(fields[i]);
+	}
+
+	free(quoted);
+	free(fields);
+	free(line);
+	return AEROSPIKE_OK;
+}
+
+/**
+ *******************************************************************************************************
+ * Loads an NDJSON or CSV file into a set. Lines are parsed in C and written
+ * by concurrent writer threads with the GIL released.
+ *
+ *		client.load_file(path, ns, set, key_field, format, concurrency, rate, reject_path, policy)
+ *
+ * Lines that can't be parsed or written are counted and, when reject_path
+ * is given, written to it along with the error.
+ * Returns a dict with the number of records written and lines rejected.
+ * In case of error,appropriate exceptions will be raised.
+ *******************************************************************************************************
+ */
+PyObject * AerospikeClient_Load_File(AerospikeClient * self, PyObject * args, PyObject * kwds)
+{
+	char * path = NULL;
+	char * ns = NULL;
+	char * set = NULL;
+	char * key_field = NULL;
+	char * format = "ndjson";
+	char * reject_path = NULL;
+	unsigned int concurrency = LOAD_DEFAULT_CONCURRENCY;
+	unsigned int rate = 0;
+	PyObject * py_policy = NULL;
+	as_policy_write write_policy;
+	as_policy_write * write_policy_p = NULL;
+	pthread_t * threads = NULL;
+	load_state state;
+
+	static char * kwlist[] = {"path", "ns", "set", "key_field", "format", "concurrency",
+		"rate", "reject_path", "policy", NULL};
+
+	if (PyArg_ParseTupleAndKeywords(args, kwds, "ssss|sIIzO:load_file", kwlist,
+				&path, &ns, &set, &key_field, &format, &concurrency, &rate,
+				&reject_path, &py_policy) == false) {
+		return NULL;
+	}
+
+	memset(&state, 0, sizeof(state));
+
+	as_error err;
+	as_error_init(&err);
+
+	trace_span span;
+	trace_start(self, &span, "load_file");
+
+	if (!self || !self->as) {
+		as_error_update(&err, AEROSPIKE_ERR_PARAM, "Invalid aerospike object");
+		goto CLEANUP;
+	}
+	if (!self->is_conn_16) {
+		as_error_update(&err, AEROSPIKE_ERR_CLUSTER, "No connection to aerospike cluster");
+		goto CLEANUP;
+	}
+
+	if (!strcmp(format, "ndjson")) {
+		state.format = LOAD_FORMAT_NDJSON;
+	} else if (!strcmp(format, "csv")) {
+		state.format = LOAD_FORMAT_CSV;
+	} else {
+		as_error_update(&err, AEROSPIKE_ERR_PARAM, "Format should be 'ndjson' or 'csv'");
+		goto CLEANUP;
+	}
+	if (concurrency < 1 || concurrency > LOAD_MAX_CONCURRENCY) {
+		as_error_update(&err, AEROSPIKE_ERR_PARAM, "Concurrency should be between 1 and %d", LOAD_MAX_CONCURRENCY);
+		goto CLEANUP;
+	}
+	if (rate > 1000000) {
+		as_error_update(&err, AEROSPIKE_ERR_PARAM, "Rate should be at most 1000000 records per second");
+		goto CLEANUP;
+	}
+
+	pyobject_to_policy_write(&err, py_policy, &write_policy, &write_policy_p,
+			&self->as->config.policies.write);
+	if (err.code != AEROSPIKE_OK) {
+		goto CLEANUP;
+	}
+
+	state.as = self->as;
+	state.limiter = self->limiter;
+	state.breaker = self->breaker;
+	state.policy = write_policy_p;
+	state.ns = ns;
+	state.set = set;
+	state.key_field = key_field;
+	state.rate = rate;
+
+	state.file = fopen(path, "r");
+	if (!state.file) {
+		as_error_update(&err, AEROSPIKE_ERR_CLIENT, "Unable to open %s", path);
+		goto CLEANUP;
+	}
+	if (reject_path) {
+		state.reject_file = fopen(reject_path, "w");
+		if (!state.reject_file) {
+			as_error_update(&err, AEROSPIKE_ERR_CLIENT, "Unable to open %s for writing", reject_path);
+			goto CLEANUP;
+		}
+	}
+
+	pthread_mutex_init(&state.read_lock, NULL);
+	pthread_mutex_init(&state.stats_lock, NULL);
+	threads = (pthread_t *) malloc(sizeof(pthread_t) * concurrency);
+
+	Py_BEGIN_ALLOW_THREADS
+	trace_call_start(&span);
+	if (state.format == LOAD_FORMAT_NDJSON || load_read_csv_header(&err, &state) == AEROSPIKE_OK) {
+		unsigned int started = 0;
+		for (; started < concurrency; started++) {
+			if (pthread_create(&threads[started], NULL, load_worker, &state) != 0) {
+				break;
+			}
+		}
+		if (started == 0) {
+			// Could not start any thread, so load in this one
+			load_worker(&state);
+		}
+		for (unsigned int i = 0; i < started; i++) {
+			pthread_join(threads[i], NULL);
+		}
+	}
+	trace_call_end(&span);
+	Py_END_ALLOW_THREADS
+
+	// Records were written without the GIL, so drop the whole cache
+	record_cache_clear(self->cache);
+
+	pthread_mutex_destroy(&state.read_lock);
+	pthread_mutex_destroy(&state.stats_lock);
+
+	if (err.code == AEROSPIKE_OK && ferror(state.file)) {
+		as_error_update(&err, AEROSPIKE_ERR_CLIENT, "Failed to read %s", path);
+	}
+
+CLEANUP:
+	trace_end_set(self, &span, ns, set, (uint32_t) state.records, err.code);
+
+	if (threads) {
+		free(threads);
+	}
+	if (state.file) {
+		fclose(state.file);
+	}
+	if (state.reject_file) {
+		fclose(state.reject_file);
+	}
+	for (uint32_t i = 0; i < state.n_columns; i++) {
+		free(state.columns[i]);
+	}
+	if (state.columns) {
+		free(state.columns);
+	}
+
+	if (err.code != AEROSPIKE_OK) {
+		PyObject * py_err = NULL;
+		error_to_pyobject(&err, &py_err);
+		PyObject *exception_type = raise_exception(&err);
+		PyErr_SetObject(exception_type, py_err);
+		Py_DECREF(py_err);
+		return NULL;
+	}
+
+	PyObject * py_stats = PyDict_New();
+	PyObject * py_value = PyLong_FromUnsignedLongLong(state.records);
+	PyDict_SetItemString(py_stats, "records", py_value);
+	Py_DECREF(py_value);
+	py_value = PyLong_FromUnsignedLongLong(state.errors);
+	PyDict_SetItemString(py_stats, "errors", py_value);
+	Py_DECREF(py_value);
+	return py_stats;
+}
@@ -24,12 +24,17 @@
 #include <aerospike/as_record.h>
 #include <aerospike/as_operations.h>
 #include <aerospike/aerospike_info.h>
+#include "breaker.h"
+#include "cache.h"
 #include "client.h"
 #include "conversions.h"
 #include "exceptions.h"
+#include "limiter.h"
+#include "module_state.h"
 #include "policy.h"
 #include "serializer.h"
 #include "geo.h"
+#include "tracer.h"
 
 #include <aerospike/as_double.h>
 #include <aerospike/as_integer.h>
@@ -146,15 +151,15 @@ PyObject * create_pylist(PyObject * py_list, long operation, PyObject * py_bin,
  */
 int check_type(AerospikeClient * self, PyObject * py_value, int op, as_error *err)
 {
-	if ((!PyInt_Check(py_value) && !PyLong_Check(py_value) && strcmp(py_value->ob_type->tp_name, "aerospike.null")) && (op == AS_OPERATOR_TOUCH)) {
+	if ((!PyInt_Check(py_value) && !PyLong_Check(py_value) && !PyObject_TypeCheck(py_value, self->state->null_object_type)) && (op == AS_OPERATOR_TOUCH)) {
 		as_error_update(err, AEROSPIKE_ERR_PARAM, "Unsupported operand type(s) for touch : only int or long allowed");
 		return 1;
 	} else if ((!PyInt_Check(py_value) && !PyLong_Check(py_value) && (!PyFloat_Check(py_value) || !aerospike_has_double(self->as)) &&
-				strcmp(py_value->ob_type->tp_name, "aerospike.null")) && op == AS_OPERATOR_INCR) {
+				!PyObject_TypeCheck(py_value, self->state->null_object_type)) && op == AS_OPERATOR_INCR) {
 		as_error_update(err, AEROSPIKE_ERR_PARAM, "Unsupported operand type(s) for +: only 'int' allowed");
 		return 1;
 	} else if ((!PyString_Check(py_value) && !PyUnicode_Check(py_value) && !PyByteArray_Check(py_value) &&
-				strcmp(py_value->ob_type->tp_name, "aerospike.null")) && (op == AS_OPERATOR_APPEND || op == AS_OPERATOR_PREPEND)) {
+				!PyObject_TypeCheck(py_value, self->state->null_object_type)) && (op == AS_OPERATOR_APPEND || op == AS_OPERATOR_PREPEND)) {
 		as_error_update(err, AEROSPIKE_ERR_PARAM, "Cannot concatenate 'str' and 'non-str' objects");
 		return 1;
 	} else if (!PyList_Check(py_value) && op == OP_LIST_APPEND_ITEMS) {
@@ -367,7 +372,7 @@ as_status add_op(AerospikeClient * self, as_error * err, PyObject * py_val, as_v
 					as_operations_add_append_rawp(ops, bin, bytes->value, bytes->size, true);
 				}
 			} else {
-				if (!self->strict_types || !strcmp(py_value->ob_type->tp_name, "aerospike.null")) {
+				if (!self->strict_types || PyObject_TypeCheck(py_value, self->state->null_object_type)) {
 					as_operations *pointer_ops = ops;
 					as_binop *binop = &pointer_ops->binops.entries[pointer_ops->binops.size++];
 					binop->op = AS_OPERATOR_APPEND;
@@ -396,7 +401,7 @@ as_status add_op(AerospikeClient * self, as_error * err, PyObject * py_val, as_v
 					as_operations_add_prepend_rawp(ops, bin, bytes->value, bytes->size, true);
 				}
 			} else {
-				if (!self->strict_types || !strcmp(py_value->ob_type->tp_name, "aerospike.null")) {
+				if (!self->strict_types || PyObject_TypeCheck(py_value, self->state->null_object_type)) {
 					as_operations *pointer_ops = ops;
 					as_binop *binop = &pointer_ops->binops.entries[pointer_ops->binops.size++];
 					binop->op = AS_OPERATOR_PREPEND;
@@ -420,7 +425,7 @@ as_status add_op(AerospikeClient * self, as_error * err, PyObject * py_val, as_v
 				double_offset = PyFloat_AsDouble(py_value);
 				as_operations_add_incr_double(ops, bin, double_offset);
 			} else {
-				if (!self->strict_types || !strcmp(py_value->ob_type->tp_name, "aerospike.null")) {
+				if (!self->strict_types || PyObject_TypeCheck(py_value, self->state->null_object_type)) {
 					as_operations *pointer_ops = ops;
 					as_binop *binop = &pointer_ops->binops.entries[pointer_ops->binops.size++];
 					binop->op = AS_OPERATOR_INCR;
@@ -652,6 +657,10 @@ PyObject *  AerospikeClient_Operate_Invoke(
 	as_record * rec = NULL;
 	as_policy_operate operate_policy;
 	as_policy_operate *operate_policy_p = NULL;
+	bool none_on_miss = false;
+
+	trace_span span;
+	trace_start(self, &span, "operate");
 
 	as_vector * unicodeStrVector = as_vector_create(sizeof(char *), 128);
 
@@ -664,6 +673,9 @@ PyObject *  AerospikeClient_Operate_Invoke(
 				&self->as->config.policies.operate) != AEROSPIKE_OK) {
 			goto CLEANUP;
 		}
+		if (pyobject_to_policy_not_found(err, py_policy, &none_on_miss) != AEROSPIKE_OK) {
+			goto CLEANUP;
+		}
 	}
 
 	as_static_pool static_pool;
@@ -695,8 +707,18 @@ PyObject *  AerospikeClient_Operate_Invoke(
 	as_record_init(rec, 0);
 
 	Py_BEGIN_ALLOW_THREADS
-	aerospike_key_operate(self->as, err, operate_policy_p, key, &ops, &rec);
+	trace_call_start(&span);
+	if (request_limiter_acquire(self->limiter, err, LIMITER_WRITE, key, 1) == AEROSPIKE_OK) {
+		as_node * node = NULL;
+		if (circuit_breaker_check(self->breaker, self->as, err, key, &node) == AEROSPIKE_OK) {
+			aerospike_key_operate(self->as, err, operate_policy_p, key, &ops, &rec);
+			circuit_breaker_record(self->breaker, node, err->code);
+		}
+		request_limiter_release(self->limiter);
+	}
+	trace_call_end(&span);
 	Py_END_ALLOW_THREADS
+	record_cache_invalidate(self->cache, key);
 
 	if (err->code != AEROSPIKE_OK) {
 		as_error_update(err, err->code, NULL);
@@ -711,6 +733,7 @@ PyObject *  AerospikeClient_Operate_Invoke(
 	}
 
 CLEANUP:
+	trace_end(self, &span, key, err->code);
 	for (unsigned int i=0; i<unicodeStrVector->size ; i++) {
 		free(as_vector_get_ptr(unicodeStrVector, i));
 	}
@@ -726,6 +749,10 @@ CLEANUP:
 
 	as_operations_destroy(&ops);
 
+	if (err->code == AEROSPIKE_ERR_RECORD_NOT_FOUND && none_on_miss) {
+		Py_RETURN_NONE;
+	}
+
 	if (err->code != AEROSPIKE_OK) {
 		PyObject * py_err = NULL;
 		error_to_pyobject(err, &py_err);
@@ -865,8 +892,16 @@ static PyObject *  AerospikeClient_OperateOrdered_Invoke(
 		}
 
 		Py_BEGIN_ALLOW_THREADS
-		aerospike_key_operate(self->as, err, operate_policy_p, key, &ops, &rec);
+		if (request_limiter_acquire(self->limiter, err, LIMITER_WRITE, key, 1) == AEROSPIKE_OK) {
+			as_node * node = NULL;
+			if (circuit_breaker_check(self->breaker, self->as, err, key, &node) == AEROSPIKE_OK) {
+				aerospike_key_operate(self->as, err, operate_policy_p, key, &ops, &rec);
+				circuit_breaker_record(self->breaker, node, err->code);
+			}
+			request_limiter_release(self->limiter);
+		}
 		Py_END_ALLOW_THREADS
+		record_cache_invalidate(self->cache, key);
 
 		if (err->code != AEROSPIKE_OK) {
 			as_error_update(err, err->code, NULL);
@@ -24,9 +24,12 @@
 #include <aerospike/as_record.h>
 #include <aerospike/as_operations.h>
 #include <aerospike/aerospike_info.h>
+#include "breaker.h"
+#include "cache.h"
 #include "client.h"
 #include "conversions.h"
 #include "exceptions.h"
+#include "limiter.h"
 #include "policy.h"
 #include "serializer.h"
 #include "geo.h"
@@ -86,8 +89,16 @@
 
 #define DO_OPERATION(__rec)\
 	Py_BEGIN_ALLOW_THREADS\
-	aerospike_key_operate(self->as, &err, operate_policy_p, &key, &ops, __rec);\
-	Py_END_ALLOW_THREADS
+	if (request_limiter_acquire(self->limiter, &err, LIMITER_WRITE, &key, 1) == AEROSPIKE_OK) {\
+		as_node * node = NULL;\
+		if (circuit_breaker_check(self->breaker, self->as, &err, &key, &node) == AEROSPIKE_OK) {\
+			aerospike_key_operate(self->as, &err, operate_policy_p, &key, &ops, __rec);\
+			circuit_breaker_record(self->breaker, node, err.code);\
+		}\
+		request_limiter_release(self->limiter);\
+	}\
+	Py_END_ALLOW_THREADS\
+	record_cache_invalidate(self->cache, &key);
 
 #define EXCEPTION_ON_ERROR()\
 	if (key_created) {\
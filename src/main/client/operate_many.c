@@ -0,0 +1,465 @@
+/*******************************************************************************
+ * Copyright 2013-2016 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include <Python.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <aerospike/aerospike_key.h>
+#include <aerospike/as_error.h>
+#include <aerospike/as_key.h>
+#include <aerospike/as_map_operations.h>
+#include <aerospike/as_operations.h>
+#include <aerospike/as_record.h>
+
+#include "breaker.h"
+#include "cache.h"
+#include "client.h"
+#include "conversions.h"
+#include "exceptions.h"
+#include "limiter.h"
+#include "policy.h"
+#include "serializer.h"
+#include "tracer.h"
+
+// Operates run at the same time unless the caller asks for fewer
+#define OPERATE_MANY_MAX_CONCURRENCY 16
+
+typedef struct {
+	aerospike * as;
+	request_limiter * limiter;
+	circuit_breaker * breaker;
+	as_policy_operate * policy;
+	as_operations * ops;
+	as_key * keys;
+	as_error * errors;
+	uint32_t n_keys;
+	uint32_t next;
+	pthread_mutex_t lock;
+} operate_many_job;
+
+/*******************************************************************************
+ * SHARED OPERATE
+ ******************************************************************************/
+
+static void * operate_many_worker(void * udata)
+{
+	operate_many_job * job = (operate_many_job *) udata;
+
+	while (true) {
+		pthread_mutex_lock(&job->lock);
+		uint32_t i = job->next++;
+		pthread_mutex_unlock(&job->lock);
+
+		if (i >= job->n_keys) {
+			break;
+		}
+
+		if (request_limiter_acquire(job->limiter, &job->errors[i], LIMITER_WRITE,
+				&job->keys[i], 1) != AEROSPIKE_OK) {
+			continue;
+		}
+		as_node * node = NULL;
+		if (circuit_breaker_check(job->breaker, job->as, &job->errors[i], &job->keys[i],
+				&node) == AEROSPIKE_OK) {
+			// The operations only write, there is no record to return
+			aerospike_key_operate(job->as, &job->errors[i], job->policy,
+					&job->keys[i], job->ops, NULL);
+			circuit_breaker_record(job->breaker, node, job->errors[i].code);
+		}
+		request_limiter_release(job->limiter);
+	}
+	return NULL;
+}
+
+static void operate_many_run(operate_many_job * job, uint32_t concurrency)
+{
+	pthread_t threads[OPERATE_MANY_MAX_CONCURRENCY - 1];
+	uint32_t n_threads = 0;
+
+	// The calling thread runs operates too
+	while (n_threads + 1 < concurrency && n_threads + 1 < job->n_keys) {
+		if (pthread_create(&threads[n_threads], NULL, operate_many_worker, job) != 0) {
+			break;
+		}
+		n_threads++;
+	}
+	operate_many_worker(job);
+	for (uint32_t i = 0; i < n_threads; i++) {
+		pthread_join(threads[i], NULL);
+	}
+}
+
+/**
+ * Applies ops to every key in py_keys, with the GIL released, and returns a
+ * list holding 0 or the exception of each key in turn. The ops are built once
+ * by the caller and shared by all the operates. Ends the caller's span.
+ */
+static PyObject * operate_many(AerospikeClient * self, as_error * err, trace_span * span,
+		PyObject * py_keys, as_operations * ops, as_policy_operate * operate_policy_p, int concurrency)
+{
+	PyObject * py_fast = NULL;
+	PyObject * py_results = NULL;
+	operate_many_job job;
+	uint32_t n_keys = 0;
+
+	memset(&job, 0, sizeof(job));
+
+	if (concurrency < 1 || concurrency > OPERATE_MANY_MAX_CONCURRENCY) {
+		as_error_update(err, AEROSPIKE_ERR_PARAM, "concurrency should be between 1 and 16");
+		goto CLEANUP;
+	}
+
+	py_fast = PySequence_Fast(py_keys, "keys should be a list");
+	if (!py_fast) {
+		PyErr_Clear();
+		as_error_update(err, AEROSPIKE_ERR_PARAM, "keys should be a list of keys");
+		goto CLEANUP;
+	}
+
+	Py_ssize_t size = PySequence_Fast_GET_SIZE(py_fast);
+	job.as = self->as;
+	job.limiter = self->limiter;
+	job.breaker = self->breaker;
+	job.policy = operate_policy_p;
+	job.ops = ops;
+	job.keys = (as_key *) malloc(sizeof(as_key) * (size ? size : 1));
+	job.errors = (as_error *) malloc(sizeof(as_error) * (size ? size : 1));
+	job.n_keys = (uint32_t) size;
+
+	// The keys may point into the Python keys, which py_fast keeps alive
+	for (n_keys = 0; n_keys < job.n_keys; n_keys++) {
+		if (pyobject_to_key(err, PySequence_Fast_GET_ITEM(py_fast, n_keys),
+				&job.keys[n_keys]) != AEROSPIKE_OK) {
+			goto CLEANUP;
+		}
+		as_error_init(&job.errors[n_keys]);
+	}
+
+	pthread_mutex_init(&job.lock, NULL);
+	Py_BEGIN_ALLOW_THREADS
+	trace_call_start(span);
+	operate_many_run(&job, (uint32_t) concurrency);
+	trace_call_end(span);
+	Py_END_ALLOW_THREADS
+	pthread_mutex_destroy(&job.lock);
+
+	py_results = PyList_New(job.n_keys);
+	for (uint32_t i = 0; i < job.n_keys; i++) {
+		record_cache_invalidate(self->cache, &job.keys[i]);
+
+		PyObject * py_result = NULL;
+		if (job.errors[i].code == AEROSPIKE_OK) {
+			py_result = PyLong_FromLong(0);
+		} else {
+			PyObject * py_err = NULL;
+			error_to_pyobject(&job.errors[i], &py_err);
+			py_result = PyObject_CallObject(raise_exception(&job.errors[i]), py_err);
+			Py_XDECREF(py_err);
+		}
+		if (!py_result) {
+			Py_CLEAR(py_results);
+			goto CLEANUP;
+		}
+		PyList_SET_ITEM(py_results, i, py_result);
+	}
+
+CLEANUP:
+	if (err->code == AEROSPIKE_OK && py_results) {
+		// The span carries the first failure of the keys
+		as_status status = AEROSPIKE_OK;
+		for (uint32_t i = 0; i < job.n_keys && status == AEROSPIKE_OK; i++) {
+			status = job.errors[i].code;
+		}
+		trace_end_batch(self, span, job.n_keys ? &job.keys[0] : NULL, job.n_keys, status);
+	} else {
+		trace_end_batch(self, span, n_keys ? &job.keys[0] : NULL, n_keys, err->code);
+	}
+	for (uint32_t i = 0; i < n_keys; i++) {
+		as_key_destroy(&job.keys[i]);
+	}
+	free(job.keys);
+	free(job.errors);
+	Py_XDECREF(py_fast);
+
+	return py_results;
+}
+
+static PyObject * operate_many_result(as_error * err, PyObject * py_results)
+{
+	if (err->code != AEROSPIKE_OK) {
+		PyObject * py_err = NULL;
+		error_to_pyobject(err, &py_err);
+		PyObject *exception_type = raise_exception(err);
+		PyErr_SetObject(exception_type, py_err);
+		Py_DECREF(py_err);
+		return NULL;
+	}
+	return py_results;
+}
+
+static bool operate_many_setup(AerospikeClient * self, as_error * err, PyObject * py_bin,
+		char ** bin, PyObject * py_meta, as_operations * ops, PyObject * py_policy,
+		as_policy_operate * operate_policy, as_policy_operate ** operate_policy_p)
+{
+	if (!self || !self->as) {
+		as_error_update(err, AEROSPIKE_ERR_PARAM, "Invalid aerospike object");
+		return false;
+	}
+	if (!self->is_conn_16) {
+		as_error_update(err, AEROSPIKE_ERR_CLUSTER, "No connection to aerospike cluster");
+		return false;
+	}
+	if (py_policy) {
+		if (pyobject_to_policy_operate(err, py_policy, operate_policy, operate_policy_p,
+				&self->as->config.policies.operate) != AEROSPIKE_OK) {
+			return false;
+		}
+	}
+	if (py_meta) {
+		if (check_for_meta(py_meta, ops, err) != AEROSPIKE_OK) {
+			return false;
+		}
+	}
+	if (bin_strict_type_checking(self, err, py_bin, bin) != AEROSPIKE_OK) {
+		// Report the bin error like the other errors
+		PyErr_Clear();
+		return false;
+	}
+	// The shared operation copies the name into a fixed size bin
+	if (strlen(*bin) > AS_BIN_NAME_MAX_LEN) {
+		as_error_update(err, AEROSPIKE_ERR_BIN_NAME, "A bin name should not exceed 14 characters limit");
+		return false;
+	}
+	return true;
+}
+
+/*******************************************************************************
+ * MULTI-KEY CDT OPERATIONS
+ ******************************************************************************/
+
+/**
+ *******************************************************************************************************
+ * Puts one item into the map bin of every record in keys.
+ *
+ *		client.map_put_many(keys, bin, map_key, val, map_policy, meta, policy, concurrency=16, serializer)
+ *
+ * Returns a list with 0 or the exception of each key in turn.
+ * In case of error,appropriate exceptions will be raised.
+ *******************************************************************************************************
+ */
+PyObject * AerospikeClient_MapPut_Many(AerospikeClient * self, PyObject * args, PyObject * kwds)
+{
+	PyObject * py_keys = NULL;
+	PyObject * py_bin = NULL;
+	PyObject * py_mapKey = NULL;
+	PyObject * py_mapValue = NULL;
+	PyObject * py_mapPolicy = NULL;
+	PyObject * py_meta = NULL;
+	PyObject * py_policy = NULL;
+	PyObject * py_results = NULL;
+	PyObject * py_serializer = NULL;
+	int concurrency = OPERATE_MANY_MAX_CONCURRENCY;
+
+	static char * kwlist[] = {"keys", "bin", "map_key", "val", "map_policy", "meta", "policy", "concurrency",
+		"serializer", NULL};
+	if (PyArg_ParseTupleAndKeywords(args, kwds, "OOOO|OOOiO:map_put_many", kwlist,
+				&py_keys, &py_bin, &py_mapKey, &py_mapValue, &py_mapPolicy, &py_meta, &py_policy,
+				&concurrency, &py_serializer) == false) {
+		return NULL;
+	}
+
+	as_error err;
+	as_error_init(&err);
+	trace_span span;
+	trace_start(self, &span, "map_put_many");
+	as_operations ops;
+	as_operations_inita(&ops, 1);
+	as_policy_operate operate_policy;
+	as_policy_operate * operate_policy_p = NULL;
+	as_map_policy map_policy;
+	as_map_policy_init(&map_policy);
+	as_static_pool static_pool;
+	memset(&static_pool, 0, sizeof(static_pool));
+	as_val * put_key = NULL;
+	as_val * put_val = NULL;
+	char * bin = NULL;
+
+	if (!operate_many_setup(self, &err, py_bin, &bin, py_meta, &ops, py_policy,
+			&operate_policy, &operate_policy_p)) {
+		goto CLEANUP;
+	}
+	if (py_mapPolicy) {
+		if (pyobject_to_map_policy(&err, py_mapPolicy, &map_policy) != AEROSPIKE_OK) {
+			goto CLEANUP;
+		}
+	}
+	long serializer_option = serializer_option_from_pyobject(self, py_serializer);
+	serializer_batch values;
+	serializer_batch_begin(self, &values);
+	if (pyobject_to_val(self, &err, py_mapKey, &put_key, &static_pool, serializer_option) == AEROSPIKE_OK) {
+		pyobject_to_val(self, &err, py_mapValue, &put_val, &static_pool, serializer_option);
+	}
+	if (serializer_batch_end(&values, &err) != AEROSPIKE_OK) {
+		goto CLEANUP;
+	}
+	as_operations_add_map_put(&ops, bin, &map_policy, put_key, put_val);
+
+	py_results = operate_many(self, &err, &span, py_keys, &ops, operate_policy_p, concurrency);
+
+CLEANUP:
+	// Ends the span when operate_many was not reached
+	trace_end_batch(self, &span, NULL, 0, err.code);
+	as_operations_destroy(&ops);
+	return operate_many_result(&err, py_results);
+}
+
+/**
+ *******************************************************************************************************
+ * Puts the items of a dict into the map bin of every record in keys.
+ *
+ *		client.map_put_items_many(keys, bin, items, map_policy, meta, policy, concurrency=16, serializer)
+ *
+ * Returns a list with 0 or the exception of each key in turn.
+ * In case of error,appropriate exceptions will be raised.
+ *******************************************************************************************************
+ */
+PyObject * AerospikeClient_MapPutItems_Many(AerospikeClient * self, PyObject * args, PyObject * kwds)
+{
+	PyObject * py_keys = NULL;
+	PyObject * py_bin = NULL;
+	PyObject * py_items = NULL;
+	PyObject * py_mapPolicy = NULL;
+	PyObject * py_meta = NULL;
+	PyObject * py_policy = NULL;
+	PyObject * py_results = NULL;
+	PyObject * py_serializer = NULL;
+	int concurrency = OPERATE_MANY_MAX_CONCURRENCY;
+
+	static char * kwlist[] = {"keys", "bin", "items", "map_policy", "meta", "policy", "concurrency",
+		"serializer", NULL};
+	if (PyArg_ParseTupleAndKeywords(args, kwds, "OOO|OOOiO:map_put_items_many", kwlist,
+				&py_keys, &py_bin, &py_items, &py_mapPolicy, &py_meta, &py_policy,
+				&concurrency, &py_serializer) == false) {
+		return NULL;
+	}
+
+	as_error err;
+	as_error_init(&err);
+	trace_span span;
+	trace_start(self, &span, "map_put_items_many");
+	as_operations ops;
+	as_operations_inita(&ops, 1);
+	as_policy_operate operate_policy;
+	as_policy_operate * operate_policy_p = NULL;
+	as_map_policy map_policy;
+	as_map_policy_init(&map_policy);
+	as_static_pool static_pool;
+	memset(&static_pool, 0, sizeof(static_pool));
+	as_map * put_items = NULL;
+	char * bin = NULL;
+
+	if (!operate_many_setup(self, &err, py_bin, &bin, py_meta, &ops, py_policy,
+			&operate_policy, &operate_policy_p)) {
+		goto CLEANUP;
+	}
+	if (py_mapPolicy) {
+		if (pyobject_to_map_policy(&err, py_mapPolicy, &map_policy) != AEROSPIKE_OK) {
+			goto CLEANUP;
+		}
+	}
+	long serializer_option = serializer_option_from_pyobject(self, py_serializer);
+	serializer_batch values;
+	serializer_batch_begin(self, &values);
+	pyobject_to_map(self, &err, py_items, &put_items, &static_pool, serializer_option);
+	if (serializer_batch_end(&values, &err) != AEROSPIKE_OK) {
+		goto CLEANUP;
+	}
+	as_operations_add_map_put_items(&ops, bin, &map_policy, put_items);
+
+	py_results = operate_many(self, &err, &span, py_keys, &ops, operate_policy_p, concurrency);
+
+CLEANUP:
+	// Ends the span when operate_many was not reached
+	trace_end_batch(self, &span, NULL, 0, err.code);
+	as_operations_destroy(&ops);
+	return operate_many_result(&err, py_results);
+}
+
+/**
+ *******************************************************************************************************
+ * Appends a value to the list bin of every record in keys.
+ *
+ *		client.list_append_many(keys, bin, val, meta, policy, concurrency=16, serializer)
+ *
+ * Returns a list with 0 or the exception of each key in turn.
+ * In case of error,appropriate exceptions will be raised.
+ *******************************************************************************************************
+ */
+PyObject * AerospikeClient_ListAppend_Many(AerospikeClient * self, PyObject * args, PyObject * kwds)
+{
+	PyObject * py_keys = NULL;
+	PyObject * py_bin = NULL;
+	PyObject * py_append_val = NULL;
+	PyObject * py_meta = NULL;
+	PyObject * py_policy = NULL;
+	PyObject * py_results = NULL;
+	PyObject * py_serializer = NULL;
+	int concurrency = OPERATE_MANY_MAX_CONCURRENCY;
+
+	static char * kwlist[] = {"keys", "bin", "val", "meta", "policy", "concurrency", "serializer", NULL};
+	if (PyArg_ParseTupleAndKeywords(args, kwds, "OOO|OOiO:list_append_many", kwlist,
+				&py_keys, &py_bin, &py_append_val, &py_meta, &py_policy, &concurrency,
+				&py_serializer) == false) {
+		return NULL;
+	}
+
+	as_error err;
+	as_error_init(&err);
+	trace_span span;
+	trace_start(self, &span, "list_append_many");
+	as_operations ops;
+	as_operations_inita(&ops, 1);
+	as_policy_operate operate_policy;
+	as_policy_operate * operate_policy_p = NULL;
+	as_static_pool static_pool;
+	memset(&static_pool, 0, sizeof(static_pool));
+	as_val * put_val = NULL;
+	char * bin = NULL;
+
+	if (!operate_many_setup(self, &err, py_bin, &bin, py_meta, &ops, py_policy,
+			&operate_policy, &operate_policy_p)) {
+		goto CLEANUP;
+	}
+	long serializer_option = serializer_option_from_pyobject(self, py_serializer);
+	serializer_batch values;
+	serializer_batch_begin(self, &values);
+	pyobject_to_astype_write(self, &err, py_append_val, &put_val, &static_pool, serializer_option);
+	if (serializer_batch_end(&values, &err) != AEROSPIKE_OK) {
+		goto CLEANUP;
+	}
+	as_operations_add_list_append(&ops, bin, put_val);
+
+	py_results = operate_many(self, &err, &span, py_keys, &ops, operate_policy_p, concurrency);
+
+CLEANUP:
+	// Ends the span when operate_many was not reached
+	trace_end_batch(self, &span, NULL, 0, err.code);
+	as_operations_destroy(&ops);
+	return operate_many_result(&err, py_results);
+}
@@ -25,9 +25,12 @@
 #include <aerospike/as_operations.h>
 #include <aerospike/as_map_operations.h>
 #include <aerospike/aerospike_info.h>
+#include "breaker.h"
+#include "cache.h"
 #include "client.h"
 #include "conversions.h"
 #include "exceptions.h"
+#include "limiter.h"
 #include "policy.h"
 #include "serializer.h"
 
@@ -92,8 +95,16 @@
 
 #define DO_OPERATION()\
 	Py_BEGIN_ALLOW_THREADS\
-	aerospike_key_operate(self->as, &err, operate_policy_p, &key, &ops, &rec);\
-	Py_END_ALLOW_THREADS
+	if (request_limiter_acquire(self->limiter, &err, LIMITER_WRITE, &key, 1) == AEROSPIKE_OK) {\
+		as_node * node = NULL;\
+		if (circuit_breaker_check(self->breaker, self->as, &err, &key, &node) == AEROSPIKE_OK) {\
+			aerospike_key_operate(self->as, &err, operate_policy_p, &key, &ops, &rec);\
+			circuit_breaker_record(self->breaker, node, err.code);\
+		}\
+		request_limiter_release(self->limiter);\
+	}\
+	Py_END_ALLOW_THREADS\
+	record_cache_invalidate(self->cache, &key);
 
 #define SETUP_RETURN_VAL()\
 	if (rec && rec->bins.size) {\
@@ -143,7 +154,14 @@ PyObject * AerospikeClient_MapSetPolicy(AerospikeClient * self, PyObject * args,
 	as_operations_add_map_set_policy(&ops, bin, &map_policy);
 
 	Py_BEGIN_ALLOW_THREADS
-	aerospike_key_operate(self->as, &err, NULL, &key, &ops, &rec);
+	if (request_limiter_acquire(self->limiter, &err, LIMITER_WRITE, &key, 1) == AEROSPIKE_OK) {
+		as_node * node = NULL;
+		if (circuit_breaker_check(self->breaker, self->as, &err, &key, &node) == AEROSPIKE_OK) {
+			aerospike_key_operate(self->as, &err, NULL, &key, &ops, &rec);
+			circuit_breaker_record(self->breaker, node, err.code);
+		}
+		request_limiter_release(self->limiter);
+	}
 	Py_END_ALLOW_THREADS
 
 CLEANUP:
@@ -22,10 +22,15 @@
 #include <aerospike/as_error.h>
 #include <aerospike/as_record.h>
 
+#include "breaker.h"
+#include "cache.h"
 #include "client.h"
 #include "conversions.h"
 #include "exceptions.h"
+#include "limiter.h"
 #include "policy.h"
+#include "serializer.h"
+#include "tracer.h"
 
 /**
  *******************************************************************************************************
@@ -68,6 +73,9 @@ PyObject * AerospikeClient_Put_Invoke(
 	// Initialize error
 	as_error_init(&err);
 
+	trace_span span;
+	trace_start(self, &span, "put");
+
 	if (!self || !self->as) {
 		as_error_update(&err, AEROSPIKE_ERR_PARAM, "Invalid aerospike object");
 		goto CLEANUP;
@@ -87,7 +95,10 @@ PyObject * AerospikeClient_Put_Invoke(
 	key_initialised = true;
 
 	// Convert python bins and metadata objects to as_record
+	serializer_batch values;
+	serializer_batch_begin(self, &values);
 	pyobject_to_record(self, &err, py_bins, py_meta, &rec, serializer_option, &static_pool);
+	serializer_batch_end(&values, &err);
 	if (err.code != AEROSPIKE_OK) {
 		goto CLEANUP;
 	}
@@ -101,13 +112,24 @@ PyObject * AerospikeClient_Put_Invoke(
 
 	// Invoke operation
 	Py_BEGIN_ALLOW_THREADS
-	aerospike_key_put(self->as, &err, write_policy_p, &key, &rec);
+	trace_call_start(&span);
+	if (request_limiter_acquire(self->limiter, &err, LIMITER_WRITE, &key, 1) == AEROSPIKE_OK) {
+		as_node * node = NULL;
+		if (circuit_breaker_check(self->breaker, self->as, &err, &key, &node) == AEROSPIKE_OK) {
+			aerospike_key_put(self->as, &err, write_policy_p, &key, &rec);
+			circuit_breaker_record(self->breaker, node, err.code);
+		}
+		request_limiter_release(self->limiter);
+	}
+	trace_call_end(&span);
 	Py_END_ALLOW_THREADS
+	record_cache_invalidate(self->cache, &key);
 	if (err.code != AEROSPIKE_OK) {
 		as_error_update(&err, err.code, NULL);
 	}
 
 CLEANUP:
+	trace_end(self, &span, key_initialised ? &key : NULL, err.code);
 	POOL_DESTROY(&static_pool);
 
 	if (key_initialised == true) {
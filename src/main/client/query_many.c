@@ -0,0 +1,473 @@
+/*******************************************************************************
+ * Copyright 2013-2016 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include <Python.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <aerospike/aerospike_query.h>
+#include <aerospike/as_arraylist.h>
+#include <aerospike/as_bytes.h>
+#include <aerospike/as_double.h>
+#include <aerospike/as_error.h>
+#include <aerospike/as_geojson.h>
+#include <aerospike/as_integer.h>
+#include <aerospike/as_query.h>
+#include <aerospike/as_record.h>
+#include <aerospike/as_record_iterator.h>
+#include <aerospike/as_string.h>
+
+#include "client.h"
+#include "conversions.h"
+#include "exceptions.h"
+#include "module_state.h"
+#include "policy.h"
+#include "query.h"
+#include "tracer.h"
+
+// Queries run at the same time unless the caller asks for fewer
+#define QUERY_MANY_MAX_CONCURRENCY 16
+
+typedef enum {
+	QUERY_MANY_PER_QUERY,
+	QUERY_MANY_CONCAT,
+	QUERY_MANY_DEDUP
+} query_many_merge;
+
+// Digests of the records already returned, for merge='dedup_by_digest'
+typedef struct {
+	as_digest_value * slots;
+	bool * used;
+	uint32_t capacity;
+	uint32_t size;
+} query_many_digests;
+
+typedef struct {
+	as_query * query;
+	as_arraylist results;
+	pthread_mutex_t lock;
+	as_error error;
+} query_many_task;
+
+typedef struct {
+	aerospike * as;
+	as_policy_query * policy;
+	query_many_task * tasks;
+	uint32_t n_tasks;
+	uint32_t next;
+	pthread_mutex_t lock;
+	query_many_merge merge;
+	query_many_digests digests;
+} query_many_job;
+
+typedef struct {
+	query_many_job * job;
+	query_many_task * task;
+} query_many_udata;
+
+/*******************************************************************************
+ * DIGEST SET
+ ******************************************************************************/
+
+static void digests_grow(query_many_digests * digests);
+
+/**
+ * Adds the digest, returning false if it was already there. Must hold the
+ * job's lock.
+ */
+static bool digests_add(query_many_digests * digests, const uint8_t * digest)
+{
+	if ((digests->size + 1) * 2 > digests->capacity) {
+		digests_grow(digests);
+	}
+
+	uint32_t hash;
+	memcpy(&hash, digest, sizeof(hash));
+	uint32_t i = hash & (digests->capacity - 1);
+
+	while (digests->used[i]) {
+		if (!memcmp(digests->slots[i], digest, AS_DIGEST_VALUE_SIZE)) {
+			return false;
+		}
+		i = (i + 1) & (digests->capacity - 1);
+	}
+	memcpy(digests->slots[i], digest, AS_DIGEST_VALUE_SIZE);
+	digests->used[i] = true;
+	digests->size++;
+	return true;
+}
+
+static void digests_grow(query_many_digests * digests)
+{
+	query_many_digests grown;
+	grown.capacity = digests->capacity ? digests->capacity * 2 : 1024;
+	grown.size = 0;
+	grown.slots = (as_digest_value *) malloc(sizeof(as_digest_value) * grown.capacity);
+	grown.used = (bool *) calloc(grown.capacity, sizeof(bool));
+
+	for (uint32_t i = 0; i < digests->capacity; i++) {
+		if (digests->used[i]) {
+			digests_add(&grown, digests->slots[i]);
+		}
+	}
+	free(digests->slots);
+	free(digests->used);
+	*digests = grown;
+}
+
+/*******************************************************************************
+ * RECORD COPY
+ ******************************************************************************/
+
+/**
+ * Copies a bin value. Scalar values of the records handed to a query
+ * callback live in the callback's stack frame, so they can't be reserved.
+ */
+static as_val * query_many_val_copy(const as_val * val)
+{
+	switch (as_val_type(val)) {
+		case AS_INTEGER:
+			return (as_val *) as_integer_new(as_integer_get((as_integer *) val));
+		case AS_DOUBLE:
+			return (as_val *) as_double_new(as_double_get((as_double *) val));
+		case AS_STRING:
+			return (as_val *) as_string_new(strdup(as_string_get((as_string *) val)), true);
+		case AS_GEOJSON:
+			return (as_val *) as_geojson_new(strdup(as_geojson_get((as_geojson *) val)), true);
+		case AS_BYTES: {
+			as_bytes * bytes = (as_bytes *) val;
+			uint32_t size = as_bytes_size(bytes);
+			uint8_t * data = (uint8_t *) malloc(size ? size : 1);
+			memcpy(data, as_bytes_get(bytes), size);
+			as_bytes * copy = as_bytes_new_wrap(data, size, true);
+			as_bytes_set_type(copy, as_bytes_get_type(bytes));
+			return (as_val *) copy;
+		}
+		default:
+			// Lists, maps and nil are allocated on their own
+			return as_val_reserve((as_val *) val);
+	}
+}
+
+static as_record * query_many_record_copy(const as_record * rec)
+{
+	as_record * copy = as_record_new(rec->bins.size);
+	const as_key * key = &rec->key;
+
+	if (key->valuep) {
+		as_val * key_val = (as_val *) key->valuep;
+		switch (as_val_type(key_val)) {
+			case AS_INTEGER:
+				as_key_init_int64(&copy->key, key->ns, key->set, as_integer_get((as_integer *) key_val));
+				break;
+			case AS_STRING:
+				as_key_init_strp(&copy->key, key->ns, key->set, strdup(as_string_get((as_string *) key_val)), true);
+				break;
+			case AS_BYTES: {
+				as_bytes * bytes = (as_bytes *) key_val;
+				uint32_t size = as_bytes_size(bytes);
+				uint8_t * data = (uint8_t *) malloc(size ? size : 1);
+				memcpy(data, as_bytes_get(bytes), size);
+				as_key_init_rawp(&copy->key, key->ns, key->set, data, size, true);
+				break;
+			}
+			default:
+				as_key_init_digest(&copy->key, key->ns, key->set, key->digest.value);
+				break;
+		}
+	} else {
+		as_key_init_digest(&copy->key, key->ns, key->set, key->digest.value);
+	}
+	copy->key.digest = key->digest;
+
+	copy->gen = rec->gen;
+	copy->ttl = rec->ttl;
+
+	as_record_iterator it;
+	as_record_iterator_init(&it, rec);
+	while (as_record_iterator_has_next(&it)) {
+		as_bin * bin = as_record_iterator_next(&it);
+		as_val * val = (as_val *) as_bin_get_value(bin);
+		if (val) {
+			as_record_set(copy, as_bin_get_name(bin), (as_bin_value *) query_many_val_copy(val));
+		}
+	}
+	as_record_iterator_destroy(&it);
+	return copy;
+}
+
+/*******************************************************************************
+ * EXECUTION
+ ******************************************************************************/
+
+static bool query_many_each(const as_val * val, void * udata)
+{
+	if (!val) {
+		return false;
+	}
+
+	query_many_udata * data = (query_many_udata *) udata;
+	as_record * rec = as_record_fromval(val);
+
+	if (rec && data->job->merge == QUERY_MANY_DEDUP) {
+		pthread_mutex_lock(&data->job->lock);
+		bool added = digests_add(&data->job->digests, rec->key.digest.value);
+		pthread_mutex_unlock(&data->job->lock);
+		if (!added) {
+			return true;
+		}
+	}
+
+	as_val * copy = rec ? (as_val *) query_many_record_copy(rec) : as_val_reserve((as_val *) val);
+
+	pthread_mutex_lock(&data->task->lock);
+	as_arraylist_append(&data->task->results, copy);
+	pthread_mutex_unlock(&data->task->lock);
+	return true;
+}
+
+static void * query_many_worker(void * udata)
+{
+	query_many_job * job = (query_many_job *) udata;
+
+	while (true) {
+		pthread_mutex_lock(&job->lock);
+		uint32_t i = job->next++;
+		pthread_mutex_unlock(&job->lock);
+
+		if (i >= job->n_tasks) {
+			break;
+		}
+
+		query_many_udata data = {job, &job->tasks[i]};
+		aerospike_query_foreach(job->as, &job->tasks[i].error, job->policy,
+				job->tasks[i].query, query_many_each, &data);
+	}
+	return NULL;
+}
+
+static void query_many_run(query_many_job * job, uint32_t concurrency)
+{
+	pthread_t threads[QUERY_MANY_MAX_CONCURRENCY - 1];
+	uint32_t n_threads = 0;
+
+	// The calling thread runs queries too
+	while (n_threads + 1 < concurrency && n_threads + 1 < job->n_tasks) {
+		if (pthread_create(&threads[n_threads], NULL, query_many_worker, job) != 0) {
+			break;
+		}
+		n_threads++;
+	}
+	query_many_worker(job);
+	for (uint32_t i = 0; i < n_threads; i++) {
+		pthread_join(threads[i], NULL);
+	}
+}
+
+static as_status query_many_append_results(AerospikeClient * self, as_error * err,
+		query_many_task * task, PyObject * py_results)
+{
+	uint32_t size = as_arraylist_size(&task->results);
+
+	for (uint32_t i = 0; i < size; i++) {
+		PyObject * py_result = NULL;
+		val_to_pyobject(self, err, as_arraylist_get(&task->results, i), &py_result);
+		if (err->code != AEROSPIKE_OK) {
+			return err->code;
+		}
+		if (py_result) {
+			PyList_Append(py_results, py_result);
+			Py_DECREF(py_result);
+		}
+	}
+	return AEROSPIKE_OK;
+}
+
+/**
+ *******************************************************************************************************
+ * Runs several queries at the same time with the GIL released, and returns
+ * their results.
+ *
+ *		client.query_many([q1, q2], merge='dedup_by_digest', concurrency=16, policy={})
+ *
+ * merge='concat' returns one list with the results of each query in turn,
+ * 'dedup_by_digest' the same list with each record only once, and None a
+ * list of result lists, one per query.
+ *
+ * In case of error,appropriate exceptions will be raised.
+ *******************************************************************************************************
+ */
+PyObject * AerospikeClient_Query_Many(AerospikeClient * self, PyObject * args, PyObject * kwds)
+{
+	PyObject * py_queries = NULL;
+	PyObject * py_merge = NULL;
+	PyObject * py_policy = NULL;
+	PyObject * py_fast = NULL;
+	PyObject * py_results = NULL;
+	int concurrency = QUERY_MANY_MAX_CONCURRENCY;
+	query_many_job job;
+	uint32_t n_tasks = 0;
+
+	static char * kwlist[] = {"queries", "merge", "concurrency", "policy", NULL};
+
+	if (PyArg_ParseTupleAndKeywords(args, kwds, "O|OiO:query_many", kwlist,
+				&py_queries, &py_merge, &concurrency, &py_policy) == false) {
+		return NULL;
+	}
+
+	as_error err;
+	as_error_init(&err);
+
+	memset(&job, 0, sizeof(job));
+	job.merge = QUERY_MANY_CONCAT;
+
+	as_policy_query query_policy;
+	as_policy_query * query_policy_p = NULL;
+
+	trace_span span;
+	trace_start(self, &span, "query_many");
+
+	if (!self || !self->as) {
+		as_error_update(&err, AEROSPIKE_ERR_PARAM, "Invalid aerospike object");
+		goto CLEANUP;
+	}
+	if (!self->is_conn_16) {
+		as_error_update(&err, AEROSPIKE_ERR_CLUSTER, "No connection to aerospike cluster");
+		goto CLEANUP;
+	}
+
+	if (py_merge == Py_None) {
+		job.merge = QUERY_MANY_PER_QUERY;
+	} else if (py_merge) {
+		char * merge = PyString_Check(py_merge) ? PyString_AsString(py_merge) : NULL;
+		if (merge && !strcmp(merge, "concat")) {
+			job.merge = QUERY_MANY_CONCAT;
+		} else if (merge && !strcmp(merge, "dedup_by_digest")) {
+			job.merge = QUERY_MANY_DEDUP;
+		} else {
+			as_error_update(&err, AEROSPIKE_ERR_PARAM, "merge should be 'concat', 'dedup_by_digest' or None");
+			goto CLEANUP;
+		}
+	}
+
+	if (concurrency < 1 || concurrency > QUERY_MANY_MAX_CONCURRENCY) {
+		as_error_update(&err, AEROSPIKE_ERR_PARAM, "concurrency should be between 1 and 16");
+		goto CLEANUP;
+	}
+
+	py_fast = PySequence_Fast(py_queries, "queries should be a list");
+	if (!py_fast) {
+		PyErr_Clear();
+		as_error_update(&err, AEROSPIKE_ERR_PARAM, "queries should be a list of Query objects");
+		goto CLEANUP;
+	}
+
+	Py_ssize_t size = PySequence_Fast_GET_SIZE(py_fast);
+	for (Py_ssize_t i = 0; i < size; i++) {
+		PyObject * py_query = PySequence_Fast_GET_ITEM(py_fast, i);
+		if (!PyObject_TypeCheck(py_query, self->state->query_type)) {
+			as_error_update(&err, AEROSPIKE_ERR_PARAM, "queries should be a list of Query objects");
+			goto CLEANUP;
+		}
+	}
+
+	pyobject_to_policy_query(&err, py_policy, &query_policy, &query_policy_p,
+			&self->as->config.policies.query);
+	if (err.code != AEROSPIKE_OK) {
+		goto CLEANUP;
+	}
+
+	job.as = self->as;
+	job.policy = query_policy_p;
+	job.tasks = (query_many_task *) calloc(size ? size : 1, sizeof(query_many_task));
+	job.n_tasks = (uint32_t) size;
+	pthread_mutex_init(&job.lock, NULL);
+
+	for (n_tasks = 0; n_tasks < job.n_tasks; n_tasks++) {
+		query_many_task * task = &job.tasks[n_tasks];
+		task->query = &((AerospikeQuery *) PySequence_Fast_GET_ITEM(py_fast, n_tasks))->query;
+		as_arraylist_init(&task->results, 64, 64);
+		pthread_mutex_init(&task->lock, NULL);
+		as_error_init(&task->error);
+	}
+
+	// The queries are kept alive by py_fast while the GIL is released
+	Py_BEGIN_ALLOW_THREADS
+	trace_call_start(&span);
+	query_many_run(&job, (uint32_t) concurrency);
+	trace_call_end(&span);
+	Py_END_ALLOW_THREADS
+
+	for (uint32_t i = 0; i < job.n_tasks; i++) {
+		if (job.tasks[i].error.code != AEROSPIKE_OK) {
+			as_error_copy(&err, &job.tasks[i].error);
+			goto CLEANUP;
+		}
+	}
+
+	py_results = PyList_New(0);
+	for (uint32_t i = 0; i < job.n_tasks; i++) {
+		if (job.merge == QUERY_MANY_PER_QUERY) {
+			PyObject * py_query_results = PyList_New(0);
+			PyList_Append(py_results, py_query_results);
+			Py_DECREF(py_query_results);
+			query_many_append_results(self, &err, &job.tasks[i], py_query_results);
+		} else {
+			query_many_append_results(self, &err, &job.tasks[i], py_results);
+		}
+		if (err.code != AEROSPIKE_OK) {
+			Py_CLEAR(py_results);
+			goto CLEANUP;
+		}
+	}
+
+CLEANUP:
+	if (n_tasks) {
+		// The span is keyed on the namespace and set of the first query
+		uint32_t n_records = 0;
+		for (uint32_t i = 0; i < n_tasks; i++) {
+			n_records += as_arraylist_size(&job.tasks[i].results);
+		}
+		trace_end_set(self, &span, job.tasks[0].query->ns, job.tasks[0].query->set, n_records, err.code);
+	} else {
+		trace_end_set(self, &span, NULL, NULL, 0, err.code);
+	}
+
+	for (uint32_t i = 0; i < n_tasks; i++) {
+		as_arraylist_destroy(&job.tasks[i].results);
+		pthread_mutex_destroy(&job.tasks[i].lock);
+	}
+	if (job.tasks) {
+		free(job.tasks);
+		pthread_mutex_destroy(&job.lock);
+	}
+	free(job.digests.slots);
+	free(job.digests.used);
+	Py_XDECREF(py_fast);
+
+	if (err.code != AEROSPIKE_OK) {
+		PyObject * py_err = NULL;
+		error_to_pyobject(&err, &py_err);
+		PyObject *exception_type = raise_exception(&err);
+		PyErr_SetObject(exception_type, py_err);
+		Py_DECREF(py_err);
+		return NULL;
+	}
+
+	return py_results;
+}
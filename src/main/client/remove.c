@@ -22,10 +22,14 @@
 #include <aerospike/as_error.h>
 #include <aerospike/as_record.h>
 
+#include "breaker.h"
+#include "cache.h"
 #include "client.h"
 #include "conversions.h"
 #include "exceptions.h"
+#include "limiter.h"
 #include "policy.h"
+#include "tracer.h"
 
 /**
  *******************************************************************************************************
@@ -57,6 +61,9 @@ PyObject * AerospikeClient_Remove_Invoke(
 	// Initialize error
 	as_error_init(&err);
 
+	trace_span span;
+	trace_start(self, &span, "remove");
+
 	if (!self || !self->as) {
 		as_error_update(&err, AEROSPIKE_ERR_PARAM, "Invalid aerospike object");
 		goto CLEANUP;
@@ -104,13 +111,24 @@ PyObject * AerospikeClient_Remove_Invoke(
 
 	// Invoke operation
 	Py_BEGIN_ALLOW_THREADS
-	aerospike_key_remove(self->as, &err, remove_policy_p, &key);
+	trace_call_start(&span);
+	if (request_limiter_acquire(self->limiter, &err, LIMITER_WRITE, &key, 1) == AEROSPIKE_OK) {
+		as_node * node = NULL;
+		if (circuit_breaker_check(self->breaker, self->as, &err, &key, &node) == AEROSPIKE_OK) {
+			aerospike_key_remove(self->as, &err, remove_policy_p, &key);
+			circuit_breaker_record(self->breaker, node, err.code);
+		}
+		request_limiter_release(self->limiter);
+	}
+	trace_call_end(&span);
 	Py_END_ALLOW_THREADS
+	record_cache_invalidate(self->cache, &key);
 	if (err.code != AEROSPIKE_OK) {
 		as_error_update(&err, err.code, NULL);
 	}
 
 CLEANUP:
+	trace_end(self, &span, key_initialised ? &key : NULL, err.code);
 
 	if (key_initialised == true) {
 		// Destroy the key if it is initialised successfully.
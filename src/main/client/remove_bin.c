@@ -22,9 +22,12 @@
 #include <aerospike/as_error.h>
 #include <aerospike/as_record.h>
 
+#include "breaker.h"
+#include "cache.h"
 #include "client.h"
 #include "conversions.h"
 #include "exceptions.h"
+#include "limiter.h"
 #include "policy.h"
 
 /**
@@ -142,8 +145,16 @@ PyObject * AerospikeClient_RemoveBin_Invoke(
 	}
 
 	Py_BEGIN_ALLOW_THREADS
-	aerospike_key_put(self->as, err, write_policy_p, &key, &rec);
+	if (request_limiter_acquire(self->limiter, err, LIMITER_WRITE, &key, 1) == AEROSPIKE_OK) {
+		as_node * node = NULL;
+		if (circuit_breaker_check(self->breaker, self->as, err, &key, &node) == AEROSPIKE_OK) {
+			aerospike_key_put(self->as, err, write_policy_p, &key, &rec);
+			circuit_breaker_record(self->breaker, node, err->code);
+		}
+		request_limiter_release(self->limiter);
+	}
 	Py_END_ALLOW_THREADS
+	record_cache_invalidate(self->cache, &key);
 	if (err->code != AEROSPIKE_OK) {
 		as_error_update(err, err->code, NULL);
 		goto CLEANUP;
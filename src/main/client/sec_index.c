@@ -51,6 +51,7 @@ PyObject * AerospikeClient_Index_Integer_Create(AerospikeClient * self, PyObject
 
 	// Python Function Arguments
 	PyObject * py_policy = NULL;
+	PyObject * py_wait = NULL;
 	PyObject * py_ns = NULL;
 	PyObject * py_set = NULL;
 	PyObject * py_bin = NULL;
@@ -63,11 +64,16 @@ PyObject * AerospikeClient_Index_Integer_Create(AerospikeClient * self, PyObject
 	as_index_task task;
 
 	// Python Function Keyword Arguments
-	static char * kwlist[] = {"ns", "set", "bin", "name", "policy", NULL};
+	static char * kwlist[] = {"ns", "set", "bin", "name", "policy", "wait", NULL};
 
 	// Python Function Argument Parsing
-	if (PyArg_ParseTupleAndKeywords(args, kwds, "OOOO|O:index_integer_create", kwlist,
-				&py_ns, &py_set, &py_bin, &py_name, &py_policy) == false) {
+	if (PyArg_ParseTupleAndKeywords(args, kwds, "OOOO|OO:index_integer_create", kwlist,
+				&py_ns, &py_set, &py_bin, &py_name, &py_policy, &py_wait) == false) {
+		return NULL;
+	}
+
+	int should_wait = py_wait ? PyObject_IsTrue(py_wait) : 1;
+	if (should_wait == -1) {
 		return NULL;
 	}
 
@@ -140,7 +146,7 @@ PyObject * AerospikeClient_Index_Integer_Create(AerospikeClient * self, PyObject
 	if (err.code != AEROSPIKE_OK) {
 		as_error_update(&err, err.code, NULL);
 		goto CLEANUP;
-	} else {
+	} else if (should_wait) {
 		Py_BEGIN_ALLOW_THREADS
 		aerospike_index_create_wait(&err, &task, 2000);
 		Py_END_ALLOW_THREADS
@@ -168,6 +174,11 @@ CLEANUP:
 		return NULL;
 	}
 
+	// wait=False hands the build back to the caller, see wait_for_task()
+	if (!should_wait) {
+		return index_task_to_pyobject(&task);
+	}
+
 	return PyLong_FromLong(0);
 }
 
@@ -192,6 +203,7 @@ PyObject * AerospikeClient_Index_String_Create(AerospikeClient * self, PyObject
 
 	// Python Function Arguments
 	PyObject * py_policy = NULL;
+	PyObject * py_wait = NULL;
 	PyObject * py_ns = NULL;
 	PyObject * py_set = NULL;
 	PyObject * py_bin = NULL;
@@ -205,11 +217,16 @@ PyObject * AerospikeClient_Index_String_Create(AerospikeClient * self, PyObject
 	as_index_task task;
 
 	// Python Function Keyword Arguments
-	static char * kwlist[] = {"ns", "set", "bin", "name", "policy", NULL};
+	static char * kwlist[] = {"ns", "set", "bin", "name", "policy", "wait", NULL};
 
 	// Python Function Argument Parsing
-	if (PyArg_ParseTupleAndKeywords(args, kwds, "OOOO|O:index_string_create", kwlist,
-				&py_ns, &py_set, &py_bin, &py_name, &py_policy) == false) {
+	if (PyArg_ParseTupleAndKeywords(args, kwds, "OOOO|OO:index_string_create", kwlist,
+				&py_ns, &py_set, &py_bin, &py_name, &py_policy, &py_wait) == false) {
+		return NULL;
+	}
+
+	int should_wait = py_wait ? PyObject_IsTrue(py_wait) : 1;
+	if (should_wait == -1) {
 		return NULL;
 	}
 
@@ -283,7 +300,7 @@ PyObject * AerospikeClient_Index_String_Create(AerospikeClient * self, PyObject
 	if (err.code != AEROSPIKE_OK) {
 		as_error_update(&err, err.code, NULL);
 		goto CLEANUP;
-	} else {
+	} else if (should_wait) {
 		Py_BEGIN_ALLOW_THREADS
 		aerospike_index_create_wait(&err, &task, 2000);
 		Py_END_ALLOW_THREADS
@@ -311,6 +328,10 @@ CLEANUP:
 		return NULL;
 	}
 
+	if (!should_wait) {
+		return index_task_to_pyobject(&task);
+	}
+
 	return PyLong_FromLong(0);
 }
 
@@ -424,6 +445,7 @@ PyObject * AerospikeClient_Index_List_Create(AerospikeClient * self, PyObject *a
 
 	// Python Function Arguments
 	PyObject * py_policy = NULL;
+	PyObject * py_wait = NULL;
 	PyObject * py_ns = NULL;
 	PyObject * py_set = NULL;
 	PyObject * py_bin = NULL;
@@ -438,11 +460,16 @@ PyObject * AerospikeClient_Index_List_Create(AerospikeClient * self, PyObject *a
 	as_index_task task;
 
 	// Python Function Keyword Arguments
-	static char * kwlist[] = {"ns", "set", "bin", "index_datatype", "name", "policy", NULL};
+	static char * kwlist[] = {"ns", "set", "bin", "index_datatype", "name", "policy", "wait", NULL};
 
 	// Python Function Argument Parsing
-	if (PyArg_ParseTupleAndKeywords(args, kwds, "OOOOO|O:index_list_create", kwlist,
-				&py_ns, &py_set, &py_bin, &py_datatype, &py_name, &py_policy) == false) {
+	if (PyArg_ParseTupleAndKeywords(args, kwds, "OOOOO|OO:index_list_create", kwlist,
+				&py_ns, &py_set, &py_bin, &py_datatype, &py_name, &py_policy, &py_wait) == false) {
+		return NULL;
+	}
+
+	int should_wait = py_wait ? PyObject_IsTrue(py_wait) : 1;
+	if (should_wait == -1) {
 		return NULL;
 	}
 
@@ -526,7 +553,7 @@ PyObject * AerospikeClient_Index_List_Create(AerospikeClient * self, PyObject *a
 	if (err.code != AEROSPIKE_OK) {
 		as_error_update(&err, err.code, NULL);
 		goto CLEANUP;
-	} else {
+	} else if (should_wait) {
 		Py_BEGIN_ALLOW_THREADS
 		aerospike_index_create_wait(&err, &task, 2000);
 		Py_END_ALLOW_THREADS
@@ -554,6 +581,10 @@ CLEANUP:
 		return NULL;
 	}
 
+	if (!should_wait) {
+		return index_task_to_pyobject(&task);
+	}
+
 	return PyLong_FromLong(0);
 }
 
@@ -565,6 +596,7 @@ PyObject * AerospikeClient_Index_Map_Keys_Create(AerospikeClient * self, PyObjec
 
 	// Python Function Arguments
 	PyObject * py_policy = NULL;
+	PyObject * py_wait = NULL;
 	PyObject * py_ns = NULL;
 	PyObject * py_set = NULL;
 	PyObject * py_bin = NULL;
@@ -579,11 +611,16 @@ PyObject * AerospikeClient_Index_Map_Keys_Create(AerospikeClient * self, PyObjec
 	as_index_task task;
 
 	// Python Function Keyword Arguments
-	static char * kwlist[] = {"ns", "set", "bin", "index_datatype", "name", "policy", NULL};
+	static char * kwlist[] = {"ns", "set", "bin", "index_datatype", "name", "policy", "wait", NULL};
 
 	// Python Function Argument Parsing
-	if (PyArg_ParseTupleAndKeywords(args, kwds, "OOOOO|O:index_map_keys_create", kwlist,
-				&py_ns, &py_set, &py_bin, &py_datatype, &py_name, &py_policy) == false) {
+	if (PyArg_ParseTupleAndKeywords(args, kwds, "OOOOO|OO:index_map_keys_create", kwlist,
+				&py_ns, &py_set, &py_bin, &py_datatype, &py_name, &py_policy, &py_wait) == false) {
+		return NULL;
+	}
+
+	int should_wait = py_wait ? PyObject_IsTrue(py_wait) : 1;
+	if (should_wait == -1) {
 		return NULL;
 	}
 
@@ -668,7 +705,7 @@ PyObject * AerospikeClient_Index_Map_Keys_Create(AerospikeClient * self, PyObjec
 	if (err.code != AEROSPIKE_OK) {
 		as_error_update(&err, err.code, NULL);
 		goto CLEANUP;
-	} else {
+	} else if (should_wait) {
 		Py_BEGIN_ALLOW_THREADS
 		aerospike_index_create_wait(&err, &task, 2000);
 		Py_END_ALLOW_THREADS
@@ -696,6 +733,10 @@ CLEANUP:
 		return NULL;
 	}
 
+	if (!should_wait) {
+		return index_task_to_pyobject(&task);
+	}
+
 	return PyLong_FromLong(0);
 }
 
@@ -707,6 +748,7 @@ PyObject * AerospikeClient_Index_Map_Values_Create(AerospikeClient * self, PyObj
 
 	// Python Function Arguments
 	PyObject * py_policy = NULL;
+	PyObject * py_wait = NULL;
 	PyObject * py_ns = NULL;
 	PyObject * py_set = NULL;
 	PyObject * py_bin = NULL;
@@ -721,11 +763,16 @@ PyObject * AerospikeClient_Index_Map_Values_Create(AerospikeClient * self, PyObj
 	as_index_task task;
 
 	// Python Function Keyword Arguments
-	static char * kwlist[] = {"ns", "set", "bin", "index_datatype", "name", "policy", NULL};
+	static char * kwlist[] = {"ns", "set", "bin", "index_datatype", "name", "policy", "wait", NULL};
 
 	// Python Function Argument Parsing
-	if (PyArg_ParseTupleAndKeywords(args, kwds, "OOOOO|O:index_map_values_create", kwlist,
-				&py_ns, &py_set, &py_bin, &py_datatype, &py_name, &py_policy) == false) {
+	if (PyArg_ParseTupleAndKeywords(args, kwds, "OOOOO|OO:index_map_values_create", kwlist,
+				&py_ns, &py_set, &py_bin, &py_datatype, &py_name, &py_policy, &py_wait) == false) {
+		return NULL;
+	}
+
+	int should_wait = py_wait ? PyObject_IsTrue(py_wait) : 1;
+	if (should_wait == -1) {
 		return NULL;
 	}
 
@@ -811,7 +858,7 @@ PyObject * AerospikeClient_Index_Map_Values_Create(AerospikeClient * self, PyObj
 	if (err.code != AEROSPIKE_OK) {
 		as_error_update(&err, err.code, NULL);
 		goto CLEANUP;
-	} else {
+	} else if (should_wait) {
 		Py_BEGIN_ALLOW_THREADS
 		aerospike_index_create_wait(&err, &task, 2000);
 		Py_END_ALLOW_THREADS
@@ -839,6 +886,10 @@ CLEANUP:
 		return NULL;
 	}
 
+	if (!should_wait) {
+		return index_task_to_pyobject(&task);
+	}
+
 	return PyLong_FromLong(0);
 }
 PyObject * AerospikeClient_Index_2dsphere_Create(AerospikeClient * self, PyObject *args, PyObject * kwds)
@@ -849,6 +900,7 @@ PyObject * AerospikeClient_Index_2dsphere_Create(AerospikeClient * self, PyObjec
 
 	// Python Function Arguments
 	PyObject * py_policy = NULL;
+	PyObject * py_wait = NULL;
 	PyObject * py_ns = NULL;
 	PyObject * py_set = NULL;
 	PyObject * py_bin = NULL;
@@ -862,11 +914,16 @@ PyObject * AerospikeClient_Index_2dsphere_Create(AerospikeClient * self, PyObjec
 	as_index_task task;
 
 	// Python Function Keyword Arguments
-	static char * kwlist[] = {"ns", "set", "bin", "name", "policy", NULL};
+	static char * kwlist[] = {"ns", "set", "bin", "name", "policy", "wait", NULL};
 
 	// Python Function Argument Parsing
-	if (PyArg_ParseTupleAndKeywords(args, kwds, "OOOO|O:index_geo2dsphere_create", kwlist,
-				&py_ns, &py_set, &py_bin, &py_name, &py_policy) == false) {
+	if (PyArg_ParseTupleAndKeywords(args, kwds, "OOOO|OO:index_geo2dsphere_create", kwlist,
+				&py_ns, &py_set, &py_bin, &py_name, &py_policy, &py_wait) == false) {
+		return NULL;
+	}
+
+	int should_wait = py_wait ? PyObject_IsTrue(py_wait) : 1;
+	if (should_wait == -1) {
 		return NULL;
 	}
 
@@ -943,7 +1000,7 @@ PyObject * AerospikeClient_Index_2dsphere_Create(AerospikeClient * self, PyObjec
 	if (err.code != AEROSPIKE_OK) {
 		as_error_update(&err, err.code, NULL);
 		goto CLEANUP;
-	} else {
+	} else if (should_wait) {
 		Py_BEGIN_ALLOW_THREADS
 		aerospike_index_create_wait(&err, &task, 2000);
 		Py_END_ALLOW_THREADS
@@ -971,5 +1028,9 @@ CLEANUP:
 		return NULL;
 	}
 
+	if (!should_wait) {
+		return index_task_to_pyobject(&task);
+	}
+
 	return PyLong_FromLong(0);
 }
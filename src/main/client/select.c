@@ -22,10 +22,14 @@
 #include <aerospike/as_error.h>
 #include <aerospike/as_record.h>
 
+#include "breaker.h"
 #include "client.h"
 #include "conversions.h"
 #include "exceptions.h"
+#include "hedge.h"
+#include "limiter.h"
 #include "policy.h"
+#include "tracer.h"
 
 /**
  *******************************************************************************************************
@@ -57,10 +61,17 @@ PyObject * AerospikeClient_Select_Invoke(
 
 	// Initialisation flags
 	bool key_initialised = false;
+	bool none_on_miss = false;
+	uint32_t hedge_after_ms = 0;
+	bool hedged = false;
+	bool hedge_won = false;
 
 	// Initialize error
 	as_error_init(&err);
 
+	trace_span span;
+	trace_start(self, &span, "select");
+
 	if (!self || !self->as) {
 		as_error_update(&err, AEROSPIKE_ERR_PARAM, "Invalid aerospike object");
 		goto CLEANUP;
@@ -134,14 +145,37 @@ PyObject * AerospikeClient_Select_Invoke(
 	if (err.code != AEROSPIKE_OK) {
 		goto CLEANUP;
 	}
+	if (pyobject_to_policy_not_found(&err, py_policy, &none_on_miss) != AEROSPIKE_OK) {
+		goto CLEANUP;
+	}
+	if (pyobject_to_policy_hedge(&err, py_policy, &hedge_after_ms) != AEROSPIKE_OK) {
+		goto CLEANUP;
+	}
 
 	// Initialize record
 	as_record_init(rec, 0);
 
 	// Invoke operation
 	Py_BEGIN_ALLOW_THREADS
-	aerospike_key_select(self->as, &err, read_policy_p, &key, (const char **) bins, &rec);
+	trace_call_start(&span);
+	if (request_limiter_acquire(self->limiter, &err, LIMITER_READ, &key, 1) == AEROSPIKE_OK) {
+		as_node * node = NULL;
+		if (circuit_breaker_check(self->breaker, self->as, &err, &key, &node) == AEROSPIKE_OK) {
+			if (hedge_after_ms) {
+				hedge_read(self->hedge_pool, self->as, &err, read_policy_p, &key, (const char **) bins, HEDGE_SELECT,
+						hedge_after_ms, &rec, &hedged, &hedge_won);
+			} else {
+				aerospike_key_select(self->as, &err, read_policy_p, &key, (const char **) bins, &rec);
+			}
+			circuit_breaker_record(self->breaker, node, err.code);
+		}
+		request_limiter_release(self->limiter);
+	}
+	trace_call_end(&span);
 	Py_END_ALLOW_THREADS
+	if (hedge_after_ms) {
+		hedge_stats_update(self, hedged, hedge_won);
+	}
 
 	if (err.code == AEROSPIKE_OK) {
 		record_to_pyobject(self, &err, rec, &key, &py_rec);
@@ -151,6 +185,7 @@ PyObject * AerospikeClient_Select_Invoke(
 	}
 
 CLEANUP:
+	trace_end(self, &span, key_initialised ? &key : NULL, err.code);
 
 	if (py_ustr) {
 		Py_DECREF(py_ustr);
@@ -163,6 +198,10 @@ CLEANUP:
 
 	as_record_destroy(rec);
 
+	if (err.code == AEROSPIKE_ERR_RECORD_NOT_FOUND && none_on_miss) {
+		Py_RETURN_NONE;
+	}
+
 	if (err.code != AEROSPIKE_OK) {
 		PyObject * py_err = NULL;
 		error_to_pyobject(&err, &py_err);
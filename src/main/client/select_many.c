@@ -27,7 +27,11 @@
 #include "client.h"
 #include "conversions.h"
 #include "exceptions.h"
+#include "limiter.h"
 #include "policy.h"
+#include "serializer.h"
+#include "tracer.h"
+#include "module_state.h"
 
 typedef struct {
 	PyObject * py_recs;
@@ -44,10 +48,7 @@ typedef struct {
  *************************************************************************
  **/
 PyObject * store_unicode_bins(UnicodePyObjects *u_obj, PyObject * py_uobj) {
-	if (u_obj->size < MAX_UNICODE_OBJECTS) {
-		u_obj->ob[u_obj->size++] = py_uobj;
-	}
-	return py_uobj;
+	return unicode_objects_add(u_obj, py_uobj);
 }
 
 /**
@@ -69,8 +70,13 @@ static bool batch_select_cb(const as_batch_read* results, uint32_t n, void* udat
 	as_error_init(&err);
 
 	// Lock Python State
-	PyGILState_STATE gstate;
-	gstate = PyGILState_Ensure();
+	aerospike_gil gil;
+	aerospike_gil_ensure(data->client->state->interp, &gil);
+
+	// Deserialize the blobs of every record at once
+	deserializer_batch blobs;
+	deserializer_batch_begin(data->client, &blobs);
+
 	// Loop over results array
 	for (uint32_t i =0; i < n; i++) {
 		PyObject * rec = NULL;
@@ -122,8 +128,9 @@ static bool batch_select_cb(const as_batch_read* results, uint32_t n, void* udat
 			PyTuple_SetItem(py_rec, 2, py_obj);
 			// Set return value in return Dict
 			if (PyList_SetItem(py_recs, i, py_rec)) {
+				deserializer_batch_end(&blobs, NULL, &err);
 				// Release Python State
-				PyGILState_Release(gstate);
+				aerospike_gil_release(&gil);
 				return false;
 			}
 			Py_DECREF(rec);
@@ -134,14 +141,16 @@ static bool batch_select_cb(const as_batch_read* results, uint32_t n, void* udat
 			Py_INCREF(Py_None);
 			PyTuple_SetItem(py_rec, 2, Py_None);
 			if (PyList_SetItem( py_recs, i, py_rec)) {
+				deserializer_batch_end(&blobs, NULL, &err);
 				// Release Python State
-				PyGILState_Release(gstate);
+				aerospike_gil_release(&gil);
 				return false;
 			}
 		}
 	}
+	deserializer_batch_end(&blobs, py_recs, &err);
 	// Release Python State
-	PyGILState_Release(gstate);
+	aerospike_gil_release(&gil);
 	return true;
 }
 
@@ -157,6 +166,10 @@ static bool batch_select_cb(const as_batch_read* results, uint32_t n, void* udat
 static void batch_select_recs(AerospikeClient *self, as_error *err, as_batch_read_records* records, PyObject **py_recs)
 {
 	as_vector* list = &records->list;
+	deserializer_batch blobs;
+
+	// Deserialize the blobs of every record at once
+	deserializer_batch_begin(self, &blobs);
 	for (uint32_t i = 0; i < list->size; i++) {
 		as_batch_read_record* batch = as_vector_get(list, i);
 
@@ -214,6 +227,7 @@ static void batch_select_recs(AerospikeClient *self, as_error *err, as_batch_rea
 			PyList_SetItem( *py_recs, i, py_rec);
 		}
 	}
+	deserializer_batch_end(&blobs, *py_recs, err);
 }
 /**
  *******************************************************************************************************
@@ -230,6 +244,10 @@ static void batch_select_recs(AerospikeClient *self, as_error *err, as_batch_rea
 static PyObject * batch_select_aerospike_batch_read(as_error *err, AerospikeClient * self, PyObject *py_keys, as_policy_batch * batch_policy_p, char** filter_bins, Py_ssize_t bins_size)
 {
 	PyObject * py_recs = NULL;
+	as_key * first_key = NULL;
+
+	trace_span span;
+	trace_start(self, &span, "select_many");
 
 	as_batch_read_records records;
 
@@ -306,9 +324,18 @@ static PyObject * batch_select_aerospike_batch_read(as_error *err, AerospikeClie
 		goto CLEANUP;
 	}
 
+	first_key = records.list.size ?
+		&((as_batch_read_record *) as_vector_get(&records.list, 0))->key : NULL;
+
 	// Invoke C-client API
 	Py_BEGIN_ALLOW_THREADS
-	aerospike_batch_read(self->as, err, batch_policy_p, &records);
+	trace_call_start(&span);
+	if (request_limiter_acquire(self->limiter, err, LIMITER_BATCH, first_key,
+			records.list.size) == AEROSPIKE_OK) {
+		aerospike_batch_read(self->as, err, batch_policy_p, &records);
+		request_limiter_release(self->limiter);
+	}
+	trace_call_end(&span);
 	Py_END_ALLOW_THREADS
 	if (err->code != AEROSPIKE_OK)
 	{
@@ -317,6 +344,7 @@ static PyObject * batch_select_aerospike_batch_read(as_error *err, AerospikeClie
 	batch_select_recs(self, err, &records, &py_recs);
 
 CLEANUP:
+	trace_end_batch(self, &span, first_key, first_key ? records.list.size : 0, err->code);
 	if (batch_initialised == true) {
 		// We should destroy batch object as we are using 'as_batch_init' for initialisation
 		// Also, pyobject_to_key is soing strdup() in case of Unicode. So, object destruction
@@ -341,6 +369,10 @@ CLEANUP:
 static PyObject * batch_select_aerospike_batch_get(as_error *err, AerospikeClient * self, PyObject *py_keys, as_policy_batch * batch_policy_p, char **filter_bins, Py_ssize_t bins_size)
 {
 	PyObject * py_recs = NULL;
+	as_key * first_key = NULL;
+
+	trace_span span;
+	trace_start(self, &span, "select_many");
 
 	as_batch batch;
 	bool batch_initialised = false;
@@ -403,15 +435,24 @@ static PyObject * batch_select_aerospike_batch_get(as_error *err, AerospikeClien
 		goto CLEANUP;
 	}
 
+	first_key = as_batch_keyat(&batch, 0);
+
 	// Invoke C-client API
 	Py_BEGIN_ALLOW_THREADS
-	aerospike_batch_get_bins(self->as, err, batch_policy_p,
-		&batch, (const char **) filter_bins, bins_size,
-		(aerospike_batch_read_callback) batch_select_cb,
-		&data);
+	trace_call_start(&span);
+	if (request_limiter_acquire(self->limiter, err, LIMITER_BATCH, first_key,
+			batch.keys.size) == AEROSPIKE_OK) {
+		aerospike_batch_get_bins(self->as, err, batch_policy_p,
+			&batch, (const char **) filter_bins, bins_size,
+			(aerospike_batch_read_callback) batch_select_cb,
+			&data);
+		request_limiter_release(self->limiter);
+	}
+	trace_call_end(&span);
 	Py_END_ALLOW_THREADS
 
 CLEANUP:
+	trace_end_batch(self, &span, first_key, first_key ? batch.keys.size : 0, err->code);
 	if (batch_initialised == true) {
 		// We should destroy batch object as we are using 'as_batch_init' for initialisation
 		// Also, pyobject_to_key is soing strdup() in case of Unicode. So, object destruction
@@ -451,7 +492,7 @@ PyObject * AerospikeClient_Select_Many_Invoke(
 
 	// Unicode object's pool
 	UnicodePyObjects u_objs;
-	u_objs.size = 0;
+	unicode_objects_init(&u_objs, 0);
 	int i = 0;
 
 	// Initialize error
@@ -481,6 +522,7 @@ PyObject * AerospikeClient_Select_Many_Invoke(
 	}
 
 	filter_bins = (char **)malloc(sizeof(long int) * bins_size);
+	unicode_objects_init(&u_objs, (int) bins_size);
 
 	for (i = 0; i < bins_size; i++) {
 		PyObject *py_bin = NULL;
@@ -494,8 +536,12 @@ PyObject * AerospikeClient_Select_Many_Invoke(
 			// Store the unicode object into a pool
 			// It is DECREFed at later stages
 			// So, no need of DECREF here.
-			filter_bins[i] = PyBytes_AsString(
-					store_unicode_bins(&u_objs, PyUnicode_AsUTF8String(py_bin)));
+			PyObject * py_ubin = store_unicode_bins(&u_objs, PyUnicode_AsUTF8String(py_bin));
+			if (!py_ubin) {
+				as_error_update(&err, AEROSPIKE_ERR_CLIENT, "Failed to store the bin names");
+				goto CLEANUP;
+			}
+			filter_bins[i] = PyBytes_AsString(py_ubin);
 		}
 		else if (PyString_Check(py_bin)) {
 			filter_bins[i] = PyString_AsString(py_bin);
@@ -527,9 +573,7 @@ CLEANUP:
 	}
 
 	// DECREFed all the unicode objects stored in Pool
-	for (i = 0; i< u_objs.size; i++) {
-		Py_DECREF(u_objs.ob[i]);
-	}
+	unicode_objects_destroy(&u_objs);
 
 	if (err.code != AEROSPIKE_OK) {
 		PyObject * py_err = NULL;
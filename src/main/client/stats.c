@@ -0,0 +1,119 @@
+/*******************************************************************************
+ * Copyright 2013-2016 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include <Python.h>
+
+#include "breaker.h"
+#include "cache.h"
+#include "client.h"
+#include "limiter.h"
+#include "macros.h"
+
+static void stats_set(PyObject * py_stats, const char * name, uint64_t value)
+{
+	PyObject * py_value = PyLong_FromUnsignedLongLong(value);
+	PyDict_SetItemString(py_stats, name, py_value);
+	Py_DECREF(py_value);
+}
+
+static PyObject * hedge_stats_new(AerospikeClient * self)
+{
+	PyObject * py_stats = PyDict_New();
+	stats_set(py_stats, "reads", self->hedge.reads);
+	stats_set(py_stats, "hedged", self->hedge.hedged);
+	stats_set(py_stats, "hedge_wins", self->hedge.hedge_wins);
+	return py_stats;
+}
+
+/**
+ *******************************************************************************************************
+ * Returns the counters of the reads sent with a hedge_after_ms policy.
+ *
+ *		client.hedge_stats()
+ *
+ * 'reads' counts those reads, 'hedged' the reads sent again to a replica and
+ * 'hedge_wins' the hedges that answered first.
+ *******************************************************************************************************
+ */
+PyObject * AerospikeClient_Hedge_Stats(AerospikeClient * self, PyObject * args, PyObject * kwds)
+{
+	static char * kwlist[] = {NULL};
+
+	if (PyArg_ParseTupleAndKeywords(args, kwds, ":hedge_stats", kwlist) == false) {
+		return NULL;
+	}
+
+	return hedge_stats_new(self);
+}
+
+/**
+ *******************************************************************************************************
+ * Returns the state of the client side features of this client.
+ *
+ *		client.stats()
+ *
+ * 'limits' holds the rate limits with their tokens left and counters, 'cache'
+ * the size of the record cache, 'hedge' the hedge_stats() counters and
+ * 'circuit_breaker' the state of each node's breaker. Limits, cache and
+ * breakers are None when they are not configured.
+ *******************************************************************************************************
+ */
+PyObject * AerospikeClient_Stats(AerospikeClient * self, PyObject * args, PyObject * kwds)
+{
+	static char * kwlist[] = {NULL};
+
+	if (PyArg_ParseTupleAndKeywords(args, kwds, ":stats", kwlist) == false) {
+		return NULL;
+	}
+
+	PyObject * py_stats = PyDict_New();
+	PyObject * py_value = NULL;
+
+	if (self->limiter) {
+		py_value = request_limiter_stats(self->limiter);
+	} else {
+		Py_INCREF(Py_None);
+		py_value = Py_None;
+	}
+	PyDict_SetItemString(py_stats, "limits", py_value);
+	Py_DECREF(py_value);
+
+	if (self->cache) {
+		py_value = PyDict_New();
+		stats_set(py_value, "records", self->cache->n_records);
+		stats_set(py_value, "bytes", self->cache->bytes);
+	} else {
+		Py_INCREF(Py_None);
+		py_value = Py_None;
+	}
+	PyDict_SetItemString(py_stats, "cache", py_value);
+	Py_DECREF(py_value);
+
+	py_value = hedge_stats_new(self);
+	PyDict_SetItemString(py_stats, "hedge", py_value);
+	Py_DECREF(py_value);
+
+	if (self->breaker) {
+		py_value = circuit_breaker_stats(self->breaker);
+	} else {
+		Py_INCREF(Py_None);
+		py_value = Py_None;
+	}
+	PyDict_SetItemString(py_stats, "circuit_breaker", py_value);
+	Py_DECREF(py_value);
+
+	return py_stats;
+}
@@ -0,0 +1,278 @@
+/*******************************************************************************
+ * Copyright 2013-2016 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include <Python.h>
+#include <stdbool.h>
+#include <unistd.h>
+
+#include <aerospike/aerospike.h>
+#include <aerospike/aerospike_index.h>
+#include <aerospike/aerospike_info.h>
+#include <aerospike/as_error.h>
+#include <aerospike/as_node.h>
+#include <aerospike/as_policy.h>
+#include <citrusleaf/cf_clock.h>
+
+#include "client.h"
+#include "conversions.h"
+#include "exceptions.h"
+#include "policy.h"
+
+#define TASK_TYPE_INDEX "index"
+#define TASK_TYPE_UDF "udf"
+#define TASK_COMMAND_MAX_LEN 512
+#define TASK_DEFAULT_POLL_INTERVAL 1000
+
+typedef struct {
+	bool is_index;
+	bool done;
+	// Info command polled on every node
+	char command[TASK_COMMAND_MAX_LEN];
+	// For UDF tasks, the entry expected in every node's udf-list
+	char expected[TASK_COMMAND_MAX_LEN];
+} pending_task;
+
+/**
+ *******************************************************************************************************
+ * Callback for aerospike_info_foreach(), run without the GIL.
+ * A task stays pending while any node reports an index load_pct below 100,
+ * or while any node does not list the UDF module yet. As in the C client,
+ * node errors are not treated as pending.
+ *******************************************************************************************************
+ */
+static bool task_is_done_each(const as_error * err, const as_node * node, const char * req, char * res, void * udata)
+{
+	pending_task * task = (pending_task *) udata;
+
+	if ((err && err->code != AEROSPIKE_OK) || !res) {
+		return true;
+	}
+
+	if (task->is_index) {
+		char * p = strstr(res, "load_pct=");
+		if (p) {
+			int pct = atoi(p + strlen("load_pct="));
+			if (pct >= 0 && pct < 100) {
+				task->done = false;
+				return false;
+			}
+		}
+	} else if (!strstr(res, task->expected)) {
+		task->done = false;
+		return false;
+	}
+	return true;
+}
+
+/**
+ *******************************************************************************************************
+ * Returns the task dict handed out by index creation called with wait=False.
+ *******************************************************************************************************
+ */
+PyObject * index_task_to_pyobject(as_index_task * task)
+{
+	PyObject * py_task = PyDict_New();
+	PyObject * py_value = PyString_FromString(TASK_TYPE_INDEX);
+	PyDict_SetItemString(py_task, "type", py_value);
+	Py_DECREF(py_value);
+	py_value = PyString_FromString(task->ns);
+	PyDict_SetItemString(py_task, "ns", py_value);
+	Py_DECREF(py_value);
+	py_value = PyString_FromString(task->name);
+	PyDict_SetItemString(py_task, "name", py_value);
+	Py_DECREF(py_value);
+	return py_task;
+}
+
+/**
+ *******************************************************************************************************
+ * Returns the task dict handed out by udf_put called with wait=False.
+ *******************************************************************************************************
+ */
+PyObject * udf_task_to_pyobject(const char * module)
+{
+	PyObject * py_task = PyDict_New();
+	PyObject * py_value = PyString_FromString(TASK_TYPE_UDF);
+	PyDict_SetItemString(py_task, "type", py_value);
+	Py_DECREF(py_value);
+	py_value = PyString_FromString(module);
+	PyDict_SetItemString(py_task, "module", py_value);
+	Py_DECREF(py_value);
+	return py_task;
+}
+
+static char * task_field(as_error * err, PyObject * py_task, const char * field)
+{
+	PyObject * py_value = PyDict_GetItemString(py_task, field);
+	if (!py_value || !PyString_Check(py_value)) {
+		as_error_update(err, AEROSPIKE_ERR_PARAM, "Task %s must be a string", field);
+		return NULL;
+	}
+	return PyString_AsString(py_value);
+}
+
+static as_status pyobject_to_pending_task(as_error * err, PyObject * py_task, pending_task * task)
+{
+	if (!PyDict_Check(py_task)) {
+		return as_error_update(err, AEROSPIKE_ERR_PARAM, "Task must be a dict");
+	}
+
+	char * type = task_field(err, py_task, "type");
+	if (!type) {
+		return err->code;
+	}
+
+	task->done = false;
+	if (!strcmp(type, TASK_TYPE_INDEX)) {
+		char * ns = task_field(err, py_task, "ns");
+		char * name = ns ? task_field(err, py_task, "name") : NULL;
+		if (!name) {
+			return err->code;
+		}
+		task->is_index = true;
+		snprintf(task->command, sizeof(task->command), "sindex/%s/%s", ns, name);
+	} else if (!strcmp(type, TASK_TYPE_UDF)) {
+		char * module = task_field(err, py_task, "module");
+		if (!module) {
+			return err->code;
+		}
+		task->is_index = false;
+		snprintf(task->command, sizeof(task->command), "udf-list");
+		snprintf(task->expected, sizeof(task->expected), "filename=%s", module);
+	} else {
+		return as_error_update(err, AEROSPIKE_ERR_PARAM, "Unknown task type %s", type);
+	}
+	return err->code;
+}
+
+/**
+ *******************************************************************************************************
+ * Waits for one or more tasks returned by index_*_create() or udf_put()
+ * called with wait=False.
+ *
+ * All pending tasks are polled together every poll_interval milliseconds, so
+ * waiting for many index builds costs one round of info requests per
+ * interval. The GIL is released for the whole wait.
+ *
+ * @param self                  AerospikeClient object
+ * @param args                  The args is a tuple object containing an argument
+ *                              list passed from Python to a C function
+ * @param kwds                  Dictionary of keywords
+ *
+ * Returns an integer status. 0(Zero) is success value.
+ * In case of error,appropriate exceptions will be raised. A TimeoutError is
+ * raised if the tasks are not complete within timeout milliseconds.
+ *******************************************************************************************************
+ */
+PyObject * AerospikeClient_Wait_For_Task(AerospikeClient * self, PyObject * args, PyObject * kwds)
+{
+	as_error err;
+	as_error_init(&err);
+
+	PyObject * py_tasks = NULL;
+	PyObject * py_policy = NULL;
+	unsigned int timeout = 0;
+	unsigned int poll_interval = TASK_DEFAULT_POLL_INTERVAL;
+	as_policy_info info_policy;
+	as_policy_info * info_policy_p = NULL;
+	pending_task * tasks = NULL;
+	Py_ssize_t tasks_size = 0;
+
+	static char * kwlist[] = {"task", "timeout", "poll_interval", "policy", NULL};
+
+	if (PyArg_ParseTupleAndKeywords(args, kwds, "O|IIO:wait_for_task", kwlist,
+				&py_tasks, &timeout, &poll_interval, &py_policy) == false) {
+		return NULL;
+	}
+
+	if (!self || !self->as) {
+		as_error_update(&err, AEROSPIKE_ERR_PARAM, "Invalid aerospike object");
+		goto CLEANUP;
+	}
+
+	if (!self->is_conn_16) {
+		as_error_update(&err, AEROSPIKE_ERR_CLUSTER, "No connection to aerospike cluster");
+		goto CLEANUP;
+	}
+
+	pyobject_to_policy_info(&err, py_policy, &info_policy, &info_policy_p,
+			&self->as->config.policies.info);
+	if (err.code != AEROSPIKE_OK) {
+		goto CLEANUP;
+	}
+
+	if (PyList_Check(py_tasks)) {
+		tasks_size = PyList_Size(py_tasks);
+		tasks = (pending_task *) malloc(sizeof(pending_task) * (tasks_size ? tasks_size : 1));
+		for (Py_ssize_t i = 0; i < tasks_size; i++) {
+			if (pyobject_to_pending_task(&err, PyList_GetItem(py_tasks, i), &tasks[i]) != AEROSPIKE_OK) {
+				goto CLEANUP;
+			}
+		}
+	} else {
+		tasks_size = 1;
+		tasks = (pending_task *) malloc(sizeof(pending_task));
+		if (pyobject_to_pending_task(&err, py_tasks, &tasks[0]) != AEROSPIKE_OK) {
+			goto CLEANUP;
+		}
+	}
+
+	Py_BEGIN_ALLOW_THREADS
+	uint64_t deadline = timeout ? cf_getms() + timeout : 0;
+	while (true) {
+		bool all_done = true;
+		for (Py_ssize_t i = 0; i < tasks_size; i++) {
+			if (tasks[i].done) {
+				continue;
+			}
+			tasks[i].done = true;
+			as_error_reset(&err);
+			aerospike_info_foreach(self->as, &err, info_policy_p, tasks[i].command,
+					(aerospike_info_foreach_callback) task_is_done_each, &tasks[i]);
+			if (!tasks[i].done) {
+				all_done = false;
+			}
+		}
+		// A node failing to answer a poll does not fail the wait
+		as_error_reset(&err);
+
+		if (all_done) {
+			break;
+		}
+		if (deadline && cf_getms() + poll_interval > deadline) {
+			as_error_update(&err, AEROSPIKE_ERR_TIMEOUT, "Task not complete within %u ms", timeout);
+			break;
+		}
+		usleep(poll_interval * 1000);
+	}
+	Py_END_ALLOW_THREADS
+
+CLEANUP:
+	if (tasks) {
+		free(tasks);
+	}
+
+	if (err.code != AEROSPIKE_OK) {
+		PyObject * py_err = NULL;
+		error_to_pyobject(&err, &py_err);
+		PyObject *exception_type = raise_exception(&err);
+		PyErr_SetObject(exception_type, py_err);
+		Py_DECREF(py_err);
+		return NULL;
+	}
+
+	return PyLong_FromLong(0);
+}
@@ -0,0 +1,117 @@
+/*******************************************************************************
+ * Copyright 2013-2016 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include <Python.h>
+#include <stdbool.h>
+
+#include <aerospike/as_error.h>
+
+#include "client.h"
+#include "conversions.h"
+#include "exceptions.h"
+#include "tracer.h"
+
+/**
+ *******************************************************************************************************
+ * Sets the callback receiving the spans of sampled calls, replacing the
+ * current one after passing it the spans it has buffered.
+ *
+ *		client.set_tracer(callback, sample_rate=0.01, batch_size=100)
+ *
+ * callback(spans) is called with a list of batch_size span dicts. A callback
+ * of None stops tracing.
+ * In case of error,appropriate exceptions will be raised.
+ *******************************************************************************************************
+ */
+PyObject * AerospikeClient_Set_Tracer(AerospikeClient * self, PyObject * args, PyObject * kwds)
+{
+	PyObject * py_callback = NULL;
+	double sample_rate = 0.01;
+	long batch_size = TRACER_DEFAULT_BATCH_SIZE;
+
+	static char * kwlist[] = {"callback", "sample_rate", "batch_size", NULL};
+
+	if (PyArg_ParseTupleAndKeywords(args, kwds, "O|dl:set_tracer", kwlist,
+				&py_callback, &sample_rate, &batch_size) == false) {
+		return NULL;
+	}
+
+	as_error err;
+	as_error_init(&err);
+
+	if (py_callback != Py_None && !PyCallable_Check(py_callback)) {
+		as_error_update(&err, AEROSPIKE_ERR_PARAM, "callback should be callable or None");
+		goto CLEANUP;
+	}
+	if (sample_rate < 0 || sample_rate > 1) {
+		as_error_update(&err, AEROSPIKE_ERR_PARAM, "sample_rate should be between 0 and 1");
+		goto CLEANUP;
+	}
+	if (batch_size < 1 || batch_size > 1000000) {
+		as_error_update(&err, AEROSPIKE_ERR_PARAM, "batch_size should be between 1 and 1000000");
+		goto CLEANUP;
+	}
+
+	span_tracer * old_tracer = self->tracer;
+	self->tracer = NULL;
+	if (py_callback != Py_None) {
+		self->tracer = span_tracer_new(py_callback, sample_rate, (uint32_t) batch_size);
+	}
+
+	bool flushed = span_tracer_flush(old_tracer);
+	span_tracer_destroy(old_tracer);
+	if (!flushed) {
+		return NULL;
+	}
+
+CLEANUP:
+	if (err.code != AEROSPIKE_OK) {
+		PyObject * py_err = NULL;
+		error_to_pyobject(&err, &py_err);
+		PyObject *exception_type = raise_exception(&err);
+		PyErr_SetObject(exception_type, py_err);
+		Py_DECREF(py_err);
+		return NULL;
+	}
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
+/**
+ *******************************************************************************************************
+ * Passes the spans buffered so far to the tracer's callback.
+ *
+ *		client.flush_spans()
+ *
+ * Errors raised by the callback are raised here.
+ *******************************************************************************************************
+ */
+PyObject * AerospikeClient_Flush_Spans(AerospikeClient * self, PyObject * args, PyObject * kwds)
+{
+	static char * kwlist[] = {NULL};
+
+	if (PyArg_ParseTupleAndKeywords(args, kwds, ":flush_spans", kwlist) == false) {
+		return NULL;
+	}
+
+	if (!span_tracer_flush(self->tracer)) {
+		return NULL;
+	}
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
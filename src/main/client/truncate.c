@@ -19,6 +19,7 @@
 
 #include <aerospike/as_error.h>
 #include <aerospike/aerospike.h>
+#include "cache.h"
 #include "client.h"
 #include "conversions.h"
 #include "exceptions.h"
@@ -40,7 +41,10 @@ AerospikeClient_TruncateInvoke(
 		goto CLEANUP;
 	}
 
+	Py_BEGIN_ALLOW_THREADS
 	status = aerospike_truncate(self->as, err, info_policy_p, namespace, set, nanos);
+	Py_END_ALLOW_THREADS
+	record_cache_clear(self->cache);
 	if (status != AEROSPIKE_OK) {
 		// The truncate operation failed. Update the err->code and return
 		as_error_update(err, AEROSPIKE_ERR_CLIENT, "Truncate operation failed");
@@ -25,16 +25,24 @@
 #include <aerospike/as_policy.h>
 
 #include "admin.h"
+#include "breaker.h"
 #include "client.h"
 #include "policy.h"
 #include "conversions.h"
+#include "counter_batcher.h"
 #include "exceptions.h"
+#include "module_state.h"
 #include "tls_config.h"
+#include "cache.h"
+#include "hedge.h"
+#include "limiter.h"
+#include "tracer.h"
 
 enum {INIT_NO_CONFIG_ERR = 1, INIT_CONFIG_TYPE_ERR, INIT_LUA_USER_ERR,
 	  INIT_LUA_SYS_ERR,  INIT_HOST_TYPE_ERR, INIT_EMPTY_HOSTS_ERR,
 	  INIT_INVALID_ADRR_ERR, INIT_SERIALIZE_ERR, INIT_DESERIALIZE_ERR,
-	  INIT_COMPRESSION_ERR} ;
+	  INIT_COMPRESSION_ERR, INIT_CACHE_ERR, INIT_LIMITS_ERR,
+	  INIT_BREAKER_ERR} ;
 
 /*******************************************************************************
  * PYTHON TYPE METHODS
@@ -56,6 +64,9 @@ static PyMethodDef AerospikeClient_Type_Methods[] = {
 	{"shm_key",
 		(PyCFunction) AerospikeClient_shm_key, METH_VARARGS | METH_KEYWORDS,
 		"Get the shm key of the cluster"},
+	{"post_fork",
+		(PyCFunction) AerospikeClient_Post_Fork, METH_VARARGS | METH_KEYWORDS,
+		"Rebuild the connection(s) inherited across a fork."},
 
 	// ADMIN OPERATIONS
 
@@ -120,6 +131,9 @@ static PyMethodDef AerospikeClient_Type_Methods[] = {
 	{"apply",
 		(PyCFunction) AerospikeClient_Apply, METH_VARARGS | METH_KEYWORDS,
 		"Apply a UDF on a record in the database."},
+	{"apply_many",
+		(PyCFunction) AerospikeClient_Apply_Many, METH_VARARGS | METH_KEYWORDS,
+		"Apply a UDF on many records in the database."},
 	{"remove_bin",
 		(PyCFunction) AerospikeClient_RemoveBin, METH_VARARGS | METH_KEYWORDS,
 		"Remove a bin from the database."},
@@ -147,6 +161,9 @@ static PyMethodDef AerospikeClient_Type_Methods[] = {
 	{"list_append",
 		(PyCFunction) AerospikeClient_ListAppend, METH_VARARGS | METH_KEYWORDS,
 		"Appends a single val to the list value in bin"},
+	{"list_append_many",
+		(PyCFunction) AerospikeClient_ListAppend_Many, METH_VARARGS | METH_KEYWORDS,
+		"Appends a single val to the list value in bin of many records"},
 	{"list_extend",
 		(PyCFunction) AerospikeClient_ListExtend, METH_VARARGS | METH_KEYWORDS,
 		"Extend the list value in bin with the given items"},
@@ -198,6 +215,12 @@ static PyMethodDef AerospikeClient_Type_Methods[] = {
 	{"map_put_items",
 		(PyCFunction) AerospikeClient_MapPutItems, METH_VARARGS | METH_KEYWORDS,
 		"Add the dictionary to the given map"},
+	{"map_put_many",
+		(PyCFunction) AerospikeClient_MapPut_Many, METH_VARARGS | METH_KEYWORDS,
+		"Add the given map_key/value pair to the map of many records"},
+	{"map_put_items_many",
+		(PyCFunction) AerospikeClient_MapPutItems_Many, METH_VARARGS | METH_KEYWORDS,
+		"Add the dictionary to the map of many records"},
 	{"map_increment",
 		(PyCFunction) AerospikeClient_MapIncrement, METH_VARARGS | METH_KEYWORDS,
 		"Increment value of a map"},
@@ -273,6 +296,9 @@ static PyMethodDef AerospikeClient_Type_Methods[] = {
 	{"query_apply",
 		(PyCFunction) AerospikeClient_QueryApply, METH_VARARGS | METH_KEYWORDS,
 		"Applies query object for performing queries."},
+	{"query_many",
+		(PyCFunction) AerospikeClient_Query_Many, METH_VARARGS | METH_KEYWORDS,
+		"Run several queries at the same time and return their results."},
 	{"job_info",
 		(PyCFunction) AerospikeClient_JobInfo, METH_VARARGS | METH_KEYWORDS,
 		"Gets Job Info"},
@@ -295,6 +321,9 @@ static PyMethodDef AerospikeClient_Type_Methods[] = {
 	{"info",
 		(PyCFunction) AerospikeClient_Info, METH_VARARGS | METH_KEYWORDS,
 		"Send an info request to the cluster."},
+	{"info_all",
+		(PyCFunction) AerospikeClient_InfoAll, METH_VARARGS | METH_KEYWORDS,
+		"Send an info request to every node in parallel and parse the responses."},
 	{"info_node",
 		(PyCFunction) AerospikeClient_InfoNode, METH_VARARGS | METH_KEYWORDS,
 		"Send an info request to the cluster."},
@@ -364,12 +393,43 @@ static PyMethodDef AerospikeClient_Type_Methods[] = {
 	{"get_key_digest",
 		(PyCFunction)AerospikeClient_Get_Key_Digest, METH_VARARGS | METH_KEYWORDS,
 		"Get key digest"},
+	{"hedge_stats",
+		(PyCFunction)AerospikeClient_Hedge_Stats, METH_VARARGS | METH_KEYWORDS,
+		"Get the counters of the hedged reads"},
+	{"stats",
+		(PyCFunction)AerospikeClient_Stats, METH_VARARGS | METH_KEYWORDS,
+		"Get the state of the rate limits, the cache, the hedged reads and the circuit breakers"},
+	{"cluster_stats",
+		(PyCFunction)AerospikeClient_Cluster_Stats, METH_VARARGS | METH_KEYWORDS,
+		"Get the client side state of the nodes, connection pools and thread pool"},
+	{"group_keys_by_node",
+		(PyCFunction)AerospikeClient_Group_Keys_By_Node, METH_VARARGS | METH_KEYWORDS,
+		"Group keys by the node that owns them"},
+	{"set_tracer",
+		(PyCFunction)AerospikeClient_Set_Tracer, METH_VARARGS | METH_KEYWORDS,
+		"Set the callback receiving the spans of sampled calls"},
+	{"flush_spans",
+		(PyCFunction)AerospikeClient_Flush_Spans, METH_VARARGS | METH_KEYWORDS,
+		"Pass the buffered spans to the tracer's callback"},
 
 	// TRUNCATE OPERATIONS
 	{"truncate",
 		(PyCFunction)AerospikeClient_Truncate, METH_VARARGS | METH_KEYWORDS,
 		"Truncate records from the database"},
 
+	// TASK OPERATIONS
+	{"wait_for_task",
+		(PyCFunction)AerospikeClient_Wait_For_Task, METH_VARARGS | METH_KEYWORDS,
+		"Wait for index builds and UDF registrations to complete"},
+
+	// BULK OPERATIONS
+	{"load_file",
+		(PyCFunction)AerospikeClient_Load_File, METH_VARARGS | METH_KEYWORDS,
+		"Load an NDJSON or CSV file into a set"},
+	{"counter_batcher",
+		(PyCFunction)AerospikeClient_Counter_Batcher, METH_VARARGS | METH_KEYWORDS,
+		"Create a batcher that merges counter updates per record"},
+
 	{NULL}
 };
 
@@ -383,6 +443,13 @@ static PyObject * AerospikeClient_Type_New(PyTypeObject * type, PyObject * args,
 
 	self = (AerospikeClient *) type->tp_alloc(type, 0);
 
+	if (self) {
+		self->state = aerospike_get_state();
+		// Keeps the state alive while the client may still use it
+		self->py_module = aerospike_get_module();
+		Py_XINCREF(self->py_module);
+	}
+
 	return (PyObject *) self;
 }
 
@@ -394,6 +461,7 @@ static int AerospikeClient_Type_Init(AerospikeClient * self, PyObject * args, Py
 
 	self->has_connected = false;
 	self->use_shared_connection = false;
+	self->user_shm_key = false;
 
 	if (PyArg_ParseTupleAndKeywords(args, kwds, "O:client", kwlist, &py_config) == false) {
 		return INIT_NO_CONFIG_ERR;
@@ -567,7 +635,7 @@ static int AerospikeClient_Type_Init(AerospikeClient * self, PyObject * args, Py
 
 		PyObject* py_shm_cluster_key = PyDict_GetItemString(py_shm, "shm_key");
 		if (py_shm_cluster_key && PyInt_Check(py_shm_cluster_key)) {
-			user_shm_key = true;
+			self->user_shm_key = true;
 			config.shm_key = PyInt_AsLong(py_shm_cluster_key);
 		}
 	}
@@ -658,6 +726,13 @@ static int AerospikeClient_Type_Init(AerospikeClient * self, PyObject * args, Py
 			config.policies.batch.use_batch_direct = PyInt_AsLong(py_use_batch_direct);
 		}
 
+		// Off to decode list and map bins from their msgpack, skipping the as_val tree
+		PyObject * py_deserialize = PyDict_GetItemString(py_policies, "deserialize");
+		if (py_deserialize && PyBool_Check(py_deserialize)) {
+			config.policies.read.deserialize = PyInt_AsLong(py_deserialize);
+			config.policies.batch.deserialize = PyInt_AsLong(py_deserialize);
+		}
+
 		/*
 		 * Generation policy is removed from constructor.
 		 */
@@ -729,6 +804,37 @@ static int AerospikeClient_Type_Init(AerospikeClient * self, PyObject * args, Py
  		}
 	}
 
+	PyObject * py_cache = PyDict_GetItemString(py_config, "cache");
+	if (py_cache && py_cache != Py_None) {
+		record_cache_destroy(self->cache);
+		self->cache = record_cache_new(py_cache);
+		if (!self->cache) {
+			return INIT_CACHE_ERR;
+		}
+	}
+
+	PyObject * py_limits = PyDict_GetItemString(py_config, "limits");
+	if (py_limits && py_limits != Py_None) {
+		request_limiter_destroy(self->limiter);
+		self->limiter = request_limiter_new(py_limits);
+		if (!self->limiter) {
+			return INIT_LIMITS_ERR;
+		}
+	}
+
+	PyObject * py_breaker = PyDict_GetItemString(py_config, "circuit_breaker");
+	if (py_breaker && py_breaker != Py_None) {
+		circuit_breaker_destroy(self->breaker);
+		self->breaker = circuit_breaker_new(py_breaker);
+		if (!self->breaker) {
+			return INIT_BREAKER_ERR;
+		}
+	}
+
+	if (!self->hedge_pool) {
+		self->hedge_pool = hedge_pool_new();
+	}
+
 	self->as = aerospike_new(&config);
 
 	return 0;
@@ -743,23 +849,33 @@ static void AerospikeClient_Type_Dealloc(PyObject * self)
 	AerospikeGlobalHosts* global_host = NULL;
 	AerospikeClient* client = (AerospikeClient*)self;
 
+	PyObject_GC_UnTrack(self);
+
 	// If the client has never connected
 	// It is safe to destroy the aerospike structure
 	if (!client->has_connected) {
 		aerospike_destroy(client->as);
+	} else if (client->is_conn_16 && client->connect_pid != getpid()) {
+		// Connected by the parent of a fork() and never rebuilt with post_fork().
+		// Closing would join a tend thread that does not exist in this process.
+		counter_batchers_close(client, true);
 	} else {
+		counter_batchers_close(client, false);
+		// Hedged reads that lost and node probes may still be using the connection
+		hedge_wait_idle(client->hedge_pool);
+		circuit_breaker_wait_idle(client->breaker);
 
 		// If the connection is possibly shared, use reference counted deletes
 		if (client->use_shared_connection) {
 			// If this client was still connected, deal with the global host object
 			if (client->is_conn_16) {
 				alias_to_search = return_search_string(client->as);
-				py_persistent_item = PyDict_GetItemString(py_global_hosts, alias_to_search);
+				py_persistent_item = PyDict_GetItemString(client->state->global_hosts, alias_to_search);
 				if (py_persistent_item) {
 					global_host = (AerospikeGlobalHosts*) py_persistent_item;
 					// Only modify the global as object if the client points to it
 					if (client->as == global_host->as) {
-						close_aerospike_object(client->as, &err, alias_to_search, py_persistent_item, false);
+						close_aerospike_object(client, &err, alias_to_search, py_persistent_item, false);
 					}
 				}
 			}
@@ -771,13 +887,71 @@ static void AerospikeClient_Type_Dealloc(PyObject * self)
 			aerospike_destroy(client->as);
 		}
 	}
-	self->ob_type->tp_free((PyObject *) self);
+	record_cache_destroy(client->cache);
+	request_limiter_destroy(client->limiter);
+	circuit_breaker_destroy(client->breaker);
+	hedge_pool_destroy(client->hedge_pool);
+	span_tracer_destroy(client->tracer);
+	Py_XDECREF(client->py_module);
+	PyTypeObject * type = Py_TYPE(self);
+	type->tp_free((PyObject *) self);
+	AS_TYPE_RELEASE(type);
+}
+
+/**
+ * The tracer's callback is the only Python object the client holds that may
+ * refer back to it, as a bound method or a closure over the client.
+ */
+static int AerospikeClient_Type_Traverse(PyObject * self, visitproc visit, void * arg)
+{
+	AerospikeClient * client = (AerospikeClient *) self;
+	if (client->tracer) {
+		Py_VISIT(client->tracer->callback);
+	}
+#ifdef AS_HEAP_TYPES
+	Py_VISIT(Py_TYPE(self));
+#endif
+	return 0;
+}
+
+static int AerospikeClient_Type_Clear(PyObject * self)
+{
+	AerospikeClient * client = (AerospikeClient *) self;
+	span_tracer * tracer = client->tracer;
+	client->tracer = NULL;
+	span_tracer_destroy(tracer);
+	return 0;
 }
 
 /*******************************************************************************
  * PYTHON TYPE DESCRIPTOR
  ******************************************************************************/
 
+#ifdef AS_HEAP_TYPES
+
+static PyType_Slot AerospikeClient_Type_Slots[] = {
+	{Py_tp_dealloc, (void *) AerospikeClient_Type_Dealloc},
+	{Py_tp_doc, (void *)
+		"The Client class manages the connections and trasactions against\n"
+		"an Aerospike cluster.\n"},
+	{Py_tp_methods, (void *) AerospikeClient_Type_Methods},
+	{Py_tp_init, (void *) AerospikeClient_Type_Init},
+	{Py_tp_new, (void *) AerospikeClient_Type_New},
+	{Py_tp_traverse, (void *) AerospikeClient_Type_Traverse},
+	{Py_tp_clear, (void *) AerospikeClient_Type_Clear},
+	{0, NULL}
+};
+
+static PyType_Spec AerospikeClient_Type_Spec = {
+	"aerospike.Client",
+	sizeof(AerospikeClient),
+	0,
+	Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_HAVE_GC,
+	AerospikeClient_Type_Slots
+};
+
+#else
+
 static PyTypeObject AerospikeClient_Type = {
 	PyVarObject_HEAD_INIT(NULL, 0)
 	"aerospike.Client",                 // tp_name
@@ -799,13 +973,15 @@ static PyTypeObject AerospikeClient_Type = {
 	0,                                  // tp_getattro
 	0,                                  // tp_setattro
 	0,                                  // tp_as_buffer
-	Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+	Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_HAVE_GC,
 	                                    // tp_flags
 	"The Client class manages the connections and trasactions against\n"
 			"an Aerospike cluster.\n",
 	                                    // tp_doc
-	0,                                  // tp_traverse
-	0,                                  // tp_clear
+	(traverseproc) AerospikeClient_Type_Traverse,
+	                                    // tp_traverse
+	(inquiry) AerospikeClient_Type_Clear,
+	                                    // tp_clear
 	0,                                  // tp_richcompare
 	0,                                  // tp_weaklistoffset
 	0,                                  // tp_iter
@@ -827,6 +1003,8 @@ static PyTypeObject AerospikeClient_Type = {
 	0                                   // tp_bases
 };
 
+#endif
+
 
 /*******************************************************************************
  * PUBLIC FUNCTIONS
@@ -834,16 +1012,21 @@ static PyTypeObject AerospikeClient_Type = {
 
 PyTypeObject * AerospikeClient_Ready()
 {
+#ifdef AS_HEAP_TYPES
+	return (PyTypeObject *) PyType_FromSpec(&AerospikeClient_Type_Spec);
+#else
 	return PyType_Ready(&AerospikeClient_Type) == 0 ? &AerospikeClient_Type : NULL;
+#endif
 }
 
 AerospikeClient * AerospikeClient_New(PyObject * parent, PyObject * args, PyObject * kwds)
 {
-	AerospikeClient * self = (AerospikeClient *) AerospikeClient_Type.tp_new(&AerospikeClient_Type, args, kwds);
+	PyTypeObject * type = aerospike_module_state(parent)->client_type;
+	AerospikeClient * self = (AerospikeClient *) type->tp_new(type, args, kwds);
 	as_error err;
 	as_error_init(&err);
 	int return_code = 0;
-	return_code = AerospikeClient_Type.tp_init((PyObject *) self, args, kwds);
+	return_code = type->tp_init((PyObject *) self, args, kwds);
 
 	switch(return_code) {
 		case 0	: {
@@ -891,6 +1074,18 @@ AerospikeClient * AerospikeClient_New(PyObject * parent, PyObject * args, PyObje
 			as_error_update(&err, AEROSPIKE_ERR_PARAM, "Compression value must not be negative");
 			break;
 		}
+		case INIT_CACHE_ERR: {
+			as_error_update(&err, AEROSPIKE_ERR_PARAM, "Invalid cache config");
+			break;
+		}
+		case INIT_LIMITS_ERR: {
+			as_error_update(&err, AEROSPIKE_ERR_PARAM, "Invalid limits config");
+			break;
+		}
+		case INIT_BREAKER_ERR: {
+			as_error_update(&err, AEROSPIKE_ERR_PARAM, "Invalid circuit_breaker config");
+			break;
+		}
 		default:
 			// If a generic error was caught during init, use this message
 			as_error_update(&err, AEROSPIKE_ERR_PARAM, "Invalid Parameters");
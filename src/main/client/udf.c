@@ -54,6 +54,8 @@ PyObject * AerospikeClient_UDF_Put(AerospikeClient * self, PyObject *args, PyObj
 	long language = 0;
 	PyObject * py_udf_type = NULL;
 	PyObject * py_policy = NULL;
+	PyObject * py_wait = NULL;
+	PyObject * py_task = NULL;
 	PyObject * py_ustr = NULL;
 	// This lets each component be 255 characters, and allows a '/'' in between them
 	uint32_t max_copy_path_length = AS_CONFIG_PATH_MAX_SIZE * 2 - 1;
@@ -64,11 +66,16 @@ PyObject * AerospikeClient_UDF_Put(AerospikeClient * self, PyObject *args, PyObj
 	FILE * file_p = NULL;
 	FILE * copy_file_p = NULL;
 	// Python Function Keyword Arguments
-	static char * kwlist[] = {"filename", "udf_type", "policy", NULL};
+	static char * kwlist[] = {"filename", "udf_type", "policy", "wait", NULL};
 
 	// Python Function Argument Parsing
-	if (PyArg_ParseTupleAndKeywords(args, kwds, "O|lO:udf_put", kwlist,
-				&py_filename, &language, &py_policy) == false) {
+	if (PyArg_ParseTupleAndKeywords(args, kwds, "O|lOO:udf_put", kwlist,
+				&py_filename, &language, &py_policy, &py_wait) == false) {
+		return NULL;
+	}
+
+	int should_wait = py_wait ? PyObject_IsTrue(py_wait) : 1;
+	if (should_wait == -1) {
 		return NULL;
 	}
 
@@ -220,8 +227,13 @@ PyObject * AerospikeClient_UDF_Put(AerospikeClient * self, PyObject *args, PyObj
 	if (err.code != AEROSPIKE_OK) {
 		as_error_update(&err, err.code, NULL);
 		goto CLEANUP;
-	} else {
+	} else if (should_wait) {
+		Py_BEGIN_ALLOW_THREADS
 		aerospike_udf_put_wait(self->as, &err, info_policy_p, as_basename(NULL, filename), 2000);
+		Py_END_ALLOW_THREADS
+	} else {
+		// Hand the registration back to the caller, see wait_for_task()
+		py_task = udf_task_to_pyobject(as_basename(NULL, filename));
 	}
 
 CLEANUP:
@@ -255,6 +267,10 @@ CLEANUP:
 		return NULL;
 	}
 
+	if (py_task) {
+		return py_task;
+	}
+
 	return PyLong_FromLong(0);
 }
 
@@ -41,6 +41,7 @@
 #include "policy.h"
 #include "serializer.h"
 #include "exceptions.h"
+#include "module_state.h"
 
 #define PY_KEYT_NAMESPACE 0
 #define PY_KEYT_SET 1
@@ -336,10 +337,21 @@ as_status pyobject_to_map(AerospikeClient * self, as_error * err, PyObject * py_
 	while (PyDict_Next(py_dict, &pos, &py_key, &py_val)) {
 		as_val * key = NULL;
 		as_val * val = NULL;
+		// The map hashes the key when it is set, so it cannot wait for a
+		// batch serializer to fill it in
+		serializer_batch * batch = serializer_batch_suspend();
 		pyobject_to_val(self, err, py_key, &key, static_pool, serializer_type);
+		serializer_batch_resume(batch);
 		if (err->code != AEROSPIKE_OK) {
 			break;
 		}
+		// Setting it again would destroy the value it holds, which may be
+		// waiting for the serializer
+		if (as_map_get(*map, key)) {
+			as_val_destroy(key);
+			as_error_update(err, AEROSPIKE_ERR_PARAM, "Map keys should not convert to the same value");
+			break;
+		}
 		pyobject_to_val(self, err, py_val, &val, static_pool, serializer_type);
 		if (err->code != AEROSPIKE_OK) {
 			if (key) {
@@ -398,14 +410,18 @@ as_status pyobject_to_val(AerospikeClient * self, as_error * err, PyObject * py_
 	} else if (PyString_Check(py_obj)) {
 		char * s = PyString_AsString(py_obj);
 		*val = (as_val *) as_string_new(s, false);
-	} else if (!strcmp(py_obj->ob_type->tp_name, "aerospike.Geospatial")) {
-		PyObject *py_parameter = PyString_FromString("geo_data");
-		PyObject* py_data = PyObject_GenericGetAttr(py_obj, py_parameter);
-		Py_DECREF(py_parameter);
-		char *geo_value = PyString_AsString(AerospikeGeospatial_DoDumps(py_data, err));
+	} else if (PyObject_TypeCheck(py_obj, self->state->geospatial_type)) {
 		if (aerospike_has_geo(self->as)) {
-			*val = (as_val *) as_geojson_new(geo_value, false);
+			char *geo_value = AerospikeGeospatial_GeoJSON(py_obj, err);
+			if (!geo_value) {
+				return err->code;
+			}
+			*val = (as_val *) as_geojson_new(geo_value, true);
 		} else {
+			PyObject* py_data = AerospikeGeospatial_GetData((AerospikeGeospatial *) py_obj, err);
+			if (!py_data) {
+				return err->code;
+			}
 			as_bytes *bytes;
 			GET_BYTES_POOL(bytes, static_pool, err);
 			if (err->code == AEROSPIKE_OK) {
@@ -440,7 +456,7 @@ as_status pyobject_to_val(AerospikeClient * self, as_error * err, PyObject * py_
 		}
 	} else if (Py_None == py_obj) {
 		*val = as_val_reserve(&as_nil);
-	} else if (!strcmp(py_obj->ob_type->tp_name, "aerospike.null")) {
+	} else if (PyObject_TypeCheck(py_obj, self->state->null_object_type)) {
 		*val = (as_val *) &as_nil;
 	} else {
 		if (aerospike_has_double(self->as) && PyFloat_Check(py_obj)) {
@@ -536,27 +552,18 @@ as_status pyobject_to_record(AerospikeClient * self, as_error * err, PyObject *
 					}
 				}
 				ret_val = as_record_set_int64(rec, name, val);
-			} else if (!strcmp(value->ob_type->tp_name, "aerospike.Geospatial")) {
-				PyObject *py_geo_string = PyString_FromString("geo_data");
-				PyObject* py_data = PyObject_GenericGetAttr(value, py_geo_string);
-				Py_DECREF(py_geo_string);
-				PyObject *py_dumps = AerospikeGeospatial_DoDumps(py_data, err);
-				PyObject * py_ustr = NULL;
-				char *geo_value = NULL;
-
-				if (PyUnicode_Check(py_dumps)) {
-					PyObject * py_ustr = PyUnicode_AsUTF8String(py_dumps);
-					if (!py_ustr) {
-						return as_error_update(err, AEROSPIKE_ERR_CLIENT, "Unicode value not encoded in utf-8.");
-					}
-					geo_value = PyBytes_AsString(py_ustr);
-				} else {
-					geo_value = PyString_AsString(py_dumps);
-				}
-
+			} else if (PyObject_TypeCheck(value, self->state->geospatial_type)) {
 				if (aerospike_has_geo(self->as)) {
-					ret_val = as_record_set_geojson_strp(rec, name, strdup(geo_value), true);
+					char *geo_value = AerospikeGeospatial_GeoJSON(value, err);
+					if (!geo_value) {
+						return err->code;
+					}
+					ret_val = as_record_set_geojson_strp(rec, name, geo_value, true);
 				} else {
+					PyObject* py_data = AerospikeGeospatial_GetData((AerospikeGeospatial *) value, err);
+					if (!py_data) {
+						return err->code;
+					}
 					as_bytes *bytes;
 					GET_BYTES_POOL(bytes, static_pool, err);
 					if (err->code == AEROSPIKE_OK) {
@@ -567,11 +574,6 @@ as_status pyobject_to_record(AerospikeClient * self, as_error * err, PyObject *
 						ret_val = as_record_set_bytes(rec, name, bytes);
 					}
 				}
-				if (py_ustr != NULL) {
-					Py_DECREF(py_ustr);
-				}
-				Py_DECREF(py_data);
-				Py_DECREF(py_dumps);
 			} else if (PyUnicode_Check(value)) {
 				PyObject * py_ustr = PyUnicode_AsUTF8String(value);
 				if (!py_ustr) {
@@ -609,7 +611,7 @@ as_status pyobject_to_record(AerospikeClient * self, as_error * err, PyObject *
 					break;
 				}
 				ret_val = as_record_set_map(rec, name, map);
-			} else if (!strcmp(value->ob_type->tp_name, "aerospike.null")) {
+			} else if (PyObject_TypeCheck(value, self->state->null_object_type)) {
 				ret_val = as_record_set_nil(rec, name);
 			} else {
 				if (aerospike_has_double(self->as) && PyFloat_Check(value)) {
@@ -728,14 +730,18 @@ as_status pyobject_to_astype_write(AerospikeClient * self, as_error * err, PyObj
 	} else if (PyString_Check(py_value)) {
 		char * s = PyString_AsString(py_value);
 		*val = (as_val *) as_string_new(s, false);
-	} else if (!strcmp(py_value->ob_type->tp_name, "aerospike.Geospatial")) {
-		PyObject *py_parameter = PyString_FromString("geo_data");
-		PyObject* py_data = PyObject_GenericGetAttr(py_value, py_parameter);
-		Py_DECREF(py_parameter);
-		char *geo_value = PyString_AsString(AerospikeGeospatial_DoDumps(py_data, err));
+	} else if (PyObject_TypeCheck(py_value, self->state->geospatial_type)) {
 		if (aerospike_has_geo(self->as)) {
-			*val = (as_val *) as_geojson_new(geo_value, false);
+			char *geo_value = AerospikeGeospatial_GeoJSON(py_value, err);
+			if (!geo_value) {
+				return err->code;
+			}
+			*val = (as_val *) as_geojson_new(geo_value, true);
 		} else {
+			PyObject* py_data = AerospikeGeospatial_GetData((AerospikeGeospatial *) py_value, err);
+			if (!py_data) {
+				return err->code;
+			}
 			as_bytes *bytes;
 			GET_BYTES_POOL(bytes, static_pool, err);
 			if (err->code == AEROSPIKE_OK) {
@@ -762,7 +768,7 @@ as_status pyobject_to_astype_write(AerospikeClient * self, as_error * err, PyObj
 		if (err->code == AEROSPIKE_OK) {
 			*val = (as_val *) map;
 		}
-	} else if (!strcmp(py_value->ob_type->tp_name, "aerospike.null")) {
+	} else if (PyObject_TypeCheck(py_value, self->state->null_object_type)) {
 		*val = (as_val *) &as_nil;
 	} else {
 		if (aerospike_has_double(self->as) && PyFloat_Check(py_value)) {
@@ -1030,13 +1036,7 @@ as_status do_val_to_pyobject(AerospikeClient * self, as_error * err, const as_va
 		case AS_GEOJSON: {
 			as_geojson * gp = as_geojson_fromval(val);
 			char * locstr = as_geojson_get(gp);
-			PyObject *py_locstr = PyString_FromString(locstr);
-			PyObject *py_loads = AerospikeGeospatial_DoLoads(py_locstr, err);
-			*py_val = AerospikeGeospatial_New(err, py_loads);
-			Py_DECREF(py_locstr);
-			if (py_loads) {
-				Py_DECREF(py_loads);
-			}
+			*py_val = AerospikeGeospatial_New_GeoJSON(err, locstr);
 			break;
 		}
 		default: {
@@ -1206,7 +1206,9 @@ as_status do_record_to_pyobject(AerospikeClient * self, as_error * err, const as
 	PyObject * py_rec_key = NULL;
 	PyObject * py_rec_meta = NULL;
 	PyObject * py_rec_bins = NULL;
+	deserializer_batch blobs;
 
+	deserializer_batch_begin(self, &blobs);
 	key_to_pyobject(err, key ? key : &rec->key, &py_rec_key);
 	metadata_to_pyobject(err, rec, &py_rec_meta);
 	bins_to_pyobject(self, err, rec, &py_rec_bins, cnvt_list_to_map);
@@ -1230,6 +1232,7 @@ as_status do_record_to_pyobject(AerospikeClient * self, as_error * err, const as
 	PyTuple_SetItem(py_rec, 0, py_rec_key);
 	PyTuple_SetItem(py_rec, 1, py_rec_meta);
 	PyTuple_SetItem(py_rec, 2, py_rec_bins);
+	deserializer_batch_end(&blobs, py_rec, err);
 
 	*obj = py_rec;
 	return err->code;
@@ -1533,13 +1536,19 @@ void initialize_bin_for_strictypes(AerospikeClient *self, as_error *err, PyObjec
 		pyobject_to_map(self, err, py_value, &map, static_pool, SERIALIZER_PYTHON);
 		((as_val *) &binop_bin->value)->type = AS_UNKNOWN;
 		binop_bin->valuep = (as_bin_value *) map;
-	} else if (!strcmp(py_value->ob_type->tp_name, "aerospike.Geospatial")) {
-		PyObject* py_data = PyObject_GenericGetAttr(py_value, PyString_FromString("geo_data"));
-		char *geo_value = PyString_AsString(AerospikeGeospatial_DoDumps(py_data, err));
+	} else if (PyObject_TypeCheck(py_value, self->state->geospatial_type)) {
 		if (aerospike_has_geo(self->as)) {
-			as_geojson_init((as_geojson *) &binop_bin->value, geo_value, false);
+			char *geo_value = AerospikeGeospatial_GeoJSON(py_value, err);
+			if (!geo_value) {
+				return;
+			}
+			as_geojson_init((as_geojson *) &binop_bin->value, geo_value, true);
 			binop_bin->valuep = &binop_bin->value;
 		} else {
+			PyObject* py_data = AerospikeGeospatial_GetData((AerospikeGeospatial *) py_value, err);
+			if (!py_data) {
+				return;
+			}
 			as_bytes *bytes;
 			GET_BYTES_POOL(bytes, static_pool, err);
 			serialize_based_on_serializer_policy(self, SERIALIZER_PYTHON,
@@ -1547,7 +1556,7 @@ void initialize_bin_for_strictypes(AerospikeClient *self, as_error *err, PyObjec
 			((as_val *) &binop_bin->value)->type = AS_UNKNOWN;
 			binop_bin->valuep = (as_bin_value *) bytes;
 		}
-	} else if (!strcmp(py_value->ob_type->tp_name, "aerospike.null")) {
+	} else if (PyObject_TypeCheck(py_value, self->state->null_object_type)) {
 		((as_val *) &binop_bin->value)->type = AS_UNKNOWN;
 		binop_bin->valuep = (as_bin_value *) &as_nil;
 	} else if (PyByteArray_Check(py_value)) {
@@ -1675,3 +1684,66 @@ as_status pyobject_to_index(AerospikeClient * self, as_error * err, PyObject * p
 	return err->code;
 }
 
+
+/**
+ *******************************************************************************************************
+ * Initializes a UnicodePyObjects pool. Space for capacity objects is
+ * allocated up front when the number of bin names is known, otherwise the
+ * pool grows on the first add.
+ *******************************************************************************************************
+ */
+void unicode_objects_init(UnicodePyObjects * u_objs, int capacity)
+{
+	u_objs->ob = NULL;
+	u_objs->size = 0;
+	u_objs->capacity = 0;
+
+	if (capacity > MAX_UNICODE_OBJECTS) {
+		capacity = MAX_UNICODE_OBJECTS;
+	}
+	if (capacity > 0) {
+		u_objs->ob = (PyObject **) malloc(sizeof(PyObject *) * capacity);
+		if (u_objs->ob) {
+			u_objs->capacity = capacity;
+		}
+	}
+}
+
+/**
+ *******************************************************************************************************
+ * Stores a new reference in the pool, which releases it in
+ * unicode_objects_destroy(). Returns py_obj so the call can wrap
+ * PyUnicode_AsUTF8String(). The pool grows as needed; if it cannot,
+ * py_obj is released and NULL is returned.
+ *******************************************************************************************************
+ */
+PyObject * unicode_objects_add(UnicodePyObjects * u_objs, PyObject * py_obj)
+{
+	if (u_objs->size == u_objs->capacity) {
+		int capacity = u_objs->capacity ? u_objs->capacity * 2 : 8;
+		PyObject ** ob = u_objs->capacity < INT_MAX / 2 ?
+			(PyObject **) realloc(u_objs->ob, sizeof(PyObject *) * capacity) : NULL;
+		if (!ob) {
+			Py_XDECREF(py_obj);
+			return NULL;
+		}
+		u_objs->ob = ob;
+		u_objs->capacity = capacity;
+	}
+
+	u_objs->ob[u_objs->size++] = py_obj;
+	return py_obj;
+}
+
+void unicode_objects_destroy(UnicodePyObjects * u_objs)
+{
+	for (int i = 0; i < u_objs->size; i++) {
+		Py_XDECREF(u_objs->ob[i]);
+	}
+	if (u_objs->ob) {
+		free(u_objs->ob);
+	}
+	u_objs->ob = NULL;
+	u_objs->size = 0;
+	u_objs->capacity = 0;
+}
@@ -0,0 +1,446 @@
+/*******************************************************************************
+ * Copyright 2013-2016 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include <Python.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include <aerospike/aerospike_key.h>
+#include <aerospike/as_error.h>
+#include <aerospike/as_operations.h>
+#include <aerospike/as_record.h>
+#include <citrusleaf/cf_clock.h>
+
+#include "cache.h"
+#include "counter_batcher.h"
+#include "module_state.h"
+
+// Records are spread over this many threads on each flush
+#define COUNTER_BATCHER_FLUSH_THREADS 16
+
+/*******************************************************************************
+ * PENDING TABLE
+ ******************************************************************************/
+
+static counter_batcher_table * batcher_table_new(uint32_t n_buckets)
+{
+	counter_batcher_table * table = (counter_batcher_table *) calloc(1, sizeof(counter_batcher_table));
+	table->buckets = (counter_batcher_entry **) calloc(n_buckets, sizeof(counter_batcher_entry *));
+	return table;
+}
+
+static counter_batcher_entry ** batcher_bucket(counter_batcher_state * state, counter_batcher_table * table,
+		as_key * key)
+{
+	uint32_t hash;
+	memcpy(&hash, key->digest.value, sizeof(hash));
+	return &table->buckets[hash & (state->n_buckets - 1)];
+}
+
+/**
+ * Frees the entries, keeping the buckets and the entry array for reuse.
+ */
+static void batcher_table_reset(counter_batcher_state * state, counter_batcher_table * table)
+{
+	for (uint32_t i = 0; i < table->n_entries; i++) {
+		counter_batcher_entry * entry = table->entries[i];
+		*batcher_bucket(state, table, &entry->key) = NULL;
+		for (uint32_t j = 0; j < entry->n_bins; j++) {
+			if (entry->bins[j].appends) {
+				as_arraylist_destroy(entry->bins[j].appends);
+			}
+		}
+		as_key_destroy(&entry->key);
+		free(entry->bins);
+		free(entry);
+	}
+	table->n_entries = 0;
+}
+
+static void batcher_table_destroy(counter_batcher_state * state, counter_batcher_table * table)
+{
+	if (!table) {
+		return;
+	}
+	batcher_table_reset(state, table);
+	free(table->entries);
+	free(table->buckets);
+	free(table);
+}
+
+/**
+ * Finds or adds the bin of the key's entry. Must hold the state's lock.
+ */
+static counter_batcher_bin * batcher_pending_bin(counter_batcher_state * state, as_key * key, const char * bin_name)
+{
+	counter_batcher_table * table = state->pending;
+	counter_batcher_entry ** slot = batcher_bucket(state, table, key);
+	while (*slot && (memcmp((*slot)->key.digest.value, key->digest.value, AS_DIGEST_VALUE_SIZE) ||
+				strcmp((*slot)->key.ns, key->ns))) {
+		slot = &(*slot)->hash_next;
+	}
+
+	counter_batcher_entry * entry = *slot;
+	if (!entry) {
+		if (table->n_entries == table->capacity) {
+			table->capacity = table->capacity ? table->capacity * 2 : 64;
+			table->entries = (counter_batcher_entry **) realloc(table->entries,
+					sizeof(counter_batcher_entry *) * table->capacity);
+		}
+		entry = (counter_batcher_entry *) calloc(1, sizeof(counter_batcher_entry));
+		as_key_init_digest(&entry->key, key->ns, key->set, key->digest.value);
+		*slot = entry;
+		table->entries[table->n_entries++] = entry;
+	}
+
+	for (uint32_t i = 0; i < entry->n_bins; i++) {
+		if (!strcmp(entry->bins[i].name, bin_name)) {
+			return &entry->bins[i];
+		}
+	}
+
+	if (entry->n_bins == entry->capacity) {
+		entry->capacity = entry->capacity ? entry->capacity * 2 : 2;
+		entry->bins = (counter_batcher_bin *) realloc(entry->bins, sizeof(counter_batcher_bin) * entry->capacity);
+	}
+	counter_batcher_bin * bin = &entry->bins[entry->n_bins++];
+	memset(bin, 0, sizeof(counter_batcher_bin));
+	strcpy(bin->name, bin_name);
+	return bin;
+}
+
+uint32_t counter_batcher_add_increment(counter_batcher_state * state, as_key * key, const char * bin_name,
+		bool is_double, int64_t int_value, double double_value)
+{
+	pthread_mutex_lock(&state->lock);
+	counter_batcher_bin * bin = batcher_pending_bin(state, key, bin_name);
+
+	// Once a float is added the bin's total is kept as a float
+	if (is_double && !bin->is_double) {
+		bin->double_value = (double) bin->int_value;
+		bin->is_double = true;
+	}
+	if (bin->is_double) {
+		bin->double_value += is_double ? double_value : (double) int_value;
+	} else {
+		bin->int_value += int_value;
+	}
+	bin->has_increment = true;
+
+	state->updates++;
+	uint32_t n_pending = state->pending->n_entries;
+	pthread_mutex_unlock(&state->lock);
+	return n_pending;
+}
+
+uint32_t counter_batcher_add_append(counter_batcher_state * state, as_key * key, const char * bin_name, as_val * value)
+{
+	pthread_mutex_lock(&state->lock);
+	counter_batcher_bin * bin = batcher_pending_bin(state, key, bin_name);
+
+	if (!bin->appends) {
+		bin->appends = as_arraylist_new(4, 4);
+	}
+	as_arraylist_append(bin->appends, value);
+
+	state->updates++;
+	uint32_t n_pending = state->pending->n_entries;
+	pthread_mutex_unlock(&state->lock);
+	return n_pending;
+}
+
+/*******************************************************************************
+ * FLUSH
+ ******************************************************************************/
+
+typedef struct {
+	counter_batcher_state * state;
+	counter_batcher_table * table;
+	pthread_mutex_t lock;
+	uint32_t next;
+} batcher_flush_job;
+
+static void batcher_record_failure(counter_batcher_state * state, as_key * key, as_error * err)
+{
+	pthread_mutex_lock(&state->lock);
+	state->errors++;
+	if (state->n_failures < COUNTER_BATCHER_MAX_FAILURES) {
+		counter_batcher_failure * failure = &state->failures[state->n_failures++];
+		as_key_init_digest(&failure->key, key->ns, key->set, key->digest.value);
+		as_error_copy(&failure->error, err);
+	}
+	pthread_mutex_unlock(&state->lock);
+}
+
+/**
+ * Writes one record with a single operate holding all of its merged
+ * increments and appends.
+ */
+static void batcher_write_entry(counter_batcher_state * state, counter_batcher_entry * entry)
+{
+	as_error err;
+	as_operations ops;
+	as_record * rec = NULL;
+	uint16_t n_ops = 0;
+
+	as_error_init(&err);
+
+	for (uint32_t i = 0; i < entry->n_bins; i++) {
+		n_ops += entry->bins[i].has_increment + (entry->bins[i].appends != NULL);
+	}
+	as_operations_init(&ops, n_ops);
+
+	for (uint32_t i = 0; i < entry->n_bins; i++) {
+		counter_batcher_bin * bin = &entry->bins[i];
+		if (bin->has_increment) {
+			if (bin->is_double) {
+				as_operations_add_incr_double(&ops, bin->name, bin->double_value);
+			} else {
+				as_operations_add_incr(&ops, bin->name, bin->int_value);
+			}
+		}
+		if (bin->appends) {
+			// The operation takes over the list
+			as_operations_add_list_append_items(&ops, bin->name, (as_list *) bin->appends);
+			bin->appends = NULL;
+		}
+	}
+
+	aerospike_key_operate(state->as, &err, &state->policy, &entry->key, &ops, &rec);
+
+	if (rec) {
+		as_record_destroy(rec);
+	}
+	as_operations_destroy(&ops);
+
+	if (err.code != AEROSPIKE_OK) {
+		batcher_record_failure(state, &entry->key, &err);
+	}
+}
+
+static void * batcher_flush_worker(void * udata)
+{
+	batcher_flush_job * job = (batcher_flush_job *) udata;
+
+	while (true) {
+		pthread_mutex_lock(&job->lock);
+		uint32_t i = job->next++;
+		pthread_mutex_unlock(&job->lock);
+
+		if (i >= job->table->n_entries) {
+			break;
+		}
+		batcher_write_entry(job->state, job->table->entries[i]);
+	}
+	return NULL;
+}
+
+uint32_t counter_batcher_flush(counter_batcher_state * state)
+{
+	pthread_mutex_lock(&state->lock);
+	counter_batcher_table * table = state->pending;
+	if (!table->n_entries || state->detached) {
+		pthread_mutex_unlock(&state->lock);
+		return 0;
+	}
+	state->n_flushing++;
+	if (state->spare) {
+		state->pending = state->spare;
+		state->spare = NULL;
+	} else {
+		// Another flush is using the spare table
+		state->pending = batcher_table_new(state->n_buckets);
+	}
+	pthread_mutex_unlock(&state->lock);
+
+	uint64_t start = cf_getus();
+
+	batcher_flush_job job;
+	job.state = state;
+	job.table = table;
+	job.next = 0;
+	pthread_mutex_init(&job.lock, NULL);
+
+	// Writes go out concurrently, the calling thread being one of the writers
+	pthread_t threads[COUNTER_BATCHER_FLUSH_THREADS - 1];
+	uint32_t n_threads = 0;
+	while (n_threads < COUNTER_BATCHER_FLUSH_THREADS - 1 && n_threads + 1 < table->n_entries) {
+		if (pthread_create(&threads[n_threads], NULL, batcher_flush_worker, &job) != 0) {
+			break;
+		}
+		n_threads++;
+	}
+	batcher_flush_worker(&job);
+	for (uint32_t i = 0; i < n_threads; i++) {
+		pthread_join(threads[i], NULL);
+	}
+	pthread_mutex_destroy(&job.lock);
+
+	uint64_t elapsed = cf_getus() - start;
+	uint32_t n_records = table->n_entries;
+
+	if (state->cache) {
+		// Reads cached before the write went out are now stale
+		aerospike_gil gil;
+		aerospike_gil_ensure(state->interp, &gil);
+		for (uint32_t i = 0; i < n_records; i++) {
+			record_cache_invalidate(state->cache, &table->entries[i]->key);
+		}
+		aerospike_gil_release(&gil);
+	}
+
+	pthread_mutex_lock(&state->lock);
+	state->flushes++;
+	state->records += n_records;
+	state->last_flush_us = elapsed;
+	state->total_flush_us += elapsed;
+	if (elapsed > state->max_flush_us) {
+		state->max_flush_us = elapsed;
+	}
+	pthread_mutex_unlock(&state->lock);
+
+	batcher_table_reset(state, table);
+	pthread_mutex_lock(&state->lock);
+	if (!state->spare) {
+		state->spare = table;
+		table = NULL;
+	}
+	state->n_flushing--;
+	pthread_cond_broadcast(&state->cond);
+	pthread_mutex_unlock(&state->lock);
+	batcher_table_destroy(state, table);
+	return n_records;
+}
+
+/*******************************************************************************
+ * FLUSH THREAD
+ ******************************************************************************/
+
+static void * batcher_flush_thread(void * udata)
+{
+	counter_batcher_state * state = (counter_batcher_state *) udata;
+
+	pthread_mutex_lock(&state->lock);
+	while (!state->closed) {
+		struct timeval now;
+		struct timespec deadline;
+		gettimeofday(&now, NULL);
+		uint64_t ns = (uint64_t) now.tv_usec * 1000 + (uint64_t) state->flush_interval_ms * 1000000;
+		deadline.tv_sec = now.tv_sec + (time_t) (ns / 1000000000);
+		deadline.tv_nsec = (long) (ns % 1000000000);
+
+		int rc = 0;
+		while (!state->closed && rc != ETIMEDOUT) {
+			rc = pthread_cond_timedwait(&state->cond, &state->lock, &deadline);
+		}
+		if (state->closed) {
+			break;
+		}
+
+		pthread_mutex_unlock(&state->lock);
+		counter_batcher_flush(state);
+		pthread_mutex_lock(&state->lock);
+	}
+	pthread_mutex_unlock(&state->lock);
+	return NULL;
+}
+
+counter_batcher_state * counter_batcher_state_new(aerospike * as, record_cache * cache,
+		PyInterpreterState * interp, as_policy_operate * policy, uint32_t flush_interval_ms,
+		uint32_t max_pending)
+{
+	counter_batcher_state * state = (counter_batcher_state *) calloc(1, sizeof(counter_batcher_state));
+
+	state->as = as;
+	state->cache = cache;
+	state->interp = interp;
+	state->policy = *policy;
+	state->flush_interval_ms = flush_interval_ms;
+	state->max_pending = max_pending;
+	state->n_buckets = 1;
+	while (state->n_buckets < max_pending && state->n_buckets < COUNTER_BATCHER_MAX_BUCKETS) {
+		state->n_buckets <<= 1;
+	}
+
+	pthread_mutex_init(&state->lock, NULL);
+	pthread_cond_init(&state->cond, NULL);
+	state->pending = batcher_table_new(state->n_buckets);
+	state->spare = batcher_table_new(state->n_buckets);
+	state->failures = (counter_batcher_failure *) malloc(
+			sizeof(counter_batcher_failure) * COUNTER_BATCHER_MAX_FAILURES);
+
+	if (flush_interval_ms) {
+		state->has_thread = pthread_create(&state->thread, NULL, batcher_flush_thread, state) == 0;
+	}
+	return state;
+}
+
+void counter_batcher_stop(counter_batcher_state * state)
+{
+	pthread_mutex_lock(&state->lock);
+	state->closed = true;
+	pthread_cond_broadcast(&state->cond);
+	pthread_mutex_unlock(&state->lock);
+
+	if (state->has_thread) {
+		pthread_join(state->thread, NULL);
+		state->has_thread = false;
+	}
+	counter_batcher_flush(state);
+}
+
+void counter_batcher_disconnect(counter_batcher_state * state)
+{
+	pthread_mutex_lock(&state->lock);
+	state->closed = true;
+	state->detached = true;
+	while (state->n_flushing) {
+		pthread_cond_wait(&state->cond, &state->lock);
+	}
+	pthread_mutex_unlock(&state->lock);
+}
+
+void counter_batcher_abandon(counter_batcher_state * state)
+{
+	// The lock may have been held by a thread of the parent
+	pthread_mutex_init(&state->lock, NULL);
+	pthread_cond_init(&state->cond, NULL);
+
+	state->closed = true;
+	state->detached = true;
+	state->has_thread = false;
+	state->n_flushing = 0;
+	batcher_table_reset(state, state->pending);
+}
+
+void counter_batcher_state_destroy(counter_batcher_state * state)
+{
+	counter_batcher_stop(state);
+
+	for (uint32_t i = 0; i < state->n_failures; i++) {
+		as_key_destroy(&state->failures[i].key);
+	}
+	batcher_table_destroy(state, state->pending);
+	batcher_table_destroy(state, state->spare);
+	free(state->failures);
+	pthread_cond_destroy(&state->cond);
+	pthread_mutex_destroy(&state->lock);
+	free(state);
+}
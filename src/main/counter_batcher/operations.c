@@ -0,0 +1,411 @@
+/*******************************************************************************
+ * Copyright 2013-2016 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include <Python.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <aerospike/as_buffer.h>
+#include <aerospike/as_error.h>
+#include <aerospike/as_key.h>
+#include <aerospike/as_msgpack.h>
+#include <aerospike/as_serializer.h>
+
+#include "client.h"
+#include "conversions.h"
+#include "counter_batcher.h"
+#include "exceptions.h"
+#include "serializer.h"
+
+static bool batcher_raise(as_error * err)
+{
+	PyObject * py_err = NULL;
+	error_to_pyobject(err, &py_err);
+	PyObject *exception_type = raise_exception(err);
+	PyErr_SetObject(exception_type, py_err);
+	Py_DECREF(py_err);
+	return false;
+}
+
+/**
+ * Hands the failures of earlier flushes to on_error, as
+ * on_error(key, exception). They are queued because flushes may run on
+ * the batcher's own thread, which never calls into Python.
+ * Returns false with a Python error set if a callback raised.
+ */
+static bool batcher_report_failures(AerospikeCounterBatcher * self)
+{
+	counter_batcher_state * state = self->state;
+
+	while (true) {
+		counter_batcher_failure failure;
+
+		pthread_mutex_lock(&state->lock);
+		if (!state->n_failures) {
+			pthread_mutex_unlock(&state->lock);
+			return true;
+		}
+		failure = state->failures[--state->n_failures];
+		pthread_mutex_unlock(&state->lock);
+
+		if (!self->on_error || self->on_error == Py_None) {
+			as_key_destroy(&failure.key);
+			continue;
+		}
+
+		as_error err;
+		as_error_init(&err);
+		PyObject * py_key = NULL;
+		PyObject * py_err = NULL;
+		key_to_pyobject(&err, &failure.key, &py_key);
+		as_key_destroy(&failure.key);
+		error_to_pyobject(&failure.error, &py_err);
+		PyObject * py_exception = PyObject_CallObject(raise_exception(&failure.error), py_err);
+		Py_XDECREF(py_err);
+
+		PyObject * py_result = NULL;
+		if (py_key && py_exception) {
+			py_result = PyObject_CallFunctionObjArgs(self->on_error, py_key, py_exception, NULL);
+		}
+		Py_XDECREF(py_key);
+		Py_XDECREF(py_exception);
+
+		if (!py_result) {
+			return false;
+		}
+		Py_DECREF(py_result);
+	}
+}
+
+static bool batcher_check_open(AerospikeCounterBatcher * self)
+{
+	bool closed;
+	bool detached;
+
+	pthread_mutex_lock(&self->state->lock);
+	closed = self->state->closed;
+	detached = self->state->detached;
+	pthread_mutex_unlock(&self->state->lock);
+
+	if (closed) {
+		as_error err;
+		as_error_init(&err);
+		if (detached) {
+			as_error_update(&err, AEROSPIKE_ERR_CLUSTER, "The client of the counter batcher is closed");
+		} else {
+			as_error_update(&err, AEROSPIKE_ERR_CLIENT, "Counter batcher is closed");
+		}
+		return batcher_raise(&err);
+	}
+	return true;
+}
+
+/**
+ * Converts the key and computes its digest, which is all the batcher
+ * keeps of it.
+ */
+static as_status batcher_key(AerospikeCounterBatcher * self, as_error * err, PyObject * py_key, as_key * key)
+{
+	if (pyobject_to_key(err, py_key, key) != AEROSPIKE_OK) {
+		return err->code;
+	}
+	if (!as_key_digest(err, key)) {
+		as_key_destroy(key);
+		return err->code;
+	}
+	return AEROSPIKE_OK;
+}
+
+/**
+ * Bin names are copied into the pending record, so they are checked
+ * whether or not the client uses strict types.
+ */
+static as_status batcher_bin_name(AerospikeCounterBatcher * self, as_error * err, PyObject * py_bin, char ** bin)
+{
+	if (bin_strict_type_checking(self->client, err, py_bin, bin) != AEROSPIKE_OK) {
+		// Raised again by the caller
+		PyErr_Clear();
+		return err->code;
+	}
+	if (strlen(*bin) >= AS_BIN_NAME_MAX_SIZE) {
+		return as_error_update(err, AEROSPIKE_ERR_BIN_NAME, "A bin name should not exceed 14 characters limit");
+	}
+	return AEROSPIKE_OK;
+}
+
+/**
+ * Flushes in the calling thread once max_pending records are waiting.
+ */
+static bool batcher_after_update(AerospikeCounterBatcher * self, uint32_t n_pending)
+{
+	if (n_pending >= self->state->max_pending) {
+		Py_BEGIN_ALLOW_THREADS
+		counter_batcher_flush(self->state);
+		Py_END_ALLOW_THREADS
+	}
+	return batcher_report_failures(self);
+}
+
+/**
+ *******************************************************************************************************
+ * Merges an increment of a bin into the pending updates of the record.
+ *
+ *		batcher.increment(key, bin, value=1)
+ *
+ * In case of error,appropriate exceptions will be raised.
+ *******************************************************************************************************
+ */
+PyObject * AerospikeCounterBatcher_Increment(AerospikeCounterBatcher * self, PyObject * args, PyObject * kwds)
+{
+	PyObject * py_key = NULL;
+	PyObject * py_bin = NULL;
+	PyObject * py_value = NULL;
+	char * bin = NULL;
+	bool is_double = false;
+	int64_t int_value = 1;
+	double double_value = 0;
+	as_key key;
+
+	static char * kwlist[] = {"key", "bin", "value", NULL};
+
+	if (PyArg_ParseTupleAndKeywords(args, kwds, "OO|O:increment", kwlist,
+				&py_key, &py_bin, &py_value) == false) {
+		return NULL;
+	}
+
+	if (!batcher_check_open(self)) {
+		return NULL;
+	}
+
+	as_error err;
+	as_error_init(&err);
+
+	if (py_value) {
+		if (PyFloat_Check(py_value)) {
+			is_double = true;
+			double_value = PyFloat_AsDouble(py_value);
+		} else if (PyInt_Check(py_value) || PyLong_Check(py_value)) {
+			int_value = PyLong_AsLongLong(py_value);
+			if (int_value == -1 && PyErr_Occurred()) {
+				PyErr_Clear();
+				as_error_update(&err, AEROSPIKE_ERR_PARAM, "Value exceeds the integer range");
+				batcher_raise(&err);
+				return NULL;
+			}
+		} else {
+			as_error_update(&err, AEROSPIKE_ERR_PARAM, "Value should be an integer or a float");
+			batcher_raise(&err);
+			return NULL;
+		}
+	}
+
+	if (batcher_bin_name(self, &err, py_bin, &bin) != AEROSPIKE_OK ||
+			batcher_key(self, &err, py_key, &key) != AEROSPIKE_OK) {
+		batcher_raise(&err);
+		return NULL;
+	}
+
+	uint32_t n_pending = counter_batcher_add_increment(self->state, &key, bin, is_double, int_value, double_value);
+	as_key_destroy(&key);
+
+	if (!batcher_after_update(self, n_pending)) {
+		return NULL;
+	}
+	return PyLong_FromLong(0);
+}
+
+/**
+ *******************************************************************************************************
+ * Queues a value to append to a list bin of the record. Values appended to
+ * the same bin before a flush are sent as one list append.
+ *
+ *		batcher.list_append(key, bin, value)
+ *
+ * In case of error,appropriate exceptions will be raised.
+ *******************************************************************************************************
+ */
+PyObject * AerospikeCounterBatcher_List_Append(AerospikeCounterBatcher * self, PyObject * args, PyObject * kwds)
+{
+	PyObject * py_key = NULL;
+	PyObject * py_bin = NULL;
+	PyObject * py_value = NULL;
+	char * bin = NULL;
+	as_val * val = NULL;
+	as_val * owned_val = NULL;
+	as_key key;
+	bool key_created = false;
+	uint32_t n_pending = 0;
+
+	static char * kwlist[] = {"key", "bin", "value", NULL};
+
+	if (PyArg_ParseTupleAndKeywords(args, kwds, "OOO:list_append", kwlist,
+				&py_key, &py_bin, &py_value) == false) {
+		return NULL;
+	}
+
+	if (!batcher_check_open(self)) {
+		return NULL;
+	}
+
+	as_error err;
+	as_error_init(&err);
+
+	as_static_pool static_pool;
+	memset(&static_pool, 0, sizeof(static_pool));
+
+	if (batcher_bin_name(self, &err, py_bin, &bin) != AEROSPIKE_OK) {
+		goto CLEANUP;
+	}
+	if (pyobject_to_astype_write(self->client, &err, py_value, &val,
+				&static_pool, SERIALIZER_PYTHON) != AEROSPIKE_OK) {
+		goto CLEANUP;
+	}
+
+	// The converted value may point into the static pool, so keep a copy
+	as_serializer ser;
+	as_buffer buffer;
+	as_buffer_init(&buffer);
+	as_msgpack_init(&ser);
+	if (as_serializer_serialize(&ser, val, &buffer) != 0 ||
+			as_serializer_deserialize(&ser, &buffer, &owned_val) != 0) {
+		as_error_update(&err, AEROSPIKE_ERR_CLIENT, "Unable to copy value");
+	}
+	as_serializer_destroy(&ser);
+	as_buffer_destroy(&buffer);
+	if (err.code != AEROSPIKE_OK) {
+		goto CLEANUP;
+	}
+
+	if (batcher_key(self, &err, py_key, &key) != AEROSPIKE_OK) {
+		goto CLEANUP;
+	}
+	key_created = true;
+
+	n_pending = counter_batcher_add_append(self->state, &key, bin, owned_val);
+	owned_val = NULL;
+
+CLEANUP:
+	if (val) {
+		as_val_destroy(val);
+	}
+	if (owned_val) {
+		as_val_destroy(owned_val);
+	}
+	if (key_created) {
+		as_key_destroy(&key);
+	}
+	POOL_DESTROY(&static_pool);
+
+	if (err.code != AEROSPIKE_OK) {
+		batcher_raise(&err);
+		return NULL;
+	}
+	if (!batcher_after_update(self, n_pending)) {
+		return NULL;
+	}
+	return PyLong_FromLong(0);
+}
+
+/**
+ *******************************************************************************************************
+ * Writes every pending record now, with the GIL released.
+ *
+ *		batcher.flush()
+ *
+ * Returns the number of records written, failures included.
+ * Failures are passed to on_error before flush() returns.
+ *******************************************************************************************************
+ */
+PyObject * AerospikeCounterBatcher_Flush(AerospikeCounterBatcher * self, PyObject * args, PyObject * kwds)
+{
+	uint32_t n_records = 0;
+
+	if (!batcher_check_open(self)) {
+		return NULL;
+	}
+
+	Py_BEGIN_ALLOW_THREADS
+	n_records = counter_batcher_flush(self->state);
+	Py_END_ALLOW_THREADS
+
+	if (!batcher_report_failures(self)) {
+		return NULL;
+	}
+	return PyLong_FromUnsignedLong(n_records);
+}
+
+/**
+ *******************************************************************************************************
+ * Stops the flush thread and writes what is pending. Further updates
+ * raise ClientError. Calling close() again does nothing.
+ *
+ *		batcher.close()
+ *
+ *******************************************************************************************************
+ */
+PyObject * AerospikeCounterBatcher_Close(AerospikeCounterBatcher * self, PyObject * args, PyObject * kwds)
+{
+	Py_BEGIN_ALLOW_THREADS
+	counter_batcher_stop(self->state);
+	Py_END_ALLOW_THREADS
+
+	if (!batcher_report_failures(self)) {
+		return NULL;
+	}
+	return PyLong_FromLong(0);
+}
+
+static void batcher_stats_set(PyObject * py_stats, const char * name, PyObject * py_value)
+{
+	PyDict_SetItemString(py_stats, name, py_value);
+	Py_DECREF(py_value);
+}
+
+/**
+ *******************************************************************************************************
+ * Returns the batcher's counters and flush latencies, in milliseconds.
+ *
+ *		batcher.stats()
+ *
+ *******************************************************************************************************
+ */
+PyObject * AerospikeCounterBatcher_Stats(AerospikeCounterBatcher * self, PyObject * args, PyObject * kwds)
+{
+	counter_batcher_state * state = self->state;
+	PyObject * py_stats = PyDict_New();
+
+	pthread_mutex_lock(&state->lock);
+	uint64_t updates = state->updates;
+	uint64_t flushes = state->flushes;
+	uint64_t records = state->records;
+	uint64_t errors = state->errors;
+	uint32_t pending = state->pending->n_entries;
+	uint64_t last_flush_us = state->last_flush_us;
+	uint64_t max_flush_us = state->max_flush_us;
+	uint64_t total_flush_us = state->total_flush_us;
+	pthread_mutex_unlock(&state->lock);
+
+	batcher_stats_set(py_stats, "updates", PyLong_FromUnsignedLongLong(updates));
+	batcher_stats_set(py_stats, "flushes", PyLong_FromUnsignedLongLong(flushes));
+	batcher_stats_set(py_stats, "records", PyLong_FromUnsignedLongLong(records));
+	batcher_stats_set(py_stats, "errors", PyLong_FromUnsignedLongLong(errors));
+	batcher_stats_set(py_stats, "pending", PyLong_FromUnsignedLong(pending));
+	batcher_stats_set(py_stats, "last_flush_ms", PyFloat_FromDouble(last_flush_us / 1000.0));
+	batcher_stats_set(py_stats, "max_flush_ms", PyFloat_FromDouble(max_flush_us / 1000.0));
+	batcher_stats_set(py_stats, "avg_flush_ms",
+			PyFloat_FromDouble(flushes ? total_flush_us / 1000.0 / flushes : 0.0));
+	return py_stats;
+}
@@ -0,0 +1,248 @@
+/*******************************************************************************
+ * Copyright 2013-2016 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include <Python.h>
+#include <structmember.h>
+#include <stdbool.h>
+
+#include <aerospike/aerospike.h>
+#include <aerospike/as_error.h>
+#include <aerospike/as_policy.h>
+
+#include "client.h"
+#include "counter_batcher.h"
+#include "conversions.h"
+#include "exceptions.h"
+#include "module_state.h"
+#include "policy.h"
+#include "macros.h"
+
+
+/*******************************************************************************
+ * PYTHON TYPE METHODS
+ ******************************************************************************/
+
+static PyMethodDef AerospikeCounterBatcher_Type_Methods[] = {
+
+	{"increment",	(PyCFunction) AerospikeCounterBatcher_Increment,	METH_VARARGS | METH_KEYWORDS,
+				"Add to a bin of a record on the next flush."},
+
+	{"list_append",	(PyCFunction) AerospikeCounterBatcher_List_Append,	METH_VARARGS | METH_KEYWORDS,
+				"Append to a list bin of a record on the next flush."},
+
+	{"flush",	(PyCFunction) AerospikeCounterBatcher_Flush,	METH_VARARGS | METH_KEYWORDS,
+				"Write every pending record now."},
+
+	{"close",	(PyCFunction) AerospikeCounterBatcher_Close,	METH_VARARGS | METH_KEYWORDS,
+				"Flush the pending records and stop the batcher."},
+
+	{"stats",	(PyCFunction) AerospikeCounterBatcher_Stats,	METH_VARARGS | METH_KEYWORDS,
+				"Return the batcher's counters and flush latencies."},
+	{NULL}
+};
+
+/*******************************************************************************
+ * PYTHON TYPE HOOKS
+ ******************************************************************************/
+
+static PyObject * AerospikeCounterBatcher_Type_New(PyTypeObject * type, PyObject * args, PyObject * kwds)
+{
+	AerospikeCounterBatcher * self = NULL;
+
+	self = (AerospikeCounterBatcher *) type->tp_alloc(type, 0);
+
+	return (PyObject *) self;
+}
+
+static int AerospikeCounterBatcher_Type_Init(AerospikeCounterBatcher * self, PyObject * args, PyObject * kwds)
+{
+	long flush_interval_ms = COUNTER_BATCHER_DEFAULT_FLUSH_INTERVAL;
+	long max_pending = COUNTER_BATCHER_DEFAULT_MAX_PENDING;
+	PyObject * py_on_error = NULL;
+	PyObject * py_policy = NULL;
+
+	static char * kwlist[] = {"flush_interval_ms", "max_pending", "on_error", "policy", NULL};
+
+	if (PyArg_ParseTupleAndKeywords(args, kwds, "|llOO:counter_batcher", kwlist,
+		&flush_interval_ms, &max_pending, &py_on_error, &py_policy) == false) {
+		return -1;
+	}
+
+	if (flush_interval_ms < 0 || max_pending < 1 || max_pending > UINT32_MAX / 2) {
+		return -1;
+	}
+	if (py_on_error && py_on_error != Py_None && !PyCallable_Check(py_on_error)) {
+		return -1;
+	}
+
+	as_error err;
+	as_error_init(&err);
+	as_policy_operate operate_policy;
+	as_policy_operate * operate_policy_p = &self->client->as->config.policies.operate;
+
+	if (pyobject_to_policy_operate(&err, py_policy, &operate_policy, &operate_policy_p,
+			&self->client->as->config.policies.operate) != AEROSPIKE_OK) {
+		return -1;
+	}
+
+	if (py_on_error && py_on_error != Py_None) {
+		Py_INCREF(py_on_error);
+		self->on_error = py_on_error;
+	}
+	self->state = counter_batcher_state_new(self->client->as, self->client->cache,
+			self->client->state->interp, operate_policy_p, (uint32_t) flush_interval_ms,
+			(uint32_t) max_pending);
+	self->state->py_batcher = (PyObject *) self;
+	counter_batcher_attach(self->client, self->state);
+	return 0;
+}
+
+static void AerospikeCounterBatcher_Type_Dealloc(PyObject * self)
+{
+	AerospikeCounterBatcher * batcher = (AerospikeCounterBatcher *) self;
+
+	if (batcher->state) {
+		counter_batcher_detach(batcher->client, batcher->state);
+		// Pending updates are still written, their failures go unreported
+		Py_BEGIN_ALLOW_THREADS
+		counter_batcher_state_destroy(batcher->state);
+		Py_END_ALLOW_THREADS
+	}
+	Py_XDECREF(batcher->on_error);
+	Py_XDECREF(batcher->client);
+	PyTypeObject * type = Py_TYPE(self);
+	type->tp_free((PyObject *) self);
+	AS_TYPE_RELEASE(type);
+}
+
+/*******************************************************************************
+ * PYTHON TYPE DESCRIPTOR
+ ******************************************************************************/
+
+#ifdef AS_HEAP_TYPES
+
+static PyType_Slot AerospikeCounterBatcher_Type_Slots[] = {
+	{Py_tp_dealloc, (void *) AerospikeCounterBatcher_Type_Dealloc},
+	{Py_tp_doc, (void *)
+		"The CounterBatcher class merges increments and list appends to the\n"
+		"same records and writes them with one operation per record. To create\n"
+		"a new instance of the CounterBatcher class, call the counter_batcher()\n"
+		"method on an instance of a Client class.\n"},
+	{Py_tp_methods, (void *) AerospikeCounterBatcher_Type_Methods},
+	{Py_tp_init, (void *) AerospikeCounterBatcher_Type_Init},
+	{Py_tp_new, (void *) AerospikeCounterBatcher_Type_New},
+	{0, NULL}
+};
+
+static PyType_Spec AerospikeCounterBatcher_Type_Spec = {
+	"aerospike.CounterBatcher",
+	sizeof(AerospikeCounterBatcher),
+	0,
+	Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+	AerospikeCounterBatcher_Type_Slots
+};
+
+#else
+
+static PyTypeObject AerospikeCounterBatcher_Type = {
+	PyVarObject_HEAD_INIT(NULL, 0)
+	"aerospike.CounterBatcher",         // tp_name
+	sizeof(AerospikeCounterBatcher),    // tp_basicsize
+	0,                                  // tp_itemsize
+	(destructor) AerospikeCounterBatcher_Type_Dealloc,
+	                                    // tp_dealloc
+	0,                                  // tp_print
+	0,                                  // tp_getattr
+	0,                                  // tp_setattr
+	0,                                  // tp_compare
+	0,                                  // tp_repr
+	0,                                  // tp_as_number
+	0,                                  // tp_as_sequence
+	0,                                  // tp_as_mapping
+	0,                                  // tp_hash
+	0,                                  // tp_call
+	0,                                  // tp_str
+	0,                                  // tp_getattro
+	0,                                  // tp_setattro
+	0,                                  // tp_as_buffer
+	Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+	                                    // tp_flags
+	"The CounterBatcher class merges increments and list appends to the\n"
+	"same records and writes them with one operation per record. To create\n"
+	"a new instance of the CounterBatcher class, call the counter_batcher()\n"
+	"method on an instance of a Client class.\n",
+										// tp_doc
+	0,                                  // tp_traverse
+	0,                                  // tp_clear
+	0,                                  // tp_richcompare
+	0,                                  // tp_weaklistoffset
+	0,                                  // tp_iter
+	0,                                  // tp_iternext
+	AerospikeCounterBatcher_Type_Methods,
+	                                    // tp_methods
+	0,                                  // tp_members
+	0,                                  // tp_getset
+	0,                                  // tp_base
+	0,                                  // tp_dict
+	0,                                  // tp_descr_get
+	0,                                  // tp_descr_set
+	0,                                  // tp_dictoffset
+	(initproc) AerospikeCounterBatcher_Type_Init,
+	                                    // tp_init
+	0,                                  // tp_alloc
+	AerospikeCounterBatcher_Type_New,   // tp_new
+	0,                                  // tp_free
+	0,                                  // tp_is_gc
+	0                                   // tp_bases
+};
+
+#endif
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONS
+ ******************************************************************************/
+
+PyTypeObject * AerospikeCounterBatcher_Ready()
+{
+#ifdef AS_HEAP_TYPES
+	return (PyTypeObject *) PyType_FromSpec(&AerospikeCounterBatcher_Type_Spec);
+#else
+	return PyType_Ready(&AerospikeCounterBatcher_Type) == 0 ? &AerospikeCounterBatcher_Type : NULL;
+#endif
+}
+
+AerospikeCounterBatcher * AerospikeCounterBatcher_New(AerospikeClient * client, PyObject * args, PyObject * kwds)
+{
+	PyTypeObject * type = client->state->counter_batcher_type;
+	AerospikeCounterBatcher * self = (AerospikeCounterBatcher *) type->tp_new(type, args, kwds);
+	self->client = client;
+	Py_INCREF(client);
+	if (type->tp_init((PyObject *) self, args, kwds) != -1) {
+		return self;
+	}
+	else {
+		Py_XDECREF(self);
+		as_error err;
+		as_error_init(&err);
+		as_error_update(&err, AEROSPIKE_ERR_PARAM, "Parameters are incorrect");
+		PyObject * py_err = NULL;
+		error_to_pyobject(&err, &py_err);
+		PyObject *exception_type = raise_exception(&err);
+		PyErr_SetObject(exception_type, py_err);
+		Py_XDECREF(py_err);
+		return NULL;
+	}
+}
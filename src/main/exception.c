@@ -25,12 +25,50 @@
 #include "exceptions.h"
 #include "exception_types.h"
 #include "macros.h"
+#include "module_state.h"
+
+/**
+ * Index every exception class of the module by its code. The first class
+ * with a given code wins, which is the class the module dict scan used to
+ * find first.
+ */
+static void exception_table_init(aerospike_state * state)
+{
+	PyObject * py_key = NULL, *py_value = NULL;
+	Py_ssize_t pos = 0;
+	PyObject * py_module_dict = PyModule_GetDict(state->exception_module);
+	PyObject ** exception_table = state->exception_table;
+
+	memset(state->exception_table, 0, sizeof(state->exception_table));
+	state->exception_default = PyDict_GetItemString(py_module_dict, "AerospikeError");
 
-static PyObject *module;
+	while (PyDict_Next(py_module_dict, &pos, &py_key, &py_value)) {
+		if (!PyExceptionClass_Check(py_value)) {
+			continue;
+		}
+		PyObject * py_code = PyObject_GetAttrString(py_value, "code");
+		if (!py_code) {
+			PyErr_Clear();
+			continue;
+		}
+		if (PyInt_Check(py_code) || PyLong_Check(py_code)) {
+			long code = PyInt_AsLong(py_code);
+			if (code >= EXCEPTION_CODE_MIN && code <= EXCEPTION_CODE_MAX &&
+					!exception_table[code - EXCEPTION_CODE_MIN]) {
+				exception_table[code - EXCEPTION_CODE_MIN] = py_value;
+			}
+		}
+		Py_DECREF(py_code);
+	}
+}
 
-PyObject * AerospikeException_New(void)
+PyObject * AerospikeException_New(aerospike_state * state)
 {
+	PyObject * module;
 	MOD_DEF(module, "aerospike.exception", "Exception objects", NULL);
+	if (!module) {
+		return NULL;
+	}
 
 	struct exceptions exceptions_array;
 
@@ -432,13 +470,15 @@ PyObject * AerospikeException_New(void)
 		PyObject_SetAttrString(*current_exception, "code", py_code);
 		Py_DECREF(py_code);
 	}
+
+	state->exception_module = module;
+	exception_table_init(state);
 	return module;
 }
 
 PyObject* raise_exception(as_error *err) {
-	PyObject * py_key = NULL, *py_value = NULL;
-	Py_ssize_t pos = 0;
-	PyObject * py_module_dict = PyModule_GetDict(module);
+	aerospike_state * state = aerospike_get_state();
+	PyObject * py_value = NULL;
 	char * err_msg= err->message, *err_code = err->message;
 	char *final_code = NULL;
 	if (err->code == AEROSPIKE_ERR_UDF) {
@@ -456,40 +496,40 @@ PyObject* raise_exception(as_error *err) {
 		}
 		free(final_code);
 	}
-	while (PyDict_Next(py_module_dict, &pos, &py_key, &py_value)) {
-		if (PyObject_HasAttrString(py_value, "code")) {
-			PyObject * py_code = PyObject_GetAttrString(py_value, "code");
-			if (py_code == Py_None) {
-				continue;
-			}
-			if (err->code == PyInt_AsLong(py_code)) {
-				PyObject *py_attr = NULL;
-				py_attr = PyString_FromString(err->message);
-				PyObject_SetAttrString(py_value, "msg", py_attr);
-				Py_DECREF(py_attr);
-
-				// as_error.file is a char* so this may be null
-				if(err->file) {
-					py_attr = PyString_FromString(err->file);
-					PyObject_SetAttrString(py_value, "file", py_attr);
-					Py_DECREF(py_attr);
-				} else {
-					PyObject_SetAttrString(py_value, "file", Py_None);
-
-				}
-				// If the line is 0, set it as None
-				if(err->line > 0) {
-					py_attr = PyInt_FromLong(err->line);
-					PyObject_SetAttrString(py_value, "line", py_attr);
-					Py_DECREF(py_attr);
-				} else {
-					PyObject_SetAttrString(py_value, "line", Py_None);
-				}
-
-				break;
-			}
-			Py_DECREF(py_code);
-		}
+
+	if (!state || !state->exception_default) {
+		// The module is being torn down
+		return PyExc_Exception;
+	}
+	if (err->code >= EXCEPTION_CODE_MIN && err->code <= EXCEPTION_CODE_MAX) {
+		py_value = state->exception_table[err->code - EXCEPTION_CODE_MIN];
+	}
+	if (!py_value) {
+		// No class has this code, raise the common base class
+		py_value = state->exception_default;
+	}
+
+	PyObject *py_attr = NULL;
+	py_attr = PyString_FromString(err->message);
+	PyObject_SetAttrString(py_value, "msg", py_attr);
+	Py_DECREF(py_attr);
+
+	// as_error.file is a char* so this may be null
+	if(err->file) {
+		py_attr = PyString_FromString(err->file);
+		PyObject_SetAttrString(py_value, "file", py_attr);
+		Py_DECREF(py_attr);
+	} else {
+		PyObject_SetAttrString(py_value, "file", Py_None);
+
+	}
+	// If the line is 0, set it as None
+	if(err->line > 0) {
+		py_attr = PyInt_FromLong(err->line);
+		PyObject_SetAttrString(py_value, "line", py_attr);
+		Py_DECREF(py_attr);
+	} else {
+		PyObject_SetAttrString(py_value, "line", Py_None);
 	}
 
 	return py_value;
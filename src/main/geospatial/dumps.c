@@ -28,23 +28,19 @@
 
 PyObject * AerospikeGeospatial_DoDumps(PyObject *geo_data, as_error *err)
 {
-	PyObject *initresult = NULL;
-
-	PyObject* sysmodules = PyImport_GetModuleDict();
-	PyObject* json_module = NULL;
-	if (PyMapping_HasKeyString(sysmodules, "json")) {
-		json_module = PyMapping_GetItemString(sysmodules, "json");
-	} else {
-		json_module = PyImport_ImportModule("json");
+	PyObject *initresult = geojson_dumps(geo_data);
+	if (initresult) {
+		return initresult;
 	}
 
+	// Not made of plain JSON types, json.dumps() knows what to do with it
+	PyObject* json_module = geojson_json_module();
 	if (!json_module) {
 		/* insert error handling here! and exit this function */
 		as_error_update(err, AEROSPIKE_ERR_CLIENT, "Unable to load json module");
 	} else {
 		PyObject *py_funcname = PyString_FromString("dumps");
 		initresult = PyObject_CallMethodObjArgs(json_module, py_funcname, geo_data, NULL);
-		Py_DECREF(json_module);
 		Py_DECREF(py_funcname);
 	}
 
@@ -65,6 +61,10 @@ PyObject * AerospikeGeospatial_Dumps(AerospikeGeospatial * self, PyObject * args
 		goto CLEANUP;
 	}
 
+	if (self->geojson) {
+		return PyString_FromString(self->geojson);
+	}
+
 	initresult = AerospikeGeospatial_DoDumps(self->geo_data, &err);
 	if (!initresult) {
 		as_error_update(&err, AEROSPIKE_ERR_CLIENT, "Unable to call dumps function");
@@ -0,0 +1,627 @@
+/*******************************************************************************
+ * Copyright 2013-2016 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include <Python.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "geo.h"
+#include "macros.h"
+
+// Deeper documents are left to the json module
+#define GEOJSON_MAX_DEPTH 64
+
+/**
+ * The json module, for what the C encoder and parser leave to it. It is
+ * imported once and kept for the life of the process.
+ */
+PyObject * geojson_json_module(void)
+{
+	static PyObject * json_module = NULL;
+
+	if (!json_module) {
+		json_module = PyImport_ImportModule("json");
+	}
+	return json_module;
+}
+
+/*******************************************************************************
+ * ENCODER
+ *
+ * Writes the same text as json.dumps() with its default arguments, for
+ * the types GeoJSON documents are made of. Anything else makes the
+ * encoder give up, and the caller falls back to the json module.
+ ******************************************************************************/
+
+typedef struct {
+	char * data;
+	size_t size;
+	size_t capacity;
+} geojson_buffer;
+
+static void buffer_append(geojson_buffer * buf, const char * data, size_t size)
+{
+	if (buf->size + size + 1 > buf->capacity) {
+		size_t capacity = buf->capacity ? buf->capacity : 128;
+		while (buf->size + size + 1 > capacity) {
+			capacity *= 2;
+		}
+		buf->data = (char *) realloc(buf->data, capacity);
+		buf->capacity = capacity;
+	}
+	memcpy(buf->data + buf->size, data, size);
+	buf->size += size;
+	buf->data[buf->size] = '\0';
+}
+
+static void buffer_append_str(geojson_buffer * buf, const char * str)
+{
+	buffer_append(buf, str, strlen(str));
+}
+
+/**
+ * Writes a UTF-8 string as a JSON string with every non-ASCII character
+ * escaped, as json.dumps() does by default.
+ */
+static bool encode_utf8(geojson_buffer * buf, const unsigned char * s, size_t len)
+{
+	char escape[16];
+	size_t i = 0;
+
+	buffer_append(buf, "\"", 1);
+	while (i < len) {
+		unsigned char c = s[i];
+		uint32_t cp;
+		size_t n;
+
+		if (c < 0x80) {
+			cp = c;
+			n = 1;
+		} else if ((c & 0xE0) == 0xC0) {
+			cp = c & 0x1F;
+			n = 2;
+		} else if ((c & 0xF0) == 0xE0) {
+			cp = c & 0x0F;
+			n = 3;
+		} else if ((c & 0xF8) == 0xF0) {
+			cp = c & 0x07;
+			n = 4;
+		} else {
+			return false;
+		}
+		if (i + n > len) {
+			return false;
+		}
+		for (size_t j = 1; j < n; j++) {
+			if ((s[i + j] & 0xC0) != 0x80) {
+				return false;
+			}
+			cp = (cp << 6) | (s[i + j] & 0x3F);
+		}
+		i += n;
+
+		switch (cp) {
+			case '"':  buffer_append(buf, "\\\"", 2); break;
+			case '\\': buffer_append(buf, "\\\\", 2); break;
+			case '\n': buffer_append(buf, "\\n", 2); break;
+			case '\r': buffer_append(buf, "\\r", 2); break;
+			case '\t': buffer_append(buf, "\\t", 2); break;
+			case '\b': buffer_append(buf, "\\b", 2); break;
+			case '\f': buffer_append(buf, "\\f", 2); break;
+			default:
+				if (cp >= 0x20 && cp < 0x7F) {
+					char ch = (char) cp;
+					buffer_append(buf, &ch, 1);
+				} else if (cp < 0x10000) {
+					snprintf(escape, sizeof(escape), "\\u%04x", cp);
+					buffer_append_str(buf, escape);
+				} else {
+					cp -= 0x10000;
+					snprintf(escape, sizeof(escape), "\\u%04x\\u%04x",
+							0xD800 | (cp >> 10), 0xDC00 | (cp & 0x3FF));
+					buffer_append_str(buf, escape);
+				}
+		}
+	}
+	buffer_append(buf, "\"", 1);
+	return true;
+}
+
+static bool encode_string(geojson_buffer * buf, PyObject * py_str)
+{
+	bool rc = false;
+
+	if (PyUnicode_CheckExact(py_str)) {
+		PyObject * py_utf8 = PyUnicode_AsUTF8String(py_str);
+		if (!py_utf8) {
+			PyErr_Clear();
+			return false;
+		}
+		rc = encode_utf8(buf, (unsigned char *) PyBytes_AsString(py_utf8), PyBytes_Size(py_utf8));
+		Py_DECREF(py_utf8);
+	}
+#if PY_MAJOR_VERSION < 3
+	else if (PyString_CheckExact(py_str)) {
+		rc = encode_utf8(buf, (unsigned char *) PyString_AsString(py_str), PyString_Size(py_str));
+	}
+#endif
+	return rc;
+}
+
+static bool encode_value(geojson_buffer * buf, PyObject * py_obj, int depth)
+{
+	char number[32];
+
+	if (depth > GEOJSON_MAX_DEPTH) {
+		return false;
+	}
+
+	if (py_obj == Py_None) {
+		buffer_append(buf, "null", 4);
+	} else if (py_obj == Py_True) {
+		buffer_append(buf, "true", 4);
+	} else if (py_obj == Py_False) {
+		buffer_append(buf, "false", 5);
+	} else if (PyFloat_CheckExact(py_obj)) {
+		double d = PyFloat_AS_DOUBLE(py_obj);
+		if (!isfinite(d)) {
+			return false;
+		}
+		char * repr = PyOS_double_to_string(d, 'r', 0, Py_DTSF_ADD_DOT_0, NULL);
+		if (!repr) {
+			PyErr_Clear();
+			return false;
+		}
+		buffer_append_str(buf, repr);
+		PyMem_Free(repr);
+	}
+#if PY_MAJOR_VERSION < 3
+	else if (PyInt_CheckExact(py_obj)) {
+		snprintf(number, sizeof(number), "%ld", PyInt_AS_LONG(py_obj));
+		buffer_append_str(buf, number);
+	}
+#endif
+	else if (PyLong_CheckExact(py_obj)) {
+		int overflow = 0;
+		long long l = PyLong_AsLongLongAndOverflow(py_obj, &overflow);
+		if (overflow || (l == -1 && PyErr_Occurred())) {
+			PyErr_Clear();
+			return false;
+		}
+		snprintf(number, sizeof(number), "%lld", l);
+		buffer_append_str(buf, number);
+	} else if (PyList_CheckExact(py_obj) || PyTuple_CheckExact(py_obj)) {
+		Py_ssize_t size = PySequence_Fast_GET_SIZE(py_obj);
+		PyObject ** items = PySequence_Fast_ITEMS(py_obj);
+		buffer_append(buf, "[", 1);
+		for (Py_ssize_t i = 0; i < size; i++) {
+			if (i) {
+				buffer_append(buf, ", ", 2);
+			}
+			if (!encode_value(buf, items[i], depth + 1)) {
+				return false;
+			}
+		}
+		buffer_append(buf, "]", 1);
+	} else if (PyDict_CheckExact(py_obj)) {
+		PyObject * py_key = NULL;
+		PyObject * py_value = NULL;
+		Py_ssize_t pos = 0;
+		bool first = true;
+		buffer_append(buf, "{", 1);
+		while (PyDict_Next(py_obj, &pos, &py_key, &py_value)) {
+			if (!first) {
+				buffer_append(buf, ", ", 2);
+			}
+			first = false;
+			// json.dumps() turns other keys into strings, leave that to it
+			if (!encode_string(buf, py_key)) {
+				return false;
+			}
+			buffer_append(buf, ": ", 2);
+			if (!encode_value(buf, py_value, depth + 1)) {
+				return false;
+			}
+		}
+		buffer_append(buf, "}", 1);
+	} else {
+		return encode_string(buf, py_obj);
+	}
+	return true;
+}
+
+PyObject * geojson_dumps(PyObject * py_obj)
+{
+	geojson_buffer buf = {NULL, 0, 0};
+	PyObject * py_str = NULL;
+
+	if (encode_value(&buf, py_obj, 0)) {
+		py_str = PyString_FromStringAndSize(buf.data, buf.size);
+	}
+	free(buf.data);
+	return py_str;
+}
+
+/*******************************************************************************
+ * PARSER
+ *
+ * Builds the same objects as json.loads(). Text it does not accept,
+ * including the NaN and Infinity extensions, is left to the json module,
+ * which also reports the errors.
+ ******************************************************************************/
+
+typedef struct {
+	const char * p;
+	const char * end;
+} geojson_parser;
+
+static PyObject * parse_value(geojson_parser * parser, int depth);
+
+static void skip_ws(geojson_parser * parser)
+{
+	while (parser->p < parser->end &&
+			(*parser->p == ' ' || *parser->p == '\t' || *parser->p == '\n' || *parser->p == '\r')) {
+		parser->p++;
+	}
+}
+
+static bool parse_hex4(const char * p, uint32_t * cp)
+{
+	*cp = 0;
+	for (int i = 0; i < 4; i++) {
+		char c = p[i];
+		*cp <<= 4;
+		if (c >= '0' && c <= '9') {
+			*cp |= c - '0';
+		} else if (c >= 'a' && c <= 'f') {
+			*cp |= c - 'a' + 10;
+		} else if (c >= 'A' && c <= 'F') {
+			*cp |= c - 'A' + 10;
+		} else {
+			return false;
+		}
+	}
+	return true;
+}
+
+static void append_utf8(geojson_buffer * buf, uint32_t cp)
+{
+	char out[4];
+	size_t n;
+
+	if (cp < 0x80) {
+		out[0] = (char) cp;
+		n = 1;
+	} else if (cp < 0x800) {
+		out[0] = (char) (0xC0 | (cp >> 6));
+		out[1] = (char) (0x80 | (cp & 0x3F));
+		n = 2;
+	} else if (cp < 0x10000) {
+		out[0] = (char) (0xE0 | (cp >> 12));
+		out[1] = (char) (0x80 | ((cp >> 6) & 0x3F));
+		out[2] = (char) (0x80 | (cp & 0x3F));
+		n = 3;
+	} else {
+		out[0] = (char) (0xF0 | (cp >> 18));
+		out[1] = (char) (0x80 | ((cp >> 12) & 0x3F));
+		out[2] = (char) (0x80 | ((cp >> 6) & 0x3F));
+		out[3] = (char) (0x80 | (cp & 0x3F));
+		n = 4;
+	}
+	buffer_append(buf, out, n);
+}
+
+static PyObject * parse_string(geojson_parser * parser)
+{
+	const char * start = ++parser->p;
+
+	// Strings without escapes are decoded in place
+	while (parser->p < parser->end && *parser->p != '"' && *parser->p != '\\') {
+		if ((unsigned char) *parser->p < 0x20) {
+			return NULL;
+		}
+		parser->p++;
+	}
+	if (parser->p >= parser->end) {
+		return NULL;
+	}
+	if (*parser->p == '"') {
+		PyObject * py_str = PyUnicode_DecodeUTF8(start, parser->p - start, NULL);
+		parser->p++;
+		return py_str;
+	}
+
+	geojson_buffer buf = {NULL, 0, 0};
+	buffer_append(&buf, start, parser->p - start);
+
+	while (parser->p < parser->end && *parser->p != '"') {
+		char c = *parser->p;
+		if ((unsigned char) c < 0x20) {
+			goto FAIL;
+		}
+		if (c != '\\') {
+			buffer_append(&buf, &c, 1);
+			parser->p++;
+			continue;
+		}
+		if (++parser->p >= parser->end) {
+			goto FAIL;
+		}
+		switch (*parser->p++) {
+			case '"':  buffer_append(&buf, "\"", 1); break;
+			case '\\': buffer_append(&buf, "\\", 1); break;
+			case '/':  buffer_append(&buf, "/", 1); break;
+			case 'b':  buffer_append(&buf, "\b", 1); break;
+			case 'f':  buffer_append(&buf, "\f", 1); break;
+			case 'n':  buffer_append(&buf, "\n", 1); break;
+			case 'r':  buffer_append(&buf, "\r", 1); break;
+			case 't':  buffer_append(&buf, "\t", 1); break;
+			case 'u': {
+				uint32_t cp;
+				if (parser->end - parser->p < 4 || !parse_hex4(parser->p, &cp)) {
+					goto FAIL;
+				}
+				parser->p += 4;
+				if (cp >= 0xD800 && cp < 0xDC00 && parser->end - parser->p >= 6 &&
+						parser->p[0] == '\\' && parser->p[1] == 'u') {
+					uint32_t low;
+					if (parse_hex4(parser->p + 2, &low) && low >= 0xDC00 && low < 0xE000) {
+						cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+						parser->p += 6;
+					}
+				}
+				// Lone surrogates can't be decoded from UTF-8
+				if (cp >= 0xD800 && cp < 0xE000) {
+					goto FAIL;
+				}
+				append_utf8(&buf, cp);
+				break;
+			}
+			default:
+				goto FAIL;
+		}
+	}
+	if (parser->p >= parser->end) {
+		goto FAIL;
+	}
+	parser->p++;
+
+	PyObject * py_str = PyUnicode_DecodeUTF8(buf.data, buf.size, NULL);
+	free(buf.data);
+	return py_str;
+
+FAIL:
+	free(buf.data);
+	return NULL;
+}
+
+static PyObject * parse_number(geojson_parser * parser)
+{
+	const char * start = parser->p;
+	bool is_float = false;
+	char local[64];
+
+	if (parser->p < parser->end && *parser->p == '-') {
+		parser->p++;
+	}
+	if (parser->p >= parser->end || *parser->p < '0' || *parser->p > '9') {
+		return NULL;
+	}
+	if (*parser->p == '0') {
+		parser->p++;
+	} else {
+		while (parser->p < parser->end && *parser->p >= '0' && *parser->p <= '9') {
+			parser->p++;
+		}
+	}
+	if (parser->p < parser->end && *parser->p == '.') {
+		is_float = true;
+		parser->p++;
+		if (parser->p >= parser->end || *parser->p < '0' || *parser->p > '9') {
+			return NULL;
+		}
+		while (parser->p < parser->end && *parser->p >= '0' && *parser->p <= '9') {
+			parser->p++;
+		}
+	}
+	if (parser->p < parser->end && (*parser->p == 'e' || *parser->p == 'E')) {
+		is_float = true;
+		parser->p++;
+		if (parser->p < parser->end && (*parser->p == '+' || *parser->p == '-')) {
+			parser->p++;
+		}
+		if (parser->p >= parser->end || *parser->p < '0' || *parser->p > '9') {
+			return NULL;
+		}
+		while (parser->p < parser->end && *parser->p >= '0' && *parser->p <= '9') {
+			parser->p++;
+		}
+	}
+
+	size_t len = parser->p - start;
+	char * text = len < sizeof(local) ? local : (char *) malloc(len + 1);
+	memcpy(text, start, len);
+	text[len] = '\0';
+
+	PyObject * py_num = NULL;
+	if (is_float) {
+		double d = PyOS_string_to_double(text, NULL, NULL);
+		if (d == -1.0 && PyErr_Occurred()) {
+			PyErr_Clear();
+		} else {
+			py_num = PyFloat_FromDouble(d);
+		}
+	} else {
+		py_num = PyInt_FromString(text, NULL, 10);
+	}
+
+	if (text != local) {
+		free(text);
+	}
+	return py_num;
+}
+
+static bool parse_literal(geojson_parser * parser, const char * literal)
+{
+	size_t len = strlen(literal);
+	if ((size_t) (parser->end - parser->p) < len || memcmp(parser->p, literal, len)) {
+		return false;
+	}
+	parser->p += len;
+	return true;
+}
+
+static PyObject * parse_array(geojson_parser * parser, int depth)
+{
+	PyObject * py_list = PyList_New(0);
+	parser->p++;
+
+	skip_ws(parser);
+	if (parser->p < parser->end && *parser->p == ']') {
+		parser->p++;
+		return py_list;
+	}
+	while (true) {
+		PyObject * py_item = parse_value(parser, depth + 1);
+		if (!py_item) {
+			break;
+		}
+		PyList_Append(py_list, py_item);
+		Py_DECREF(py_item);
+
+		skip_ws(parser);
+		if (parser->p >= parser->end) {
+			break;
+		}
+		if (*parser->p == ']') {
+			parser->p++;
+			return py_list;
+		}
+		if (*parser->p++ != ',') {
+			break;
+		}
+	}
+	Py_DECREF(py_list);
+	return NULL;
+}
+
+static PyObject * parse_object(geojson_parser * parser, int depth)
+{
+	PyObject * py_dict = PyDict_New();
+	parser->p++;
+
+	skip_ws(parser);
+	if (parser->p < parser->end && *parser->p == '}') {
+		parser->p++;
+		return py_dict;
+	}
+	while (true) {
+		skip_ws(parser);
+		if (parser->p >= parser->end || *parser->p != '"') {
+			break;
+		}
+		PyObject * py_key = parse_string(parser);
+		if (!py_key) {
+			break;
+		}
+		skip_ws(parser);
+		if (parser->p >= parser->end || *parser->p++ != ':') {
+			Py_DECREF(py_key);
+			break;
+		}
+		PyObject * py_value = parse_value(parser, depth + 1);
+		if (!py_value) {
+			Py_DECREF(py_key);
+			break;
+		}
+		PyDict_SetItem(py_dict, py_key, py_value);
+		Py_DECREF(py_key);
+		Py_DECREF(py_value);
+
+		skip_ws(parser);
+		if (parser->p >= parser->end) {
+			break;
+		}
+		if (*parser->p == '}') {
+			parser->p++;
+			return py_dict;
+		}
+		if (*parser->p++ != ',') {
+			break;
+		}
+	}
+	Py_DECREF(py_dict);
+	return NULL;
+}
+
+static PyObject * parse_value(geojson_parser * parser, int depth)
+{
+	if (depth > GEOJSON_MAX_DEPTH) {
+		return NULL;
+	}
+
+	skip_ws(parser);
+	if (parser->p >= parser->end) {
+		return NULL;
+	}
+
+	switch (*parser->p) {
+		case '{':
+			return parse_object(parser, depth);
+		case '[':
+			return parse_array(parser, depth);
+		case '"':
+			return parse_string(parser);
+		case 't':
+			if (parse_literal(parser, "true")) {
+				Py_RETURN_TRUE;
+			}
+			return NULL;
+		case 'f':
+			if (parse_literal(parser, "false")) {
+				Py_RETURN_FALSE;
+			}
+			return NULL;
+		case 'n':
+			if (parse_literal(parser, "null")) {
+				Py_RETURN_NONE;
+			}
+			return NULL;
+		default:
+			return parse_number(parser);
+	}
+}
+
+PyObject * geojson_loads(const char * text, size_t len)
+{
+	geojson_parser parser = {text, text + len};
+
+	PyObject * py_obj = parse_value(&parser, 0);
+	if (py_obj) {
+		skip_ws(&parser);
+		if (parser.p != parser.end) {
+			Py_DECREF(py_obj);
+			py_obj = NULL;
+		}
+	}
+	if (!py_obj) {
+		PyErr_Clear();
+	}
+	return py_obj;
+}
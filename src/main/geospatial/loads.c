@@ -28,25 +28,37 @@
 
 PyObject * AerospikeGeospatial_DoLoads(PyObject *py_geodata, as_error *err)
 {
-	PyObject* sysmodules = PyImport_GetModuleDict();
-	PyObject* json_module = NULL;
-	if (PyMapping_HasKeyString(sysmodules, "json")) {
-		json_module = PyMapping_GetItemString(sysmodules, "json");
-	} else {
-		json_module = PyImport_ImportModule("json");
+	PyObject* initresult = NULL;
+	PyObject* py_ustr = NULL;
+	char* geodata = NULL;
+	Py_ssize_t geodata_len = 0;
+
+	if (PyUnicode_Check(py_geodata)) {
+		py_ustr = PyUnicode_AsUTF8String(py_geodata);
+		if (py_ustr) {
+			PyBytes_AsStringAndSize(py_ustr, &geodata, &geodata_len);
+		}
+	} else if (PyBytes_Check(py_geodata)) {
+		PyBytes_AsStringAndSize(py_geodata, &geodata, &geodata_len);
 	}
+	PyErr_Clear();
 
-	PyObject* initresult = NULL;
+	if (geodata) {
+		initresult = geojson_loads(geodata, geodata_len);
+	}
+	Py_XDECREF(py_ustr);
+	if (initresult) {
+		return initresult;
+	}
+
+	// json.loads() takes what the C parser does not, or reports the error
+	PyObject* json_module = geojson_json_module();
 	if (!json_module) {
 		/* insert error handling here! and exit this function */
 		as_error_update(err, AEROSPIKE_ERR_CLIENT, "Unable to load json module");
 	} else {
 		PyObject *py_funcname = PyString_FromString("loads");
-		Py_INCREF(json_module);
-
 		initresult = PyObject_CallMethodObjArgs(json_module, py_funcname, py_geodata, NULL);
-
-		Py_DECREF(json_module);
 		Py_DECREF(py_funcname);
 	}
 	return initresult;
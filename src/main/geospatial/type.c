@@ -28,12 +28,17 @@
 #include "geo.h"
 #include "conversions.h"
 #include "exceptions.h"
+#include "module_state.h"
 
 /*******************************************************************************
  * PYTHON TYPE METHODS
  ******************************************************************************/
-static PyMemberDef AerospikeGeospatial_Type_Members[] = {
-	{"geo_data", T_OBJECT, offsetof(AerospikeGeospatial, geo_data), 0, "The aerospike.GeoJSON object"},
+static PyObject * AerospikeGeospatial_Get_Geo_Data(AerospikeGeospatial * self, void * closure);
+static int AerospikeGeospatial_Set_Geo_Data(AerospikeGeospatial * self, PyObject * value, void * closure);
+
+static PyGetSetDef AerospikeGeospatial_Type_GetSet[] = {
+	{"geo_data", (getter) AerospikeGeospatial_Get_Geo_Data, (setter) AerospikeGeospatial_Set_Geo_Data,
+				"The aerospike.GeoJSON object", NULL},
 	{NULL}
 };
 static PyMethodDef AerospikeGeospatial_Type_Methods[] = {
@@ -66,11 +71,45 @@ void store_geodata(AerospikeGeospatial *self, as_error *err, PyObject *py_geodat
 			Py_DECREF(self->geo_data);
 		}
 		self->geo_data = py_geodata;
+		if (self->geojson) {
+			free(self->geojson);
+			self->geojson = NULL;
+		}
 	} else {
 		as_error_update(err, AEROSPIKE_ERR_PARAM, "Geospatial data should be a dictionary or raw GeoJSON string");
 	}
 }
 
+static PyObject * AerospikeGeospatial_Get_Geo_Data(AerospikeGeospatial * self, void * closure)
+{
+	as_error err;
+	as_error_init(&err);
+
+	PyObject * py_data = AerospikeGeospatial_GetData(self, &err);
+	if (!py_data) {
+		PyObject * py_err = NULL;
+		error_to_pyobject(&err, &py_err);
+		PyObject *exception_type = raise_exception(&err);
+		PyErr_SetObject(exception_type, py_err);
+		Py_DECREF(py_err);
+		return NULL;
+	}
+	Py_INCREF(py_data);
+	return py_data;
+}
+
+static int AerospikeGeospatial_Set_Geo_Data(AerospikeGeospatial * self, PyObject * value, void * closure)
+{
+	Py_XINCREF(value);
+	Py_XDECREF(self->geo_data);
+	self->geo_data = value;
+	if (self->geojson) {
+		free(self->geojson);
+		self->geojson = NULL;
+	}
+	return 0;
+}
+
 static PyObject * AerospikeGeospatial_Type_New(PyTypeObject * type, PyObject * args, PyObject * kwds)
 {
 	AerospikeGeospatial * self = NULL;
@@ -139,7 +178,11 @@ PyObject *AerospikeGeospatial_Type_Repr(self) AerospikeGeospatial* self;
 		goto CLEANUP;
 	}
 
-	initresult = AerospikeGeospatial_DoDumps(self->geo_data, &err);
+	if (self->geojson) {
+		initresult = PyString_FromString(self->geojson);
+	} else {
+		initresult = AerospikeGeospatial_DoDumps(self->geo_data, &err);
+	}
 	if (!initresult) {
 		as_error_update(&err, AEROSPIKE_ERR_CLIENT, "Unable to call get data in str format");
 		goto CLEANUP;
@@ -183,6 +226,10 @@ PyObject* AerospikeGeospatial_Type_Str(self) AerospikeGeospatial* self;
 		goto CLEANUP;
 	}
 
+	if (self->geojson) {
+		return PyString_FromString(self->geojson);
+	}
+
 	initresult = AerospikeGeospatial_DoDumps(self->geo_data, &err);
 	if (!initresult) {
 		as_error_update(&err, AEROSPIKE_ERR_CLIENT, "Unable to call get data in str format");
@@ -207,12 +254,43 @@ static void AerospikeGeospatial_Type_Dealloc(AerospikeGeospatial * self)
 	if (self->geo_data) {
 		Py_DECREF(self->geo_data);
 	}
-	Py_TYPE(self)->tp_free((PyObject *) self);
+	if (self->geojson) {
+		free(self->geojson);
+	}
+	PyTypeObject * type = Py_TYPE(self);
+	type->tp_free((PyObject *) self);
+	AS_TYPE_RELEASE(type);
 }
 
 /*******************************************************************************
  * PYTHON TYPE DESCRIPTOR
  ******************************************************************************/
+#ifdef AS_HEAP_TYPES
+
+static PyType_Slot AerospikeGeospatial_Type_Slots[] = {
+	{Py_tp_dealloc, (void *) AerospikeGeospatial_Type_Dealloc},
+	{Py_tp_repr, (void *) AerospikeGeospatial_Type_Repr},
+	{Py_tp_str, (void *) AerospikeGeospatial_Type_Str},
+	{Py_tp_doc, (void *)
+		"The GeoJSON class casts geospatial data to and from the server's\n"
+		"as_geojson type.\n"},
+	{Py_tp_methods, (void *) AerospikeGeospatial_Type_Methods},
+	{Py_tp_getset, (void *) AerospikeGeospatial_Type_GetSet},
+	{Py_tp_init, (void *) AerospikeGeospatial_Type_Init},
+	{Py_tp_new, (void *) AerospikeGeospatial_Type_New},
+	{0, NULL}
+};
+
+static PyType_Spec AerospikeGeospatial_Type_Spec = {
+	"aerospike.Geospatial",
+	sizeof(AerospikeGeospatial),
+	0,
+	Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+	AerospikeGeospatial_Type_Slots
+};
+
+#else
+
 static PyTypeObject AerospikeGeospatial_Type = {
 	PyVarObject_HEAD_INIT(NULL, 0)
 	"aerospike.Geospatial",             // tp_name
@@ -246,8 +324,8 @@ static PyTypeObject AerospikeGeospatial_Type = {
 	0,                                  // tp_iter
 	0,                                  // tp_iternext
 	AerospikeGeospatial_Type_Methods,   // tp_methods
-	AerospikeGeospatial_Type_Members,   // tp_members
-	0,                                  // tp_getset
+	0,                                  // tp_members
+	AerospikeGeospatial_Type_GetSet,    // tp_getset
 	0,                                  // tp_base
 	0,                                  // tp_dict
 	0,                                  // tp_descr_get
@@ -262,13 +340,19 @@ static PyTypeObject AerospikeGeospatial_Type = {
 	0                                   // tp_bases
 };
 
+#endif
+
 /*******************************************************************************
  * PUBLIC FUNCTIONS
  ******************************************************************************/
 
 PyTypeObject * AerospikeGeospatial_Ready()
 {
+#ifdef AS_HEAP_TYPES
+	return (PyTypeObject *) PyType_FromSpec(&AerospikeGeospatial_Type_Spec);
+#else
 	return PyType_Ready(&AerospikeGeospatial_Type) == 0 ? &AerospikeGeospatial_Type : NULL;
+#endif
 }
 
 AerospikeGeospatial  * Aerospike_Set_Geo_Data(PyObject * parent, PyObject * args, PyObject * kwds)
@@ -285,8 +369,9 @@ AerospikeGeospatial  * Aerospike_Set_Geo_Data(PyObject * parent, PyObject * args
 	}
 
 	if (PyDict_Check(py_geodata)) {
-		AerospikeGeospatial * self = (AerospikeGeospatial *) AerospikeGeospatial_Type.tp_new(&AerospikeGeospatial_Type, args, kwds);
-		if (AerospikeGeospatial_Type.tp_init((PyObject *) self, args, kwds) == 0) {
+		PyTypeObject * type = aerospike_module_state(parent)->geospatial_type;
+		AerospikeGeospatial * self = (AerospikeGeospatial *) type->tp_new(type, args, kwds);
+		if (type->tp_init((PyObject *) self, args, kwds) == 0) {
 			return self;
 		} else {
 			return NULL;
@@ -319,8 +404,9 @@ AerospikeGeospatial  * Aerospike_Set_Geo_Json(PyObject * parent, PyObject * args
 	}
 
 	if (PyString_Check(py_geodata)) {
-		AerospikeGeospatial * self = (AerospikeGeospatial *) AerospikeGeospatial_Type.tp_new(&AerospikeGeospatial_Type, args, kwds);
-		if (AerospikeGeospatial_Type.tp_init((PyObject *) self, args, kwds) == 0) {
+		PyTypeObject * type = aerospike_module_state(parent)->geospatial_type;
+		AerospikeGeospatial * self = (AerospikeGeospatial *) type->tp_new(type, args, kwds);
+		if (type->tp_init((PyObject *) self, args, kwds) == 0) {
 			return self;
 		} else {
 			return NULL;
@@ -341,8 +427,76 @@ AerospikeGeospatial  * Aerospike_Set_Geo_Json(PyObject * parent, PyObject * args
 
 PyObject * AerospikeGeospatial_New(as_error *err, PyObject * value)
 {
-	AerospikeGeospatial * self = (AerospikeGeospatial *) AerospikeGeospatial_Type.tp_new(&AerospikeGeospatial_Type, Py_None, Py_None);
+	PyTypeObject * type = aerospike_get_state()->geospatial_type;
+	AerospikeGeospatial * self = (AerospikeGeospatial *) type->tp_new(type, Py_None, Py_None);
 	store_geodata(self, err, value);
 	Py_XINCREF(self->geo_data);
 	return (PyObject *) self;
 }
+
+PyObject * AerospikeGeospatial_New_GeoJSON(as_error *err, const char * geojson)
+{
+	PyTypeObject * type = aerospike_get_state()->geospatial_type;
+	AerospikeGeospatial * self = (AerospikeGeospatial *) type->tp_new(type, Py_None, Py_None);
+	if (!self) {
+		as_error_update(err, AEROSPIKE_ERR_CLIENT, "Unable to create a GeoJSON object");
+		return NULL;
+	}
+	self->geojson = strdup(geojson);
+	return (PyObject *) self;
+}
+
+PyObject * AerospikeGeospatial_GetData(AerospikeGeospatial * self, as_error *err)
+{
+	if (self->geojson) {
+		PyObject * py_geojson = PyString_FromString(self->geojson);
+		PyObject * py_loads = py_geojson ? AerospikeGeospatial_DoLoads(py_geojson, err) : NULL;
+		Py_XDECREF(py_geojson);
+		if (!py_loads) {
+			PyErr_Clear();
+			as_error_update(err, AEROSPIKE_ERR_CLIENT, "String is not GeoJSON serializable");
+			return NULL;
+		}
+		store_geodata(self, err, py_loads);
+		if (err->code != AEROSPIKE_OK) {
+			Py_DECREF(py_loads);
+			return NULL;
+		}
+	}
+	return self->geo_data ? self->geo_data : Py_None;
+}
+
+char * AerospikeGeospatial_GeoJSON(PyObject * py_geo, as_error *err)
+{
+	AerospikeGeospatial * self = (AerospikeGeospatial *) py_geo;
+
+	// Records read and written back unchanged are never parsed
+	if (self->geojson) {
+		return strdup(self->geojson);
+	}
+
+	PyObject * py_dumps = AerospikeGeospatial_DoDumps(self->geo_data ? self->geo_data : Py_None, err);
+	if (!py_dumps) {
+		PyErr_Clear();
+		as_error_update(err, AEROSPIKE_ERR_CLIENT, "Unable to call dumps function");
+		return NULL;
+	}
+
+	char * geo_value = NULL;
+	if (PyUnicode_Check(py_dumps)) {
+		PyObject * py_ustr = PyUnicode_AsUTF8String(py_dumps);
+		if (py_ustr) {
+			geo_value = strdup(PyBytes_AsString(py_ustr));
+			Py_DECREF(py_ustr);
+		}
+	} else if (PyBytes_Check(py_dumps)) {
+		geo_value = strdup(PyBytes_AsString(py_dumps));
+	}
+	Py_DECREF(py_dumps);
+
+	if (!geo_value) {
+		PyErr_Clear();
+		as_error_update(err, AEROSPIKE_ERR_CLIENT, "Unicode value not encoded in utf-8.");
+	}
+	return geo_value;
+}
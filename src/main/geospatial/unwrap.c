@@ -30,6 +30,7 @@ PyObject * AerospikeGeospatial_Unwrap(AerospikeGeospatial * self, PyObject * arg
 {
 
 	// Python function arguments
+	PyObject * py_geodata = NULL;
 	// Python function keyword arguments
 	static char * kwlist[] = {NULL};
 
@@ -47,6 +48,8 @@ PyObject * AerospikeGeospatial_Unwrap(AerospikeGeospatial * self, PyObject * arg
 		goto CLEANUP;
 	}
 
+	py_geodata = AerospikeGeospatial_GetData(self, &err);
+
 CLEANUP:
 
 	// If an error occurred, tell Python.
@@ -58,6 +61,6 @@ CLEANUP:
 		Py_DECREF(py_err);
 		return NULL;
 	}
-	Py_INCREF(self->geo_data);
-	return self->geo_data;
+	Py_INCREF(py_geodata);
+	return py_geodata;
 }
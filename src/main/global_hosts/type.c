@@ -30,6 +30,7 @@
 #include "conversions.h"
 #include "exceptions.h"
 #include "global_hosts.h"
+#include "module_state.h"
 
 static PyObject * AerospikeGlobalHosts_Type_New(PyTypeObject * type, PyObject * args, PyObject * kwds)
 {
@@ -42,13 +43,35 @@ static PyObject * AerospikeGlobalHosts_Type_New(PyTypeObject * type, PyObject *
 
 static void AerospikeGlobalHosts_Type_Dealloc(PyObject * self)
 {
+	PyTypeObject * type = Py_TYPE(self);
 	PyObject_Del(self);
+	AS_TYPE_RELEASE(type);
 }
 
 /*******************************************************************************
  * PYTHON TYPE DESCRIPTOR
  ******************************************************************************/
 
+#ifdef AS_HEAP_TYPES
+
+static PyType_Slot AerospikeGlobalHosts_Type_Slots[] = {
+	{Py_tp_dealloc, (void *) AerospikeGlobalHosts_Type_Dealloc},
+	{Py_tp_doc, (void *)
+		"The Global Host stores the persistent objects\n"},
+	{Py_tp_new, (void *) AerospikeGlobalHosts_Type_New},
+	{0, NULL}
+};
+
+static PyType_Spec AerospikeGlobalHosts_Type_Spec = {
+	"aerospike.GlobalHosts",
+	sizeof(AerospikeGlobalHosts),
+	0,
+	Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+	AerospikeGlobalHosts_Type_Slots
+};
+
+#else
+
 static PyTypeObject AerospikeGlobalHosts_Type = {
 	PyVarObject_HEAD_INIT(NULL, 0)
 	0,                                  // tp_name
@@ -96,17 +119,31 @@ static PyTypeObject AerospikeGlobalHosts_Type = {
 	0                                   // tp_bases
 };
 
+#endif
+
 
 AerospikeGlobalHosts * AerospikeGobalHosts_New(aerospike* as)
 {
-	AerospikeGlobalHosts * self = (AerospikeGlobalHosts *) AerospikeGlobalHosts_Type.tp_new(&AerospikeGlobalHosts_Type, Py_None, Py_None);
+	PyTypeObject * type = aerospike_get_state()->global_hosts_type;
+	AerospikeGlobalHosts * self = (AerospikeGlobalHosts *) type->tp_new(type, Py_None, Py_None);
 	self->as = as;
 	self->shm_key = as->config.shm_key;
 	self->ref_cnt = 1;
+	self->pid = getpid();
 	Py_INCREF((PyObject*) self);
 	return self;
 }
 
+PyTypeObject * AerospikeGlobalHosts_Ready()
+{
+#ifdef AS_HEAP_TYPES
+	return (PyTypeObject *) PyType_FromSpec(&AerospikeGlobalHosts_Type_Spec);
+#else
+	// Never exposed to Python, so it is used without PyType_Ready()
+	return &AerospikeGlobalHosts_Type;
+#endif
+}
+
 void AerospikeGlobalHosts_Del(PyObject *self)
 {
 	AerospikeGlobalHosts_Type_Dealloc(self);
@@ -0,0 +1,443 @@
+/*******************************************************************************
+ * Copyright 2013-2016 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include <Python.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <aerospike/aerospike_key.h>
+#include <aerospike/as_bytes.h>
+#include <aerospike/as_integer.h>
+#include <aerospike/as_string.h>
+
+#include "hedge.h"
+
+struct hedge_call_s;
+
+typedef struct hedge_attempt_s {
+	struct hedge_call_s * call;
+	as_policy_read policy;
+	as_error err;
+	as_record * rec;
+	bool started;
+	bool done;
+	// Next attempt waiting in the pool's queue
+	struct hedge_attempt_s * next;
+} hedge_attempt;
+
+/**
+ * State shared by the caller and the two reads. The slower read may still
+ * run after the caller returns, so the call owns copies of the key and bins
+ * and is freed by whoever drops the last reference.
+ */
+typedef struct hedge_call_s {
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	uint32_t refs;
+	hedge_pool * pool;
+	// Attempt whose answer is returned, -1 until one is chosen
+	int winner;
+	aerospike * as;
+	hedge_op op;
+	as_key key;
+	char ** bins;
+	hedge_attempt attempts[2];
+} hedge_call;
+
+/**
+ * Threads running a client's hedged reads. Threads are started as reads need
+ * them, up to HEDGE_POOL_MAX_THREADS, and then wait for the next read until
+ * the client is freed. A read is only queued for a thread already waiting,
+ * so it never waits behind another read.
+ */
+struct hedge_pool_s {
+	pthread_mutex_t lock;
+	// Signalled when a read is queued or the pool stops
+	pthread_cond_t work;
+	// Signalled when running or threads drop to 0
+	pthread_cond_t idle_cond;
+	hedge_attempt * queue_head;
+	hedge_attempt * queue_tail;
+	uint32_t threads;
+	// Waiting threads no queued read has been handed to yet
+	uint32_t idle;
+	// Reads queued or running
+	uint32_t running;
+	bool stopping;
+	pid_t pid;
+};
+
+static void hedge_key_copy(as_key * copy, const as_key * key)
+{
+	as_val * key_val = (as_val *) key->valuep;
+
+	switch (key_val ? as_val_type(key_val) : AS_UNDEF) {
+		case AS_INTEGER:
+			as_key_init_int64(copy, key->ns, key->set, as_integer_get((as_integer *) key_val));
+			break;
+		case AS_STRING:
+			as_key_init_strp(copy, key->ns, key->set, strdup(as_string_get((as_string *) key_val)), true);
+			break;
+		case AS_BYTES: {
+			as_bytes * bytes = (as_bytes *) key_val;
+			uint32_t size = as_bytes_size(bytes);
+			uint8_t * data = (uint8_t *) malloc(size ? size : 1);
+			memcpy(data, as_bytes_get(bytes), size);
+			as_key_init_rawp(copy, key->ns, key->set, data, size, true);
+			break;
+		}
+		default:
+			as_key_init_digest(copy, key->ns, key->set, key->digest.value);
+			break;
+	}
+	if (key->digest.init) {
+		copy->digest = key->digest;
+	}
+}
+
+static char ** hedge_bins_copy(const char ** bins)
+{
+	if (!bins) {
+		return NULL;
+	}
+
+	uint32_t n_bins = 0;
+	while (bins[n_bins]) {
+		n_bins++;
+	}
+
+	char ** copy = (char **) malloc(sizeof(char *) * (n_bins + 1));
+	for (uint32_t i = 0; i < n_bins; i++) {
+		copy[i] = strdup(bins[i]);
+	}
+	copy[n_bins] = NULL;
+	return copy;
+}
+
+static void hedge_call_release(hedge_call * call)
+{
+	pthread_mutex_lock(&call->lock);
+	bool last = --call->refs == 0;
+	pthread_mutex_unlock(&call->lock);
+
+	if (!last) {
+		return;
+	}
+
+	for (int i = 0; i < 2; i++) {
+		if (call->attempts[i].rec) {
+			as_record_destroy(call->attempts[i].rec);
+		}
+	}
+	if (call->bins) {
+		for (uint32_t i = 0; call->bins[i]; i++) {
+			free(call->bins[i]);
+		}
+		free(call->bins);
+	}
+	as_key_destroy(&call->key);
+	pthread_cond_destroy(&call->cond);
+	pthread_mutex_destroy(&call->lock);
+	free(call);
+}
+
+static void hedge_attempt_run(hedge_attempt * attempt)
+{
+	hedge_call * call = attempt->call;
+	int index = attempt == &call->attempts[0] ? 0 : 1;
+	as_record * rec = NULL;
+	as_error err;
+	as_error_init(&err);
+
+	switch (call->op) {
+		case HEDGE_GET:
+			aerospike_key_get(call->as, &err, &attempt->policy, &call->key, &rec);
+			break;
+		case HEDGE_SELECT:
+			aerospike_key_select(call->as, &err, &attempt->policy, &call->key,
+					(const char **) call->bins, &rec);
+			break;
+		case HEDGE_EXISTS:
+			aerospike_key_exists(call->as, &err, &attempt->policy, &call->key, &rec);
+			break;
+	}
+
+	pthread_mutex_lock(&call->lock);
+	as_error_copy(&attempt->err, &err);
+	attempt->rec = rec;
+	attempt->done = true;
+
+	if (call->winner < 0) {
+		hedge_attempt * other = &call->attempts[1 - index];
+		bool answered = err.code == AEROSPIKE_OK || err.code == AEROSPIKE_ERR_RECORD_NOT_FOUND;
+
+		// A failed read only wins if the other one cannot answer instead
+		if (answered || !other->started || other->done) {
+			call->winner = index;
+			pthread_cond_signal(&call->cond);
+		}
+	}
+	pthread_mutex_unlock(&call->lock);
+
+	hedge_call_release(call);
+}
+
+// Threads inherited across fork() only exist in the parent
+static void hedge_pool_check_fork(hedge_pool * pool)
+{
+	if (pool->pid != getpid()) {
+		pool->pid = getpid();
+		pool->queue_head = NULL;
+		pool->queue_tail = NULL;
+		pool->threads = 0;
+		pool->idle = 0;
+		pool->running = 0;
+	}
+}
+
+static void * hedge_pool_run(void * udata)
+{
+	hedge_attempt * attempt = (hedge_attempt *) udata;
+	hedge_pool * pool = attempt->call->pool;
+
+	while (attempt) {
+		hedge_attempt_run(attempt);
+
+		pthread_mutex_lock(&pool->lock);
+		if (--pool->running == 0) {
+			pthread_cond_broadcast(&pool->idle_cond);
+		}
+		pool->idle++;
+		while (!pool->queue_head && !pool->stopping) {
+			pthread_cond_wait(&pool->work, &pool->lock);
+		}
+		attempt = pool->queue_head;
+		if (attempt) {
+			// The thread queuing it already took this thread off idle
+			pool->queue_head = attempt->next;
+			if (!pool->queue_head) {
+				pool->queue_tail = NULL;
+			}
+		} else {
+			pool->idle--;
+			if (--pool->threads == 0) {
+				pthread_cond_broadcast(&pool->idle_cond);
+			}
+		}
+		pthread_mutex_unlock(&pool->lock);
+	}
+	return NULL;
+}
+
+/**
+ * Hands the attempt to a waiting thread, or a new one while the pool has
+ * room. Fails if every thread is busy.
+ */
+static bool hedge_pool_submit(hedge_pool * pool, hedge_attempt * attempt)
+{
+	bool submitted = false;
+
+	if (!pool) {
+		return false;
+	}
+
+	pthread_mutex_lock(&pool->lock);
+	hedge_pool_check_fork(pool);
+
+	if (pool->stopping) {
+		// The client is being freed
+	} else if (pool->idle) {
+		pool->idle--;
+		attempt->next = NULL;
+		if (pool->queue_tail) {
+			pool->queue_tail->next = attempt;
+		} else {
+			pool->queue_head = attempt;
+		}
+		pool->queue_tail = attempt;
+		pthread_cond_signal(&pool->work);
+		submitted = true;
+	} else if (pool->threads < HEDGE_POOL_MAX_THREADS) {
+		pthread_t thread;
+		pthread_attr_t attr;
+		pthread_attr_init(&attr);
+		pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+		submitted = pthread_create(&thread, &attr, hedge_pool_run, attempt) == 0;
+		pthread_attr_destroy(&attr);
+		if (submitted) {
+			pool->threads++;
+		}
+	}
+
+	if (submitted) {
+		pool->running++;
+	}
+	pthread_mutex_unlock(&pool->lock);
+	return submitted;
+}
+
+static bool hedge_attempt_start(hedge_call * call, int index)
+{
+	// Called with the call's lock held
+	call->attempts[index].started = true;
+	call->refs++;
+
+	bool started = hedge_pool_submit(call->pool, &call->attempts[index]);
+	if (!started) {
+		call->attempts[index].started = false;
+		call->refs--;
+	}
+	return started;
+}
+
+hedge_pool * hedge_pool_new(void)
+{
+	hedge_pool * pool = (hedge_pool *) calloc(1, sizeof(hedge_pool));
+	pthread_mutex_init(&pool->lock, NULL);
+	pthread_cond_init(&pool->work, NULL);
+	pthread_cond_init(&pool->idle_cond, NULL);
+	pool->pid = getpid();
+	return pool;
+}
+
+void hedge_pool_destroy(hedge_pool * pool)
+{
+	if (!pool) {
+		return;
+	}
+
+	pthread_mutex_lock(&pool->lock);
+	hedge_pool_check_fork(pool);
+	pool->stopping = true;
+	pthread_cond_broadcast(&pool->work);
+	while (pool->threads) {
+		pthread_cond_wait(&pool->idle_cond, &pool->lock);
+	}
+	pthread_mutex_unlock(&pool->lock);
+
+	pthread_cond_destroy(&pool->idle_cond);
+	pthread_cond_destroy(&pool->work);
+	pthread_mutex_destroy(&pool->lock);
+	free(pool);
+}
+
+as_status hedge_read(hedge_pool * pool, aerospike * as, as_error * err, const as_policy_read * policy,
+		const as_key * key, const char ** bins, hedge_op op, uint32_t hedge_after_ms,
+		as_record ** rec, bool * hedged, bool * hedge_won)
+{
+	*hedged = false;
+	*hedge_won = false;
+
+	hedge_call * call = (hedge_call *) calloc(1, sizeof(hedge_call));
+	pthread_mutex_init(&call->lock, NULL);
+	pthread_cond_init(&call->cond, NULL);
+	call->refs = 1;
+	call->winner = -1;
+	call->pool = pool;
+	call->as = as;
+	call->op = op;
+	hedge_key_copy(&call->key, key);
+	call->bins = hedge_bins_copy(bins);
+
+	for (int i = 0; i < 2; i++) {
+		call->attempts[i].call = call;
+		as_policy_read_copy(policy ? policy : &as->config.policies.read, &call->attempts[i].policy);
+		as_error_init(&call->attempts[i].err);
+	}
+	call->attempts[1].policy.replica = AS_POLICY_REPLICA_ANY;
+
+	struct timeval now;
+	gettimeofday(&now, NULL);
+	uint64_t deadline_us = (uint64_t) now.tv_sec * 1000000 + now.tv_usec + (uint64_t) hedge_after_ms * 1000;
+	struct timespec deadline;
+	deadline.tv_sec = (time_t) (deadline_us / 1000000);
+	deadline.tv_nsec = (long) (deadline_us % 1000000) * 1000;
+
+	pthread_mutex_lock(&call->lock);
+	if (!hedge_attempt_start(call, 0)) {
+		// Every thread is busy, read without hedging
+		pthread_mutex_unlock(&call->lock);
+		hedge_call_release(call);
+		switch (op) {
+			case HEDGE_GET:
+				return aerospike_key_get(as, err, policy, key, rec);
+			case HEDGE_SELECT:
+				return aerospike_key_select(as, err, policy, key, bins, rec);
+			case HEDGE_EXISTS:
+			default:
+				return aerospike_key_exists(as, err, policy, key, rec);
+		}
+	}
+
+	while (call->winner < 0) {
+		if (!call->attempts[1].started) {
+			int rc = pthread_cond_timedwait(&call->cond, &call->lock, &deadline);
+			if (rc == ETIMEDOUT && call->winner < 0 && !call->attempts[0].done) {
+				*hedged = hedge_attempt_start(call, 1);
+				if (!*hedged) {
+					// Keep waiting for the first read alone
+					call->attempts[1].started = true;
+					call->attempts[1].done = true;
+				}
+			}
+		} else {
+			pthread_cond_wait(&call->cond, &call->lock);
+		}
+	}
+
+	hedge_attempt * winner = &call->attempts[call->winner];
+	*hedge_won = call->winner == 1;
+	as_error_copy(err, &winner->err);
+	*rec = winner->rec;
+	winner->rec = NULL;
+
+	// The other read's record is freed with the call, whenever it ends
+	pthread_mutex_unlock(&call->lock);
+	hedge_call_release(call);
+
+	return err->code;
+}
+
+void hedge_wait_idle(hedge_pool * pool)
+{
+	if (!pool) {
+		return;
+	}
+
+	pthread_mutex_lock(&pool->lock);
+	hedge_pool_check_fork(pool);
+	while (pool->running) {
+		pthread_cond_wait(&pool->idle_cond, &pool->lock);
+	}
+	pthread_mutex_unlock(&pool->lock);
+}
+
+void hedge_stats_update(AerospikeClient * self, bool hedged, bool hedge_won)
+{
+	self->hedge.reads++;
+	if (hedged) {
+		self->hedge.hedged++;
+	}
+	if (hedge_won) {
+		self->hedge.hedge_wins++;
+	}
+}
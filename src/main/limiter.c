@@ -0,0 +1,384 @@
+/*******************************************************************************
+ * Copyright 2013-2016 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include <Python.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+
+#include <aerospike/as_error.h>
+#include <citrusleaf/cf_clock.h>
+
+#include "limiter.h"
+#include "macros.h"
+
+static const char * limiter_op_names[LIMITER_OPERATIONS] = {"read", "write", "batch", "udf"};
+
+static bool limiter_config_uint(PyObject * py_config, const char * name, uint64_t * value)
+{
+	PyObject * py_value = PyDict_GetItemString(py_config, name);
+	if (!py_value) {
+		return true;
+	}
+	if (!PyInt_Check(py_value) && !PyLong_Check(py_value)) {
+		return false;
+	}
+	long long v = PyLong_AsLongLong(py_value);
+	if (v < 0 || v > UINT32_MAX || PyErr_Occurred()) {
+		PyErr_Clear();
+		return false;
+	}
+	*value = (uint64_t) v;
+	return true;
+}
+
+/**
+ * Namespaces are limited by name, sets by "namespace.set".
+ */
+static bool limiter_name_valid(const char * name, bool is_set)
+{
+	const char * dot = strchr(name, '.');
+	size_t ns_len = dot ? (size_t) (dot - name) : strlen(name);
+
+	if (ns_len == 0 || ns_len >= AS_NAMESPACE_MAX_SIZE || is_set != (dot != NULL)) {
+		return false;
+	}
+	return !is_set || (dot[1] && strlen(dot + 1) < AS_SET_MAX_SIZE);
+}
+
+static bool limiter_bucket_init(limiter_bucket * bucket, const char * name, PyObject * py_rate)
+{
+	if (!PyInt_Check(py_rate) && !PyLong_Check(py_rate)) {
+		return false;
+	}
+	long long rate = PyLong_AsLongLong(py_rate);
+	if (rate <= 0 || rate > UINT32_MAX || PyErr_Occurred()) {
+		PyErr_Clear();
+		return false;
+	}
+	strcpy(bucket->name, name);
+	bucket->rate = (double) rate;
+	// Start full, so a burst of up to one second of requests goes through
+	bucket->tokens = bucket->rate;
+	bucket->refilled_us = cf_getus();
+	return true;
+}
+
+static bool limiter_buckets_new(PyObject * py_config, const char * name, bool is_set,
+		limiter_bucket ** buckets, uint32_t * n_buckets)
+{
+	PyObject * py_rates = PyDict_GetItemString(py_config, name);
+	if (!py_rates || py_rates == Py_None) {
+		return true;
+	}
+	if (!PyDict_Check(py_rates)) {
+		return false;
+	}
+
+	Py_ssize_t size = PyDict_Size(py_rates);
+	*buckets = (limiter_bucket *) calloc(size ? size : 1, sizeof(limiter_bucket));
+
+	PyObject * py_name = NULL;
+	PyObject * py_rate = NULL;
+	Py_ssize_t pos = 0;
+	while (PyDict_Next(py_rates, &pos, &py_name, &py_rate)) {
+		if (!PyString_Check(py_name) || !limiter_name_valid(PyString_AsString(py_name), is_set) ||
+				!limiter_bucket_init(&(*buckets)[*n_buckets], PyString_AsString(py_name), py_rate)) {
+			return false;
+		}
+		(*n_buckets)++;
+	}
+	return true;
+}
+
+static bool limiter_operations_init(request_limiter * limiter, PyObject * py_config)
+{
+	for (int i = 0; i < LIMITER_OPERATIONS; i++) {
+		strcpy(limiter->operations[i].name, limiter_op_names[i]);
+	}
+
+	PyObject * py_rates = PyDict_GetItemString(py_config, "operations");
+	if (!py_rates || py_rates == Py_None) {
+		return true;
+	}
+	if (!PyDict_Check(py_rates)) {
+		return false;
+	}
+
+	PyObject * py_name = NULL;
+	PyObject * py_rate = NULL;
+	Py_ssize_t pos = 0;
+	while (PyDict_Next(py_rates, &pos, &py_name, &py_rate)) {
+		if (!PyString_Check(py_name)) {
+			return false;
+		}
+		int op = 0;
+		while (op < LIMITER_OPERATIONS && strcmp(limiter_op_names[op], PyString_AsString(py_name))) {
+			op++;
+		}
+		if (op == LIMITER_OPERATIONS ||
+				!limiter_bucket_init(&limiter->operations[op], limiter_op_names[op], py_rate)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+request_limiter * request_limiter_new(PyObject * py_limits_config)
+{
+	uint64_t max_in_flight = 0;
+	uint64_t max_wait_ms = 0;
+
+	if (!PyDict_Check(py_limits_config) ||
+			!limiter_config_uint(py_limits_config, "max_in_flight", &max_in_flight) ||
+			!limiter_config_uint(py_limits_config, "max_wait_ms", &max_wait_ms)) {
+		return NULL;
+	}
+
+	request_limiter * limiter = (request_limiter *) calloc(1, sizeof(request_limiter));
+	pthread_mutex_init(&limiter->lock, NULL);
+	pthread_cond_init(&limiter->cond, NULL);
+	limiter->max_in_flight = (uint32_t) max_in_flight;
+	limiter->max_wait_ms = (uint32_t) max_wait_ms;
+
+	if (!limiter_operations_init(limiter, py_limits_config) ||
+			!limiter_buckets_new(py_limits_config, "namespaces", false,
+				&limiter->namespaces, &limiter->n_namespaces) ||
+			!limiter_buckets_new(py_limits_config, "sets", true,
+				&limiter->sets, &limiter->n_sets)) {
+		request_limiter_destroy(limiter);
+		return NULL;
+	}
+	return limiter;
+}
+
+void request_limiter_destroy(request_limiter * limiter)
+{
+	if (!limiter) {
+		return;
+	}
+	free(limiter->namespaces);
+	free(limiter->sets);
+	pthread_cond_destroy(&limiter->cond);
+	pthread_mutex_destroy(&limiter->lock);
+	free(limiter);
+}
+
+/*******************************************************************************
+ * ADMISSION
+ ******************************************************************************/
+
+static void limiter_refill(limiter_bucket * bucket, uint64_t now)
+{
+	if (now > bucket->refilled_us) {
+		bucket->tokens += (double) (now - bucket->refilled_us) * bucket->rate / 1000000;
+		if (bucket->tokens > bucket->rate) {
+			bucket->tokens = bucket->rate;
+		}
+		bucket->refilled_us = now;
+	}
+}
+
+/**
+ * Collects the limited buckets a request draws from, at most three.
+ */
+static uint32_t limiter_buckets(request_limiter * limiter, limiter_op op,
+		const as_key * key, limiter_bucket ** buckets)
+{
+	uint32_t n_buckets = 0;
+
+	if (limiter->operations[op].rate) {
+		buckets[n_buckets++] = &limiter->operations[op];
+	}
+	if (!key) {
+		return n_buckets;
+	}
+
+	const char * ns = key->ns;
+	const char * set = key->set;
+
+	for (uint32_t i = 0; i < limiter->n_namespaces; i++) {
+		if (!strcmp(limiter->namespaces[i].name, ns)) {
+			buckets[n_buckets++] = &limiter->namespaces[i];
+			break;
+		}
+	}
+
+	size_t ns_len = strlen(ns);
+	for (uint32_t i = 0; *set && i < limiter->n_sets; i++) {
+		const char * name = limiter->sets[i].name;
+		if (!strncmp(name, ns, ns_len) && name[ns_len] == '.' && !strcmp(name + ns_len + 1, set)) {
+			buckets[n_buckets++] = &limiter->sets[i];
+			break;
+		}
+	}
+	return n_buckets;
+}
+
+static void limiter_wait(request_limiter * limiter, uint64_t wait_us)
+{
+	struct timeval now;
+	gettimeofday(&now, NULL);
+	uint64_t until_us = (uint64_t) now.tv_sec * 1000000 + now.tv_usec + wait_us;
+	struct timespec until;
+	until.tv_sec = (time_t) (until_us / 1000000);
+	until.tv_nsec = (long) (until_us % 1000000) * 1000;
+
+	pthread_cond_timedwait(&limiter->cond, &limiter->lock, &until);
+}
+
+as_status request_limiter_acquire(request_limiter * limiter, as_error * err, limiter_op op,
+		const as_key * key, uint32_t cost)
+{
+	if (!limiter) {
+		return AEROSPIKE_OK;
+	}
+
+	limiter_bucket * buckets[3];
+	bool queued = false;
+	uint64_t deadline = cf_getus() + (uint64_t) limiter->max_wait_ms * 1000;
+
+	pthread_mutex_lock(&limiter->lock);
+	uint32_t n_buckets = limiter_buckets(limiter, op, key, buckets);
+
+	while (true) {
+		uint64_t now = cf_getus();
+		limiter_bucket * empty = NULL;
+		uint64_t wait_us = 0;
+
+		// A request goes through with a single token left and may leave the
+		// bucket in debt, so batches bigger than the rate are not starved
+		for (uint32_t i = 0; i < n_buckets; i++) {
+			limiter_refill(buckets[i], now);
+			if (buckets[i]->tokens < 1) {
+				uint64_t refill_us = (uint64_t) ((1 - buckets[i]->tokens) * 1000000 / buckets[i]->rate) + 1;
+				if (refill_us > wait_us) {
+					wait_us = refill_us;
+					empty = buckets[i];
+				}
+			}
+		}
+		bool full = limiter->max_in_flight && limiter->in_flight >= limiter->max_in_flight;
+
+		if (!empty && !full) {
+			for (uint32_t i = 0; i < n_buckets; i++) {
+				buckets[i]->tokens -= cost;
+				buckets[i]->admitted++;
+			}
+			limiter->in_flight++;
+			limiter->admitted++;
+			break;
+		}
+
+		// Slots free up at any time, tokens only once refilled
+		if (now >= deadline || (empty && now + wait_us > deadline)) {
+			limiter->rejected++;
+			if (empty) {
+				empty->rejected++;
+				if (empty == &limiter->operations[op]) {
+					as_error_update(err, AEROSPIKE_ERR_NO_MORE_CONNECTIONS,
+							"Rate limit of %s operations exceeded", empty->name);
+				} else {
+					as_error_update(err, AEROSPIKE_ERR_NO_MORE_CONNECTIONS,
+							"Rate limit of '%s' exceeded", empty->name);
+				}
+			} else {
+				as_error_update(err, AEROSPIKE_ERR_NO_MORE_CONNECTIONS,
+						"Too many requests in flight");
+			}
+			break;
+		}
+
+		if (!queued) {
+			queued = true;
+			limiter->queued++;
+		}
+		limiter_wait(limiter, empty ? wait_us : deadline - now);
+	}
+
+	pthread_mutex_unlock(&limiter->lock);
+	return err->code;
+}
+
+void request_limiter_release(request_limiter * limiter)
+{
+	if (!limiter) {
+		return;
+	}
+	pthread_mutex_lock(&limiter->lock);
+	limiter->in_flight--;
+	pthread_cond_signal(&limiter->cond);
+	pthread_mutex_unlock(&limiter->lock);
+}
+
+/*******************************************************************************
+ * STATS
+ ******************************************************************************/
+
+static void limiter_stats_set(PyObject * py_stats, const char * name, PyObject * py_value)
+{
+	PyDict_SetItemString(py_stats, name, py_value);
+	Py_DECREF(py_value);
+}
+
+static PyObject * limiter_bucket_stats(limiter_bucket * bucket, uint64_t now)
+{
+	PyObject * py_bucket = PyDict_New();
+
+	limiter_refill(bucket, now);
+	limiter_stats_set(py_bucket, "rate", PyLong_FromUnsignedLongLong((uint64_t) bucket->rate));
+	limiter_stats_set(py_bucket, "tokens", PyFloat_FromDouble(bucket->tokens));
+	limiter_stats_set(py_bucket, "admitted", PyLong_FromUnsignedLongLong(bucket->admitted));
+	limiter_stats_set(py_bucket, "rejected", PyLong_FromUnsignedLongLong(bucket->rejected));
+	return py_bucket;
+}
+
+static PyObject * limiter_buckets_stats(limiter_bucket * buckets, uint32_t n_buckets, uint64_t now)
+{
+	PyObject * py_buckets = PyDict_New();
+
+	for (uint32_t i = 0; i < n_buckets; i++) {
+		if (buckets[i].rate) {
+			limiter_stats_set(py_buckets, buckets[i].name, limiter_bucket_stats(&buckets[i], now));
+		}
+	}
+	return py_buckets;
+}
+
+PyObject * request_limiter_stats(request_limiter * limiter)
+{
+	PyObject * py_stats = PyDict_New();
+
+	pthread_mutex_lock(&limiter->lock);
+	uint64_t now = cf_getus();
+	limiter_stats_set(py_stats, "max_in_flight", PyLong_FromUnsignedLong(limiter->max_in_flight));
+	limiter_stats_set(py_stats, "max_wait_ms", PyLong_FromUnsignedLong(limiter->max_wait_ms));
+	limiter_stats_set(py_stats, "in_flight", PyLong_FromUnsignedLong(limiter->in_flight));
+	limiter_stats_set(py_stats, "admitted", PyLong_FromUnsignedLongLong(limiter->admitted));
+	limiter_stats_set(py_stats, "queued", PyLong_FromUnsignedLongLong(limiter->queued));
+	limiter_stats_set(py_stats, "rejected", PyLong_FromUnsignedLongLong(limiter->rejected));
+	limiter_stats_set(py_stats, "operations",
+			limiter_buckets_stats(limiter->operations, LIMITER_OPERATIONS, now));
+	limiter_stats_set(py_stats, "namespaces",
+			limiter_buckets_stats(limiter->namespaces, limiter->n_namespaces, now));
+	limiter_stats_set(py_stats, "sets", limiter_buckets_stats(limiter->sets, limiter->n_sets, now));
+	pthread_mutex_unlock(&limiter->lock);
+
+	return py_stats;
+}
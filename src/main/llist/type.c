@@ -27,6 +27,7 @@
 #include "client.h"
 #include "conversions.h"
 #include "exceptions.h"
+#include "module_state.h"
 #include "llist.h"
 
 /*******************************************************************************
@@ -146,12 +147,36 @@ static int AerospikeLList_Type_Init(AerospikeLList * self, PyObject * args, PyOb
 
 static void AerospikeLList_Type_Dealloc(PyObject * self)
 {
-	Py_TYPE(self)->tp_free((PyObject *) self);
+	PyTypeObject * type = Py_TYPE(self);
+	type->tp_free((PyObject *) self);
+	AS_TYPE_RELEASE(type);
 }
 
 /*******************************************************************************
  * PYTHON TYPE DESCRIPTOR
  ******************************************************************************/
+#ifdef AS_HEAP_TYPES
+
+static PyType_Slot AerospikeLList_Type_Slots[] = {
+	{Py_tp_dealloc, (void *) AerospikeLList_Type_Dealloc},
+	{Py_tp_doc, (void *)
+		"The LList class assists in populating the parameters of a LList.\n"},
+	{Py_tp_methods, (void *) AerospikeLList_Type_Methods},
+	{Py_tp_init, (void *) AerospikeLList_Type_Init},
+	{Py_tp_new, (void *) AerospikeLList_Type_New},
+	{0, NULL}
+};
+
+static PyType_Spec AerospikeLList_Type_Spec = {
+	"aerospike.LList",
+	sizeof(AerospikeLList),
+	0,
+	Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+	AerospikeLList_Type_Slots
+};
+
+#else
+
 static PyTypeObject AerospikeLList_Type = {
 	PyVarObject_HEAD_INIT(NULL, 0)
 	"aerospike.LList",                  // tp_name
@@ -200,22 +225,29 @@ static PyTypeObject AerospikeLList_Type = {
 	0                                   // tp_bases
 };
 
+#endif
+
 /*******************************************************************************
  * PUBLIC FUNCTIONS
  ******************************************************************************/
 
 PyTypeObject * AerospikeLList_Ready()
 {
+#ifdef AS_HEAP_TYPES
+	return (PyTypeObject *) PyType_FromSpec(&AerospikeLList_Type_Spec);
+#else
 	return PyType_Ready(&AerospikeLList_Type) == 0 ? &AerospikeLList_Type : NULL;
+#endif
 }
 
 AerospikeLList * AerospikeLList_New(AerospikeClient * client, PyObject * args, PyObject * kwds)
 {
-	AerospikeLList * self = (AerospikeLList *) AerospikeLList_Type.tp_new(&AerospikeLList_Type, args, kwds);
+	PyTypeObject * type = client->state->llist_type;
+	AerospikeLList * self = (AerospikeLList *) type->tp_new(type, args, kwds);
 	self->client = client;
 	Py_INCREF(client);
 
-	if (AerospikeLList_Type.tp_init((PyObject *)self, args, kwds) == 0) {
+	if (type->tp_init((PyObject *)self, args, kwds) == 0) {
 		return self;
 	} else {
 		as_error err;
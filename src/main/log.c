@@ -24,6 +24,7 @@
 #include "conversions.h"
 #include "exceptions.h"
 #include "log.h"
+#include "module_state.h"
 
 static AerospikeLogCallback user_callback;
 
@@ -120,14 +121,22 @@ static bool log_cb(as_log_level level, const char * func,
 	vsnprintf(msg, 1024, fmt, ap);
 	va_end(ap);
 
-	// Extract pyhton user callback
-	PyObject *py_callback = user_callback.callback;
 	// User callback's argument list
 	PyObject *py_arglist = NULL;
 
 	// Lock python state
-	PyGILState_STATE gstate;
-	gstate = PyGILState_Ensure();
+	aerospike_gil gil;
+	aerospike_gil_ensure(user_callback.interp, &gil);
+
+	// The C client logs from its own threads, so the handler may be swapped
+	// concurrently by set_log_handler(). Only read it while holding the GIL,
+	// and hold a reference for the duration of the call.
+	PyObject *py_callback = user_callback.callback;
+	if (!py_callback) {
+		aerospike_gil_release(&gil);
+		return true;
+	}
+	Py_INCREF(py_callback);
 
 	// Create a tuple of argument list
 	py_arglist = PyTuple_New(5);
@@ -147,12 +156,19 @@ static bool log_cb(as_log_level level, const char * func,
 	PyTuple_SetItem(py_arglist, 4, message);
 
 	// Invoke user callback, passing in argument's list
-	PyEval_CallObject(py_callback, py_arglist);
+	PyObject *py_result = PyEval_CallObject(py_callback, py_arglist);
 
+	// There is no caller to report a failing handler to, and the exception
+	// must not leak into whatever Python code runs next on this thread
+	if (!py_result) {
+		PyErr_Clear();
+	}
+	Py_XDECREF(py_result);
 	Py_DECREF(py_arglist);
+	Py_DECREF(py_callback);
 
 	// Release python state
-	PyGILState_Release(gstate);
+	aerospike_gil_release(&gil);
 
 	return true;
 }
@@ -174,9 +190,13 @@ PyObject * Aerospike_Set_Log_Handler(PyObject *parent, PyObject *args, PyObject
 		as_error_update(&err, AEROSPIKE_ERR_PARAM, "Log handler must be callable");
 		goto CLEANUP;
 	}
-	// Store user callback
+	// Store user callback, releasing the one it replaces
 	Py_INCREF(py_callback);
+	PyObject *py_previous = user_callback.callback;
 	user_callback.callback = py_callback;
+	aerospike_state * state = aerospike_module_state(parent);
+	user_callback.interp = state ? state->interp : NULL;
+	Py_XDECREF(py_previous);
 
 	// Register callback to C-SDK
 	as_log_set_callback((as_log_callback) log_cb);
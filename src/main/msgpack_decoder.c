@@ -0,0 +1,369 @@
+/*******************************************************************************
+ * Copyright 2013-2016 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include <Python.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <aerospike/as_bytes.h>
+#include <aerospike/as_error.h>
+
+#include "geo.h"
+#include "macros.h"
+#include "msgpack_decoder.h"
+#include "serializer.h"
+
+typedef struct {
+	AerospikeClient * client;
+	as_error * err;
+	const uint8_t * p;
+	const uint8_t * end;
+} msgpack_decoder;
+
+static PyObject * decoder_value(msgpack_decoder * dec);
+
+static bool decoder_invalid(msgpack_decoder * dec)
+{
+	if (dec->err->code == AEROSPIKE_OK) {
+		as_error_update(dec->err, AEROSPIKE_ERR_CLIENT, "Invalid msgpack in list or map bin");
+	}
+	return false;
+}
+
+/**
+ * Reads an n byte big endian unsigned integer.
+ */
+static bool decoder_uint(msgpack_decoder * dec, uint32_t n, uint64_t * value)
+{
+	if (dec->end - dec->p < n) {
+		return decoder_invalid(dec);
+	}
+	*value = 0;
+	for (uint32_t i = 0; i < n; i++) {
+		*value = (*value << 8) | dec->p[i];
+	}
+	dec->p += n;
+	return true;
+}
+
+static PyObject * decoder_int(msgpack_decoder * dec, uint32_t n, bool is_signed)
+{
+	uint64_t value = 0;
+	if (!decoder_uint(dec, n, &value)) {
+		return NULL;
+	}
+
+	int64_t i = (int64_t) value;
+	if (is_signed && n < 8) {
+		// Extend the sign of the narrower types
+		uint32_t shift = 64 - n * 8;
+		i = (int64_t) (value << shift) >> shift;
+	}
+	// Unsigned 64 bit values wrap as they do in as_integer
+	return PyInt_FromLong((long) i);
+}
+
+static PyObject * decoder_float(msgpack_decoder * dec, uint32_t n)
+{
+	uint64_t value = 0;
+	if (!decoder_uint(dec, n, &value)) {
+		return NULL;
+	}
+
+	if (n == 4) {
+		uint32_t bits = (uint32_t) value;
+		float f;
+		memcpy(&f, &bits, sizeof(f));
+		return PyFloat_FromDouble(f);
+	}
+	double d;
+	memcpy(&d, &value, sizeof(d));
+	return PyFloat_FromDouble(d);
+}
+
+/**
+ * Converts a raw value, whose first byte is its as_bytes type as written by
+ * as_msgpack.
+ */
+static PyObject * decoder_raw(msgpack_decoder * dec, uint32_t size)
+{
+	if (dec->end - dec->p < size) {
+		decoder_invalid(dec);
+		return NULL;
+	}
+
+	const uint8_t * data = dec->p;
+	dec->p += size;
+
+	if (size == 0) {
+		return PyString_FromStringAndSize(NULL, 0);
+	}
+
+	uint8_t type = data[0];
+	data++;
+	size--;
+
+	if (type == AS_BYTES_STRING) {
+		PyObject * py_str = PyString_FromStringAndSize((const char *) data, size);
+		if (!py_str) {
+			PyErr_Clear();
+			as_error_update(dec->err, AEROSPIKE_ERR_CLIENT, "Unknown type for value");
+		}
+		return py_str;
+	}
+
+	if (type == AS_BYTES_GEOJSON) {
+		char * geojson = (char *) malloc(size + 1);
+		memcpy(geojson, data, size);
+		geojson[size] = '\0';
+		PyObject * py_geo = AerospikeGeospatial_New_GeoJSON(dec->err, geojson);
+		free(geojson);
+		return py_geo;
+	}
+
+	// Blobs and pickled values go through the deserializers, as for a bin
+	as_bytes bytes;
+	as_bytes_init_wrap(&bytes, (uint8_t *) data, size, false);
+	bytes.type = (as_bytes_type) type;
+
+	PyObject * py_val = NULL;
+	if (deserialize_based_on_as_bytes_type(dec->client, &bytes, &py_val, dec->err) != AEROSPIKE_OK) {
+		return NULL;
+	}
+	return py_val;
+}
+
+static bool decoder_is_ext(uint8_t type)
+{
+	return (type >= 0xc7 && type <= 0xc9) || (type >= 0xd4 && type <= 0xd8);
+}
+
+/**
+ * Skips an ext value. Aerospike puts one first in ordered lists and maps to
+ * carry their flags, which the as_val tree does not keep either.
+ */
+static bool decoder_skip_ext(msgpack_decoder * dec)
+{
+	uint8_t type = *dec->p++;
+	uint64_t size = 0;
+
+	switch (type) {
+		case 0xd4: size = 1; break;
+		case 0xd5: size = 2; break;
+		case 0xd6: size = 4; break;
+		case 0xd7: size = 8; break;
+		case 0xd8: size = 16; break;
+		case 0xc7:
+			if (!decoder_uint(dec, 1, &size)) return false;
+			break;
+		case 0xc8:
+			if (!decoder_uint(dec, 2, &size)) return false;
+			break;
+		default:
+			if (!decoder_uint(dec, 4, &size)) return false;
+			break;
+	}
+
+	// The ext type byte, then its data
+	if ((uint64_t) (dec->end - dec->p) < size + 1) {
+		return decoder_invalid(dec);
+	}
+	dec->p += size + 1;
+	return true;
+}
+
+static PyObject * decoder_list(msgpack_decoder * dec, uint32_t count)
+{
+	if (count > 0 && dec->p < dec->end && decoder_is_ext(*dec->p)) {
+		if (!decoder_skip_ext(dec)) {
+			return NULL;
+		}
+		count--;
+	}
+
+	// Each element takes at least a byte, which bounds the allocation
+	if (dec->end - dec->p < count) {
+		decoder_invalid(dec);
+		return NULL;
+	}
+
+	PyObject * py_list = PyList_New(count);
+	if (!py_list) {
+		PyErr_Clear();
+		as_error_update(dec->err, AEROSPIKE_ERR_CLIENT, "Unable to allocate list");
+		return NULL;
+	}
+
+	for (uint32_t i = 0; i < count; i++) {
+		PyObject * py_val = decoder_value(dec);
+		if (!py_val) {
+			Py_DECREF(py_list);
+			return NULL;
+		}
+		PyList_SET_ITEM(py_list, i, py_val);
+	}
+	return py_list;
+}
+
+static PyObject * decoder_map(msgpack_decoder * dec, uint32_t count)
+{
+	if (count > 0 && dec->p < dec->end && decoder_is_ext(*dec->p)) {
+		// The flags are the key of the first pair, with a nil value
+		if (!decoder_skip_ext(dec)) {
+			return NULL;
+		}
+		PyObject * py_nil = decoder_value(dec);
+		if (!py_nil) {
+			return NULL;
+		}
+		Py_DECREF(py_nil);
+		count--;
+	}
+
+	PyObject * py_dict = PyDict_New();
+
+	for (uint32_t i = 0; i < count; i++) {
+		PyObject * py_key = decoder_value(dec);
+		if (!py_key) {
+			Py_DECREF(py_dict);
+			return NULL;
+		}
+		PyObject * py_val = decoder_value(dec);
+		if (!py_val) {
+			Py_DECREF(py_key);
+			Py_DECREF(py_dict);
+			return NULL;
+		}
+
+		int rc = PyDict_SetItem(py_dict, py_key, py_val);
+		Py_DECREF(py_key);
+		Py_DECREF(py_val);
+		if (rc == -1) {
+			PyErr_Clear();
+			as_error_update(dec->err, AEROSPIKE_ERR_CLIENT, "Unable to use a map key as a dict key");
+			Py_DECREF(py_dict);
+			return NULL;
+		}
+	}
+	return py_dict;
+}
+
+static PyObject * decoder_container(msgpack_decoder * dec, uint32_t n, bool is_map)
+{
+	uint64_t count = 0;
+	if (n && !decoder_uint(dec, n, &count)) {
+		return NULL;
+	}
+	return is_map ? decoder_map(dec, (uint32_t) count) : decoder_list(dec, (uint32_t) count);
+}
+
+static PyObject * decoder_sized_raw(msgpack_decoder * dec, uint32_t n)
+{
+	uint64_t size = 0;
+	if (!decoder_uint(dec, n, &size)) {
+		return NULL;
+	}
+	return decoder_raw(dec, (uint32_t) size);
+}
+
+static PyObject * decoder_value(msgpack_decoder * dec)
+{
+	if (dec->p >= dec->end) {
+		decoder_invalid(dec);
+		return NULL;
+	}
+
+	// Guards the C stack against deeply nested documents
+	if (Py_EnterRecursiveCall(" while decoding a list or map bin")) {
+		PyErr_Clear();
+		as_error_update(dec->err, AEROSPIKE_ERR_CLIENT, "List or map bin nested too deeply");
+		return NULL;
+	}
+
+	PyObject * py_val = NULL;
+	uint8_t type = *dec->p++;
+
+	if (type <= 0x7f) {
+		py_val = PyInt_FromLong(type);
+	} else if (type >= 0xe0) {
+		py_val = PyInt_FromLong((int8_t) type);
+	} else if (type <= 0x8f) {
+		py_val = decoder_map(dec, type & 0x0f);
+	} else if (type <= 0x9f) {
+		py_val = decoder_list(dec, type & 0x0f);
+	} else if (type <= 0xbf) {
+		py_val = decoder_raw(dec, type & 0x1f);
+	} else {
+		switch (type) {
+			case 0xc0:
+				Py_INCREF(Py_None);
+				py_val = Py_None;
+				break;
+			case 0xc2:
+				Py_INCREF(Py_False);
+				py_val = Py_False;
+				break;
+			case 0xc3:
+				Py_INCREF(Py_True);
+				py_val = Py_True;
+				break;
+			case 0xc4: case 0xd9: py_val = decoder_sized_raw(dec, 1); break;
+			case 0xc5: case 0xda: py_val = decoder_sized_raw(dec, 2); break;
+			case 0xc6: case 0xdb: py_val = decoder_sized_raw(dec, 4); break;
+			case 0xca: py_val = decoder_float(dec, 4); break;
+			case 0xcb: py_val = decoder_float(dec, 8); break;
+			case 0xcc: py_val = decoder_int(dec, 1, false); break;
+			case 0xcd: py_val = decoder_int(dec, 2, false); break;
+			case 0xce: py_val = decoder_int(dec, 4, false); break;
+			case 0xcf: py_val = decoder_int(dec, 8, false); break;
+			case 0xd0: py_val = decoder_int(dec, 1, true); break;
+			case 0xd1: py_val = decoder_int(dec, 2, true); break;
+			case 0xd2: py_val = decoder_int(dec, 4, true); break;
+			case 0xd3: py_val = decoder_int(dec, 8, true); break;
+			case 0xdc: py_val = decoder_container(dec, 2, false); break;
+			case 0xdd: py_val = decoder_container(dec, 4, false); break;
+			case 0xde: py_val = decoder_container(dec, 2, true); break;
+			case 0xdf: py_val = decoder_container(dec, 4, true); break;
+			default:
+				as_error_update(dec->err, AEROSPIKE_ERR_CLIENT, "Unknown type for value");
+				break;
+		}
+	}
+
+	Py_LeaveRecursiveCall();
+	return py_val;
+}
+
+as_status msgpack_to_pyobject(AerospikeClient * self, as_error * err,
+		const uint8_t * buf, uint32_t size, PyObject ** py_obj)
+{
+	msgpack_decoder dec = {
+		.client = self,
+		.err = err,
+		.p = buf,
+		.end = buf + size
+	};
+
+	*py_obj = decoder_value(&dec);
+
+	if (!*py_obj && err->code == AEROSPIKE_OK) {
+		PyErr_Clear();
+		as_error_update(err, AEROSPIKE_ERR_CLIENT, "Unable to decode list or map bin");
+	}
+	return err->code;
+}
@@ -19,19 +19,42 @@
 #include <stdbool.h>
 #include <unistd.h>
 
+#include "module_state.h"
 #include "nullobject.h"
 
 static PyObject * AerospikeNullObject_Type_New(PyTypeObject * parent, PyObject * args, PyObject * kwds);
 
 static void AerospikeNullObject_Type_Dealloc(AerospikeNullObject * self)
 {
+	PyTypeObject * type = Py_TYPE(self);
 	PyObject_Del(self);
+	AS_TYPE_RELEASE(type);
 }
 
 /*******************************************************************************
  * PYTHON TYPE DESCRIPTOR
  ******************************************************************************/
 
+#ifdef AS_HEAP_TYPES
+
+static PyType_Slot AerospikeNullObject_Type_Slots[] = {
+	{Py_tp_dealloc, (void *) AerospikeNullObject_Type_Dealloc},
+	{Py_tp_doc, (void *)
+		"The nullobject when used with put() works as a removebin()\n"},
+	{Py_tp_new, (void *) AerospikeNullObject_Type_New},
+	{0, NULL}
+};
+
+static PyType_Spec AerospikeNullObject_Type_Spec = {
+	"aerospike.null",
+	sizeof(AerospikeNullObject),
+	0,
+	Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+	AerospikeNullObject_Type_Slots
+};
+
+#else
+
 static PyTypeObject AerospikeNullObject_Type = {
 	PyVarObject_HEAD_INIT(NULL, 0)
 	"aerospike.null",                   // tp_name
@@ -79,6 +102,8 @@ static PyTypeObject AerospikeNullObject_Type = {
 	0                                   // tp_bases
 };
 
+#endif
+
 
 static PyObject * AerospikeNullObject_Type_New(PyTypeObject * parent, PyObject * args, PyObject * kwds)
 {
@@ -87,11 +112,15 @@ static PyObject * AerospikeNullObject_Type_New(PyTypeObject * parent, PyObject *
 
 PyObject * AerospikeNullObject_New()
 {
-	return AerospikeNullObject_Type_New(&AerospikeNullObject_Type, Py_None, Py_None);
+	return AerospikeNullObject_Type_New(aerospike_get_state()->null_object_type, Py_None, Py_None);
 }
 
 PyTypeObject * AerospikeNullObject_Ready()
 {
+#ifdef AS_HEAP_TYPES
+	return (PyTypeObject *) PyType_FromSpec(&AerospikeNullObject_Type_Spec);
+#else
 	return PyType_Ready(&AerospikeNullObject_Type) == 0 ? &AerospikeNullObject_Type : NULL;
+#endif
 }
 
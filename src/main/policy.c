@@ -444,6 +444,7 @@ as_status pyobject_to_policy_read(as_error * err, PyObject * py_policy,
 	POLICY_SET_FIELD(consistency_level, as_policy_consistency_level);
 	POLICY_SET_FIELD(replica, as_policy_replica);
 	POLICY_SET_FIELD(retry_on_timeout, bool);
+	POLICY_SET_FIELD(deserialize, bool);
 
 	// Update the policy
 	POLICY_UPDATE();
@@ -451,6 +452,62 @@ as_status pyobject_to_policy_read(as_error * err, PyObject * py_policy,
 	return err->code;
 }
 
+/**
+ * Reads the hedge_after_ms field of a read policy, 0 when the read should
+ * not be hedged.
+ */
+as_status pyobject_to_policy_hedge(as_error * err, PyObject * py_policy,
+		uint32_t * hedge_after_ms)
+{
+	*hedge_after_ms = 0;
+
+	if (!py_policy || !PyDict_Check(py_policy)) {
+		return err->code;
+	}
+
+	PyObject * py_hedge = PyDict_GetItemString(py_policy, "hedge_after_ms");
+	if (!py_hedge || py_hedge == Py_None) {
+		return err->code;
+	}
+
+	long hedge = PyInt_Check(py_hedge) ? PyInt_AsLong(py_hedge) : -1;
+	if (hedge < 0 || hedge > UINT32_MAX) {
+		return as_error_update(err, AEROSPIKE_ERR_PARAM, "hedge_after_ms is invalid");
+	}
+	*hedge_after_ms = (uint32_t) hedge;
+
+	return err->code;
+}
+
+/**
+ * Reads the not_found field of a read policy. none_on_miss is set when a
+ * missing record should be returned as None instead of raising
+ * RecordNotFound. Only 'none' and 'raise' are accepted.
+ */
+as_status pyobject_to_policy_not_found(as_error * err, PyObject * py_policy,
+		bool * none_on_miss)
+{
+	*none_on_miss = false;
+
+	if (!py_policy || !PyDict_Check(py_policy)) {
+		return err->code;
+	}
+
+	PyObject * py_not_found = PyDict_GetItemString(py_policy, "not_found");
+	if (!py_not_found) {
+		return err->code;
+	}
+
+	char * not_found = PyString_Check(py_not_found) ? PyString_AsString(py_not_found) : NULL;
+	if (not_found && !strcmp(not_found, "none")) {
+		*none_on_miss = true;
+	} else if (!not_found || strcmp(not_found, "raise")) {
+		return as_error_update(err, AEROSPIKE_ERR_PARAM, "not_found should be 'none' or 'raise'");
+	}
+
+	return err->code;
+}
+
 /**
  * Converts a PyObject into an as_policy_remove object.
  * Returns AEROSPIKE_OK on success. On error, the err argument is populated.
@@ -601,6 +658,7 @@ as_status pyobject_to_policy_batch(as_error * err, PyObject * py_policy,
 	// Set policy fields
 	POLICY_SET_FIELD(timeout, uint32_t);
 	POLICY_SET_FIELD(retry_on_timeout, bool);
+	POLICY_SET_FIELD(deserialize, bool);
 
 	// Update the policy
 	POLICY_UPDATE();
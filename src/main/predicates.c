@@ -21,12 +21,15 @@
  */
 
 #include <Python.h>
+#include <math.h>
+#include <stdbool.h>
 #include <aerospike/as_query.h>
 #include <aerospike/as_error.h>
 
 #include "conversions.h"
 #include "exceptions.h"
 #include "geo.h"
+#include "macros.h"
 
 static PyObject * AerospikePredicates_Equals(PyObject * self, PyObject * args)
 {
@@ -154,13 +157,118 @@ exit:
 	return Py_None;
 }
 
+/**
+ * Appends a coordinate as json.dumps() writes it, which is how the
+ * shapes were formatted when they were built as Python objects.
+ */
+static bool geo_append_number(char * buf, size_t size, size_t * offset, PyObject * py_num)
+{
+	char * text = NULL;
+	char number[32];
+	PyObject * py_str = NULL;
+
+	if (PyFloat_Check(py_num)) {
+		double d = PyFloat_AsDouble(py_num);
+		if (isnan(d)) {
+			text = "NaN";
+		} else if (isinf(d)) {
+			text = d > 0 ? "Infinity" : "-Infinity";
+		} else {
+			char * repr = PyOS_double_to_string(d, 'r', 0, Py_DTSF_ADD_DOT_0, NULL);
+			if (!repr) {
+				return false;
+			}
+			snprintf(number, sizeof(number), "%s", repr);
+			PyMem_Free(repr);
+			text = number;
+		}
+	} else {
+		int overflow = 0;
+		long long l = PyLong_AsLongLongAndOverflow(py_num, &overflow);
+		if (l == -1 && PyErr_Occurred()) {
+			return false;
+		}
+		if (overflow) {
+			py_str = PyObject_Str(py_num);
+			text = py_str ? PyString_AsString(py_str) : NULL;
+			if (!text) {
+				Py_XDECREF(py_str);
+				return false;
+			}
+		} else {
+			snprintf(number, sizeof(number), "%lld", l);
+			text = number;
+		}
+	}
+
+	int n = snprintf(buf + *offset, size - *offset, "%s", text);
+	Py_XDECREF(py_str);
+	if (n < 0 || (size_t) n >= size - *offset) {
+		return false;
+	}
+	*offset += n;
+	return true;
+}
+
+static bool geo_is_number(PyObject * py_num)
+{
+	return PyFloat_Check(py_num) || PyInt_Check(py_num) || PyLong_Check(py_num);
+}
+
+/**
+ * Formats an AeroCircle region in C, without building a dict and
+ * calling json.dumps() on it.
+ */
+static PyObject * geo_circle_shape(PyObject * py_long, PyObject * py_lat, PyObject * py_radius)
+{
+	char buf[512];
+	size_t offset = 0;
+
+	offset += snprintf(buf, sizeof(buf), "{\"type\": \"AeroCircle\", \"coordinates\": [[");
+	if (!geo_append_number(buf, sizeof(buf), &offset, py_long)) {
+		return NULL;
+	}
+	offset += snprintf(buf + offset, sizeof(buf) - offset, ", ");
+	if (!geo_append_number(buf, sizeof(buf), &offset, py_lat)) {
+		return NULL;
+	}
+	offset += snprintf(buf + offset, sizeof(buf) - offset, "], ");
+	if (!geo_append_number(buf, sizeof(buf), &offset, py_radius)) {
+		return NULL;
+	}
+	if (offset + 3 > sizeof(buf)) {
+		return NULL;
+	}
+	offset += snprintf(buf + offset, sizeof(buf) - offset, "]}");
+	return PyString_FromStringAndSize(buf, offset);
+}
+
+static PyObject * geo_point_shape(PyObject * py_long, PyObject * py_lat)
+{
+	char buf[512];
+	size_t offset = 0;
+
+	offset += snprintf(buf, sizeof(buf), "{\"type\": \"Point\", \"coordinates\": [");
+	if (!geo_append_number(buf, sizeof(buf), &offset, py_long)) {
+		return NULL;
+	}
+	offset += snprintf(buf + offset, sizeof(buf) - offset, ", ");
+	if (!geo_append_number(buf, sizeof(buf), &offset, py_lat)) {
+		return NULL;
+	}
+	if (offset + 3 > sizeof(buf)) {
+		return NULL;
+	}
+	offset += snprintf(buf + offset, sizeof(buf) - offset, "]}");
+	return PyString_FromStringAndSize(buf, offset);
+}
+
 static PyObject * AerospikePredicates_GeoWithin_Radius(PyObject * self, PyObject * args)
 {
 	PyObject * py_bin = NULL;
 	PyObject * py_lat = NULL;
 	PyObject * py_long = NULL;
 	PyObject * py_radius = NULL;
-	PyObject * py_geo_object = NULL;
 	PyObject * py_shape = NULL;
 	PyObject * py_indexType = NULL;
 	PyObject * ret_val = NULL;
@@ -168,66 +276,129 @@ static PyObject * AerospikePredicates_GeoWithin_Radius(PyObject * self, PyObject
 	as_error err;
 	as_error_init(&err);
 
-	py_geo_object = PyDict_New();
-
 	if (PyArg_ParseTuple(args, "OOOO|O:geo_within_radius",
 			&py_bin, &py_lat, &py_long, &py_radius, &py_indexType) == false) {
 		goto CLEANUP;
 	}
 
-	if (!py_indexType) {
-		py_indexType = Py_BuildValue("i", AS_INDEX_TYPE_DEFAULT);
+	if (PyString_Check(py_bin) && geo_is_number(py_lat) && geo_is_number(py_long) && geo_is_number(py_radius)) {
+		py_shape = geo_circle_shape(py_lat, py_long, py_radius);
+		if (!py_shape) {
+			PyErr_Clear();
+			as_error_update(&err, AEROSPIKE_ERR_CLIENT, "Unable to format the AeroCircle");
+			goto CLEANUP;
+		}
+	} else {
+		as_error_update(&err, AEROSPIKE_ERR_PARAM, "Latitude, longitude and radius should be integer or double type, bin of string type");
+		goto CLEANUP;
+	}
+
+	if (py_indexType) {
+		ret_val = Py_BuildValue("iiOOOO", AS_PREDICATE_RANGE, AS_INDEX_GEO2DSPHERE, py_bin, py_shape, Py_None, py_indexType);
+	} else {
+		ret_val = Py_BuildValue("iiOOOi", AS_PREDICATE_RANGE, AS_INDEX_GEO2DSPHERE, py_bin, py_shape, Py_None, AS_INDEX_TYPE_DEFAULT);
+	}
+	Py_DECREF(py_shape);
+	if (ret_val) {
+		return ret_val;
+	}
+
+CLEANUP:
+	// If an error occurred, tell Python.
+	if (err.code != AEROSPIKE_OK) {
+		PyObject * py_err = NULL;
+		error_to_pyobject(&err, &py_err);
+		PyObject *exception_type = raise_exception(&err);
+		PyErr_SetObject(exception_type, py_err);
+		Py_DECREF(py_err);
+		return NULL;
 	}
 
-	PyObject *py_circle = PyString_FromString("AeroCircle");
-	PyDict_SetItemString(py_geo_object, "type", py_circle);
-	Py_DECREF(py_circle);
+	Py_INCREF(Py_None);
+	return Py_None;
+}
 
-	if (PyString_Check(py_bin) &&
-			(PyFloat_Check(py_lat) || PyInt_Check(py_lat)) &&
-			(PyFloat_Check(py_long) || PyInt_Check(py_long)) &&
-			(PyFloat_Check(py_radius) || PyInt_Check(py_radius))) {
+/**
+ * Builds one geo_within_radius predicate per (long, lat) point, all with
+ * the same bin and radius.
+ *
+ *		predicates.geo_within_radius_many(bin, points, radius_meters[, index_type])
+ */
+static PyObject * AerospikePredicates_GeoWithin_Radius_Many(PyObject * self, PyObject * args)
+{
+	PyObject * py_bin = NULL;
+	PyObject * py_points = NULL;
+	PyObject * py_radius = NULL;
+	PyObject * py_indexType = NULL;
+	PyObject * py_fast = NULL;
+	PyObject * py_predicates = NULL;
 
-		PyObject * py_inner_list = Py_BuildValue("[OO]", py_lat, py_long);
+	as_error err;
+	as_error_init(&err);
 
-		if (!py_inner_list) {
-			goto CLEANUP;
-		}
+	if (PyArg_ParseTuple(args, "OOO|O:geo_within_radius_many",
+			&py_bin, &py_points, &py_radius, &py_indexType) == false) {
+		return NULL;
+	}
 
-		PyObject * py_outer_list = Py_BuildValue("[OO]", py_inner_list, py_radius);
+	if (!PyString_Check(py_bin) || !geo_is_number(py_radius)) {
+		as_error_update(&err, AEROSPIKE_ERR_PARAM, "Radius should be integer or double type, bin of string type");
+		goto CLEANUP;
+	}
 
-		if (!py_outer_list) {
-			goto CLEANUP;
-		}
-		Py_DECREF(py_inner_list);
+	py_fast = PySequence_Fast(py_points, "points should be a sequence");
+	if (!py_fast) {
+		PyErr_Clear();
+		as_error_update(&err, AEROSPIKE_ERR_PARAM, "Points should be a list of (longitude, latitude) pairs");
+		goto CLEANUP;
+	}
+
+	if (!py_indexType) {
+		py_indexType = PyInt_FromLong(AS_INDEX_TYPE_DEFAULT);
+	} else {
+		Py_INCREF(py_indexType);
+	}
 
-		PyDict_SetItemString(py_geo_object, "coordinates", py_outer_list);
-		Py_DECREF(py_outer_list);
+	Py_ssize_t n_points = PySequence_Fast_GET_SIZE(py_fast);
+	py_predicates = PyList_New(n_points);
 
-		py_shape = AerospikeGeospatial_DoDumps(py_geo_object, &err);
+	for (Py_ssize_t i = 0; i < n_points; i++) {
+		PyObject * py_point = PySequence_Fast_GET_ITEM(py_fast, i);
 
-		if (!py_shape) {
-			as_error_update(&err, AEROSPIKE_ERR_CLIENT, "Unable to call dumps function");
+		if (!(PyTuple_Check(py_point) || PyList_Check(py_point)) || PySequence_Size(py_point) != 2) {
+			as_error_update(&err, AEROSPIKE_ERR_PARAM, "Points should be a list of (longitude, latitude) pairs");
+			goto CLEANUP;
+		}
+		PyObject * py_long = PySequence_Fast_GET_ITEM(py_point, 0);
+		PyObject * py_lat = PySequence_Fast_GET_ITEM(py_point, 1);
+		if (!geo_is_number(py_long) || !geo_is_number(py_lat)) {
+			as_error_update(&err, AEROSPIKE_ERR_PARAM, "Latitude and longitude should be integer or double type");
 			goto CLEANUP;
 		}
-	} else {
-		as_error_update(&err, AEROSPIKE_ERR_PARAM, "Latitude, longitude and radius should be integer or double type, bin of string type");
-		goto CLEANUP;
-	}
-	Py_CLEAR(py_geo_object);
 
-	ret_val = Py_BuildValue("iiOOOO", AS_PREDICATE_RANGE, AS_INDEX_GEO2DSPHERE, py_bin, py_shape, Py_None, py_indexType );
-	if (ret_val) {
+		PyObject * py_shape = geo_circle_shape(py_long, py_lat, py_radius);
+		if (!py_shape) {
+			PyErr_Clear();
+			as_error_update(&err, AEROSPIKE_ERR_CLIENT, "Unable to format the AeroCircle");
+			goto CLEANUP;
+		}
+		PyObject * py_predicate = Py_BuildValue("iiOOOO", AS_PREDICATE_RANGE, AS_INDEX_GEO2DSPHERE,
+				py_bin, py_shape, Py_None, py_indexType);
 		Py_DECREF(py_shape);
-		return ret_val;
-	} else {
-		goto CLEANUP;
+		if (!py_predicate) {
+			Py_CLEAR(py_predicates);
+			goto CLEANUP;
+		}
+		PyList_SET_ITEM(py_predicates, i, py_predicate);
 	}
 
 CLEANUP:
+	Py_XDECREF(py_fast);
+	Py_XDECREF(py_indexType);
+
 	// If an error occurred, tell Python.
-	Py_XDECREF(py_geo_object);
 	if (err.code != AEROSPIKE_OK) {
+		Py_XDECREF(py_predicates);
 		PyObject * py_err = NULL;
 		error_to_pyobject(&err, &py_err);
 		PyObject *exception_type = raise_exception(&err);
@@ -235,9 +406,7 @@ CLEANUP:
 		Py_DECREF(py_err);
 		return NULL;
 	}
-
-	Py_INCREF(Py_None);
-	return Py_None;
+	return py_predicates;
 }
 
 static PyObject * AerospikePredicates_GeoContains_GeoJSONPoint(PyObject * self, PyObject * args)
@@ -268,58 +437,41 @@ static PyObject * AerospikePredicates_GeoContains_Point(PyObject * self, PyObjec
 	PyObject * py_bin = NULL;
 	PyObject * py_lat = NULL;
 	PyObject * py_long = NULL;
-	PyObject * py_geo_object = NULL;
 	PyObject * py_shape = NULL;
 	PyObject * py_indexType = NULL;
-	PyObject * py_list = NULL;
+	PyObject * ret_val = NULL;
 
 	as_error err;
 	as_error_init(&err);
 
-	py_geo_object = PyDict_New();
-
 	if (PyArg_ParseTuple(args, "OOO|O:geo_contains_point",
 			&py_bin, &py_lat, &py_long, &py_indexType) == false) {
 		goto CLEANUP;
 	}
 
-	if (!py_indexType) {
-		py_indexType = Py_BuildValue("i", AS_INDEX_TYPE_DEFAULT);
-	}
-
-	PyObject *py_point = PyString_FromString("Point");
-	PyDict_SetItemString(py_geo_object, "type", py_point);
-	Py_DECREF(py_point);
-
-	if (PyString_Check(py_bin) && (PyFloat_Check(py_lat) || PyInt_Check(py_lat)) && (PyFloat_Check(py_long) || PyInt_Check(py_long))) {
-		py_list = Py_BuildValue("[OO]", py_lat, py_long);
-
-		PyDict_SetItemString(py_geo_object, "coordinates", py_list);
-		Py_CLEAR(py_list);
-
-		py_shape = AerospikeGeospatial_DoDumps(py_geo_object, &err);
-		Py_CLEAR(py_geo_object);
-
+	if (PyString_Check(py_bin) && geo_is_number(py_lat) && geo_is_number(py_long)) {
+		py_shape = geo_point_shape(py_lat, py_long);
 		if (!py_shape) {
-			as_error_update(&err, AEROSPIKE_ERR_CLIENT, "Unable to call dumps function");
+			PyErr_Clear();
+			as_error_update(&err, AEROSPIKE_ERR_CLIENT, "Unable to format the point");
 			goto CLEANUP;
 		}
 	} else {
 		as_error_update(&err, AEROSPIKE_ERR_PARAM, "Latitude and longitude should be integer or double type, bin of string type");
 		goto CLEANUP;
 	}
-	PyObject* ret_val = Py_BuildValue("iiOOOO", AS_PREDICATE_RANGE, AS_INDEX_GEO2DSPHERE, py_bin, py_shape, Py_None, py_indexType);
-	if(ret_val) {
-		Py_DECREF(py_shape);
+
+	if (py_indexType) {
+		ret_val = Py_BuildValue("iiOOOO", AS_PREDICATE_RANGE, AS_INDEX_GEO2DSPHERE, py_bin, py_shape, Py_None, py_indexType);
 	} else {
-		goto CLEANUP;
+		ret_val = Py_BuildValue("iiOOOi", AS_PREDICATE_RANGE, AS_INDEX_GEO2DSPHERE, py_bin, py_shape, Py_None, AS_INDEX_TYPE_DEFAULT);
+	}
+	Py_DECREF(py_shape);
+	if (ret_val) {
+		return ret_val;
 	}
-	return ret_val;
-
 
 CLEANUP:
-		Py_XDECREF(py_geo_object);
-		Py_XDECREF(py_list);
 	// If an error occurred, tell Python.
 	if (err.code != AEROSPIKE_OK) {
 		PyObject * py_err = NULL;
@@ -341,6 +493,7 @@ static PyMethodDef AerospikePredicates_Methods[] = {
 	{"range",	(PyCFunction) AerospikePredicates_RangeContains,	METH_VARARGS, "Tests whether a bin's value is within the specified range in a complex data type"},
 	{"geo_within_geojson_region",		(PyCFunction) AerospikePredicates_GeoWithin_GeoJSONRegion,	METH_VARARGS, "Tests whether a bin's value is within the specified shape."},
 	{"geo_within_radius",		(PyCFunction) AerospikePredicates_GeoWithin_Radius,	METH_VARARGS, "Create a geo_within_geojson_region predicate"},
+	{"geo_within_radius_many",		(PyCFunction) AerospikePredicates_GeoWithin_Radius_Many,	METH_VARARGS, "Create a geo_within_radius predicate for each point"},
 	{"geo_contains_geojson_point",		(PyCFunction) AerospikePredicates_GeoContains_GeoJSONPoint,	METH_VARARGS, "Tests whether a bin's value contains the specified point."},
 	{"geo_contains_point",		(PyCFunction) AerospikePredicates_GeoContains_Point,	METH_VARARGS, "Create a geo_contains_geojson_point predicate"},
 	{NULL, NULL, 0, NULL}
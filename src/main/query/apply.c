@@ -113,6 +113,12 @@ AerospikeQuery * AerospikeQuery_Apply(AerospikeQuery * self, PyObject * args, Py
 	}
 
 
+	// Replace the arglist of an earlier apply() on this query
+	if (self->query.apply.arglist) {
+		as_list_destroy(self->query.apply.arglist);
+		self->query.apply.arglist = NULL;
+	}
+
 	Py_BEGIN_ALLOW_THREADS
 	as_query_apply(&self->query, module, function, (as_list *) arglist);
 	Py_END_ALLOW_THREADS
@@ -28,12 +28,16 @@
 #include "exceptions.h"
 #include "query.h"
 #include "policy.h"
+#include "tracer.h"
+#include "module_state.h"
 
 // Struct for Python User-Data for the Callback
 typedef struct {
 	as_error error;
 	PyObject * callback;
 	AerospikeClient * client;
+	// Records passed to the callback, for the span
+	uint32_t n_records;
 } LocalData;
 
 
@@ -56,8 +60,8 @@ static bool each_result(const as_val * val, void * udata)
 	PyObject * py_return = NULL;
 
 	// Lock Python State
-	PyGILState_STATE gstate;
-	gstate = PyGILState_Ensure();
+	aerospike_gil gil;
+	aerospike_gil_ensure(data->client->state->interp, &gil);
 
 	// Convert as_val to a Python Object
 	val_to_pyobject(data->client, err, val, &py_result);
@@ -66,9 +70,10 @@ static bool each_result(const as_val * val, void * udata)
 	if (!py_result) {
 		//TBD set error here
 		// Must release the interpreter lock before returning
-		PyGILState_Release(gstate);
+		aerospike_gil_release(&gil);
 		return true;
 	}
+	data->n_records++;
 	// Build Python Function Arguments
 	py_arglist = PyTuple_New(1);
 	PyTuple_SetItem(py_arglist, 0, py_result);
@@ -100,7 +105,7 @@ static bool each_result(const as_val * val, void * udata)
 	}
 
 	// Release Python State
-	PyGILState_Release(gstate);
+	aerospike_gil_release(&gil);
 
 	return rval;
 }
@@ -116,7 +121,6 @@ PyObject * AerospikeQuery_Foreach(AerospikeQuery * self, PyObject * args, PyObje
 
 	// Python Function Argument Parsing
 	if (PyArg_ParseTupleAndKeywords(args, kwds, "O|O:foreach", kwlist, &py_callback, &py_policy) == false) {
-		as_query_destroy(&self->query);
 		return NULL;
 	}
 
@@ -124,6 +128,7 @@ PyObject * AerospikeQuery_Foreach(AerospikeQuery * self, PyObject * args, PyObje
 	LocalData data;
 	data.callback = py_callback;
 	data.client = self->client;
+	data.n_records = 0;
 	as_error_init(&data.error);
 
 	// Aerospike Client Arguments
@@ -134,6 +139,9 @@ PyObject * AerospikeQuery_Foreach(AerospikeQuery * self, PyObject * args, PyObje
 	// Initialize error
 	as_error_init(&err);
 
+	trace_span span;
+	trace_start(self->client, &span, "query");
+
 	if (!self || !self->client->as) {
 		as_error_update(&err, AEROSPIKE_ERR_PARAM, "Invalid aerospike object");
 		goto CLEANUP;
@@ -155,7 +163,9 @@ PyObject * AerospikeQuery_Foreach(AerospikeQuery * self, PyObject * args, PyObje
 	PyThreadState * _save = PyEval_SaveThread();
 
 	// Invoke operation
+	trace_call_start(&span);
 	aerospike_query_foreach(self->client->as, &err, query_policy_p, &self->query, each_result, &data);
+	trace_call_end(&span);
 
 	// We are done using multiple threads
 	PyEval_RestoreThread(_save);
@@ -165,11 +175,10 @@ PyObject * AerospikeQuery_Foreach(AerospikeQuery * self, PyObject * args, PyObje
 	}
 
 CLEANUP:
-	if (self->query.apply.arglist) {
-		as_arraylist_destroy( (as_arraylist *) self->query.apply.arglist );
-	}
-	self->query.apply.arglist = NULL;
+	trace_end_set(self->client, &span, self->query.ns, self->query.set, data.n_records,
+			data.error.code != AEROSPIKE_OK ? data.error.code : err.code);
 
+	// The query, including its UDF arglist, is kept so it can be run again
 	if (err.code != AEROSPIKE_OK || data.error.code != AEROSPIKE_OK) {
 		PyObject * py_err = NULL;
 		PyObject *exception_type = NULL;
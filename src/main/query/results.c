@@ -28,6 +28,8 @@
 #include "exceptions.h"
 #include "query.h"
 #include "policy.h"
+#include "tracer.h"
+#include "module_state.h"
 
 #undef TRACE
 #define TRACE()
@@ -52,8 +54,8 @@ static bool each_result(const as_val * val, void * udata)
 
 	TRACE();
 
-	PyGILState_STATE gstate;
-	gstate = PyGILState_Ensure();
+	aerospike_gil gil;
+	aerospike_gil_ensure(data->client->state->interp, &gil);
 
 	TRACE();
 
@@ -71,7 +73,7 @@ static bool each_result(const as_val * val, void * udata)
 
 	TRACE();
 
-	PyGILState_Release(gstate);
+	aerospike_gil_release(&gil);
 
 	TRACE();
 	return true;
@@ -97,6 +99,9 @@ PyObject * AerospikeQuery_Results(AerospikeQuery * self, PyObject * args, PyObje
 	as_policy_query query_policy;
 	as_policy_query * query_policy_p = NULL;
 
+	trace_span span;
+	trace_start(self->client, &span, "query");
+
 	if (!self || !self->client->as) {
 		as_error_update(&err, AEROSPIKE_ERR_PARAM, "Invalid aerospike object");
 		goto CLEANUP;
@@ -122,13 +127,18 @@ PyObject * AerospikeQuery_Results(AerospikeQuery * self, PyObject * args, PyObje
 	PyThreadState * _save = PyEval_SaveThread();
 
 	TRACE();
+	trace_call_start(&span);
 	aerospike_query_foreach(self->client->as, &err, query_policy_p, &self->query, each_result, &data);
+	trace_call_end(&span);
 
 	TRACE();
 	PyEval_RestoreThread(_save);
 
 CLEANUP:/*??trace()*/
 	TRACE();
+	trace_end_set(self->client, &span, self->query.ns, self->query.set,
+			py_results ? (uint32_t) PyList_GET_SIZE(py_results) : 0, err.code);
+
 	if (err.code != AEROSPIKE_OK) {
 		PyObject * py_err = NULL;
 		error_to_pyobject(&err, &py_err);
@@ -141,10 +151,49 @@ CLEANUP:/*??trace()*/
 
 	TRACE();
 
-	if (self->query.apply.arglist) {
-		as_arraylist_destroy( (as_arraylist *) self->query.apply.arglist );
+	return py_results;
+}
+
+/**
+ *******************************************************************************************************
+ * Runs a prepared query again, optionally rebinding its predicate values
+ * first, and returns the list of results.
+ *
+ *		query.execute((min, max), policy)
+ *
+ * The bin selection, predicate and UDF of the query are kept between runs.
+ *******************************************************************************************************
+ */
+PyObject * AerospikeQuery_Execute(AerospikeQuery * self, PyObject * args, PyObject * kwds)
+{
+	PyObject * py_params = NULL;
+	PyObject * py_policy = NULL;
+	PyObject * py_args = NULL;
+	PyObject * py_results = NULL;
+
+	static char * kwlist[] = {"params", "policy", NULL};
+
+	if (PyArg_ParseTupleAndKeywords(args, kwds, "|OO:execute", kwlist, &py_params, &py_policy) == false) {
+		return NULL;
 	}
-	self->query.apply.arglist = NULL;
+
+	as_error err;
+	as_error_init(&err);
+
+	if (py_params && py_params != Py_None) {
+		if (AerospikeQuery_Where_Bind(self, &err, py_params) != AEROSPIKE_OK) {
+			PyObject * py_err = NULL;
+			error_to_pyobject(&err, &py_err);
+			PyObject *exception_type = raise_exception(&err);
+			PyErr_SetObject(exception_type, py_err);
+			Py_DECREF(py_err);
+			return NULL;
+		}
+	}
+
+	py_args = py_policy ? Py_BuildValue("(O)", py_policy) : PyTuple_New(0);
+	py_results = AerospikeQuery_Results(self, py_args, NULL);
+	Py_DECREF(py_args);
 
 	return py_results;
 }
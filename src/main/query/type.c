@@ -28,6 +28,7 @@
 #include "query.h"
 #include "conversions.h"
 #include "exceptions.h"
+#include "module_state.h"
 
 /*******************************************************************************
  * PYTHON TYPE METHODS
@@ -38,6 +39,9 @@ static PyMethodDef AerospikeQuery_Type_Methods[] = {
 	{"apply",	(PyCFunction) AerospikeQuery_Apply,		METH_VARARGS | METH_KEYWORDS,
 				"Apply a Stream UDF on the resultset of the query."},
 
+	{"execute",	(PyCFunction) AerospikeQuery_Execute,	METH_VARARGS | METH_KEYWORDS,
+				"Rebind the predicate values and run the query again."},
+
 	{"foreach",	(PyCFunction) AerospikeQuery_Foreach,	METH_VARARGS | METH_KEYWORDS,
 				"Iterate over each record in the resultset and call the callback function."},
 
@@ -62,6 +66,9 @@ static PyObject * AerospikeQuery_Type_New(PyTypeObject * type, PyObject * args,
 	AerospikeQuery * self = NULL;
 
 	self = (AerospikeQuery *) type->tp_alloc(type, 0);
+	if (self) {
+		unicode_objects_init(&self->u_objs, 0);
+	}
 
 	return (PyObject *) self;
 }
@@ -127,27 +134,43 @@ CLEANUP:
 
 static void AerospikeQuery_Type_Dealloc(AerospikeQuery * self)
 {
-	int i;
-	for (i=0; i < self->u_objs.size; i++) {
-		Py_XDECREF(self->u_objs.ob[i]);
-	}
+	unicode_objects_destroy(&self->u_objs);
 
-	for (i = 0; i < self->query.where.size; i++) {
-		as_predicate * p = &self->query.where.entries[i];
-		if (p) {
-			if (p->dtype == AS_INDEX_STRING) {
-				free(p->value.string);
-			}
-		}
-	}
+	AerospikeQuery_Where_Clear(self);
 
 	as_query_destroy(&self->query);
-	Py_TYPE(self)->tp_free((PyObject *) self);
+	PyTypeObject * type = Py_TYPE(self);
+	type->tp_free((PyObject *) self);
+	AS_TYPE_RELEASE(type);
 }
 
 /*******************************************************************************
  * PYTHON TYPE DESCRIPTOR
  ******************************************************************************/
+#ifdef AS_HEAP_TYPES
+
+static PyType_Slot AerospikeQuery_Type_Slots[] = {
+	{Py_tp_dealloc, (void *) AerospikeQuery_Type_Dealloc},
+	{Py_tp_doc, (void *)
+		"The Query class assists in populating the parameters of a query\n"
+		"operation. To create a new instance of the Query class, call the\n"
+		"query() method on an instance of a Client class.\n"},
+	{Py_tp_methods, (void *) AerospikeQuery_Type_Methods},
+	{Py_tp_init, (void *) AerospikeQuery_Type_Init},
+	{Py_tp_new, (void *) AerospikeQuery_Type_New},
+	{0, NULL}
+};
+
+static PyType_Spec AerospikeQuery_Type_Spec = {
+	"aerospike.Query",
+	sizeof(AerospikeQuery),
+	0,
+	Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+	AerospikeQuery_Type_Slots
+};
+
+#else
+
 static PyTypeObject AerospikeQuery_Type = {
 	PyVarObject_HEAD_INIT(NULL, 0)
 	"aerospike.Query",                  // tp_name
@@ -198,6 +221,8 @@ static PyTypeObject AerospikeQuery_Type = {
 	0                                   // tp_bases
 };
 
+#endif
+
 
 /*******************************************************************************
  * PUBLIC FUNCTIONS
@@ -205,15 +230,20 @@ static PyTypeObject AerospikeQuery_Type = {
 
 PyTypeObject * AerospikeQuery_Ready()
 {
+#ifdef AS_HEAP_TYPES
+	return (PyTypeObject *) PyType_FromSpec(&AerospikeQuery_Type_Spec);
+#else
 	return PyType_Ready(&AerospikeQuery_Type) == 0 ? &AerospikeQuery_Type : NULL;
+#endif
 }
 
 AerospikeQuery * AerospikeQuery_New(AerospikeClient * client, PyObject * args, PyObject * kwds)
 {
-	AerospikeQuery * self = (AerospikeQuery *) AerospikeQuery_Type.tp_new(&AerospikeQuery_Type, args, kwds);
+	PyTypeObject * type = client->state->query_type;
+	AerospikeQuery * self = (AerospikeQuery *) type->tp_new(type, args, kwds);
 	self->client = client;
 
-	if (AerospikeQuery_Type.tp_init((PyObject *) self, args, kwds) == 0) {
+	if (type->tp_init((PyObject *) self, args, kwds) == 0) {
 		Py_INCREF(client);
 		return self;
 	} else {
@@ -223,8 +253,5 @@ AerospikeQuery * AerospikeQuery_New(AerospikeClient * client, PyObject * args, P
 
 PyObject * StoreUnicodePyObject(AerospikeQuery * self, PyObject *obj)
 {
-	if (self->u_objs.size < MAX_UNICODE_OBJECTS) {
-		self->u_objs.ob[self->u_objs.size++] = obj;
-	}
-	return obj;
+	return unicode_objects_add(&self->u_objs, obj);
 }
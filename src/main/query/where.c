@@ -41,13 +41,53 @@ int64_t pyobject_to_int64(PyObject * py_obj)
 	}
 }
 
+static bool predicate_owns_string(as_predicate * p)
+{
+	return p->dtype == AS_INDEX_STRING || p->dtype == AS_INDEX_GEO2DSPHERE;
+}
+
+void AerospikeQuery_Where_Clear(AerospikeQuery * self)
+{
+	for (uint16_t i = 0; i < self->query.where.size; i++) {
+		as_predicate * p = &self->query.where.entries[i];
+		if (predicate_owns_string(p)) {
+			free(p->value.string);
+			p->value.string = NULL;
+		}
+	}
+	self->query.where.size = 0;
+}
+
+/**
+ * A later where() replaces the query's predicate rather than being ignored.
+ */
+static void AerospikeQuery_Where_Reset(AerospikeQuery * self)
+{
+	AerospikeQuery_Where_Clear(self);
+
+	// Only allocates on the first call, later calls reuse the entry
+	as_query_where_init(&self->query, 1);
+}
+
 static int AerospikeQuery_Where_Add(AerospikeQuery * self, as_predicate_type predicate, as_index_datatype in_datatype, 
 		PyObject * py_bin, PyObject * py_val1, PyObject * py_val2, int index_type)
 {
 	as_error err;
+	as_error_init(&err);
 	char * val = NULL, * bin = NULL;
 	PyObject * py_ubin = NULL;
 
+	// Checked before anything is allocated or the current predicate is reset
+	if (index_type < AS_INDEX_TYPE_DEFAULT || index_type > AS_INDEX_TYPE_MAPVALUES) {
+		as_error_update(&err, AEROSPIKE_ERR_PARAM, "index type %d is invalid", index_type);
+		PyObject * py_err = NULL;
+		error_to_pyobject(&err, &py_err);
+		PyObject *exception_type = raise_exception(&err);
+		PyErr_SetObject(exception_type, py_err);
+		Py_DECREF(py_err);
+		return 1;
+	}
+
 	switch (predicate) {
 		case AS_PREDICATE_EQUAL: {
 			if (in_datatype == AS_INDEX_STRING) {
@@ -72,7 +112,7 @@ static int AerospikeQuery_Where_Add(AerospikeQuery * self, as_predicate_type pre
 					return 1;
 				}
 
-				as_query_where_init(&self->query, 1);
+				AerospikeQuery_Where_Reset(self);
 				if (index_type == 0) {
 					as_query_where(&self->query, bin, as_equals( STRING, val ));
 				} else if (index_type == 1) {
@@ -82,6 +122,8 @@ static int AerospikeQuery_Where_Add(AerospikeQuery * self, as_predicate_type pre
 				} else if (index_type == 3) {
 					as_query_where(&self->query, bin, as_contains( MAPVALUES, STRING, val ));
 				} else {
+					free(val);
+					Py_XDECREF(py_ubin);
 					return 1;
 				}
 				if (py_ubin){
@@ -101,7 +143,7 @@ static int AerospikeQuery_Where_Add(AerospikeQuery * self, as_predicate_type pre
 				}
 				int64_t val = pyobject_to_int64(py_val1);
 
-				as_query_where_init(&self->query, 1);
+				AerospikeQuery_Where_Reset(self);
 				if (index_type == 0) {
 					as_query_where(&self->query, bin, as_equals( NUMERIC, val ));
 				} else if (index_type == 1) {
@@ -111,6 +153,7 @@ static int AerospikeQuery_Where_Add(AerospikeQuery * self, as_predicate_type pre
 				} else if (index_type == 3) {
 					as_query_where(&self->query, bin, as_contains( MAPVALUES, NUMERIC, val ));
 				} else {
+					Py_XDECREF(py_ubin);
 					return 1;
 				}
 				if (py_ubin){
@@ -143,7 +186,7 @@ static int AerospikeQuery_Where_Add(AerospikeQuery * self, as_predicate_type pre
 				int64_t min = pyobject_to_int64(py_val1);
 				int64_t max = pyobject_to_int64(py_val2);
 
-				as_query_where_init(&self->query, 1);
+				AerospikeQuery_Where_Reset(self);
 				if (index_type == 0) {
 					as_query_where(&self->query, bin, as_range( DEFAULT, NUMERIC, min, max ));
 				} else if (index_type == 1) {
@@ -153,6 +196,7 @@ static int AerospikeQuery_Where_Add(AerospikeQuery * self, as_predicate_type pre
 				} else if (index_type == 3) {
 					as_query_where(&self->query, bin, as_range( MAPVALUES, NUMERIC, min, max ));
 				} else {
+					Py_XDECREF(py_ubin);
 					return 1;
 				}
 				if (py_ubin) {
@@ -192,7 +236,7 @@ static int AerospikeQuery_Where_Add(AerospikeQuery * self, as_predicate_type pre
 					return 1;
 				}
 
-				as_query_where_init(&self->query, 1);
+				AerospikeQuery_Where_Reset(self);
 				as_query_where(&self->query, bin, AS_PREDICATE_RANGE, index_type, in_datatype, val);
 
 				if (py_ubin) {
@@ -413,7 +457,6 @@ AerospikeQuery * AerospikeQuery_Where(AerospikeQuery * self, PyObject * args)
 		PyObject *exception_type = raise_exception(&err);
 		PyErr_SetObject(exception_type, py_err);
 		Py_DECREF(py_err);
-		as_query_destroy(&self->query);
 		rc = 1;
 	}
 CLEANUP:
@@ -434,3 +477,75 @@ CLEANUP:
 	Py_INCREF(self);
 	return self;
 }
+
+/**
+ *******************************************************************************************************
+ * Rebinds the values of the query's predicate in place, keeping its bin,
+ * predicate type and index type.
+ *
+ * @param self                  AerospikeQuery object
+ * @param err                   as_error to be populated on failure
+ * @param py_params             A list or tuple of values. One value for an
+ *                              equals, contains or geo predicate, a
+ *                              (min, max) pair for a range.
+ *
+ * Returns the error code.
+ *******************************************************************************************************
+ */
+as_status AerospikeQuery_Where_Bind(AerospikeQuery * self, as_error * err, PyObject * py_params)
+{
+	PyObject * py_values = NULL;
+
+	if (self->query.where.size == 0) {
+		return as_error_update(err, AEROSPIKE_ERR_PARAM, "Query has no predicate to bind");
+	}
+
+	if (!PyList_Check(py_params) && !PyTuple_Check(py_params)) {
+		return as_error_update(err, AEROSPIKE_ERR_PARAM, "Params should be a list or tuple");
+	}
+
+	py_values = PySequence_Fast(py_params, "Params should be a list or tuple");
+	Py_ssize_t size = PySequence_Fast_GET_SIZE(py_values);
+	PyObject ** py_items = PySequence_Fast_ITEMS(py_values);
+	as_predicate * p = &self->query.where.entries[0];
+
+	if (p->type == AS_PREDICATE_RANGE && p->dtype == AS_INDEX_NUMERIC) {
+		if (size != 2 || !(PyInt_Check(py_items[0]) || PyLong_Check(py_items[0])) ||
+				!(PyInt_Check(py_items[1]) || PyLong_Check(py_items[1]))) {
+			as_error_update(err, AEROSPIKE_ERR_PARAM, "Range predicate expects two integer params");
+			goto CLEANUP;
+		}
+		p->value.integer_range.min = pyobject_to_int64(py_items[0]);
+		p->value.integer_range.max = pyobject_to_int64(py_items[1]);
+	} else if (p->dtype == AS_INDEX_NUMERIC) {
+		if (size != 1 || !(PyInt_Check(py_items[0]) || PyLong_Check(py_items[0]))) {
+			as_error_update(err, AEROSPIKE_ERR_PARAM, "Predicate expects one integer param");
+			goto CLEANUP;
+		}
+		p->value.integer = pyobject_to_int64(py_items[0]);
+	} else if (predicate_owns_string(p)) {
+		char * val = NULL;
+		if (size != 1) {
+			as_error_update(err, AEROSPIKE_ERR_PARAM, "Predicate expects one string param");
+			goto CLEANUP;
+		}
+		if (PyUnicode_Check(py_items[0])) {
+			PyObject * py_uval = PyUnicode_AsUTF8String(py_items[0]);
+			val = strdup(PyBytes_AsString(py_uval));
+			Py_DECREF(py_uval);
+		} else if (PyString_Check(py_items[0])) {
+			val = strdup(PyString_AsString(py_items[0]));
+		} else {
+			as_error_update(err, AEROSPIKE_ERR_PARAM, "Predicate expects one string param");
+			goto CLEANUP;
+		}
+		free(p->value.string);
+		p->value.string = val;
+	} else {
+		as_error_update(err, AEROSPIKE_ERR_PARAM, "Predicate values cannot be rebound");
+	}
+
+CLEANUP:
+	Py_DECREF(py_values);
+	return err->code;
+}
@@ -0,0 +1,684 @@
+/*******************************************************************************
+ * Copyright 2013-2016 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include <Python.h>
+#include <inttypes.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+
+#include <aerospike/aerospike_scan.h>
+#include <aerospike/as_boolean.h>
+#include <aerospike/as_bytes.h>
+#include <aerospike/as_double.h>
+#include <aerospike/as_error.h>
+#include <aerospike/as_geojson.h>
+#include <aerospike/as_hashmap.h>
+#include <aerospike/as_integer.h>
+#include <aerospike/as_list.h>
+#include <aerospike/as_map.h>
+#include <aerospike/as_msgpack.h>
+#include <aerospike/as_nil.h>
+#include <aerospike/as_record.h>
+#include <aerospike/as_record_iterator.h>
+#include <aerospike/as_scan.h>
+#include <aerospike/as_serializer.h>
+#include <aerospike/as_string.h>
+#include <citrusleaf/cf_b64.h>
+
+#include "client.h"
+#include "conversions.h"
+#include "exceptions.h"
+#include "policy.h"
+#include "scan.h"
+#include "tracer.h"
+
+#define EXPORT_FORMAT_NDJSON 0
+#define EXPORT_FORMAT_MSGPACK 1
+#define EXPORT_BUFFER_SIZE 4096
+// Records a scan thread serializes before compressing and writing them
+#define EXPORT_CHUNK_SIZE (256 * 1024)
+
+// A growable byte buffer
+typedef struct {
+	char * data;
+	size_t size;
+	size_t capacity;
+	bool failed;
+} export_buffer;
+
+// Records serialized by one scan thread and not yet written
+typedef struct export_chunk_s {
+	export_buffer buf;
+	uint64_t records;
+	// Gzip output, reused for each write
+	export_buffer packed;
+	struct export_chunk_s * next;
+} export_chunk;
+
+// Shared state of an export, used from the C client's scan threads
+typedef struct {
+	// Tells this export's chunks from those of earlier exports
+	uint64_t id;
+	int format;
+	bool compress;
+	FILE * file;
+	// Guards everything below
+	pthread_mutex_t lock;
+	export_chunk * chunks;
+	uint64_t records;
+	uint64_t bytes;
+	as_error error;
+} export_state;
+
+// The chunk of the export the scan thread last wrote for
+static __thread export_chunk * export_thread_chunk = NULL;
+static __thread uint64_t export_thread_id = 0;
+// Only changed with the GIL held
+static uint64_t export_count = 0;
+
+static void buffer_append(export_buffer * buf, const char * data, size_t size)
+{
+	if (buf->failed) {
+		return;
+	}
+	if (buf->size + size > buf->capacity) {
+		size_t capacity = buf->capacity ? buf->capacity : EXPORT_BUFFER_SIZE;
+		while (buf->size + size > capacity) {
+			capacity *= 2;
+		}
+		char * data_p = (char *) realloc(buf->data, capacity);
+		if (!data_p) {
+			buf->failed = true;
+			return;
+		}
+		buf->data = data_p;
+		buf->capacity = capacity;
+	}
+	memcpy(buf->data + buf->size, data, size);
+	buf->size += size;
+}
+
+static void buffer_append_str(export_buffer * buf, const char * str)
+{
+	buffer_append(buf, str, strlen(str));
+}
+
+/*******************************************************************************
+ * NDJSON
+ ******************************************************************************/
+
+static void json_append_string(export_buffer * buf, const char * str, size_t len)
+{
+	static const char hex[] = "0123456789abcdef";
+	char escape[7];
+
+	buffer_append(buf, "\"", 1);
+	for (size_t i = 0; i < len; i++) {
+		unsigned char c = (unsigned char) str[i];
+		switch (c) {
+			case '"':  buffer_append(buf, "\\\"", 2); break;
+			case '\\': buffer_append(buf, "\\\\", 2); break;
+			case '\n': buffer_append(buf, "\\n", 2); break;
+			case '\r': buffer_append(buf, "\\r", 2); break;
+			case '\t': buffer_append(buf, "\\t", 2); break;
+			default:
+				if (c < 0x20) {
+					snprintf(escape, sizeof(escape), "\\u00%c%c", hex[c >> 4], hex[c & 0xf]);
+					buffer_append(buf, escape, 6);
+				} else {
+					buffer_append(buf, (const char *) &c, 1);
+				}
+		}
+	}
+	buffer_append(buf, "\"", 1);
+}
+
+static void json_append_val(export_buffer * buf, const as_val * val);
+
+typedef struct {
+	export_buffer * buf;
+	bool first;
+} json_iterate_udata;
+
+static bool json_append_list_entry(as_val * val, void * udata)
+{
+	json_iterate_udata * iter = (json_iterate_udata *) udata;
+	if (!iter->first) {
+		buffer_append(iter->buf, ",", 1);
+	}
+	iter->first = false;
+	json_append_val(iter->buf, val);
+	return true;
+}
+
+static bool json_append_map_entry(const as_val * key, const as_val * val, void * udata)
+{
+	json_iterate_udata * iter = (json_iterate_udata *) udata;
+	if (!iter->first) {
+		buffer_append(iter->buf, ",", 1);
+	}
+	iter->first = false;
+
+	// JSON keys are strings, other keys are written as their JSON text
+	as_string * key_str = as_string_fromval(key);
+	if (key_str) {
+		json_append_string(iter->buf, as_string_get(key_str), as_string_len(key_str));
+	} else {
+		export_buffer key_buf = {NULL, 0, 0, false};
+		json_append_val(&key_buf, key);
+		json_append_string(iter->buf, key_buf.data ? key_buf.data : "", key_buf.size);
+		iter->buf->failed |= key_buf.failed;
+		free(key_buf.data);
+	}
+	buffer_append(iter->buf, ":", 1);
+	json_append_val(iter->buf, val);
+	return true;
+}
+
+static void json_append_val(export_buffer * buf, const as_val * val)
+{
+	char number[32];
+
+	switch (as_val_type(val)) {
+		case AS_INTEGER: {
+			snprintf(number, sizeof(number), "%" PRId64, as_integer_get(as_integer_fromval(val)));
+			buffer_append_str(buf, number);
+			break;
+		}
+		case AS_DOUBLE: {
+			double d = as_double_get(as_double_fromval(val));
+			if (isfinite(d)) {
+				// Shortest digits that read back as d, with a '.0' as repr()
+				// adds so that 3.0 does not come back as an int
+				for (int precision = 15; precision <= 17; precision++) {
+					snprintf(number, sizeof(number), "%.*g", precision, d);
+					if (strtod(number, NULL) == d) {
+						break;
+					}
+				}
+				if (!strpbrk(number, ".e")) {
+					strcat(number, ".0");
+				}
+				buffer_append_str(buf, number);
+			} else {
+				buffer_append_str(buf, "null");
+			}
+			break;
+		}
+		case AS_STRING: {
+			as_string * str = as_string_fromval(val);
+			json_append_string(buf, as_string_get(str), as_string_len(str));
+			break;
+		}
+		case AS_GEOJSON: {
+			// Already JSON text
+			buffer_append_str(buf, as_geojson_get(as_geojson_fromval(val)));
+			break;
+		}
+		case AS_BOOLEAN: {
+			buffer_append_str(buf, as_boolean_get(as_boolean_fromval(val)) ? "true" : "false");
+			break;
+		}
+		case AS_BYTES: {
+			as_bytes * bytes = as_bytes_fromval(val);
+			uint32_t encoded_len = cf_b64_encoded_len(bytes->size);
+			char * encoded = (char *) malloc(encoded_len + 1);
+			if (!encoded) {
+				buf->failed = true;
+				break;
+			}
+			cf_b64_encode(bytes->value, bytes->size, encoded);
+			encoded[encoded_len] = '\0';
+			snprintf(number, sizeof(number), "%d", (int) bytes->type);
+			buffer_append_str(buf, "{\"$bytes\":\"");
+			buffer_append(buf, encoded, encoded_len);
+			buffer_append_str(buf, "\",\"type\":");
+			buffer_append_str(buf, number);
+			buffer_append_str(buf, "}");
+			free(encoded);
+			break;
+		}
+		case AS_LIST: {
+			json_iterate_udata iter = {buf, true};
+			buffer_append(buf, "[", 1);
+			as_list_foreach(as_list_fromval((as_val *) val), json_append_list_entry, &iter);
+			buffer_append(buf, "]", 1);
+			break;
+		}
+		case AS_MAP: {
+			json_iterate_udata iter = {buf, true};
+			buffer_append(buf, "{", 1);
+			as_map_foreach(as_map_fromval(val), json_append_map_entry, &iter);
+			buffer_append(buf, "}", 1);
+			break;
+		}
+		default:
+			buffer_append_str(buf, "null");
+	}
+}
+
+static void json_append_record(export_buffer * buf, as_record * rec)
+{
+	char number[32];
+	char digest[AS_DIGEST_VALUE_SIZE * 2 + 1];
+
+	buffer_append_str(buf, "{\"key\":{\"ns\":");
+	json_append_string(buf, rec->key.ns, strlen(rec->key.ns));
+	buffer_append_str(buf, ",\"set\":");
+	json_append_string(buf, rec->key.set, strlen(rec->key.set));
+	buffer_append_str(buf, ",\"key\":");
+	if (rec->key.valuep) {
+		json_append_val(buf, (as_val *) rec->key.valuep);
+	} else {
+		buffer_append_str(buf, "null");
+	}
+	for (int i = 0; i < AS_DIGEST_VALUE_SIZE; i++) {
+		snprintf(digest + i * 2, 3, "%02x", rec->key.digest.value[i]);
+	}
+	buffer_append_str(buf, ",\"digest\":\"");
+	buffer_append(buf, digest, AS_DIGEST_VALUE_SIZE * 2);
+
+	snprintf(number, sizeof(number), "%u", rec->gen);
+	buffer_append_str(buf, "\"},\"gen\":");
+	buffer_append_str(buf, number);
+	snprintf(number, sizeof(number), "%u", rec->ttl);
+	buffer_append_str(buf, ",\"ttl\":");
+	buffer_append_str(buf, number);
+
+	buffer_append_str(buf, ",\"bins\":{");
+	as_record_iterator it;
+	as_record_iterator_init(&it, rec);
+	bool first = true;
+	while (as_record_iterator_has_next(&it)) {
+		as_bin * bin = as_record_iterator_next(&it);
+		if (!first) {
+			buffer_append(buf, ",", 1);
+		}
+		first = false;
+		json_append_string(buf, as_bin_get_name(bin), strlen(as_bin_get_name(bin)));
+		buffer_append(buf, ":", 1);
+		as_val * bin_val = (as_val *) as_bin_get_value(bin);
+		if (bin_val) {
+			json_append_val(buf, bin_val);
+		} else {
+			buffer_append_str(buf, "null");
+		}
+	}
+	as_record_iterator_destroy(&it);
+	buffer_append_str(buf, "}}\n");
+}
+
+/*******************************************************************************
+ * MSGPACK
+ ******************************************************************************/
+
+static void msgpack_map_set_val(as_hashmap * map, const char * name, as_val * val)
+{
+	as_hashmap_set(map, (as_val *) as_string_new_strdup(name), val);
+}
+
+/**
+ * Writes {"key": {"ns", "set", "key", "digest"}, "gen", "ttl", "bins"} as one
+ * msgpack map. Record values are reserved rather than copied.
+ */
+static void msgpack_append_record(export_buffer * buf, as_record * rec)
+{
+	as_hashmap key_map;
+	as_hashmap_init(&key_map, 4);
+	msgpack_map_set_val(&key_map, "ns", (as_val *) as_string_new_strdup(rec->key.ns));
+	msgpack_map_set_val(&key_map, "set", (as_val *) as_string_new_strdup(rec->key.set));
+	if (rec->key.valuep) {
+		as_val_reserve((as_val *) rec->key.valuep);
+		msgpack_map_set_val(&key_map, "key", (as_val *) rec->key.valuep);
+	} else {
+		msgpack_map_set_val(&key_map, "key", as_val_reserve(&as_nil));
+	}
+	msgpack_map_set_val(&key_map, "digest",
+			(as_val *) as_bytes_new_wrap(rec->key.digest.value, AS_DIGEST_VALUE_SIZE, false));
+
+	as_hashmap bins;
+	as_hashmap_init(&bins, rec->bins.size ? rec->bins.size : 1);
+	as_record_iterator it;
+	as_record_iterator_init(&it, rec);
+	while (as_record_iterator_has_next(&it)) {
+		as_bin * bin = as_record_iterator_next(&it);
+		as_val * bin_val = (as_val *) as_bin_get_value(bin);
+		if (bin_val) {
+			as_val_reserve(bin_val);
+		} else {
+			bin_val = as_val_reserve(&as_nil);
+		}
+		msgpack_map_set_val(&bins, as_bin_get_name(bin), bin_val);
+	}
+	as_record_iterator_destroy(&it);
+
+	as_hashmap top;
+	as_hashmap_init(&top, 4);
+	as_val_reserve((as_val *) &key_map);
+	msgpack_map_set_val(&top, "key", (as_val *) &key_map);
+	msgpack_map_set_val(&top, "gen", (as_val *) as_integer_new(rec->gen));
+	msgpack_map_set_val(&top, "ttl", (as_val *) as_integer_new(rec->ttl));
+	as_val_reserve((as_val *) &bins);
+	msgpack_map_set_val(&top, "bins", (as_val *) &bins);
+
+	as_serializer ser;
+	as_buffer packed;
+	as_buffer_init(&packed);
+	as_msgpack_init(&ser);
+	if (as_serializer_serialize(&ser, (as_val *) &top, &packed) == 0) {
+		buffer_append(buf, (const char *) packed.data, packed.size);
+	} else {
+		buf->failed = true;
+	}
+	as_serializer_destroy(&ser);
+	as_buffer_destroy(&packed);
+
+	as_hashmap_destroy(&top);
+	as_hashmap_destroy(&bins);
+	as_hashmap_destroy(&key_map);
+}
+
+/*******************************************************************************
+ * SCAN CALLBACK
+ ******************************************************************************/
+
+/**
+ * Compresses in into out as one complete gzip member. A file of members
+ * written back to back reads as a single gzip stream.
+ */
+static bool export_gzip(const export_buffer * in, export_buffer * out)
+{
+	z_stream stream;
+	memset(&stream, 0, sizeof(stream));
+	// 16 over the window bits asks for a gzip header and trailer
+	if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8,
+				Z_DEFAULT_STRATEGY) != Z_OK) {
+		return false;
+	}
+
+	out->size = 0;
+	size_t bound = deflateBound(&stream, (uLong) in->size);
+	if (bound > out->capacity) {
+		char * data_p = (char *) realloc(out->data, bound);
+		if (!data_p) {
+			deflateEnd(&stream);
+			return false;
+		}
+		out->data = data_p;
+		out->capacity = bound;
+	}
+
+	stream.next_in = (Bytef *) in->data;
+	stream.avail_in = (uInt) in->size;
+	stream.next_out = (Bytef *) out->data;
+	stream.avail_out = (uInt) out->capacity;
+	bool rval = deflate(&stream, Z_FINISH) == Z_STREAM_END;
+	out->size = stream.total_out;
+	deflateEnd(&stream);
+	return rval;
+}
+
+/**
+ * Compresses the chunk's records without the lock, then appends them to the
+ * file with a single locked write and empties the chunk.
+ */
+static bool export_chunk_write(export_state * state, export_chunk * chunk)
+{
+	if (!chunk->buf.size) {
+		return true;
+	}
+
+	const export_buffer * out = &chunk->buf;
+	bool packed = true;
+	if (state->compress) {
+		packed = export_gzip(&chunk->buf, &chunk->packed);
+		out = &chunk->packed;
+	}
+
+	bool rval = true;
+	pthread_mutex_lock(&state->lock);
+	if (state->error.code != AEROSPIKE_OK) {
+		rval = false;
+	} else if (!packed) {
+		as_error_update(&state->error, AEROSPIKE_ERR_CLIENT, "Failed to compress export");
+		rval = false;
+	} else if (fwrite(out->data, 1, out->size, state->file) != out->size) {
+		as_error_update(&state->error, AEROSPIKE_ERR_CLIENT, "Failed to write to export file");
+		rval = false;
+	} else {
+		state->records += chunk->records;
+		state->bytes += out->size;
+	}
+	pthread_mutex_unlock(&state->lock);
+
+	chunk->buf.size = 0;
+	chunk->records = 0;
+	return rval;
+}
+
+// The calling thread's chunk, created on its first record of the export
+static export_chunk * export_chunk_get(export_state * state)
+{
+	if (export_thread_id == state->id) {
+		return export_thread_chunk;
+	}
+
+	export_chunk * chunk = (export_chunk *) calloc(1, sizeof(export_chunk));
+	if (!chunk) {
+		return NULL;
+	}
+
+	pthread_mutex_lock(&state->lock);
+	chunk->next = state->chunks;
+	state->chunks = chunk;
+	pthread_mutex_unlock(&state->lock);
+
+	export_thread_chunk = chunk;
+	export_thread_id = state->id;
+	return chunk;
+}
+
+/**
+ * Runs on the C client's scan threads without the GIL. Each thread
+ * serializes records into its own chunk and only takes the lock to write
+ * a full one, so threads neither wait on each other to format or compress
+ * nor interleave records.
+ */
+static bool export_each(const as_val * val, void * udata)
+{
+	export_state * state = (export_state *) udata;
+
+	if (!val) {
+		return false;
+	}
+
+	as_record * rec = as_record_fromval(val);
+	if (!rec) {
+		return true;
+	}
+
+	export_chunk * chunk = export_chunk_get(state);
+	if (chunk) {
+		if (state->format == EXPORT_FORMAT_NDJSON) {
+			json_append_record(&chunk->buf, rec);
+		} else {
+			msgpack_append_record(&chunk->buf, rec);
+		}
+	}
+
+	if (!chunk || chunk->buf.failed) {
+		pthread_mutex_lock(&state->lock);
+		as_error_update(&state->error, AEROSPIKE_ERR_CLIENT, "Failed to serialize record");
+		pthread_mutex_unlock(&state->lock);
+		return false;
+	}
+
+	chunk->records++;
+	if (chunk->buf.size >= EXPORT_CHUNK_SIZE) {
+		return export_chunk_write(state, chunk);
+	}
+	return true;
+}
+
+/**
+ *******************************************************************************************************
+ * Scans the records and writes them straight to a file, without creating
+ * Python objects. The GIL is released for the whole scan.
+ *
+ *		scan.export(path, format='ndjson', compress=False, policy)
+ *
+ * Returns a dict with the number of records and bytes written to the file.
+ * In case of error,appropriate exceptions will be raised.
+ *******************************************************************************************************
+ */
+PyObject * AerospikeScan_Export(AerospikeScan * self, PyObject * args, PyObject * kwds)
+{
+	PyObject * py_path = NULL;
+	PyObject * py_ustr = NULL;
+	PyObject * py_compress = NULL;
+	PyObject * py_policy = NULL;
+	char * format = "ndjson";
+	char * path = NULL;
+	int compress = 0;
+	as_policy_scan scan_policy;
+	as_policy_scan * scan_policy_p = NULL;
+	export_state state;
+
+	static char * kwlist[] = {"path", "format", "compress", "policy", NULL};
+
+	if (PyArg_ParseTupleAndKeywords(args, kwds, "O|sOO:export", kwlist,
+				&py_path, &format, &py_compress, &py_policy) == false) {
+		return NULL;
+	}
+
+	compress = py_compress ? PyObject_IsTrue(py_compress) : 0;
+	if (compress == -1) {
+		return NULL;
+	}
+
+	memset(&state, 0, sizeof(state));
+	as_error_init(&state.error);
+
+	as_error err;
+	as_error_init(&err);
+
+	trace_span span;
+	trace_start(self->client, &span, "scan_export");
+
+	if (!self || !self->client->as) {
+		as_error_update(&err, AEROSPIKE_ERR_PARAM, "Invalid aerospike object");
+		goto CLEANUP;
+	}
+	if (!self->client->is_conn_16) {
+		as_error_update(&err, AEROSPIKE_ERR_CLUSTER, "No connection to aerospike cluster");
+		goto CLEANUP;
+	}
+
+	if (PyUnicode_Check(py_path)) {
+		py_ustr = PyUnicode_AsUTF8String(py_path);
+		path = PyBytes_AsString(py_ustr);
+	} else if (PyString_Check(py_path)) {
+		path = PyString_AsString(py_path);
+	} else {
+		as_error_update(&err, AEROSPIKE_ERR_PARAM, "Path should be a string");
+		goto CLEANUP;
+	}
+
+	if (!strcmp(format, "ndjson")) {
+		state.format = EXPORT_FORMAT_NDJSON;
+	} else if (!strcmp(format, "msgpack")) {
+		state.format = EXPORT_FORMAT_MSGPACK;
+	} else {
+		as_error_update(&err, AEROSPIKE_ERR_PARAM, "Format should be 'ndjson' or 'msgpack'");
+		goto CLEANUP;
+	}
+
+	state.compress = compress;
+
+	pyobject_to_policy_scan(&err, py_policy, &scan_policy, &scan_policy_p,
+			&self->client->as->config.policies.scan);
+	if (err.code != AEROSPIKE_OK) {
+		goto CLEANUP;
+	}
+
+	state.file = fopen(path, "wb");
+	if (!state.file) {
+		as_error_update(&err, AEROSPIKE_ERR_CLIENT, "Unable to open %s for writing", path);
+		goto CLEANUP;
+	}
+
+	pthread_mutex_init(&state.lock, NULL);
+	state.id = ++export_count;
+
+	Py_BEGIN_ALLOW_THREADS
+	trace_call_start(&span);
+	aerospike_scan_foreach(self->client->as, &err, scan_policy_p, &self->scan, export_each, &state);
+
+	// The scan threads are done, write what each one has left
+	while (state.chunks) {
+		export_chunk * chunk = state.chunks;
+		state.chunks = chunk->next;
+		if (err.code == AEROSPIKE_OK) {
+			export_chunk_write(&state, chunk);
+		}
+		free(chunk->buf.data);
+		free(chunk->packed.data);
+		free(chunk);
+	}
+
+	if (fclose(state.file) != 0 && err.code == AEROSPIKE_OK) {
+		as_error_update(&err, AEROSPIKE_ERR_CLIENT, "Failed to close export file");
+	}
+	trace_call_end(&span);
+	Py_END_ALLOW_THREADS
+
+	pthread_mutex_destroy(&state.lock);
+
+	// An error from the writer stops the scan, so it explains err
+	if (state.error.code != AEROSPIKE_OK) {
+		as_error_copy(&err, &state.error);
+	}
+
+CLEANUP:
+	trace_end_set(self->client, &span, self->scan.ns, self->scan.set, (uint32_t) state.records, err.code);
+
+	if (py_ustr) {
+		Py_DECREF(py_ustr);
+	}
+
+	if (err.code != AEROSPIKE_OK) {
+		PyObject * py_err = NULL;
+		error_to_pyobject(&err, &py_err);
+		PyObject *exception_type = raise_exception(&err);
+		PyErr_SetObject(exception_type, py_err);
+		Py_DECREF(py_err);
+		return NULL;
+	}
+
+	PyObject * py_stats = PyDict_New();
+	PyObject * py_value = PyLong_FromUnsignedLongLong(state.records);
+	PyDict_SetItemString(py_stats, "records", py_value);
+	Py_DECREF(py_value);
+	py_value = PyLong_FromUnsignedLongLong(state.bytes);
+	PyDict_SetItemString(py_stats, "bytes", py_value);
+	Py_DECREF(py_value);
+	return py_stats;
+}
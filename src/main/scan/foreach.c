@@ -26,12 +26,16 @@
 #include "exceptions.h"
 #include "scan.h"
 #include "policy.h"
+#include "tracer.h"
+#include "module_state.h"
 
 // Struct for Python User-Data for the Callback
 typedef struct {
 	as_error error;
 	PyObject * callback;
 	AerospikeClient * client;
+	// Records passed to the callback, for the span
+	uint32_t n_records;
 } LocalData;
 
 
@@ -54,16 +58,17 @@ static bool each_result(const as_val * val, void * udata)
 	PyObject * py_return = NULL;
 
 	// Lock Python State
-	PyGILState_STATE gstate;
-	gstate = PyGILState_Ensure();
+	aerospike_gil gil;
+	aerospike_gil_ensure(data->client->state->interp, &gil);
 
 	// Convert as_val to a Python Object
 	val_to_pyobject(data->client, err, val, &py_result);
 
 	if (!py_result) {
-		PyGILState_Release(gstate);
+		aerospike_gil_release(&gil);
 		return true;
 	}
+	data->n_records++;
 	// Build Python Function Arguments
 	py_arglist = PyTuple_New(1);
 	PyTuple_SetItem(py_arglist, 0, py_result);
@@ -96,7 +101,7 @@ static bool each_result(const as_val * val, void * udata)
 	}
 
 	// Release Python State
-	PyGILState_Release(gstate);
+	aerospike_gil_release(&gil);
 
 	return rval;
 }
@@ -107,14 +112,15 @@ PyObject * AerospikeScan_Foreach(AerospikeScan * self, PyObject * args, PyObject
 	PyObject * py_callback = NULL;
 	PyObject * py_policy = NULL;
 	PyObject * py_options = NULL;
+	char * nodename = NULL;
 	as_policy_scan scan_policy;
 	as_policy_scan * scan_policy_p = NULL;
 
 	// Python Function Keyword Arguments
-	static char * kwlist[] = {"callback", "policy", "options", NULL};
+	static char * kwlist[] = {"callback", "policy", "options", "nodename", NULL};
 
 	// Python Function Argument Parsing
-	if (PyArg_ParseTupleAndKeywords(args, kwds, "O|OO:foreach", kwlist, &py_callback, &py_policy, &py_options) == false) {
+	if (PyArg_ParseTupleAndKeywords(args, kwds, "O|OOz:foreach", kwlist, &py_callback, &py_policy, &py_options, &nodename) == false) {
 		return NULL;
 	}
 
@@ -122,6 +128,7 @@ PyObject * AerospikeScan_Foreach(AerospikeScan * self, PyObject * args, PyObject
 	LocalData data;
 	data.callback = py_callback;
 	data.client = self->client;
+	data.n_records = 0;
 	as_error_init(&data.error);
 
 	// Aerospike Client Arguments
@@ -130,6 +137,9 @@ PyObject * AerospikeScan_Foreach(AerospikeScan * self, PyObject * args, PyObject
 	// Initialize error
 	as_error_init(&err);
 
+	trace_span span;
+	trace_start(self->client, &span, "scan");
+
 	if (!self || !self->client->as) {
 		as_error_update(&err, AEROSPIKE_ERR_PARAM, "Invalid aerospike object");
 		goto CLEANUP;
@@ -157,7 +167,13 @@ PyObject * AerospikeScan_Foreach(AerospikeScan * self, PyObject * args, PyObject
 	PyThreadState * _save = PyEval_SaveThread();
 
 	// Invoke operation
-	aerospike_scan_foreach(self->client->as, &err, scan_policy_p, &self->scan, each_result, &data);
+	trace_call_start(&span);
+	if (nodename) {
+		aerospike_scan_node(self->client->as, &err, scan_policy_p, &self->scan, nodename, each_result, &data);
+	} else {
+		aerospike_scan_foreach(self->client->as, &err, scan_policy_p, &self->scan, each_result, &data);
+	}
+	trace_call_end(&span);
 
 	// We are done using multiple threads
 	PyEval_RestoreThread(_save);
@@ -167,6 +183,8 @@ PyObject * AerospikeScan_Foreach(AerospikeScan * self, PyObject * args, PyObject
 	}
 
 CLEANUP:
+	trace_end_set(self->client, &span, self->scan.ns, self->scan.set, data.n_records,
+			data.error.code != AEROSPIKE_OK ? data.error.code : err.code);
 
 	if (err.code != AEROSPIKE_OK || data.error.code != AEROSPIKE_OK) {
 		PyObject * py_err = NULL, *exception_type = NULL;
@@ -27,6 +27,8 @@
 #include "exceptions.h"
 #include "policy.h"
 #include "scan.h"
+#include "tracer.h"
+#include "module_state.h"
 
 #undef TRACE
 #define TRACE()
@@ -49,8 +51,8 @@ static bool each_result(const as_val * val, void * udata)
 
 	as_error err;
 
-	PyGILState_STATE gstate;
-	gstate = PyGILState_Ensure();
+	aerospike_gil gil;
+	aerospike_gil_ensure(data->client->state->interp, &gil);
 
 	val_to_pyobject(data->client, &err, val, &py_result);
 
@@ -59,7 +61,7 @@ static bool each_result(const as_val * val, void * udata)
 		Py_DECREF(py_result);
 	}
 
-	PyGILState_Release(gstate);
+	aerospike_gil_release(&gil);
 
 	return true;
 }
@@ -68,20 +70,24 @@ PyObject * AerospikeScan_Results(AerospikeScan * self, PyObject * args, PyObject
 {
 	PyObject * py_policy = NULL;
 	PyObject * py_results = NULL;
+	char * nodename = NULL;
 	as_policy_scan scan_policy;
 	as_policy_scan * scan_policy_p = NULL;
 
 	LocalData data;
 	data.client = self->client;
-	static char * kwlist[] = {"policy", NULL};
+	static char * kwlist[] = {"policy", "nodename", NULL};
 
-	if (PyArg_ParseTupleAndKeywords(args, kwds, "|O:results", kwlist, &py_policy) == false) {
+	if (PyArg_ParseTupleAndKeywords(args, kwds, "|Oz:results", kwlist, &py_policy, &nodename) == false) {
 		return NULL;
 	}
 
 	as_error err;
 	as_error_init(&err);
 
+	trace_span span;
+	trace_start(self->client, &span, "scan");
+
 	if (!self || !self->client->as) {
 		as_error_update(&err, AEROSPIKE_ERR_PARAM, "Invalid aerospike object");
 		goto CLEANUP;
@@ -104,12 +110,20 @@ PyObject * AerospikeScan_Results(AerospikeScan * self, PyObject * args, PyObject
 
 	PyThreadState * _save = PyEval_SaveThread();
 
-	aerospike_scan_foreach(self->client->as, &err, scan_policy_p, &self->scan, each_result, &data);
+	trace_call_start(&span);
+	if (nodename) {
+		aerospike_scan_node(self->client->as, &err, scan_policy_p, &self->scan, nodename, each_result, &data);
+	} else {
+		aerospike_scan_foreach(self->client->as, &err, scan_policy_p, &self->scan, each_result, &data);
+	}
+	trace_call_end(&span);
 
 	PyEval_RestoreThread(_save);
 
 
 CLEANUP:
+	trace_end_set(self->client, &span, self->scan.ns, self->scan.set,
+			py_results ? (uint32_t) PyList_GET_SIZE(py_results) : 0, err.code);
 
 	if (err.code != AEROSPIKE_OK) {
 		PyObject * py_err = NULL;
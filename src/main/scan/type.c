@@ -28,6 +28,7 @@
 #include "scan.h"
 #include "conversions.h"
 #include "exceptions.h"
+#include "module_state.h"
 #include "macros.h"
 
 
@@ -45,6 +46,9 @@ static PyMethodDef AerospikeScan_Type_Methods[] = {
 
 	{"results",	(PyCFunction) AerospikeScan_Results,	METH_VARARGS | METH_KEYWORDS,
 				"Get a record."},
+
+	{"export",	(PyCFunction) AerospikeScan_Export,	METH_VARARGS | METH_KEYWORDS,
+				"Write the scan results to a file."},
 	{NULL}
 };
 
@@ -105,13 +109,39 @@ static int AerospikeScan_Type_Init(AerospikeScan * self, PyObject * args, PyObje
 static void AerospikeScan_Type_Dealloc(PyObject * self)
 {
 	as_scan_destroy(&((AerospikeScan *)self)->scan);
-	Py_TYPE(self)->tp_free((PyObject *) self);
+	PyTypeObject * type = Py_TYPE(self);
+	type->tp_free((PyObject *) self);
+	AS_TYPE_RELEASE(type);
 }
 
 /*******************************************************************************
  * PYTHON TYPE DESCRIPTOR
  ******************************************************************************/
 
+#ifdef AS_HEAP_TYPES
+
+static PyType_Slot AerospikeScan_Type_Slots[] = {
+	{Py_tp_dealloc, (void *) AerospikeScan_Type_Dealloc},
+	{Py_tp_doc, (void *)
+		"The Scan class assists in populating the parameters of a scan\n"
+		"operation. To create a new instance of the Scan class, call the\n"
+		"scan() method on an instance of a Client class.\n"},
+	{Py_tp_methods, (void *) AerospikeScan_Type_Methods},
+	{Py_tp_init, (void *) AerospikeScan_Type_Init},
+	{Py_tp_new, (void *) AerospikeScan_Type_New},
+	{0, NULL}
+};
+
+static PyType_Spec AerospikeScan_Type_Spec = {
+	"aerospike.Scan",
+	sizeof(AerospikeScan),
+	0,
+	Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+	AerospikeScan_Type_Slots
+};
+
+#else
+
 static PyTypeObject AerospikeScan_Type = {
 	PyVarObject_HEAD_INIT(NULL, 0)
 	"aerospike.Scan",                   // tp_name
@@ -162,21 +192,28 @@ static PyTypeObject AerospikeScan_Type = {
 	0                                   // tp_bases
 };
 
+#endif
+
 /*******************************************************************************
  * PUBLIC FUNCTIONS
  ******************************************************************************/
 
 PyTypeObject * AerospikeScan_Ready()
 {
+#ifdef AS_HEAP_TYPES
+	return (PyTypeObject *) PyType_FromSpec(&AerospikeScan_Type_Spec);
+#else
 	return PyType_Ready(&AerospikeScan_Type) == 0 ? &AerospikeScan_Type : NULL;
+#endif
 }
 
 AerospikeScan * AerospikeScan_New(AerospikeClient * client, PyObject * args, PyObject * kwds)
 {
-	AerospikeScan * self  = (AerospikeScan *) AerospikeScan_Type.tp_new(&AerospikeScan_Type, args, kwds);
+	PyTypeObject * type = client->state->scan_type;
+	AerospikeScan * self  = (AerospikeScan *) type->tp_new(type, args, kwds);
 	self->client = client;
 	Py_INCREF(client);
-	if (AerospikeScan_Type.tp_init((PyObject *) self, args, kwds) != -1) {
+	if (type->tp_init((PyObject *) self, args, kwds) != -1) {
 		return self;
 	}
 	else {
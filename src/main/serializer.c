@@ -24,18 +24,20 @@
 #include "client.h"
 #include "conversions.h"
 #include "exceptions.h"
+#include "msgpack_decoder.h"
 #include "policy.h"
 #include "serializer.h"
-
-uint32_t is_user_serializer_registered = 0;
-uint32_t is_user_deserializer_registered = 0;
-
-user_serializer_callback user_serializer_call_info, user_deserializer_call_info;
+#include "module_state.h"
 
 /**
  ******************************************************************************************************
  * Set a serializer in the aerospike database
  *
+ *		aerospike.set_serializer(function, batch=False)
+ *
+ * With batch=True the function is called once per write, with a list of
+ * the values to serialize, and returns a list of as many strings.
+ *
  * @param self                  Aerospike object
  * @param args                  The args is a tuple object containing an argument
  *                              list passed from Python to a C function
@@ -46,26 +48,35 @@ user_serializer_callback user_serializer_call_info, user_deserializer_call_info;
  */
 PyObject * AerospikeClient_Set_Serializer(AerospikeClient * self, PyObject * args, PyObject * kwds)
 {
+	// self is the aerospike module
+	aerospike_state * state = aerospike_module_state((PyObject *) self);
 	// Python Function Arguments
 	PyObject * py_func = NULL;
+	PyObject * py_batch = NULL;
 
 	// Python Function Keyword Arguments
-	static char * kwlist[] = {"function", NULL};
+	static char * kwlist[] = {"function", "batch", NULL};
 	as_error err;
 	// Initialize error
 	as_error_init(&err);
 
 	// Python Function Argument Parsing
-	if (PyArg_ParseTupleAndKeywords(args, kwds, "O:set_serializer", kwlist,
-				&py_func) == false) {
+	if (PyArg_ParseTupleAndKeywords(args, kwds, "O|O:set_serializer", kwlist,
+				&py_func, &py_batch) == false) {
 		return NULL;
 	}
 
-	if (!is_user_serializer_registered) {
-		memset(&user_serializer_call_info, 0, sizeof(user_serializer_call_info));
+	int batch = py_batch ? PyObject_IsTrue(py_batch) : 0;
+	if (batch == -1) {
+		return NULL;
 	}
 
-	if (user_serializer_call_info.callback == py_func) {
+	if (!state->is_serializer_registered) {
+		memset(&state->serializer, 0, sizeof(state->serializer));
+	}
+
+	if (state->serializer.callback == py_func) {
+		state->serializer.batch = batch;
 		return PyLong_FromLong(0);
 	}
 	if (!PyCallable_Check(py_func)) {
@@ -73,11 +84,12 @@ PyObject * AerospikeClient_Set_Serializer(AerospikeClient * self, PyObject * arg
 		goto CLEANUP;
 	}
 
-	if (user_serializer_call_info.callback) {
-		Py_DECREF(user_serializer_call_info.callback);
+	if (state->serializer.callback) {
+		Py_DECREF(state->serializer.callback);
 	}
-	is_user_serializer_registered = 1;
-	user_serializer_call_info.callback = py_func;
+	state->is_serializer_registered = true;
+	state->serializer.callback = py_func;
+	state->serializer.batch = batch;
 	Py_INCREF(py_func);
 
 CLEANUP:
@@ -97,6 +109,11 @@ CLEANUP:
  ******************************************************************************************************
  * Set a deserializer in the aerospike database
  *
+ *		aerospike.set_deserializer(function, batch=False)
+ *
+ * With batch=True the function is called once per result, with a list of
+ * the values to deserialize, and returns a list of as many objects.
+ *
  * @param self                  Aerospike object
  * @param args                  The args is a tuple object containing an argument
  *                              list passed from Python to a C function
@@ -107,25 +124,34 @@ CLEANUP:
  */
 PyObject * AerospikeClient_Set_Deserializer(AerospikeClient * self, PyObject * args, PyObject * kwds)
 {
+	// self is the aerospike module
+	aerospike_state * state = aerospike_module_state((PyObject *) self);
 	// Python Function Arguments
 	PyObject * py_func = NULL;
+	PyObject * py_batch = NULL;
 
 	// Python Function Keyword Arguments
-	static char * kwlist[] = {"function", NULL};
+	static char * kwlist[] = {"function", "batch", NULL};
 	as_error err;
 	as_error_init(&err);
 
 	// Python Function Argument Parsing
-	if (PyArg_ParseTupleAndKeywords(args, kwds, "O:set_deserializer", kwlist,
-				&py_func) == false) {
+	if (PyArg_ParseTupleAndKeywords(args, kwds, "O|O:set_deserializer", kwlist,
+				&py_func, &py_batch) == false) {
+		return NULL;
+	}
+
+	int batch = py_batch ? PyObject_IsTrue(py_batch) : 0;
+	if (batch == -1) {
 		return NULL;
 	}
 
-	if (!is_user_deserializer_registered) {
-		memset(&user_deserializer_call_info, 0, sizeof(user_deserializer_call_info));
+	if (!state->is_deserializer_registered) {
+		memset(&state->deserializer, 0, sizeof(state->deserializer));
 	}
 
-	if (user_deserializer_call_info.callback == py_func) {
+	if (state->deserializer.callback == py_func) {
+		state->deserializer.batch = batch;
 		return PyLong_FromLong(0);
 	}
 
@@ -133,11 +159,12 @@ PyObject * AerospikeClient_Set_Deserializer(AerospikeClient * self, PyObject * a
 		as_error_update(&err, AEROSPIKE_ERR_PARAM, "Parameter must be a callable");
 		goto CLEANUP;
 	}
-	is_user_deserializer_registered = 1;
-	if (user_deserializer_call_info.callback) {
-		Py_DECREF(user_deserializer_call_info.callback);
+	state->is_deserializer_registered = true;
+	if (state->deserializer.callback) {
+		Py_DECREF(state->deserializer.callback);
 	}
-	user_deserializer_call_info.callback = py_func;
+	state->deserializer.callback = py_func;
+	state->deserializer.batch = batch;
 	Py_INCREF(py_func);
 
 CLEANUP:
@@ -284,6 +311,425 @@ CLEANUP:
 	}
 }
 
+/*******************************************************************************
+ * BATCH SERIALIZER
+ ******************************************************************************/
+
+// Collection of the write being converted by this thread, if any
+static __thread serializer_batch * current_serializer_batch = NULL;
+
+long serializer_option_from_pyobject(AerospikeClient * self, PyObject * py_serializer)
+{
+	if (py_serializer && (PyInt_Check(py_serializer) || PyLong_Check(py_serializer))) {
+		self->is_client_put_serializer = true;
+		return PyLong_AsLong(py_serializer);
+	}
+	self->is_client_put_serializer = false;
+	return SERIALIZER_PYTHON;
+}
+
+void serializer_batch_begin(AerospikeClient * self, serializer_batch * batch)
+{
+	aerospike_state * state = self->state;
+
+	memset(batch, 0, sizeof(serializer_batch));
+
+	if (!state->is_serializer_registered || !state->serializer.batch ||
+			current_serializer_batch) {
+		return;
+	}
+	batch->active = true;
+	batch->py_callback = state->serializer.callback;
+	Py_XINCREF(batch->py_callback);
+	current_serializer_batch = batch;
+}
+
+/**
+ * Adds the value to the current collection, leaving bytes empty until the
+ * serializer returns. Returns false if nothing is being collected.
+ */
+static bool serializer_batch_defer(PyObject * py_value, as_bytes * bytes)
+{
+	serializer_batch * batch = current_serializer_batch;
+	if (!batch) {
+		return false;
+	}
+
+	if (!batch->py_values) {
+		batch->py_values = PyList_New(0);
+		if (!batch->py_values) {
+			PyErr_Clear();
+			return false;
+		}
+	}
+
+	Py_ssize_t size = PyList_GET_SIZE(batch->py_values);
+	if (size == batch->capacity) {
+		Py_ssize_t capacity = batch->capacity ? batch->capacity * 2 : 16;
+		as_bytes ** bytes_p = (as_bytes **) realloc(batch->bytes, sizeof(as_bytes *) * capacity);
+		if (!bytes_p) {
+			return false;
+		}
+		batch->bytes = bytes_p;
+		batch->capacity = capacity;
+	}
+	if (PyList_Append(batch->py_values, py_value) == -1) {
+		PyErr_Clear();
+		return false;
+	}
+
+	as_bytes_init_wrap(bytes, NULL, 0, false);
+	batch->bytes[size] = bytes;
+	return true;
+}
+
+/**
+ * Copies one string returned by the serializer into bytes.
+ */
+static bool serializer_batch_fill(as_bytes * bytes, PyObject * py_result)
+{
+	char * data = NULL;
+	Py_ssize_t len = 0;
+
+	if (PyBytes_Check(py_result)) {
+		PyBytes_AsStringAndSize(py_result, &data, &len);
+#if PY_MAJOR_VERSION >= 3
+	} else if (PyUnicode_Check(py_result)) {
+		data = (char *) PyUnicode_AsUTF8AndSize(py_result, &len);
+#endif
+	}
+	if (!data) {
+		PyErr_Clear();
+		return false;
+	}
+
+	as_bytes_init(bytes, (uint32_t) len);
+	if (!as_bytes_set(bytes, 0, (uint8_t *) data, (uint32_t) len)) {
+		return false;
+	}
+	as_bytes_set_type(bytes, AS_BYTES_BLOB);
+	return true;
+}
+
+as_status serializer_batch_end(serializer_batch * batch, as_error * err)
+{
+	if (!batch->active) {
+		return err->code;
+	}
+	current_serializer_batch = NULL;
+
+	if (batch->py_values && err->code == AEROSPIKE_OK) {
+		Py_ssize_t size = PyList_GET_SIZE(batch->py_values);
+		PyObject * py_results = NULL;
+		if (batch->py_callback) {
+			py_results = PyObject_CallFunctionObjArgs(batch->py_callback, batch->py_values, NULL);
+		}
+		PyObject * py_fast = py_results ? PySequence_Fast(py_results, "serializer should return a list") : NULL;
+
+		if (!py_fast || PySequence_Fast_GET_SIZE(py_fast) != size) {
+			as_error_update(err, AEROSPIKE_ERR,
+					"Unable to call user's registered serializer callback");
+		} else {
+			for (Py_ssize_t i = 0; i < size; i++) {
+				if (!serializer_batch_fill(batch->bytes[i], PySequence_Fast_GET_ITEM(py_fast, i))) {
+					as_error_update(err, AEROSPIKE_ERR, "Unable to set as_bytes");
+					break;
+				}
+			}
+		}
+		PyErr_Clear();
+		Py_XDECREF(py_fast);
+		Py_XDECREF(py_results);
+	}
+
+	Py_CLEAR(batch->py_callback);
+	Py_CLEAR(batch->py_values);
+	free(batch->bytes);
+	batch->bytes = NULL;
+	batch->capacity = 0;
+	return err->code;
+}
+
+serializer_batch * serializer_batch_suspend(void)
+{
+	serializer_batch * batch = current_serializer_batch;
+	current_serializer_batch = NULL;
+	return batch;
+}
+
+void serializer_batch_resume(serializer_batch * batch)
+{
+	current_serializer_batch = batch;
+}
+
+/**
+ * Serializes a value written outside of any collection, such as by
+ * operate(), by calling the serializer with a list of one.
+ */
+static void serializer_batch_single(AerospikeClient * self, as_bytes * bytes, PyObject * py_value, as_error * err)
+{
+	if (serializer_batch_defer(py_value, bytes)) {
+		return;
+	}
+
+	serializer_batch single;
+	serializer_batch_begin(self, &single);
+	if (!serializer_batch_defer(py_value, bytes)) {
+		serializer_batch_end(&single, err);
+		as_error_update(err, AEROSPIKE_ERR, "Unable to set as_bytes");
+		return;
+	}
+	serializer_batch_end(&single, err);
+}
+
+/*******************************************************************************
+ * BATCH DESERIALIZER
+ ******************************************************************************/
+
+// Collection of the result being converted by this thread, if any. Results
+// are converted with the GIL held, but Python code run while converting,
+// such as pickle.loads, lets other threads convert results of their own.
+static __thread deserializer_batch * current_deserializer_batch = NULL;
+
+void deserializer_batch_begin(AerospikeClient * self, deserializer_batch * batch)
+{
+	aerospike_state * state = self->state;
+
+	batch->active = false;
+	batch->py_callback = NULL;
+	batch->py_blobs = NULL;
+	batch->py_placeholders = NULL;
+
+	if (!state->is_deserializer_registered || !state->deserializer.batch ||
+			current_deserializer_batch) {
+		return;
+	}
+	batch->active = true;
+	batch->py_callback = state->deserializer.callback;
+	Py_XINCREF(batch->py_callback);
+	current_deserializer_batch = batch;
+}
+
+/**
+ * Adds the blob to the current collection and sets retval to a new object
+ * standing in for it. Returns false if nothing is being collected.
+ */
+static bool deserializer_batch_defer(as_bytes * bytes, PyObject ** retval)
+{
+	deserializer_batch * batch = current_deserializer_batch;
+	if (!batch) {
+		return false;
+	}
+
+	PyObject * py_blob = PyString_FromStringAndSize((char *) bytes->value, as_bytes_size(bytes));
+	if (!py_blob) {
+		PyErr_Clear();
+		return false;
+	}
+	if (!batch->py_blobs) {
+		batch->py_blobs = PyList_New(0);
+		batch->py_placeholders = PyList_New(0);
+	}
+
+	// A bare object is never shared with the rest of the result, unlike
+	// the interned strings a blob could be
+	PyObject * py_placeholder = PyObject_CallObject((PyObject *) &PyBaseObject_Type, NULL);
+	PyList_Append(batch->py_blobs, py_blob);
+	PyList_Append(batch->py_placeholders, py_placeholder);
+	Py_DECREF(py_blob);
+
+	*retval = py_placeholder;
+	return true;
+}
+
+/**
+ * Deserializes a blob converted outside of any collection, such as the
+ * result of a UDF, by calling the deserializer with a list of one.
+ */
+static void deserializer_batch_single(AerospikeClient * self, as_bytes * bytes, PyObject ** retval, as_error * err)
+{
+	deserializer_batch single;
+	PyObject * py_value = NULL;
+
+	deserializer_batch_begin(self, &single);
+	if (!deserializer_batch_defer(bytes, &py_value)) {
+		// Not valid as a string argument
+		py_value = PyByteArray_FromStringAndSize((char *) as_bytes_get(bytes), as_bytes_size(bytes));
+	}
+	if (!py_value) {
+		deserializer_batch_end(&single, NULL, err);
+		as_error_update(err, AEROSPIKE_ERR_CLIENT, "Unable to deserialize bytes");
+		return;
+	}
+
+	PyObject * py_wrapper = PyList_New(1);
+	PyList_SET_ITEM(py_wrapper, 0, py_value);
+	if (deserializer_batch_end(&single, py_wrapper, err) == AEROSPIKE_OK) {
+		*retval = PyList_GET_ITEM(py_wrapper, 0);
+		Py_INCREF(*retval);
+	}
+	Py_DECREF(py_wrapper);
+}
+
+/**
+ * The bytes given to the deserializer, as a bytearray.
+ */
+static PyObject * deserializer_batch_fallback(PyObject * py_blob)
+{
+	Py_ssize_t len = 0;
+#if PY_MAJOR_VERSION >= 3
+	const char * data = PyUnicode_AsUTF8AndSize(py_blob, &len);
+#else
+	char * data = NULL;
+	PyString_AsStringAndSize(py_blob, &data, &len);
+#endif
+	return data ? PyByteArray_FromStringAndSize(data, len) : NULL;
+}
+
+/**
+ * The value of a placeholder, or NULL for any other object. Placeholders are
+ * the only bare objects in a result, which saves hashing everything else.
+ */
+static PyObject * deserializer_batch_value(PyObject * py_values, PyObject * py_obj)
+{
+	if (!py_obj || Py_TYPE(py_obj) != &PyBaseObject_Type) {
+		return NULL;
+	}
+	return PyDict_GetItem(py_values, py_obj);
+}
+
+/**
+ * Replaces the placeholders found in py_obj, and in the lists, tuples and
+ * dicts it holds, with their values from py_values.
+ */
+static bool deserializer_batch_splice(PyObject * py_obj, PyObject * py_values)
+{
+	if (PyList_Check(py_obj) || PyTuple_Check(py_obj)) {
+		bool is_list = PyList_Check(py_obj);
+		Py_ssize_t size = is_list ? PyList_GET_SIZE(py_obj) : PyTuple_GET_SIZE(py_obj);
+
+		for (Py_ssize_t i = 0; i < size; i++) {
+			PyObject * py_item = is_list ? PyList_GET_ITEM(py_obj, i) : PyTuple_GET_ITEM(py_obj, i);
+			PyObject * py_value = deserializer_batch_value(py_values, py_item);
+
+			if (py_value) {
+				Py_INCREF(py_value);
+				// The tuples of a result are new, so their items can still change
+				if (is_list) {
+					PyList_SET_ITEM(py_obj, i, py_value);
+				} else {
+					PyTuple_SET_ITEM(py_obj, i, py_value);
+				}
+				Py_DECREF(py_item);
+			} else if (py_item && !deserializer_batch_splice(py_item, py_values)) {
+				return false;
+			}
+		}
+	} else if (PyDict_Check(py_obj)) {
+		PyObject * py_key = NULL;
+		PyObject * py_item = NULL;
+		PyObject * py_placeholder_keys = NULL;
+		Py_ssize_t pos = 0;
+
+		while (PyDict_Next(py_obj, &pos, &py_key, &py_item)) {
+			if (deserializer_batch_value(py_values, py_key)) {
+				// Keys are changed once the dict is no longer being iterated
+				if (!py_placeholder_keys) {
+					py_placeholder_keys = PyList_New(0);
+				}
+				PyList_Append(py_placeholder_keys, py_key);
+			}
+
+			PyObject * py_value = deserializer_batch_value(py_values, py_item);
+			if (py_value) {
+				// Changing the value of a key does not disturb PyDict_Next
+				PyDict_SetItem(py_obj, py_key, py_value);
+			} else if (!deserializer_batch_splice(py_item, py_values)) {
+				Py_XDECREF(py_placeholder_keys);
+				return false;
+			}
+		}
+
+		Py_ssize_t n_keys = py_placeholder_keys ? PyList_GET_SIZE(py_placeholder_keys) : 0;
+		for (Py_ssize_t i = 0; i < n_keys; i++) {
+			py_key = PyList_GET_ITEM(py_placeholder_keys, i);
+			py_item = PyDict_GetItem(py_obj, py_key);
+			Py_INCREF(py_item);
+			PyDict_DelItem(py_obj, py_key);
+			int rc = PyDict_SetItem(py_obj, PyDict_GetItem(py_values, py_key), py_item);
+			Py_DECREF(py_item);
+			if (rc == -1) {
+				Py_DECREF(py_placeholder_keys);
+				return false;
+			}
+		}
+		Py_XDECREF(py_placeholder_keys);
+	}
+	return true;
+}
+
+as_status deserializer_batch_end(deserializer_batch * batch, PyObject * py_result, as_error * err)
+{
+	if (!batch->active) {
+		return err->code;
+	}
+	current_deserializer_batch = NULL;
+
+	if (!batch->py_blobs) {
+		Py_CLEAR(batch->py_callback);
+		return err->code;
+	}
+
+	Py_ssize_t size = PyList_GET_SIZE(batch->py_blobs);
+	PyObject * py_values = PyDict_New();
+
+	// Keep the pending Python error, if any, of a failed conversion
+	PyObject * py_type = NULL;
+	PyObject * py_error = NULL;
+	PyObject * py_traceback = NULL;
+	PyErr_Fetch(&py_type, &py_error, &py_traceback);
+
+	PyObject * py_results = NULL;
+	if (py_result && batch->py_callback) {
+		py_results = PyObject_CallFunctionObjArgs(batch->py_callback, batch->py_blobs, NULL);
+	}
+
+	PyObject * py_fast = py_results ? PySequence_Fast(py_results, "deserializer should return a list") : NULL;
+	bool deserialized = py_fast && PySequence_Fast_GET_SIZE(py_fast) == size;
+
+	for (Py_ssize_t i = 0; i < size && py_result; i++) {
+		PyObject * py_value = NULL;
+		if (deserialized) {
+			py_value = PySequence_Fast_GET_ITEM(py_fast, i);
+			Py_INCREF(py_value);
+		} else {
+			// As for a single value the deserializer failed on
+			py_value = deserializer_batch_fallback(PyList_GET_ITEM(batch->py_blobs, i));
+		}
+		if (!py_value) {
+			as_error_update(err, AEROSPIKE_ERR_CLIENT, "Unable to deserialize bytes");
+			break;
+		}
+		PyDict_SetItem(py_values, PyList_GET_ITEM(batch->py_placeholders, i), py_value);
+		Py_DECREF(py_value);
+	}
+	PyErr_Clear();
+
+	if (py_result && err->code == AEROSPIKE_OK && !deserializer_batch_splice(py_result, py_values)) {
+		PyErr_Clear();
+		as_error_update(err, AEROSPIKE_ERR_CLIENT, "Unable to deserialize bytes");
+	}
+	PyErr_Restore(py_type, py_error, py_traceback);
+
+	Py_XDECREF(py_fast);
+	Py_XDECREF(py_results);
+	Py_DECREF(py_values);
+	Py_CLEAR(batch->py_callback);
+	Py_CLEAR(batch->py_blobs);
+	Py_CLEAR(batch->py_placeholders);
+	return err->code;
+}
+
 /*
  *******************************************************************************************************
  * Checks serializer_policy.
@@ -395,8 +841,13 @@ extern as_status serialize_based_on_serializer_policy(AerospikeClient * self,
 					goto CLEANUP;
 				}
 			} else {
-				if (is_user_serializer_registered) {
-					execute_user_callback(&user_serializer_call_info, bytes, &value, true, error_p);
+				if (self->state->is_serializer_registered) {
+					if (self->state->serializer.batch) {
+						// Deferred to the end of the write's collection, if any
+						serializer_batch_single(self, *bytes, value, error_p);
+					} else {
+						execute_user_callback(&self->state->serializer, bytes, &value, true, error_p);
+					}
 					if (AEROSPIKE_OK != (error_p->code)) {
 						goto CLEANUP;
 					}
@@ -509,8 +960,13 @@ extern as_status deserialize_based_on_as_bytes_type(AerospikeClient * self,
 										as_error_update(error_p, AEROSPIKE_OK, NULL);
 									}
 								} else {
-									if (is_user_deserializer_registered) {
-										execute_user_callback(&user_deserializer_call_info, &bytes, retval, false, error_p);
+									if (self->state->is_deserializer_registered && self->state->deserializer.batch) {
+										// Deserialized with the rest of the result, or alone in a list
+										if (!deserializer_batch_defer(bytes, retval)) {
+											deserializer_batch_single(self, bytes, retval, error_p);
+										}
+									} else if (self->state->is_deserializer_registered) {
+										execute_user_callback(&self->state->deserializer, &bytes, retval, false, error_p);
 										if (AEROSPIKE_OK != (error_p->code)) {
 											uint32_t bval_size = as_bytes_size(bytes);
 											PyObject *py_val = PyByteArray_FromStringAndSize((char *) as_bytes_get(bytes), bval_size);
@@ -533,6 +989,15 @@ extern as_status deserialize_based_on_as_bytes_type(AerospikeClient * self,
 								}
 							}
 							break;
+		case AS_BYTES_LIST:
+		case AS_BYTES_MAP:  {
+								// Read with the deserialize policy off
+								if (msgpack_to_pyobject(self, error_p, as_bytes_get(bytes),
+											as_bytes_size(bytes), retval) != AEROSPIKE_OK) {
+									goto CLEANUP;
+								}
+							}
+							break;
 		case AS_BYTES_LDT:  {
 								Py_INCREF(Py_None);
 								*retval = Py_None;
@@ -568,6 +1033,8 @@ CLEANUP:
 }
 PyObject * AerospikeClient_Unset_Serializers(AerospikeClient * self, PyObject * args, PyObject * kwds)
 {
+	// self is the aerospike module
+	aerospike_state * state = aerospike_module_state((PyObject *) self);
 	// Python Function Keyword Arguments
 	static char * kwlist[] = {NULL};
 	as_error err;
@@ -578,10 +1045,12 @@ PyObject * AerospikeClient_Unset_Serializers(AerospikeClient * self, PyObject *
 	if ( PyArg_ParseTupleAndKeywords(args, kwds, ":unset_serializers", kwlist) == false ) {
 		return NULL;
 	}
-	is_user_serializer_registered = 0;
-	is_user_deserializer_registered = 0;
-	memset(&user_deserializer_call_info, 0, sizeof(user_deserializer_call_info));
-	memset(&user_serializer_call_info, 0, sizeof(user_serializer_call_info));
+	state->is_serializer_registered = false;
+	state->is_deserializer_registered = false;
+	Py_XDECREF(state->deserializer.callback);
+	Py_XDECREF(state->serializer.callback);
+	memset(&state->deserializer, 0, sizeof(state->deserializer));
+	memset(&state->serializer, 0, sizeof(state->serializer));
 
 	return PyLong_FromLong(0);
 }
@@ -0,0 +1,241 @@
+/*******************************************************************************
+ * Copyright 2013-2016 Aerospike, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ******************************************************************************/
+
+#include <Python.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include <aerospike/aerospike.h>
+#include <aerospike/as_cluster.h>
+#include <aerospike/as_error.h>
+#include <aerospike/as_key.h>
+#include <aerospike/as_node.h>
+#include <citrusleaf/cf_clock.h>
+
+#include "macros.h"
+#include "tracer.h"
+
+span_tracer * span_tracer_new(PyObject * callback, double sample_rate, uint32_t batch_size)
+{
+	span_tracer * tracer = (span_tracer *) calloc(1, sizeof(span_tracer));
+	Py_INCREF(callback);
+	tracer->callback = callback;
+	tracer->sample_rate = sample_rate;
+	tracer->batch_size = batch_size;
+	tracer->spans = (trace_record *) malloc(sizeof(trace_record) * batch_size);
+	return tracer;
+}
+
+void span_tracer_destroy(span_tracer * tracer)
+{
+	if (!tracer) {
+		return;
+	}
+	Py_DECREF(tracer->callback);
+	free(tracer->spans);
+	free(tracer);
+}
+
+static void tracer_set(PyObject * py_span, const char * name, PyObject * py_value)
+{
+	PyDict_SetItemString(py_span, name, py_value);
+	Py_DECREF(py_value);
+}
+
+static PyObject * trace_record_to_pyobject(trace_record * record)
+{
+	PyObject * py_span = PyDict_New();
+	tracer_set(py_span, "operation", PyString_FromString(record->operation));
+	if (record->ns[0]) {
+		tracer_set(py_span, "namespace", PyString_FromString(record->ns));
+		tracer_set(py_span, "set", PyString_FromString(record->set));
+	} else {
+		Py_INCREF(Py_None);
+		tracer_set(py_span, "namespace", Py_None);
+		Py_INCREF(Py_None);
+		tracer_set(py_span, "set", Py_None);
+	}
+	if (record->node[0]) {
+		tracer_set(py_span, "node", PyString_FromString(record->node));
+	} else {
+		Py_INCREF(Py_None);
+		tracer_set(py_span, "node", Py_None);
+	}
+	tracer_set(py_span, "keys", PyLong_FromUnsignedLong(record->n_keys));
+	tracer_set(py_span, "status", PyInt_FromLong(record->status));
+	tracer_set(py_span, "start_us", PyLong_FromUnsignedLongLong(record->start_us));
+	tracer_set(py_span, "end_us", PyLong_FromUnsignedLongLong(record->start_us +
+				record->convert_us + record->network_us + record->result_us));
+	tracer_set(py_span, "convert_us", PyLong_FromUnsignedLongLong(record->convert_us));
+	tracer_set(py_span, "network_us", PyLong_FromUnsignedLongLong(record->network_us));
+	tracer_set(py_span, "result_us", PyLong_FromUnsignedLongLong(record->result_us));
+	return py_span;
+}
+
+bool span_tracer_flush(span_tracer * tracer)
+{
+	if (!tracer || !tracer->n_spans) {
+		return true;
+	}
+
+	PyObject * py_spans = PyList_New(tracer->n_spans);
+	for (uint32_t i = 0; i < tracer->n_spans; i++) {
+		PyList_SET_ITEM(py_spans, i, trace_record_to_pyobject(&tracer->spans[i]));
+	}
+	tracer->n_spans = 0;
+
+	// The callback may replace the tracer, or trace calls of its own
+	PyObject * callback = tracer->callback;
+	Py_INCREF(callback);
+	PyObject * py_result = PyObject_CallFunctionObjArgs(callback, py_spans, NULL);
+	Py_DECREF(callback);
+	Py_DECREF(py_spans);
+
+	if (!py_result) {
+		return false;
+	}
+	Py_DECREF(py_result);
+	return true;
+}
+
+void trace_start(AerospikeClient * self, trace_span * span, const char * operation)
+{
+	span->sampled = false;
+
+	span_tracer * tracer = self->tracer;
+	if (!tracer) {
+		return;
+	}
+
+	tracer->credit += tracer->sample_rate;
+	if (tracer->credit < 1) {
+		return;
+	}
+	tracer->credit -= 1;
+
+	span->sampled = true;
+	span->operation = operation;
+	span->start_us = cf_getus();
+	span->call_us = 0;
+	span->return_us = 0;
+}
+
+/**
+ * Buffers the span of a sampled call and returns its record, or NULL if the
+ * call was not sampled or its span has already ended.
+ */
+static trace_record * trace_record_add(span_tracer * tracer, trace_span * span,
+		const char * ns, const char * set, uint32_t n_keys, as_status status)
+{
+	if (!span->sampled || !tracer) {
+		return NULL;
+	}
+	span->sampled = false;
+
+	uint64_t end_us = cf_getus();
+	if (!span->call_us) {
+		// Failed before reaching the server
+		span->call_us = end_us;
+		span->return_us = end_us;
+	}
+
+	struct timeval now;
+	gettimeofday(&now, NULL);
+
+	trace_record * record = &tracer->spans[tracer->n_spans++];
+	memset(record, 0, sizeof(trace_record));
+	record->operation = span->operation;
+	record->n_keys = n_keys;
+	record->status = status;
+	record->start_us = (uint64_t) now.tv_sec * 1000000 + now.tv_usec - (end_us - span->start_us);
+	record->convert_us = span->call_us - span->start_us;
+	record->network_us = span->return_us - span->call_us;
+	record->result_us = end_us - span->return_us;
+
+	if (ns) {
+		strncpy(record->ns, ns, AS_NAMESPACE_MAX_SIZE - 1);
+		strncpy(record->set, set ? set : "", AS_SET_MAX_SIZE - 1);
+	}
+	return record;
+}
+
+/**
+ * Passes the buffer to the callback once it holds batch_size spans.
+ */
+static void trace_flush_full(span_tracer * tracer)
+{
+	if (tracer->n_spans < tracer->batch_size) {
+		return;
+	}
+
+	// The call keeps its own outcome, so the callback's error can only be reported
+	PyObject * py_type = NULL;
+	PyObject * py_value = NULL;
+	PyObject * py_traceback = NULL;
+	PyErr_Fetch(&py_type, &py_value, &py_traceback);
+
+	PyObject * callback = tracer->callback;
+	Py_INCREF(callback);
+	if (!span_tracer_flush(tracer)) {
+		PyErr_WriteUnraisable(callback);
+	}
+	Py_DECREF(callback);
+
+	PyErr_Restore(py_type, py_value, py_traceback);
+}
+
+void trace_end(AerospikeClient * self, trace_span * span, const as_key * key, as_status status)
+{
+	span_tracer * tracer = self->tracer;
+	trace_record * record = trace_record_add(tracer, span, key ? key->ns : NULL,
+			key ? key->set : NULL, 1, status);
+	if (!record) {
+		return;
+	}
+
+	as_error err;
+	as_error_init(&err);
+	if (key && self->is_conn_16 && as_key_digest(&err, (as_key *) key)) {
+		as_node * node = as_node_get(self->as->cluster, key->ns, key->digest.value, true,
+				AS_POLICY_REPLICA_MASTER);
+		if (node) {
+			strncpy(record->node, node->name, AS_NODE_NAME_MAX_SIZE - 1);
+			as_node_release(node);
+		}
+	}
+	trace_flush_full(tracer);
+}
+
+void trace_end_batch(AerospikeClient * self, trace_span * span, const as_key * first_key,
+		uint32_t n_keys, as_status status)
+{
+	span_tracer * tracer = self->tracer;
+	if (trace_record_add(tracer, span, first_key ? first_key->ns : NULL,
+			first_key ? first_key->set : NULL, n_keys, status)) {
+		trace_flush_full(tracer);
+	}
+}
+
+void trace_end_set(AerospikeClient * self, trace_span * span, const char * ns,
+		const char * set, uint32_t n_records, as_status status)
+{
+	span_tracer * tracer = self->tracer;
+	if (trace_record_add(tracer, span, ns, set, n_records, status)) {
+		trace_flush_full(tracer);
+	}
+}
@@ -15,9 +15,11 @@ class AerospikeStatus(object):
     AEROSPIKE_ERR_RECORD_NOT_FOUND = 2
     AEROSPIKE_ERR_RECORD_GENERATION = 3
     AEROSPIKE_ERR_REQUEST_INVALID = 4
+    AEROSPIKE_ERR_TIMEOUT = 9
     AEROSPIKE_CLUSTER_ERROR = 11
     AEROSPIKE_ERR_BIN_INCOMPATIBLE_TYPE = 12
     AEROSPIKE_ERR_NAMESPACE_NOT_FOUND = 20
+    AEROSPIKE_ERR_BIN_NAME = 21
     AEROSPIKE_ERR_UDF = 100
     AEROSPIKE_ERR_INDEX_NOT_FOUND = 201
     LUA_FILE_NOT_FOUND = 1302
@@ -0,0 +1,111 @@
+# -*- coding: utf-8 -*-
+
+import pytest
+import sys
+
+from .test_base_class import TestBaseClass
+from .as_status_codes import AerospikeStatus
+from aerospike import exception as e
+aerospike = pytest.importorskip("aerospike")
+try:
+    import aerospike
+except:
+    print("Please install aerospike python client.")
+    sys.exit(1)
+
+
+def add_udfs(client):
+    client.udf_put("test_record_udf.lua", 0, {})
+
+
+def remove_udfs(client):
+    client.udf_remove("test_record_udf.lua", {})
+
+
+class TestApplyMany(TestBaseClass):
+
+    def setup_class(cls):
+        cls.connection_setup_functions = [add_udfs]
+        cls.connection_teardown_functions = [remove_udfs]
+
+    @pytest.fixture(autouse=True)
+    def setup(self, request, connection_with_config_funcs):
+        as_connection = connection_with_config_funcs
+        self.keys = [('test', 'demo', 'apply_many_%d' % i) for i in range(20)]
+        for i, key in enumerate(self.keys):
+            as_connection.put(key, {'age': i, 'name': 'apply_many'})
+
+        def teardown():
+            for key in self.keys:
+                try:
+                    as_connection.remove(key)
+                except e.RecordNotFound:
+                    pass
+
+        request.addfinalizer(teardown)
+
+    def test_results_in_key_order(self):
+        results = self.as_connection.apply_many(
+            self.keys, 'test_record_udf', 'bin_udf_operation_integer',
+            ['age', 1, 2])
+
+        assert results == [i + 3 for i in range(len(self.keys))]
+        for i, key in enumerate(self.keys):
+            assert self.as_connection.get(key)[2]['age'] == i + 3
+
+    def test_single_call_in_flight(self):
+        results = self.as_connection.apply_many(
+            self.keys[:3], u'test_record_udf', u'bin_udf_operation_integer',
+            ['age', 0, 0], {'timeout': 1000}, concurrency=1)
+
+        assert results == [0, 1, 2]
+
+    def test_per_key_errors(self):
+        keys = [self.keys[0], ('test', 'demo', 'apply_many_missing')]
+        self.keys.append(keys[1])
+
+        results = self.as_connection.apply_many(
+            keys, 'test_record_udf', 'bin_udf_operation_integer',
+            ['name', 1, 2])
+
+        assert len(results) == 2
+        for result in results:
+            assert isinstance(result, e.UDFError)
+            assert result.code == AerospikeStatus.AEROSPIKE_ERR_UDF
+            assert result.module == 'test_record_udf'
+            assert result.func == 'bin_udf_operation_integer'
+        assert results[0].key == keys[0]
+        assert results[1].key == keys[1]
+
+    def test_empty_keys(self):
+        assert self.as_connection.apply_many(
+            [], 'test_record_udf', 'bin_udf_operation_integer',
+            ['age', 1, 2]) == []
+
+    def test_args_not_a_list(self):
+        with pytest.raises(TypeError):
+            self.as_connection.apply_many(
+                self.keys, 'test_record_udf', 'bin_udf_operation_integer',
+                ('age', 1, 2))
+
+    @pytest.mark.parametrize(
+        "keys, kwargs",
+        [
+            ('not a list', {}),
+            ([('test', 'demo')], {}),
+            ([('test', 'demo', 1)], {'concurrency': 17}),
+            ([('test', 'demo', 1)], {'policy': 'policy'})
+        ],
+        ids=["keys not a list", "invalid key", "concurrency too high",
+             "invalid policy"]
+    )
+    def test_invalid_args(self, keys, kwargs):
+        with pytest.raises(e.ParamError):
+            self.as_connection.apply_many(
+                keys, 'test_record_udf', 'bin_udf_operation_integer',
+                ['age', 1, 2], **kwargs)
+
+    def test_invalid_module(self):
+        with pytest.raises(e.ClientError):
+            self.as_connection.apply_many(
+                self.keys, 1, 'bin_udf_operation_integer', ['age', 1, 2])
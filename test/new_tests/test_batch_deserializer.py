@@ -0,0 +1,103 @@
+# -*- coding: utf-8 -*-
+
+import pytest
+import sys
+import json
+from aerospike import exception as e
+
+aerospike = pytest.importorskip("aerospike")
+try:
+    import aerospike
+except:
+    print("Please install aerospike python client.")
+    sys.exit(1)
+
+
+def serialize_function(val):
+    return json.dumps(val)
+
+
+@pytest.mark.usefixtures("as_connection")
+class TestBatchDeserializer(object):
+
+    @pytest.fixture(autouse=True)
+    def setup(self, request, as_connection):
+        aerospike.set_serializer(serialize_function)
+        self.keys = [('test', 'demo', 'batch_deserializer_%d' % i)
+                     for i in range(3)]
+        for i, key in enumerate(self.keys):
+            as_connection.put(key, {'obj': (i, 'x'), 'tup': [i, (i,)],
+                                    'plain': i},
+                              serializer=aerospike.SERIALIZER_USER)
+        self.calls = []
+
+        def teardown():
+            aerospike.unset_serializers()
+            for key in self.keys:
+                try:
+                    as_connection.remove(key)
+                except e.RecordNotFound:
+                    pass
+
+        request.addfinalizer(teardown)
+
+    def deserialize_all(self, values):
+        self.calls.append(len(values))
+        return [json.loads(val) for val in values]
+
+    def test_get_single_call(self):
+        aerospike.set_deserializer(self.deserialize_all, batch=True)
+
+        _, _, bins = self.as_connection.get(self.keys[0])
+
+        assert bins == {'obj': [0, 'x'], 'tup': [0, [0]], 'plain': 0}
+        assert self.calls == [2]
+
+    def test_get_many_single_call(self):
+        aerospike.set_deserializer(self.deserialize_all, batch=True)
+
+        records = self.as_connection.get_many(self.keys)
+
+        assert self.calls == [6]
+        for i, (_, _, bins) in enumerate(records):
+            assert bins == {'obj': [i, 'x'], 'tup': [i, [i]], 'plain': i}
+
+    def test_select_many_single_call(self):
+        aerospike.set_deserializer(self.deserialize_all, batch=True)
+
+        records = self.as_connection.select_many(self.keys, ['obj'])
+
+        assert self.calls == [3]
+        for i, (_, _, bins) in enumerate(records):
+            assert bins == {'obj': [i, 'x']}
+
+    def test_callback_raising_leaves_bytearrays(self):
+        def raising(values):
+            raise ValueError("cannot deserialize")
+        aerospike.set_deserializer(raising, batch=True)
+
+        _, _, bins = self.as_connection.get(self.keys[0])
+
+        assert isinstance(bins['obj'], bytearray)
+        assert json.loads(bins['obj'].decode('utf-8')) == [0, 'x']
+        assert bins['plain'] == 0
+
+    def test_wrong_length_leaves_bytearrays(self):
+        aerospike.set_deserializer(lambda values: values[:1], batch=True)
+
+        _, _, bins = self.as_connection.get(self.keys[0])
+
+        assert isinstance(bins['obj'], bytearray)
+        assert isinstance(bins['tup'][1], bytearray)
+
+    def test_batch_false_calls_per_value(self):
+        calls = []
+
+        def deserialize(val):
+            calls.append(val)
+            return json.loads(val)
+        aerospike.set_deserializer(deserialize, batch=False)
+
+        self.as_connection.get_many(self.keys)
+
+        assert len(calls) == 6
@@ -0,0 +1,127 @@
+# -*- coding: utf-8 -*-
+
+import pytest
+import sys
+import json
+from aerospike import exception as e
+
+aerospike = pytest.importorskip("aerospike")
+try:
+    import aerospike
+except:
+    print("Please install aerospike python client.")
+    sys.exit(1)
+
+
+def deserialize_function(val):
+    return json.loads(val)
+
+
+@pytest.mark.usefixtures("as_connection")
+class TestBatchSerializer(object):
+
+    @pytest.fixture(autouse=True)
+    def setup(self, request, as_connection):
+        aerospike.set_deserializer(deserialize_function)
+        self.keys = [('test', 'demo', 'batch_serializer_%d' % i)
+                     for i in range(3)]
+        for key in self.keys:
+            as_connection.put(key, {'l': [], 'm': {}})
+        self.calls = []
+
+        def teardown():
+            aerospike.unset_serializers()
+            for key in self.keys:
+                try:
+                    as_connection.remove(key)
+                except e.RecordNotFound:
+                    pass
+
+        request.addfinalizer(teardown)
+
+    def serialize_all(self, values):
+        self.calls.append(len(values))
+        return [json.dumps(val) for val in values]
+
+    def test_put_single_call(self):
+        aerospike.set_serializer(self.serialize_all, batch=True)
+
+        self.as_connection.put(self.keys[0], {'a': (1, 'x'), 'b': [(2,)],
+                                              'plain': 3},
+                               serializer=aerospike.SERIALIZER_USER)
+
+        _, _, bins = self.as_connection.get(self.keys[0])
+        assert bins['a'] == [1, 'x']
+        assert bins['b'] == [[2]]
+        assert bins['plain'] == 3
+        assert self.calls == [2]
+
+    def test_map_put_items_many_single_call(self):
+        aerospike.set_serializer(self.serialize_all, batch=True)
+
+        results = self.as_connection.map_put_items_many(
+            self.keys, 'm', {'a': (1,), 'b': (2,), 'c': 3},
+            serializer=aerospike.SERIALIZER_USER)
+
+        assert results == [0, 0, 0]
+        assert self.calls == [2]
+        for key in self.keys:
+            _, _, bins = self.as_connection.get(key)
+            assert bins['m'] == {'a': [1], 'b': [2], 'c': 3}
+
+    def test_list_append_many_single_call(self):
+        aerospike.set_serializer(self.serialize_all, batch=True)
+
+        results = self.as_connection.list_append_many(
+            self.keys, 'l', [(1,), (2,)], serializer=aerospike.SERIALIZER_USER)
+
+        assert results == [0, 0, 0]
+        assert self.calls == [2]
+        _, _, bins = self.as_connection.get(self.keys[0])
+        assert bins['l'] == [[[1], [2]]]
+
+    def test_map_keys_serialized(self):
+        aerospike.set_serializer(self.serialize_all, batch=True)
+
+        self.as_connection.put(self.keys[0],
+                               {'m': {True: 'a', False: 'b', 'c': (3,)}},
+                               serializer=aerospike.SERIALIZER_USER)
+
+        _, _, bins = self.as_connection.get(self.keys[0])
+        assert bins['m'] == {True: 'a', False: 'b', 'c': [3]}
+
+    def test_per_value_serializer_unchanged(self):
+        aerospike.set_serializer(lambda val: json.dumps(val))
+
+        self.as_connection.put(self.keys[0], {'a': (1,), 'b': (2,)},
+                               serializer=aerospike.SERIALIZER_USER)
+
+        _, _, bins = self.as_connection.get(self.keys[0])
+        assert bins['a'] == [1]
+        assert bins['b'] == [2]
+
+    def test_serializer_raising(self):
+        def fail(values):
+            raise ValueError('no')
+
+        aerospike.set_serializer(fail, batch=True)
+
+        with pytest.raises(e.AerospikeError):
+            self.as_connection.put(self.keys[0], {'a': (1,)},
+                                   serializer=aerospike.SERIALIZER_USER)
+
+    def test_serializer_wrong_length(self):
+        aerospike.set_serializer(lambda values: [], batch=True)
+
+        with pytest.raises(e.AerospikeError):
+            self.as_connection.put(self.keys[0], {'a': (1,)},
+                                   serializer=aerospike.SERIALIZER_USER)
+
+    def test_set_serializer_invalid_batch(self):
+        class Bad(object):
+            def __bool__(self):
+                raise ValueError('no')
+            __nonzero__ = __bool__
+
+        with pytest.raises(ValueError):
+            aerospike.set_serializer(self.serialize_all, batch=Bad())
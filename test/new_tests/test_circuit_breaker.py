@@ -0,0 +1,89 @@
+# -*- coding: utf-8 -*-
+
+import pytest
+import sys
+from .test_base_class import TestBaseClass
+from aerospike import exception as e
+
+aerospike = pytest.importorskip("aerospike")
+try:
+    import aerospike
+except:
+    print("Please install aerospike python client.")
+    sys.exit(1)
+
+
+@pytest.mark.usefixtures("as_connection", "connection_config")
+class TestCircuitBreaker(object):
+
+    @pytest.fixture(autouse=True)
+    def setup(self, request, as_connection):
+        self.keys = [('test', 'demo', 'circuit_breaker_%d' % i)
+                     for i in range(10)]
+        self.clients = []
+
+        def teardown():
+            for client in self.clients:
+                client.close()
+            for key in self.keys:
+                try:
+                    as_connection.remove(key)
+                except e.RecordNotFound:
+                    pass
+
+        request.addfinalizer(teardown)
+
+    def breaker_client(self, **breaker_config):
+        client = TestBaseClass.get_new_connection(
+            {'circuit_breaker': breaker_config})
+        self.clients.append(client)
+        return client
+
+    def test_healthy_nodes_stay_closed(self):
+        client = self.breaker_client(max_timeouts=2, window=5)
+
+        for key in self.keys:
+            client.put(key, {'a': 1})
+            assert client.get(key)[2] == {'a': 1}
+
+        breakers = client.stats()['circuit_breaker']
+        assert len(breakers) >= 1
+        for breaker in breakers.values():
+            assert breaker['state'] == 'closed'
+            assert breaker['trips'] == 0
+            assert breaker['errors'] == 0
+        assert sum(b['requests'] for b in breakers.values()) > 0
+
+    def test_record_errors_do_not_count(self):
+        client = self.breaker_client(error_rate=0.1, window=2)
+
+        for key in self.keys:
+            with pytest.raises(e.RecordNotFound):
+                client.get(key)
+
+        for breaker in client.stats()['circuit_breaker'].values():
+            assert breaker['state'] == 'closed'
+            assert breaker['errors'] == 0
+
+    def test_stats_without_breaker(self):
+        assert self.as_connection.stats()['circuit_breaker'] is None
+
+    @pytest.mark.parametrize(
+        "breaker_config",
+        [
+            {'max_timeouts': -1},
+            {'error_rate': 1.5},
+            {'error_rate': 'x'},
+            {'window': 0},
+            {'open_ms': 'x'},
+            []
+        ],
+        ids=["negative timeouts", "rate above one", "rate not a number",
+             "empty window", "bad open_ms", "not a dict"]
+    )
+    def test_invalid_breaker_config(self, breaker_config):
+        config = dict(self.connection_config)
+        config['circuit_breaker'] = breaker_config
+
+        with pytest.raises(e.ParamError):
+            aerospike.client(config)
@@ -0,0 +1,55 @@
+# -*- coding: utf-8 -*-
+
+import pytest
+import sys
+from .test_base_class import TestBaseClass
+from aerospike import exception as e
+
+aerospike = pytest.importorskip("aerospike")
+try:
+    import aerospike
+except:
+    print("Please install aerospike python client.")
+    sys.exit(1)
+
+
+@pytest.mark.usefixtures("as_connection")
+class TestClusterStats(object):
+
+    def test_nodes(self):
+        stats = self.as_connection.cluster_stats()
+
+        assert len(stats['nodes']) >= 1
+        for name, node in stats['nodes'].items():
+            assert node['active'] is True
+            assert node['connections_in_use'] >= 0
+            assert node['connections_pooled'] >= 0
+            assert node['tend_failures'] >= 0
+            assert node['partition_generation'] >= 0
+            assert ':' in node['address']
+
+    def test_connections_are_pooled_after_use(self):
+        key = ('test', 'demo', 'cluster_stats')
+        self.as_connection.put(key, {'a': 1})
+        self.as_connection.remove(key)
+
+        nodes = self.as_connection.cluster_stats()['nodes'].values()
+
+        assert sum(node['connections_pooled'] for node in nodes) >= 1
+
+    def test_thread_pool(self):
+        pool = self.as_connection.cluster_stats()['thread_pool']
+
+        assert pool['threads'] >= 0
+        assert pool['queued'] >= 0
+
+    def test_unexpected_argument(self):
+        with pytest.raises(TypeError):
+            self.as_connection.cluster_stats('nodes')
+
+    def test_not_connected(self):
+        config = TestBaseClass.get_connection_config()
+        client = aerospike.client(config)
+
+        with pytest.raises(e.ClusterError):
+            client.cluster_stats()
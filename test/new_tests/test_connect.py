@@ -127,6 +127,29 @@ class TestConnect(object):
             assert client.is_connected()
             assert client.shm_key() is not None
 
+    def test_connect_shm_key_not_shared_between_clients(self):
+        """
+            A configured shm_key belongs to the client it was given to, even
+            when another client connects first
+        """
+        config = self.connection_config.copy()
+        config['shm'] = {'shm_key': 5}
+        keyed_client = aerospike.client(config)
+
+        config = self.connection_config.copy()
+        config['shm'] = {}
+        with open_as_connection(config) as client:
+            assert client.shm_key() != 5
+
+        if using_auth:
+            keyed_client.connect(user, password)
+        else:
+            keyed_client.connect()
+        try:
+            assert keyed_client.shm_key() == 5
+        finally:
+            keyed_client.close()
+
     def test_connect_positive_shm_not_enabled(self):
         """
             Invoke connect() with shm not anabled
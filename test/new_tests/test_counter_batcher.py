@@ -0,0 +1,210 @@
+# -*- coding: utf-8 -*-
+
+import pytest
+import sys
+import time
+from .as_status_codes import AerospikeStatus
+from .test_base_class import TestBaseClass
+from aerospike import exception as e
+
+aerospike = pytest.importorskip("aerospike")
+try:
+    import aerospike
+except:
+    print("Please install aerospike python client.")
+    sys.exit(1)
+
+
+@pytest.mark.usefixtures("as_connection")
+class TestCounterBatcher(object):
+
+    @pytest.fixture(autouse=True)
+    def setup(self, request, as_connection):
+        self.keys = [('test', 'demo', 'counter_batcher_%d' % i)
+                     for i in range(3)]
+        for key in self.keys:
+            as_connection.put(key, {'count': 0, 'name': 'counter'})
+
+        def teardown():
+            for key in self.keys:
+                try:
+                    as_connection.remove(key)
+                except e.RecordNotFound:
+                    pass
+
+        request.addfinalizer(teardown)
+
+    def test_increments_are_merged_per_record(self):
+        batcher = self.as_connection.counter_batcher(flush_interval_ms=0)
+
+        for _ in range(10):
+            for key in self.keys:
+                batcher.increment(key, 'count')
+        batcher.increment(self.keys[0], 'count', 5)
+
+        assert batcher.flush() == 3
+        for key in self.keys[1:]:
+            _, meta, bins = self.as_connection.get(key)
+            assert bins['count'] == 10
+            assert meta['gen'] == 2
+        assert self.as_connection.get(self.keys[0])[2]['count'] == 15
+
+        stats = batcher.stats()
+        assert stats['updates'] == 31
+        assert stats['flushes'] == 1
+        assert stats['records'] == 3
+        assert stats['errors'] == 0
+        assert stats['pending'] == 0
+        batcher.close()
+
+    def test_float_increment(self):
+        batcher = self.as_connection.counter_batcher(flush_interval_ms=0)
+
+        batcher.increment(self.keys[0], 'total', 1)
+        batcher.increment(self.keys[0], 'total', 0.5)
+        batcher.close()
+
+        assert self.as_connection.get(self.keys[0])[2]['total'] == 1.5
+
+    def test_list_appends_and_increments_share_an_operate(self):
+        batcher = self.as_connection.counter_batcher(flush_interval_ms=0)
+
+        batcher.list_append(self.keys[0], 'events', 'a')
+        batcher.increment(self.keys[0], 'count', 2)
+        batcher.list_append(self.keys[0], 'events', {'b': [1, 2]})
+        batcher.close()
+
+        _, meta, bins = self.as_connection.get(self.keys[0])
+        assert bins['events'] == ['a', {'b': [1, 2]}]
+        assert bins['count'] == 2
+        assert meta['gen'] == 2
+
+    def test_flush_thread(self):
+        batcher = self.as_connection.counter_batcher(flush_interval_ms=50)
+
+        batcher.increment(self.keys[0], 'count', 3)
+        time.sleep(0.5)
+
+        assert self.as_connection.get(self.keys[0])[2]['count'] == 3
+        assert batcher.stats()['pending'] == 0
+        batcher.close()
+
+    def test_max_pending_flushes(self):
+        batcher = self.as_connection.counter_batcher(flush_interval_ms=0,
+                                                     max_pending=2)
+
+        batcher.increment(self.keys[0], 'count')
+        assert batcher.stats()['pending'] == 1
+        batcher.increment(self.keys[1], 'count')
+
+        assert batcher.stats()['pending'] == 0
+        assert self.as_connection.get(self.keys[1])[2]['count'] == 1
+        batcher.close()
+
+    def test_on_error_receives_failures(self):
+        failures = []
+        batcher = self.as_connection.counter_batcher(
+            flush_interval_ms=0,
+            on_error=lambda key, exc: failures.append((key, exc)))
+
+        batcher.increment(self.keys[0], 'name')
+        batcher.increment(self.keys[1], 'count')
+        batcher.flush()
+
+        assert len(failures) == 1
+        key, exc = failures[0]
+        assert key[0] == 'test'
+        assert key[3] == self.as_connection.get_key_digest(
+            'test', 'demo', 'counter_batcher_0')
+        assert exc.code == AerospikeStatus.AEROSPIKE_ERR_BIN_INCOMPATIBLE_TYPE
+        assert batcher.stats()['errors'] == 1
+        assert self.as_connection.get(self.keys[1])[2]['count'] == 1
+        batcher.close()
+
+    def test_on_error_exception_propagates(self):
+        def on_error(key, exc):
+            raise ValueError("stop")
+
+        batcher = self.as_connection.counter_batcher(flush_interval_ms=0,
+                                                     on_error=on_error)
+        batcher.increment(self.keys[0], 'name')
+
+        with pytest.raises(ValueError):
+            batcher.flush()
+        batcher.close()
+
+    def test_closed_batcher_rejects_updates(self):
+        batcher = self.as_connection.counter_batcher()
+        batcher.increment(self.keys[0], 'count')
+        batcher.close()
+        batcher.close()
+
+        assert self.as_connection.get(self.keys[0])[2]['count'] == 1
+        with pytest.raises(e.ClientError) as err_info:
+            batcher.increment(self.keys[0], 'count')
+        assert err_info.value.code == AerospikeStatus.AEROSPIKE_ERR_CLIENT
+
+    def test_client_close_flushes_and_stops_batchers(self):
+        client = TestBaseClass.get_new_connection()
+        batcher = client.counter_batcher(flush_interval_ms=60000)
+        batcher.increment(self.keys[0], 'count', 3)
+        client.close()
+
+        assert self.as_connection.get(self.keys[0])[2]['count'] == 3
+        with pytest.raises(e.ClusterError):
+            batcher.increment(self.keys[0], 'count')
+        with pytest.raises(e.ClusterError):
+            batcher.flush()
+        batcher.close()
+
+    def test_flush_invalidates_cached_record(self):
+        client = TestBaseClass.get_new_connection(
+            {'cache': {'max_staleness': 60000}})
+        batcher = client.counter_batcher(flush_interval_ms=0)
+        client.get(self.keys[0])
+        batcher.increment(self.keys[0], 'count', 2)
+
+        # Still cached until the write goes out
+        assert client.get(self.keys[0])[2]['count'] == 0
+        batcher.flush()
+        assert client.get(self.keys[0])[2]['count'] == 2
+        batcher.close()
+        client.close()
+
+    @pytest.mark.parametrize(
+        "key, bin, value",
+        [
+            (('test', 'demo', 1), 'count', 'one'),
+            (('test', 'demo', 1), 1, 1),
+            ('test', 'count', 1)
+        ],
+        ids=["string value", "integer bin", "invalid key"]
+    )
+    def test_invalid_increment(self, key, bin, value):
+        batcher = self.as_connection.counter_batcher(flush_interval_ms=0)
+
+        with pytest.raises(e.ParamError):
+            batcher.increment(key, bin, value)
+        batcher.close()
+
+    def test_long_bin_name(self):
+        batcher = self.as_connection.counter_batcher(flush_interval_ms=0)
+
+        with pytest.raises(e.BinNameError):
+            batcher.increment(self.keys[0], 'a' * 20)
+        batcher.close()
+
+    @pytest.mark.parametrize(
+        "kwargs",
+        [
+            {'flush_interval_ms': -1},
+            {'max_pending': 0},
+            {'on_error': 'not callable'},
+            {'policy': 'not a dict'}
+        ],
+        ids=["negative interval", "zero max pending", "bad on_error",
+             "bad policy"]
+    )
+    def test_invalid_batcher_args(self, kwargs):
+        with pytest.raises(e.ParamError):
+            self.as_connection.counter_batcher(**kwargs)
@@ -0,0 +1,93 @@
+# -*- coding: utf-8 -*-
+
+import pytest
+import sys
+from .test_base_class import TestBaseClass
+from aerospike import exception as e
+
+aerospike = pytest.importorskip("aerospike")
+try:
+    import aerospike
+except:
+    print("Please install aerospike python client.")
+    sys.exit(1)
+
+
+@pytest.mark.usefixtures("as_connection")
+class TestDeserializePolicy(object):
+
+    @pytest.fixture(autouse=True)
+    def setup(self, request, as_connection):
+        self.keys = [('test', 'demo', 'deserialize_%d' % i) for i in range(3)]
+        self.records = []
+        for i, key in enumerate(self.keys):
+            record = {
+                'doc': {
+                    'id': i,
+                    'name': u'name_%d_é' % i,
+                    'scores': [1, -1, 300, -70000, 2 ** 40, 1.5, None],
+                    'nested': {'a': [{'b': [i] * 20}], 2: 'two'},
+                    'blob': bytearray(b'\x00\x01'),
+                },
+                'list': [i, 'x' * 100, [], {}],
+                'plain': i,
+            }
+            as_connection.put(key, record)
+            self.records.append(record)
+
+        def teardown():
+            for key in self.keys:
+                try:
+                    as_connection.remove(key)
+                except e.RecordNotFound:
+                    pass
+
+        request.addfinalizer(teardown)
+
+    def test_get_same_as_deserialized(self):
+        for key, record in zip(self.keys, self.records):
+            _, _, raw = self.as_connection.get(key, {'deserialize': False})
+            _, _, tree = self.as_connection.get(key)
+
+            assert raw == tree == record
+
+    def test_select(self):
+        _, _, bins = self.as_connection.select(self.keys[0], ['doc'],
+                                               {'deserialize': False})
+
+        assert bins == {'doc': self.records[0]['doc']}
+
+    def test_get_many(self):
+        records = self.as_connection.get_many(self.keys,
+                                              {'deserialize': False})
+
+        assert [bins for _, _, bins in records] == self.records
+
+    def test_select_many(self):
+        records = self.as_connection.select_many(self.keys, ['list'],
+                                                 {'deserialize': False})
+
+        assert [bins for _, _, bins in records] == [
+            {'list': record['list']} for record in self.records]
+
+    def test_pickled_value_in_list(self):
+        key = self.keys[0]
+        self.as_connection.put(key, {'list': [(1, 2), 3]})
+
+        _, _, bins = self.as_connection.get(key, {'deserialize': False})
+
+        assert bins['list'] == [(1, 2), 3]
+
+    def test_client_default(self):
+        client = TestBaseClass.get_new_connection(
+            {'policies': {'deserialize': False}})
+        try:
+            _, _, bins = client.get(self.keys[1])
+        finally:
+            client.close()
+
+        assert bins == self.records[1]
+
+    def test_invalid_deserialize(self):
+        with pytest.raises(e.ParamError):
+            self.as_connection.get(self.keys[0], {'deserialize': 'no'})
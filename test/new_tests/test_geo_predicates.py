@@ -0,0 +1,87 @@
+# -*- coding: utf-8 -*-
+
+import json
+import pytest
+import sys
+from aerospike import exception as e
+
+aerospike = pytest.importorskip("aerospike")
+try:
+    import aerospike
+    from aerospike import predicates as p
+except:
+    print("Please install aerospike python client.")
+    sys.exit(1)
+
+
+class TestGeoPredicates(object):
+
+    @pytest.mark.parametrize(
+        "lng, lat, radius",
+        [
+            (-122.0, 37.5, 250.2),
+            (-122, 37, 250),
+            (0.1, -1e-07, 1e+16),
+            (10, 20.5, 12345678901234567890123)
+        ],
+        ids=["floats", "integers", "float reprs", "big radius"]
+    )
+    def test_within_radius_matches_json(self, lng, lat, radius):
+        predicate = p.geo_within_radius('loc', lng, lat, radius)
+
+        assert predicate[2] == 'loc'
+        assert predicate[3] == json.dumps(
+            {"type": "AeroCircle", "coordinates": [[lng, lat], radius]})
+        assert predicate[4] is None
+        assert predicate[5] == aerospike.INDEX_TYPE_DEFAULT
+
+    def test_contains_point_matches_json(self):
+        predicate = p.geo_contains_point('loc', -121.7, 37)
+
+        assert predicate[3] == json.dumps(
+            {"type": "Point", "coordinates": [-121.7, 37]})
+        assert predicate[5] == aerospike.INDEX_TYPE_DEFAULT
+
+    def test_index_type(self):
+        predicate = p.geo_contains_point('loc', 1.0, 2.0,
+                                         aerospike.INDEX_TYPE_LIST)
+
+        assert predicate[5] == aerospike.INDEX_TYPE_LIST
+
+    def test_within_radius_many(self):
+        points = [(-122.0, 37.5), [1, 2], (0.5, -0.5)]
+
+        predicates = p.geo_within_radius_many('loc', points, 100.0)
+
+        assert predicates == [p.geo_within_radius('loc', lng, lat, 100.0)
+                              for lng, lat in points]
+
+    def test_within_radius_many_index_type(self):
+        predicates = p.geo_within_radius_many(
+            'loc', [(1.0, 2.0)], 10, aerospike.INDEX_TYPE_MAPVALUES)
+
+        assert predicates[0][5] == aerospike.INDEX_TYPE_MAPVALUES
+
+    def test_within_radius_many_empty(self):
+        assert p.geo_within_radius_many('loc', [], 10.0) == []
+
+    @pytest.mark.parametrize(
+        "bin, points, radius",
+        [
+            ('loc', [(1.0, 2.0, 3.0)], 10.0),
+            ('loc', [(1.0, 'a')], 10.0),
+            ('loc', [1.0], 10.0),
+            ('loc', 5, 10.0),
+            ('loc', [(1.0, 2.0)], 'a'),
+            (1, [(1.0, 2.0)], 10.0)
+        ],
+        ids=["three coordinates", "string coordinate", "not a pair",
+             "not a list", "string radius", "integer bin"]
+    )
+    def test_within_radius_many_invalid(self, bin, points, radius):
+        with pytest.raises(e.ParamError):
+            p.geo_within_radius_many(bin, points, radius)
+
+    def test_within_radius_invalid(self):
+        with pytest.raises(e.ParamError):
+            p.geo_within_radius('loc', 'a', 1.0, 10.0)
@@ -0,0 +1,129 @@
+# -*- coding: utf-8 -*-
+
+import json
+import pytest
+import sys
+from .test_base_class import TestBaseClass
+from aerospike import exception as e
+
+aerospike = pytest.importorskip("aerospike")
+try:
+    import aerospike
+except:
+    print("Please install aerospike python client.")
+    sys.exit(1)
+
+
+class TestGeoJSONCodec(object):
+
+    @pytest.mark.parametrize(
+        "geo_data",
+        [
+            {"type": "Point", "coordinates": [-122.0, 37.5]},
+            {"type": "Point", "coordinates": [1, -2]},
+            {"type": "Polygon",
+             "coordinates": [[[-122.5, 37.0], [-121.0, 37.0],
+                              [-121.0, 38.08], [-122.5, 37.0]]]},
+            {"type": "AeroCircle", "coordinates": [[-122.0, 37.0], 250.2]},
+            {"type": "Point", "coordinates": (0.1, 1e+16),
+             "properties": {u"näme": u"café \U0001f600",
+                            "quote": "a\"b\\c\n", "ok": True,
+                            "missing": None}}
+        ],
+        ids=["point", "integer point", "polygon", "circle", "properties"]
+    )
+    def test_dumps_matches_json(self, geo_data):
+        geo = aerospike.GeoJSON(geo_data)
+
+        assert geo.dumps() == json.dumps(geo_data)
+        assert str(geo) == json.dumps(geo_data)
+
+    def test_dumps_falls_back_to_json(self):
+        geo_data = {"type": "Point", "coordinates": [1.0, 2.0], 1: 2}
+        geo = aerospike.GeoJSON(geo_data)
+
+        assert geo.dumps() == json.dumps(geo_data)
+
+    @pytest.mark.parametrize(
+        "text",
+        [
+            '{"type": "Point", "coordinates": [-122.0, 37.5]}',
+            '{"type":"AeroCircle","coordinates":[[-1.5e2,3E-1],-0]}',
+            ' { "type" : "Point" , "coordinates" : [ 1 , 2 ] ,'
+            ' "p" : { "s" : "\\u00e9\\ud83d\\ude00\\/" , "n" : null ,'
+            ' "t" : true , "f" : false , "big" : 123456789012345678901 } } ',
+            '{"type": "Point", "coordinates": [-Infinity, Infinity]}'
+        ],
+        ids=["point", "compact", "whitespace and escapes", "json extensions"]
+    )
+    def test_loads_matches_json(self, text):
+        geo = aerospike.geojson(text)
+
+        assert geo.unwrap() == json.loads(text)
+
+    @pytest.mark.parametrize(
+        "text",
+        [
+            '{"type": "Point", "coordinates": [1, 2]',
+            '{"type": "Point", "coordinates": [01, 2]}',
+            '{"type": "Point"} x'
+        ],
+        ids=["unterminated", "leading zero", "trailing text"]
+    )
+    def test_loads_invalid(self, text):
+        with pytest.raises(e.ClientError):
+            aerospike.geojson(text)
+
+
+@pytest.mark.usefixtures("as_connection")
+class TestGeoJSONRead(object):
+
+    pytestmark = pytest.mark.skipif(
+        not TestBaseClass.has_geo_support(),
+        reason="Server does not support geospatial data.")
+
+    @pytest.fixture(autouse=True)
+    def setup(self, request, as_connection):
+        self.key = ('test', 'demo', 'geojson_codec')
+        self.geo_data = {"type": "Point", "coordinates": [-122.0, 37.5]}
+        as_connection.put(self.key, {'loc': aerospike.GeoJSON(self.geo_data)})
+
+        def teardown():
+            as_connection.remove(self.key)
+
+        request.addfinalizer(teardown)
+
+    def test_read_value(self):
+        loc = self.as_connection.get(self.key)[2]['loc']
+
+        assert str(loc) == json.dumps(self.geo_data)
+        assert loc.geo_data == self.geo_data
+        assert loc.unwrap() == self.geo_data
+
+    def test_write_back_unchanged(self):
+        loc = self.as_connection.get(self.key)[2]['loc']
+        other = ('test', 'demo', 'geojson_codec_copy')
+
+        self.as_connection.put(other, {'loc': loc})
+        copied = self.as_connection.get(other)[2]['loc']
+        self.as_connection.remove(other)
+
+        assert copied.unwrap() == self.geo_data
+
+    def test_changed_geo_data_is_written(self):
+        loc = self.as_connection.get(self.key)[2]['loc']
+        loc.geo_data['coordinates'] = [10.0, 20.0]
+
+        self.as_connection.put(self.key, {'loc': loc})
+
+        assert self.as_connection.get(self.key)[2]['loc'].unwrap() == \
+            {"type": "Point", "coordinates": [10.0, 20.0]}
+
+    def test_assigned_geo_data_is_written(self):
+        loc = self.as_connection.get(self.key)[2]['loc']
+        loc.geo_data = {"type": "Point", "coordinates": [1.0, 2.0]}
+
+        self.as_connection.put(self.key, {'loc': loc})
+
+        assert self.as_connection.get(self.key)[2]['loc'].unwrap() == \
+            {"type": "Point", "coordinates": [1.0, 2.0]}
@@ -23,6 +23,15 @@ class SomeClass(object):
     pass
 
 
+# Share their names with aerospike.null and the Geospatial type
+class null(object):
+    pass
+
+
+class Geospatial(object):
+    pass
+
+
 @pytest.mark.usefixtures("as_connection")
 class TestGetPut():
 
@@ -854,3 +863,19 @@ class TestGetPut():
             assert exception.msg == 'integer value for KEY exceeds sys.maxsize'
         except SystemError as exception:
             pass
+
+    @pytest.mark.parametrize("value", [null(), Geospatial()],
+                             ids=["null", "Geospatial"])
+    def test_put_lookalike_of_client_type(self, value):
+        """
+            Objects of other classes named like the client's types are
+            serialized, not taken for them
+        """
+        key = ('test', 'demo', 'lookalike')
+
+        self.as_connection.put(key, {'a': value},
+                               serializer=aerospike.SERIALIZER_PYTHON)
+        _, _, bins = self.as_connection.get(key)
+        self.as_connection.remove(key)
+
+        assert type(bins['a']) is type(value)
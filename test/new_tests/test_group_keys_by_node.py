@@ -0,0 +1,81 @@
+# -*- coding: utf-8 -*-
+
+import pytest
+import sys
+from .test_base_class import TestBaseClass
+from aerospike import exception as e
+
+aerospike = pytest.importorskip("aerospike")
+try:
+    import aerospike
+except:
+    print("Please install aerospike python client.")
+    sys.exit(1)
+
+
+@pytest.mark.usefixtures("as_connection")
+class TestGroupKeysByNode(object):
+
+    keys = [('test', 'demo', i) for i in range(50)]
+
+    def test_groups_every_key_once(self):
+        groups = self.as_connection.group_keys_by_node(self.keys)
+
+        grouped = [key for group in groups.values() for key in group]
+        assert sorted(grouped) == sorted(self.keys)
+        node_names = set(self.as_connection.cluster_stats()['nodes'])
+        assert set(groups) <= node_names
+
+    def test_indexes(self):
+        groups = self.as_connection.group_keys_by_node(self.keys, indexes=True)
+        by_key = self.as_connection.group_keys_by_node(self.keys)
+
+        assert sorted(i for group in groups.values() for i in group) == list(range(len(self.keys)))
+        for node, indexes in groups.items():
+            assert [self.keys[i] for i in indexes] == by_key[node]
+
+    def test_digest_keys_group_with_their_keys(self):
+        digest = aerospike.calc_digest('test', 'demo', 1)
+        keys = [('test', 'demo', 1), ('test', 'demo', None, digest)]
+
+        groups = self.as_connection.group_keys_by_node(keys, indexes=True)
+
+        assert list(groups.values()) == [[0, 1]]
+
+    @pytest.mark.parametrize("replica", [aerospike.POLICY_REPLICA_MASTER,
+                                         aerospike.POLICY_REPLICA_ANY,
+                                         aerospike.POLICY_REPLICA_SEQUENCE])
+    def test_replica(self, replica):
+        groups = self.as_connection.group_keys_by_node(self.keys, replica=replica)
+
+        assert sum(len(group) for group in groups.values()) == len(self.keys)
+
+    def test_replica_any_groups_by_master(self):
+        master = self.as_connection.group_keys_by_node(
+            self.keys, replica=aerospike.POLICY_REPLICA_MASTER)
+
+        for _ in range(3):
+            assert self.as_connection.group_keys_by_node(
+                self.keys, replica=aerospike.POLICY_REPLICA_ANY) == master
+
+    def test_empty_keys(self):
+        assert self.as_connection.group_keys_by_node([]) == {}
+
+    @pytest.mark.parametrize(
+        "keys, replica",
+        [
+            ('keys', aerospike.POLICY_REPLICA_MASTER),
+            ([('test', 'demo')], aerospike.POLICY_REPLICA_MASTER),
+            ([('test', 'demo', 1)], 42),
+        ],
+        ids=["keys not a list", "invalid key", "invalid replica"]
+    )
+    def test_invalid_arguments(self, keys, replica):
+        with pytest.raises(e.ParamError):
+            self.as_connection.group_keys_by_node(keys, replica=replica)
+
+    def test_not_connected(self):
+        client = aerospike.client(TestBaseClass.get_connection_config())
+
+        with pytest.raises(e.ClusterError):
+            client.group_keys_by_node(self.keys)
@@ -0,0 +1,85 @@
+# -*- coding: utf-8 -*-
+
+import pytest
+import sys
+from aerospike import exception as e
+
+aerospike = pytest.importorskip("aerospike")
+try:
+    import aerospike
+except:
+    print("Please install aerospike python client.")
+    sys.exit(1)
+
+
+@pytest.mark.usefixtures("as_connection")
+class TestHedgedReads(object):
+
+    @pytest.fixture(autouse=True)
+    def setup(self, request, as_connection):
+        self.key = ('test', 'demo', 'hedged_reads')
+        as_connection.put(self.key, {'name': 'hedged', 'age': 1})
+
+        def teardown():
+            as_connection.remove(self.key)
+
+        request.addfinalizer(teardown)
+
+    def test_get(self):
+        before = self.as_connection.hedge_stats()
+
+        _, meta, bins = self.as_connection.get(self.key,
+                                               {'hedge_after_ms': 50})
+
+        assert bins == {'name': 'hedged', 'age': 1}
+        assert meta['gen'] == 1
+        after = self.as_connection.hedge_stats()
+        assert after['reads'] == before['reads'] + 1
+
+    def test_select(self):
+        _, _, bins = self.as_connection.select(self.key, ['age'],
+                                               {'hedge_after_ms': 50})
+
+        assert bins == {'age': 1}
+
+    def test_exists(self):
+        _, meta = self.as_connection.exists(self.key, {'hedge_after_ms': 50})
+
+        assert meta['gen'] == 1
+
+    def test_hedge_fires_immediately(self):
+        before = self.as_connection.hedge_stats()
+
+        for _ in range(20):
+            _, _, bins = self.as_connection.get(self.key,
+                                                {'hedge_after_ms': 1})
+            assert bins['name'] == 'hedged'
+
+        after = self.as_connection.hedge_stats()
+        assert after['reads'] == before['reads'] + 20
+        assert after['hedged'] >= before['hedged']
+        assert after['hedge_wins'] - before['hedge_wins'] <= \
+            after['hedged'] - before['hedged']
+
+    def test_missing_record(self):
+        missing = ('test', 'demo', 'hedged_reads_missing')
+
+        with pytest.raises(e.RecordNotFound):
+            self.as_connection.get(missing, {'hedge_after_ms': 1})
+        assert self.as_connection.get(
+            missing, {'hedge_after_ms': 1, 'not_found': 'none'}) is None
+        assert self.as_connection.exists(missing,
+                                         {'hedge_after_ms': 1})[1] is None
+
+    def test_zero_disables_hedging(self):
+        before = self.as_connection.hedge_stats()
+
+        self.as_connection.get(self.key, {'hedge_after_ms': 0})
+
+        assert self.as_connection.hedge_stats() == before
+
+    @pytest.mark.parametrize("hedge_after_ms", [-1, '5', 1.5])
+    def test_invalid_hedge_after_ms(self, hedge_after_ms):
+        with pytest.raises(e.ParamError):
+            self.as_connection.get(self.key,
+                                   {'hedge_after_ms': hedge_after_ms})
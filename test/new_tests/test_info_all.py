@@ -0,0 +1,96 @@
+# -*- coding: utf-8 -*-
+
+import pytest
+import sys
+
+from aerospike import exception as e
+
+aerospike = pytest.importorskip("aerospike")
+try:
+    import aerospike
+except:
+    print("Please install aerospike python client.")
+    sys.exit(1)
+
+
+@pytest.mark.usefixtures("as_connection", "connection_config")
+class TestInfoAll(object):
+
+    def test_info_all_statistics_parsed(self):
+        nodes_info = self.as_connection.info_all('statistics')
+
+        assert len(nodes_info) > 0
+        for error, stats in nodes_info.values():
+            assert error is None
+            assert isinstance(stats, dict)
+            assert isinstance(stats['uptime'], int)
+
+    def test_info_all_answers_every_node(self):
+        nodes_info = self.as_connection.info_all('node')
+
+        for name, (error, node) in nodes_info.items():
+            assert error is None
+            assert node == name
+
+    def test_info_all_namespaces_list(self):
+        nodes_info = self.as_connection.info_all('namespaces')
+
+        for _, namespaces in nodes_info.values():
+            if not isinstance(namespaces, list):
+                namespaces = [namespaces]
+            assert 'test' in namespaces
+
+    def test_info_all_sets_list_of_dicts(self):
+        key = ('test', 'demo', 'info_all_key')
+        self.as_connection.put(key, {'a': 1})
+
+        nodes_info = self.as_connection.info_all('sets')
+        self.as_connection.remove(key)
+
+        found = False
+        for _, sets in nodes_info.values():
+            for set_info in sets:
+                if set_info['ns'] == 'test' and set_info['set'] == 'demo':
+                    found = True
+        assert found
+
+    def test_info_all_unparsed(self):
+        nodes_info = self.as_connection.info_all('statistics', parse=False)
+
+        for _, stats in nodes_info.values():
+            assert isinstance(stats, str)
+            assert not stats.startswith('statistics')
+            assert 'uptime=' in stats
+
+    def test_info_all_multiple_commands(self):
+        nodes_info = self.as_connection.info_all('node\nnamespaces')
+
+        for name, (_, response) in nodes_info.items():
+            assert response['node'] == name
+            assert 'namespaces' in response
+
+    def test_info_all_with_policy(self):
+        nodes_info = self.as_connection.info_all('statistics', True,
+                                                 {'timeout': 1000})
+
+        assert len(nodes_info) > 0
+
+    def test_info_all_without_command(self):
+        with pytest.raises(TypeError):
+            self.as_connection.info_all()
+
+    def test_info_all_invalid_command_type(self):
+        with pytest.raises(e.ParamError) as err_info:
+            self.as_connection.info_all(1)
+
+        assert err_info.value.msg == "Request must be a string"
+
+    def test_info_all_invalid_policy(self):
+        with pytest.raises(e.ParamError):
+            self.as_connection.info_all('statistics', policy=5)
+
+    def test_info_all_on_unconnected_client(self):
+        client = aerospike.client(self.connection_config)
+
+        with pytest.raises(e.ClusterError):
+            client.info_all('statistics')
@@ -0,0 +1,159 @@
+# -*- coding: utf-8 -*-
+
+import io
+import pytest
+import sys
+from aerospike import exception as e
+from .as_status_codes import AerospikeStatus
+
+aerospike = pytest.importorskip("aerospike")
+try:
+    import aerospike
+except:
+    print("Please install aerospike python client.")
+    sys.exit(1)
+
+
+@pytest.mark.usefixtures("as_connection")
+class TestLoadFile(object):
+
+    @pytest.fixture(autouse=True)
+    def setup(self, request, as_connection, tmpdir):
+        self.set_name = 'load_file'
+        self.path = str(tmpdir.join('input'))
+        self.reject_path = str(tmpdir.join('rejects'))
+        self.keys = []
+
+        def teardown():
+            for key in self.keys:
+                try:
+                    as_connection.remove(key)
+                except e.RecordNotFound:
+                    pass
+
+        request.addfinalizer(teardown)
+
+    def write_input(self, text):
+        with io.open(self.path, 'w', encoding='utf-8') as input_file:
+            input_file.write(text)
+
+    def test_load_ndjson(self):
+        self.write_input(u''.join(
+            u'{"id": %d, "name": "n\\"%d", "l": [1, 2.5], "m": {"a": true},'
+            u' "u": "\\u00e9", "skip": null}\n' % (i, i) for i in range(100)))
+        self.keys = [('test', self.set_name, i) for i in range(100)]
+
+        stats = self.as_connection.load_file(self.path, 'test',
+                                             self.set_name, 'id')
+
+        assert stats == {'records': 100, 'errors': 0}
+        _, _, bins = self.as_connection.get(('test', self.set_name, 7))
+        assert bins == {'id': 7, 'name': 'n"7', 'l': [1, 2.5],
+                        'm': {'a': 1}, 'u': u'\xe9'}
+
+    def test_load_csv(self):
+        self.write_input(u'key,age,score,name\n'
+                         u'a,1,1.5,"x,y"\n'
+                         u'b,2,,"say ""hi"""\n'
+                         u'c,3,2.5,007\n')
+        self.keys = [('test', self.set_name, k) for k in ('a', 'b', 'c')]
+
+        stats = self.as_connection.load_file(self.path, 'test',
+                                             self.set_name, 'key',
+                                             format='csv', concurrency=2)
+
+        assert stats == {'records': 3, 'errors': 0}
+        _, _, bins = self.as_connection.get(('test', self.set_name, 'a'))
+        assert bins == {'key': 'a', 'age': 1, 'score': 1.5, 'name': 'x,y'}
+        _, _, bins = self.as_connection.get(('test', self.set_name, 'b'))
+        assert bins == {'key': 'b', 'age': 2, 'name': 'say "hi"'}
+        _, _, bins = self.as_connection.get(('test', self.set_name, 'c'))
+        assert bins['name'] == 7
+
+    def test_rejects_are_reported(self):
+        self.write_input(u'{"id": 1, "a": 1}\n'
+                         u'{"id": 2, "a": \n'
+                         u'{"a": 3}\n'
+                         u'\n'
+                         u'{"id": 4, "a_very_long_bin_name": 1}\n')
+        self.keys = [('test', self.set_name, 1)]
+
+        stats = self.as_connection.load_file(self.path, 'test',
+                                             self.set_name, 'id',
+                                             reject_path=self.reject_path)
+
+        assert stats == {'records': 1, 'errors': 3}
+        with io.open(self.reject_path, encoding='utf-8') as reject_file:
+            rejects = [line.rstrip(u'\n').split(u'\t', 3)
+                       for line in reject_file]
+        assert sorted(int(r[0]) for r in rejects) == [2, 3, 5]
+        for line_no, code, _, line in rejects:
+            if line_no == u'5':
+                assert int(code) == AerospikeStatus.AEROSPIKE_ERR_BIN_NAME
+                assert line == u'{"id": 4, "a_very_long_bin_name": 1}'
+            else:
+                assert int(code) == AerospikeStatus.AEROSPIKE_ERR_PARAM
+
+    def test_rejects_embedded_nul(self):
+        self.write_input(u'{"id": 1, "s": "a\\u0000b"}\n'
+                         u'{"id": 2, "s": "ab"}\n')
+        self.keys = [('test', self.set_name, 1), ('test', self.set_name, 2)]
+
+        stats = self.as_connection.load_file(self.path, 'test',
+                                             self.set_name, 'id')
+
+        assert stats == {'records': 1, 'errors': 1}
+        with pytest.raises(e.RecordNotFound):
+            self.as_connection.get(self.keys[0])
+
+    def test_csv_wrong_field_count(self):
+        self.write_input(u'id,a\n1,2,3\n')
+
+        stats = self.as_connection.load_file(self.path, 'test',
+                                             self.set_name, 'id',
+                                             format='csv')
+
+        assert stats == {'records': 0, 'errors': 1}
+
+    def test_load_with_rate_and_policy(self):
+        self.write_input(u''.join(u'{"id": %d}\n' % i for i in range(20)))
+        self.keys = [('test', self.set_name, i) for i in range(20)]
+
+        stats = self.as_connection.load_file(
+            self.path, 'test', self.set_name, 'id', rate=1000,
+            policy={'key': aerospike.POLICY_KEY_SEND})
+
+        assert stats['records'] == 20
+        key, _, _ = self.as_connection.get(('test', self.set_name, 3))
+        assert key[2] == 3
+
+    @pytest.mark.parametrize(
+        "kwargs",
+        [
+            {'format': 'xml'},
+            {'concurrency': 0},
+            {'concurrency': 1000},
+        ],
+        ids=[
+            "unknown format",
+            "zero concurrency",
+            "concurrency too high"
+        ]
+    )
+    def test_load_invalid_args(self, kwargs):
+        self.write_input(u'{"id": 1}\n')
+
+        with pytest.raises(e.ParamError) as err_info:
+            self.as_connection.load_file(self.path, 'test', self.set_name,
+                                         'id', **kwargs)
+
+        assert err_info.value.code == AerospikeStatus.AEROSPIKE_ERR_PARAM
+
+    def test_load_missing_file(self):
+        with pytest.raises(e.ClientError):
+            self.as_connection.load_file(self.path + 'missing', 'test',
+                                         self.set_name, 'id')
+
+    def test_load_without_key_field(self):
+        with pytest.raises(TypeError):
+            self.as_connection.load_file(self.path, 'test', self.set_name)
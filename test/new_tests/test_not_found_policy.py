@@ -0,0 +1,89 @@
+# -*- coding: utf-8 -*-
+
+import pytest
+import sys
+from .as_status_codes import AerospikeStatus
+from aerospike import exception as e
+
+aerospike = pytest.importorskip("aerospike")
+try:
+    import aerospike
+except:
+    print("Please install aerospike python client.")
+    sys.exit(1)
+
+
+@pytest.mark.usefixtures("as_connection")
+class TestNotFoundPolicy(object):
+
+    @pytest.fixture(autouse=True)
+    def setup(self, request, as_connection):
+        self.key = ('test', 'demo', 'not_found_policy')
+        self.missing = ('test', 'demo', 'not_found_policy_missing')
+        as_connection.put(self.key, {'name': 'existing', 'age': 1})
+
+        def teardown():
+            as_connection.remove(self.key)
+
+        request.addfinalizer(teardown)
+
+    def test_get_returns_none(self):
+        assert self.as_connection.get(
+            self.missing, {'not_found': 'none'}) is None
+
+    def test_select_returns_none(self):
+        assert self.as_connection.select(
+            self.missing, ['name'], {'not_found': 'none'}) is None
+
+    def test_operate_returns_none(self):
+        ops = [{'op': aerospike.OPERATOR_READ, 'bin': 'name'}]
+
+        assert self.as_connection.operate(
+            self.missing, ops, policy={'not_found': 'none'}) is None
+
+    def test_existing_record_is_returned(self):
+        _, _, bins = self.as_connection.get(self.key, {'not_found': 'none'})
+
+        assert bins == {'name': 'existing', 'age': 1}
+
+    def test_raise_is_the_default(self):
+        with pytest.raises(e.RecordNotFound) as err_info:
+            self.as_connection.get(self.missing, {'not_found': 'raise'})
+        assert err_info.value.code == \
+            AerospikeStatus.AEROSPIKE_ERR_RECORD_NOT_FOUND
+
+        with pytest.raises(e.RecordNotFound):
+            self.as_connection.get(self.missing)
+
+    def test_other_errors_still_raise(self):
+        with pytest.raises(e.NamespaceNotFound):
+            self.as_connection.get(('namespace', 'demo', 1),
+                                   {'not_found': 'none'})
+
+    @pytest.mark.parametrize("not_found", ['None', None, 1])
+    def test_invalid_not_found(self, not_found):
+        with pytest.raises(e.ParamError):
+            self.as_connection.get(self.key, {'not_found': not_found})
+
+
+class TestExceptionDispatch(object):
+
+    @pytest.mark.parametrize(
+        "exception, code",
+        [
+            (e.ParamError, AerospikeStatus.AEROSPIKE_ERR_PARAM),
+            (e.ClientError, AerospikeStatus.AEROSPIKE_ERR_CLIENT),
+            (e.RecordNotFound, AerospikeStatus.AEROSPIKE_ERR_RECORD_NOT_FOUND),
+            (e.BinNameError, AerospikeStatus.AEROSPIKE_ERR_BIN_NAME),
+            (e.ClusterError, AerospikeStatus.AEROSPIKE_CLUSTER_ERROR)
+        ]
+    )
+    def test_codes_are_unchanged(self, exception, code):
+        assert exception.code == code
+
+    def test_param_error_is_raised_with_message(self):
+        with pytest.raises(e.ParamError) as err_info:
+            aerospike.client({'hosts': [3000]})
+
+        assert err_info.value.code == AerospikeStatus.AEROSPIKE_ERR_PARAM
+        assert err_info.value.msg
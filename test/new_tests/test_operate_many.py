@@ -0,0 +1,104 @@
+# -*- coding: utf-8 -*-
+
+import pytest
+import sys
+from .as_status_codes import AerospikeStatus
+from aerospike import exception as e
+
+aerospike = pytest.importorskip("aerospike")
+try:
+    import aerospike
+except:
+    print("Please install aerospike python client.")
+    sys.exit(1)
+
+
+@pytest.mark.usefixtures("as_connection")
+class TestOperateMany(object):
+
+    @pytest.fixture(autouse=True)
+    def setup(self, request, as_connection):
+        self.keys = [('test', 'demo', 'operate_many_%d' % i)
+                     for i in range(20)]
+        for key in self.keys:
+            as_connection.put(key, {'features': {'a': 1}, 'events': [1],
+                                    'name': 'operate_many'})
+
+        def teardown():
+            for key in self.keys:
+                try:
+                    as_connection.remove(key)
+                except e.RecordNotFound:
+                    pass
+
+        request.addfinalizer(teardown)
+
+    def test_map_put_many(self):
+        results = self.as_connection.map_put_many(self.keys, 'features',
+                                                  'b', 2)
+
+        assert results == [0] * len(self.keys)
+        for key in self.keys:
+            bins = self.as_connection.get(key)[2]
+            assert bins['features'] == {'a': 1, 'b': 2}
+
+    def test_map_put_items_many(self):
+        results = self.as_connection.map_put_items_many(
+            self.keys, 'features', {'b': 2, 'c': [3]}, concurrency=4)
+
+        assert results == [0] * len(self.keys)
+        for key in self.keys:
+            bins = self.as_connection.get(key)[2]
+            assert bins['features'] == {'a': 1, 'b': 2, 'c': [3]}
+
+    def test_list_append_many(self):
+        results = self.as_connection.list_append_many(
+            self.keys, 'events', {'type': 'login'}, meta={'ttl': 1000},
+            concurrency=1)
+
+        assert results == [0] * len(self.keys)
+        for key in self.keys:
+            _, meta, bins = self.as_connection.get(key)
+            assert bins['events'] == [1, {'type': 'login'}]
+            assert meta['gen'] == 2
+
+    def test_creates_missing_records(self):
+        new_key = ('test', 'demo', 'operate_many_new')
+        self.keys.append(new_key)
+
+        assert self.as_connection.list_append_many([new_key], 'events',
+                                                   1) == [0]
+        assert self.as_connection.get(new_key)[2]['events'] == [1]
+
+    def test_per_key_errors(self):
+        results = self.as_connection.map_put_many(self.keys[:2], 'name',
+                                                  'b', 2)
+
+        assert len(results) == 2
+        for result in results:
+            assert isinstance(result, e.BinIncompatibleType)
+            assert result.code == \
+                AerospikeStatus.AEROSPIKE_ERR_BIN_INCOMPATIBLE_TYPE
+
+    def test_empty_keys(self):
+        assert self.as_connection.list_append_many([], 'events', 1) == []
+
+    @pytest.mark.parametrize(
+        "args, kwargs",
+        [
+            (('not a list', 'events', 1), {}),
+            (([('test', 'demo')], 'events', 1), {}),
+            (([('test', 'demo', 1)], 1, 1), {}),
+            (([('test', 'demo', 1)], 'events', 1), {'concurrency': 0}),
+            (([('test', 'demo', 1)], 'events', 1), {'policy': 'policy'})
+        ],
+        ids=["keys not a list", "invalid key", "integer bin",
+             "zero concurrency", "invalid policy"]
+    )
+    def test_invalid_args(self, args, kwargs):
+        with pytest.raises(e.ParamError):
+            self.as_connection.list_append_many(*args, **kwargs)
+
+    def test_long_bin_name(self):
+        with pytest.raises(e.BinNameError):
+            self.as_connection.map_put_many(self.keys, 'a' * 20, 'b', 2)
@@ -0,0 +1,112 @@
+# -*- coding: utf-8 -*-
+
+import os
+import pytest
+import sys
+from .test_base_class import TestBaseClass
+
+aerospike = pytest.importorskip("aerospike")
+try:
+    import aerospike
+    from aerospike import exception as e
+except:
+    print("Please install aerospike python client.")
+    sys.exit(1)
+
+
+def _run_in_child(func):
+    """
+    Fork, run func in the child and return the child's exit status
+    """
+    pid = os.fork()
+    if pid == 0:
+        status = 1
+        try:
+            if func():
+                status = 0
+        finally:
+            os._exit(status)
+    _, status = os.waitpid(pid, 0)
+    return os.WEXITSTATUS(status)
+
+
+class TestPostFork(object):
+
+    def setup_class(cls):
+        cls.config = TestBaseClass.get_connection_config()
+        cls.key = ('test', 'demo', 'post_fork')
+
+    def setup_method(self, method):
+        self.client = TestBaseClass.get_new_connection()
+        self.client.put(self.key, {'worker': 'parent'})
+
+    def teardown_method(self, method):
+        try:
+            self.client.remove(self.key)
+        except e.RecordNotFound:
+            pass
+        self.client.close()
+
+    def test_post_fork_without_fork_is_noop(self):
+        """
+        Invoke post_fork() in the process which connected the client
+        """
+        assert self.client.post_fork() is None
+        assert self.client.is_connected()
+        _, _, bins = self.client.get(self.key)
+        assert bins == {'worker': 'parent'}
+
+    def test_post_fork_before_connect(self):
+        """
+        Invoke post_fork() on a client which was never connected
+        """
+        client = aerospike.client(self.config)
+        assert client.post_fork() is None
+        assert client.is_connected() is False
+
+    def test_post_fork_in_child(self):
+        """
+        A child rebuilds the inherited connection and can issue commands
+        """
+        def child():
+            self.client.post_fork()
+            _, _, bins = self.client.get(self.key)
+            return bins == {'worker': 'parent'}
+
+        assert _run_in_child(child) == 0
+        # The parent's connection is unaffected by the child
+        _, _, bins = self.client.get(self.key)
+        assert bins == {'worker': 'parent'}
+
+    def test_close_in_child_without_post_fork(self):
+        """
+        Closing an inherited connection in the child must not hang
+        """
+        def child():
+            self.client.close()
+            return self.client.is_connected() is False
+
+        assert _run_in_child(child) == 0
+        assert self.client.is_connected()
+
+    def test_post_fork_shared_connection(self):
+        """
+        Shared clients in a child are rebuilt once and reuse the new handle
+        """
+        shared = {'use_shared_connection': True}
+        client1 = TestBaseClass.get_new_connection(shared)
+        client2 = TestBaseClass.get_new_connection(shared)
+
+        def child():
+            client1.post_fork()
+            client2.post_fork()
+            _, _, bins1 = client1.get(self.key)
+            _, _, bins2 = client2.get(self.key)
+            client1.close()
+            return bins1 == bins2 == {'worker': 'parent'}
+
+        try:
+            assert _run_in_child(child) == 0
+        finally:
+            client1.close()
+            client2.close()
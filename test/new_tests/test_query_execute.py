@@ -0,0 +1,180 @@
+# -*- coding: utf-8 -*-
+
+import pytest
+import sys
+from .test_base_class import TestBaseClass
+from .as_status_codes import AerospikeStatus
+from aerospike import exception as e
+from aerospike import predicates as p
+
+aerospike = pytest.importorskip("aerospike")
+try:
+    import aerospike
+except:
+    print("Please install aerospike python client.")
+    sys.exit(1)
+
+
+class TestQueryExecute(TestBaseClass):
+
+    def setup_class(cls):
+        client = TestBaseClass.get_new_connection()
+        client.index_integer_create('test', 'demo', 'exec_age',
+                                    'exec_age_index')
+        client.index_string_create('test', 'demo', 'exec_name',
+                                   'exec_name_index')
+        client.close()
+
+    def teardown_class(cls):
+        client = TestBaseClass.get_new_connection()
+        client.index_remove('test', 'exec_age_index')
+        client.index_remove('test', 'exec_name_index')
+        client.close()
+
+    @pytest.fixture(autouse=True)
+    def setup_method(self, request, as_connection):
+        """
+        Setup method.
+        """
+        self.keys = []
+        for i in range(10):
+            key = ('test', 'demo', 'exec_%d' % i)
+            self.as_connection.put(key, {'exec_age': i,
+                                         'exec_name': 'name%d' % i,
+                                         'other': i})
+            self.keys.append(key)
+
+        def teardown():
+            for key in self.keys:
+                self.as_connection.remove(key)
+
+        request.addfinalizer(teardown)
+
+    def test_execute_without_params_repeats_query(self):
+        query = self.as_connection.query('test', 'demo')
+        query.where(p.between('exec_age', 0, 4))
+
+        first = query.execute()
+        second = query.execute()
+
+        assert len(first) == 5
+        assert len(second) == 5
+
+    def test_results_can_run_repeatedly(self):
+        query = self.as_connection.query('test', 'demo')
+        query.where(p.equals('exec_age', 3))
+
+        for _ in range(3):
+            records = query.results()
+            assert len(records) == 1
+
+    def test_execute_rebinds_range(self):
+        query = self.as_connection.query('test', 'demo')
+        query.where(p.between('exec_age', 0, 0))
+
+        assert len(query.execute()) == 1
+        assert len(query.execute((0, 5))) == 6
+        assert len(query.execute([8, 9])) == 2
+
+    def test_execute_rebinds_numeric_equals(self):
+        query = self.as_connection.query('test', 'demo')
+        query.where(p.equals('exec_age', 1))
+
+        records = query.execute((7,))
+
+        assert len(records) == 1
+        _, _, bins = records[0]
+        assert bins['exec_age'] == 7
+
+    def test_execute_rebinds_string_equals(self):
+        query = self.as_connection.query('test', 'demo')
+        query.where(p.equals('exec_name', 'name1'))
+
+        records = query.execute([u'name6'])
+
+        assert len(records) == 1
+        _, _, bins = records[0]
+        assert bins['exec_name'] == 'name6'
+
+    def test_execute_keeps_bin_selection(self):
+        query = self.as_connection.query('test', 'demo')
+        query.select('exec_age')
+        query.where(p.between('exec_age', 0, 9))
+
+        for params in [(0, 2), (3, 5)]:
+            for _, _, bins in query.execute(params):
+                assert list(bins.keys()) == ['exec_age']
+
+    def test_execute_with_policy(self):
+        query = self.as_connection.query('test', 'demo')
+        query.where(p.between('exec_age', 0, 9))
+
+        records = query.execute(None, {'timeout': 2000})
+
+        assert len(records) == 10
+
+    def test_where_replaces_predicate(self):
+        query = self.as_connection.query('test', 'demo')
+        query.where(p.equals('exec_age', 1))
+        query.where(p.equals('exec_age', 2))
+
+        records = query.results()
+
+        assert len(records) == 1
+        _, _, bins = records[0]
+        assert bins['exec_age'] == 2
+
+    def test_invalid_index_type_keeps_predicate(self):
+        query = self.as_connection.query('test', 'demo')
+        query.where(p.equals('exec_age', 2))
+
+        with pytest.raises(e.ParamError):
+            query.where(p.contains('exec_name', 7, 'name1'))
+
+        records = query.results()
+        assert len(records) == 1
+        _, _, bins = records[0]
+        assert bins['exec_age'] == 2
+
+    def test_foreach_argument_error_keeps_query(self):
+        query = self.as_connection.query('test', 'demo')
+        query.where(p.equals('exec_age', 2))
+
+        with pytest.raises(TypeError):
+            query.foreach()
+
+        assert len(query.results()) == 1
+
+    def test_execute_params_without_predicate(self):
+        query = self.as_connection.query('test', 'demo')
+
+        with pytest.raises(e.ParamError) as err_info:
+            query.execute((1,))
+
+        assert err_info.value.code == AerospikeStatus.AEROSPIKE_ERR_PARAM
+
+    @pytest.mark.parametrize(
+        "predicate, params",
+        [
+            (p.between('exec_age', 0, 1), (1,)),
+            (p.between('exec_age', 0, 1), ('a', 'b')),
+            (p.equals('exec_age', 1), (1, 2)),
+            (p.equals('exec_name', 'name1'), (1,)),
+            (p.equals('exec_age', 1), 1)
+        ],
+        ids=[
+            "range with one value",
+            "range with strings",
+            "equals with two values",
+            "string equals with int",
+            "params not a sequence"
+        ]
+    )
+    def test_execute_invalid_params(self, predicate, params):
+        query = self.as_connection.query('test', 'demo')
+        query.where(predicate)
+
+        with pytest.raises(e.ParamError) as err_info:
+            query.execute(params)
+
+        assert err_info.value.code == AerospikeStatus.AEROSPIKE_ERR_PARAM
@@ -0,0 +1,136 @@
+# -*- coding: utf-8 -*-
+
+import pytest
+import sys
+from .test_base_class import TestBaseClass
+from .as_status_codes import AerospikeStatus
+from aerospike import exception as e
+from aerospike import predicates as p
+
+aerospike = pytest.importorskip("aerospike")
+try:
+    import aerospike
+except:
+    print("Please install aerospike python client.")
+    sys.exit(1)
+
+
+class TestQueryMany(TestBaseClass):
+
+    def setup_class(cls):
+        client = TestBaseClass.get_new_connection()
+        client.index_integer_create('test', 'demo', 'many_age',
+                                    'many_age_index')
+        client.close()
+
+    def teardown_class(cls):
+        client = TestBaseClass.get_new_connection()
+        client.index_remove('test', 'many_age_index')
+        client.close()
+
+    @pytest.fixture(autouse=True)
+    def setup_method(self, request, as_connection):
+        self.keys = []
+        for i in range(10):
+            key = ('test', 'demo', 'many_%d' % i)
+            self.as_connection.put(key, {'many_age': i, 'name': 'name%d' % i})
+            self.keys.append(key)
+
+        def teardown():
+            for key in self.keys:
+                self.as_connection.remove(key)
+
+        request.addfinalizer(teardown)
+
+    def age_query(self, low, high):
+        query = self.as_connection.query('test', 'demo')
+        query.where(p.between('many_age', low, high))
+        return query
+
+    @staticmethod
+    def ages(results):
+        return sorted(bins['many_age'] for _, _, bins in results)
+
+    def test_concat(self):
+        queries = [self.age_query(0, 4), self.age_query(3, 6)]
+
+        results = self.as_connection.query_many(queries)
+
+        assert self.ages(results) == [0, 1, 2, 3, 3, 4, 4, 5, 6]
+
+    def test_concat_keeps_query_order(self):
+        queries = [self.age_query(5, 9), self.age_query(0, 1)]
+
+        results = self.as_connection.query_many(queries, merge='concat',
+                                                concurrency=2)
+
+        assert [bins['many_age'] >= 5 for _, _, bins in results] == \
+            [True] * 5 + [False] * 2
+
+    def test_dedup_by_digest(self):
+        queries = [self.age_query(0, 4), self.age_query(3, 6),
+                   self.age_query(0, 9)]
+
+        results = self.as_connection.query_many(queries,
+                                                merge='dedup_by_digest')
+
+        assert self.ages(results) == list(range(10))
+        digests = [key[3] for key, _, _ in results]
+        assert len(set(digests)) == 10
+
+    def test_per_query(self):
+        queries = [self.age_query(0, 1), self.age_query(8, 9),
+                   self.age_query(20, 30)]
+
+        results = self.as_connection.query_many(queries, merge=None)
+
+        assert len(results) == 3
+        assert self.ages(results[0]) == [0, 1]
+        assert self.ages(results[1]) == [8, 9]
+        assert results[2] == []
+
+    def test_record_shape_matches_results(self):
+        query = self.age_query(2, 2)
+        query.select('name')
+
+        results = self.as_connection.query_many([query])
+
+        assert results == query.results()
+        key, meta, bins = results[0]
+        assert bins == {'name': 'name2'}
+        assert meta['gen'] >= 1
+
+    def test_no_queries(self):
+        assert self.as_connection.query_many([]) == []
+        assert self.as_connection.query_many([], merge=None) == []
+
+    def test_query_error_is_raised(self):
+        bad = self.as_connection.query('test', 'demo')
+        bad.where(p.between('many_no_index', 0, 1))
+
+        with pytest.raises(e.AerospikeError):
+            self.as_connection.query_many([self.age_query(0, 1), bad])
+
+    def test_scan_is_not_a_query(self):
+        scan = self.as_connection.scan('test', 'demo')
+
+        with pytest.raises(e.ParamError):
+            self.as_connection.query_many([self.age_query(0, 1), scan])
+
+    @pytest.mark.parametrize(
+        "queries, kwargs",
+        [
+            ([1], {}),
+            (None, {}),
+            ([], {'merge': 'union'}),
+            ([], {'concurrency': 0}),
+            ([], {'concurrency': 17}),
+            ([], {'policy': 'x'})
+        ],
+        ids=["not a query", "not a list", "unknown merge", "zero concurrency",
+             "high concurrency", "bad policy"]
+    )
+    def test_invalid_arguments(self, queries, kwargs):
+        with pytest.raises(e.ParamError) as err_info:
+            self.as_connection.query_many(queries, **kwargs)
+        assert err_info.value.code == AerospikeStatus.AEROSPIKE_ERR_PARAM
@@ -0,0 +1,137 @@
+# -*- coding: utf-8 -*-
+
+import pytest
+import sys
+import threading
+import time
+from .test_base_class import TestBaseClass
+from aerospike import exception as e
+
+aerospike = pytest.importorskip("aerospike")
+try:
+    import aerospike
+except:
+    print("Please install aerospike python client.")
+    sys.exit(1)
+
+
+@pytest.mark.usefixtures("as_connection", "connection_config")
+class TestRateLimits(object):
+
+    @pytest.fixture(autouse=True)
+    def setup(self, request, as_connection):
+        self.keys = [('test', 'demo', 'rate_limits_%d' % i) for i in range(5)]
+        for key in self.keys:
+            as_connection.put(key, {'a': 1})
+        self.limited_clients = []
+
+        def teardown():
+            for client in self.limited_clients:
+                client.close()
+            for key in self.keys:
+                try:
+                    as_connection.remove(key)
+                except e.RecordNotFound:
+                    pass
+
+        request.addfinalizer(teardown)
+
+    def limited_client(self, **limits):
+        client = TestBaseClass.get_new_connection({'limits': limits})
+        self.limited_clients.append(client)
+        return client
+
+    def test_namespace_rate_rejects(self):
+        client = self.limited_client(namespaces={'test': 2})
+
+        client.get(self.keys[0])
+        client.get(self.keys[1])
+        with pytest.raises(e.NoMoreConnectionsError):
+            client.get(self.keys[2])
+
+        limits = client.stats()['limits']
+        assert limits['admitted'] == 2
+        assert limits['rejected'] == 1
+        assert limits['namespaces']['test']['rejected'] == 1
+
+    def test_queued_request_waits_for_token(self):
+        client = self.limited_client(namespaces={'test': 10}, max_wait_ms=1000)
+
+        start = time.time()
+        for key in self.keys * 3:
+            client.get(key)
+
+        assert time.time() - start >= 0.4
+        limits = client.stats()['limits']
+        assert limits['rejected'] == 0
+        assert limits['queued'] >= 1
+
+    def test_set_and_operation_rates(self):
+        client = self.limited_client(sets={'test.demo': 1},
+                                     operations={'write': 1000})
+
+        client.put(self.keys[0], {'a': 2})
+        with pytest.raises(e.NoMoreConnectionsError):
+            client.put(self.keys[1], {'a': 2})
+        # Other sets are not limited
+        client.exists(('test', 'other_set', 'rate_limits'))
+
+        limits = client.stats()['limits']
+        assert limits['sets']['test.demo']['admitted'] == 1
+        assert limits['operations']['write']['rate'] == 1000
+        assert 'read' not in limits['operations']
+
+    def test_batch_takes_token_per_key(self):
+        client = self.limited_client(operations={'batch': 3})
+
+        client.get_many(self.keys)
+        with pytest.raises(e.NoMoreConnectionsError):
+            client.get_many(self.keys[:1])
+
+    def test_max_in_flight(self):
+        client = self.limited_client(max_in_flight=2, max_wait_ms=5000)
+        results = []
+
+        def reader():
+            for _ in range(5):
+                results.append(client.get(self.keys[0])[2])
+
+        threads = [threading.Thread(target=reader) for _ in range(4)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+
+        assert len(results) == 20
+        limits = client.stats()['limits']
+        assert limits['in_flight'] == 0
+        assert limits['admitted'] == 20
+
+    def test_stats_without_limits(self):
+        stats = self.as_connection.stats()
+
+        assert stats['limits'] is None
+        assert set(stats['hedge']) == set(['reads', 'hedged', 'hedge_wins'])
+
+    @pytest.mark.parametrize(
+        "limits",
+        [
+            {'max_in_flight': -1},
+            {'max_wait_ms': 'x'},
+            {'namespaces': {'test': 0}},
+            {'namespaces': {'test.demo': 10}},
+            {'sets': {'test': 10}},
+            {'operations': {'scan': 10}},
+            {'operations': []},
+            []
+        ],
+        ids=["negative in flight", "bad wait", "zero rate",
+             "set as namespace", "namespace as set", "unknown operation",
+             "operations not a dict", "not a dict"]
+    )
+    def test_invalid_limits_config(self, limits):
+        config = dict(self.connection_config)
+        config['limits'] = limits
+
+        with pytest.raises(e.ParamError):
+            aerospike.client(config)
@@ -0,0 +1,171 @@
+# -*- coding: utf-8 -*-
+
+import pytest
+import sys
+import threading
+import time
+from .test_base_class import TestBaseClass
+from aerospike import exception as e
+
+aerospike = pytest.importorskip("aerospike")
+try:
+    import aerospike
+except:
+    print("Please install aerospike python client.")
+    sys.exit(1)
+
+
+@pytest.mark.usefixtures("as_connection", "connection_config")
+class TestRecordCache(object):
+
+    @pytest.fixture(autouse=True)
+    def setup(self, request, as_connection):
+        self.key = ('test', 'demo', 'record_cache')
+        as_connection.put(self.key, {'a': 1, 'l': [1, 2]})
+        self.cached_clients = []
+
+        def teardown():
+            for client in self.cached_clients:
+                client.close()
+            try:
+                as_connection.remove(self.key)
+            except e.RecordNotFound:
+                pass
+
+        request.addfinalizer(teardown)
+
+    def cached_client(self, **cache_config):
+        client = TestBaseClass.get_new_connection({'cache': cache_config})
+        self.cached_clients.append(client)
+        return client
+
+    def test_hit_does_not_see_other_writers(self):
+        client = self.cached_client(max_staleness=60000)
+
+        assert client.get(self.key)[2]['a'] == 1
+        self.as_connection.put(self.key, {'a': 2})
+
+        assert client.get(self.key)[2]['a'] == 1
+
+    def test_hit_returns_same_record_shape(self):
+        client = self.cached_client(max_staleness=60000)
+
+        first = client.get(self.key)
+        second = client.get(self.key)
+
+        assert first[0] == second[0]
+        assert first[1]['gen'] == second[1]['gen']
+        assert first[2] == second[2]
+
+    def test_returned_bins_are_copies(self):
+        client = self.cached_client(max_staleness=60000)
+
+        client.get(self.key)[2]['a'] = 100
+
+        assert client.get(self.key)[2]['a'] == 1
+
+    def test_returned_lists_are_copies(self):
+        client = self.cached_client(max_staleness=60000)
+
+        client.get(self.key)[2]['l'].append(3)
+
+        assert client.get(self.key)[2]['l'] == [1, 2]
+
+    def test_staleness_expires_records(self):
+        client = self.cached_client(max_staleness=100)
+
+        client.get(self.key)
+        self.as_connection.put(self.key, {'a': 2})
+        time.sleep(0.2)
+
+        assert client.get(self.key)[2]['a'] == 2
+
+    @pytest.mark.parametrize(
+        "write",
+        [
+            lambda c, k: c.put(k, {'a': 3}),
+            lambda c, k: c.increment(k, 'a', 2),
+            lambda c, k: c.operate(k, [{'op': aerospike.OPERATOR_WRITE,
+                                        'bin': 'a', 'val': 3}]),
+            lambda c, k: c.list_append(k, 'l', 3),
+            lambda c, k: c.remove_bin(k, ['l'])
+        ],
+        ids=["put", "increment", "operate", "list_append", "remove_bin"]
+    )
+    def test_own_writes_invalidate(self, write):
+        client = self.cached_client(max_staleness=60000)
+        before = client.get(self.key)
+
+        write(client, self.key)
+
+        assert client.get(self.key)[1]['gen'] == before[1]['gen'] + 1
+
+    def test_remove_invalidates(self):
+        client = self.cached_client(max_staleness=60000)
+        client.get(self.key)
+
+        client.remove(self.key)
+
+        with pytest.raises(e.RecordNotFound):
+            client.get(self.key)
+
+    def test_get_racing_own_put_is_not_cached(self):
+        client = self.cached_client(max_staleness=60000)
+        done = threading.Event()
+
+        def reader():
+            while not done.is_set():
+                client.get(self.key)
+
+        thread = threading.Thread(target=reader)
+        thread.start()
+        try:
+            for i in range(200):
+                client.put(self.key, {'a': i})
+        finally:
+            done.set()
+            thread.join()
+
+        assert client.get(self.key)[2]['a'] == 199
+
+    def test_generation_validation_sees_other_writers(self):
+        client = self.cached_client(max_staleness=60000,
+                                    validate='generation')
+
+        client.get(self.key)
+        self.as_connection.put(self.key, {'a': 2})
+
+        assert client.get(self.key)[2]['a'] == 2
+
+    def test_max_records_evicts(self):
+        client = self.cached_client(max_records=1, max_staleness=60000)
+        other = ('test', 'demo', 'record_cache_other')
+        self.as_connection.put(other, {'a': 10})
+
+        client.get(self.key)
+        client.get(other)
+        self.as_connection.put(self.key, {'a': 2})
+        self.as_connection.remove(other)
+
+        # other is still cached, self.key was evicted
+        assert client.get(other)[2]['a'] == 10
+        assert client.get(self.key)[2]['a'] == 2
+
+    @pytest.mark.parametrize(
+        "cache_config",
+        [
+            {'max_records': 0},
+            {'max_records': -1},
+            {'max_staleness': 'x'},
+            {'validate': 'bins'},
+            []
+        ],
+        ids=["zero records", "negative records", "bad staleness",
+             "unknown validate", "not a dict"]
+    )
+    def test_invalid_cache_config(self, cache_config):
+        config = dict(self.connection_config)
+        config['cache'] = cache_config
+
+        with pytest.raises(e.ParamError):
+            aerospike.client(config)
@@ -475,3 +475,31 @@ class TestScan(TestBaseClass):
 
         err_code = err_info.value.code
         assert err_code == AerospikeStatus.AEROSPIKE_ERR_CLIENT
+
+    def test_scan_split_by_node(self):
+        digests = []
+
+        def callback(input_tuple):
+            key, _, _ = input_tuple
+            digests.append(bytes(key[3]))
+
+        for nodename in self.as_connection.info_all('node'):
+            scan_obj = self.as_connection.scan(self.test_ns, self.test_set)
+            scan_obj.foreach(callback, nodename=nodename)
+
+        assert len(digests) == self.record_count
+        assert len(set(digests)) == self.record_count
+
+    def test_scan_results_split_by_node(self):
+        records = []
+        for nodename in self.as_connection.info_all('node'):
+            scan_obj = self.as_connection.scan(self.test_ns, self.test_set)
+            records.extend(scan_obj.results(nodename=nodename))
+
+        assert len(records) == self.record_count
+
+    def test_scan_with_unknown_nodename(self):
+        scan_obj = self.as_connection.scan(self.test_ns, self.test_set)
+
+        with pytest.raises(e.ParamError):
+            scan_obj.results(nodename='no_such_node')
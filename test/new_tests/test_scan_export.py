@@ -0,0 +1,142 @@
+# -*- coding: utf-8 -*-
+
+import gzip
+import json
+import os
+import pytest
+import sys
+from aerospike import exception as e
+from .as_status_codes import AerospikeStatus
+
+aerospike = pytest.importorskip("aerospike")
+try:
+    import aerospike
+except:
+    print("Please install aerospike python client.")
+    sys.exit(1)
+
+
+@pytest.mark.usefixtures("as_connection")
+class TestScanExport(object):
+
+    @pytest.fixture(autouse=True)
+    def setup(self, request, as_connection, tmpdir):
+        self.set_name = 'scan_export'
+        self.path = str(tmpdir.join('export'))
+        self.keys = [('test', self.set_name, i) for i in range(50)]
+        for i, key in enumerate(self.keys):
+            as_connection.put(key, {'i': i, 's': 'str"%d' % i,
+                                    'l': [i, 1.5], 'm': {'a': i}},
+                              policy={'key': aerospike.POLICY_KEY_SEND})
+
+        def teardown():
+            for key in self.keys:
+                as_connection.remove(key)
+
+        request.addfinalizer(teardown)
+
+    def read_ndjson(self, opener=open):
+        with opener(self.path, 'rb') as export_file:
+            return [json.loads(line.decode('utf-8')) for line in export_file]
+
+    def test_export_ndjson(self):
+        scan = self.as_connection.scan('test', self.set_name)
+
+        stats = scan.export(self.path)
+
+        records = self.read_ndjson()
+        assert stats['records'] == 50
+        assert stats['bytes'] == os.path.getsize(self.path)
+        assert sorted(r['bins']['i'] for r in records) == list(range(50))
+        for record in records:
+            i = record['bins']['i']
+            assert record['key']['ns'] == 'test'
+            assert record['key']['set'] == self.set_name
+            assert record['key']['key'] == i
+            assert len(record['key']['digest']) == 40
+            assert record['bins']['s'] == 'str"%d' % i
+            assert record['bins']['l'] == [i, 1.5]
+            assert record['bins']['m'] == {'a': i}
+            assert record['gen'] >= 1
+
+    def test_export_ndjson_compressed(self):
+        scan = self.as_connection.scan('test', self.set_name)
+
+        stats = scan.export(self.path, compress=True)
+
+        records = self.read_ndjson(gzip.open)
+        assert stats['records'] == len(records) == 50
+        assert stats['bytes'] == os.path.getsize(self.path)
+
+    def test_export_compress_not_a_bool(self):
+        class Unbooled(object):
+            def __bool__(self):
+                raise ValueError("no truth value")
+            __nonzero__ = __bool__
+
+        scan = self.as_connection.scan('test', self.set_name)
+
+        with pytest.raises(ValueError):
+            scan.export(self.path, compress=Unbooled())
+
+    def test_export_msgpack(self):
+        msgpack = pytest.importorskip("msgpack")
+        scan = self.as_connection.scan('test', self.set_name)
+
+        stats = scan.export(self.path, format='msgpack')
+
+        with open(self.path, 'rb') as export_file:
+            unpacker = msgpack.Unpacker(export_file, raw=False)
+            records = list(unpacker)
+        assert stats['records'] == len(records) == 50
+        assert sorted(r['bins']['i'] for r in records) == list(range(50))
+
+    def test_export_ndjson_keeps_floats(self):
+        key = ('test', self.set_name, 'float')
+        self.keys.append(key)
+        self.as_connection.put(key, {'f': 3.0, 'g': 0.1, 'l': [2.0]})
+        scan = self.as_connection.scan('test', self.set_name)
+
+        scan.export(self.path)
+
+        bins = [r['bins'] for r in self.read_ndjson() if 'f' in r['bins']][0]
+        assert bins == {'f': 3.0, 'g': 0.1, 'l': [2.0]}
+        assert isinstance(bins['f'], float)
+        assert isinstance(bins['l'][0], float)
+
+    def test_export_selected_bins(self):
+        scan = self.as_connection.scan('test', self.set_name)
+        scan.select('i')
+
+        scan.export(self.path)
+
+        for record in self.read_ndjson():
+            assert list(record['bins'].keys()) == ['i']
+
+    def test_export_invalid_format(self):
+        scan = self.as_connection.scan('test', self.set_name)
+
+        with pytest.raises(e.ParamError) as err_info:
+            scan.export(self.path, format='csv')
+
+        assert err_info.value.code == AerospikeStatus.AEROSPIKE_ERR_PARAM
+
+    def test_export_invalid_path_type(self):
+        scan = self.as_connection.scan('test', self.set_name)
+
+        with pytest.raises(e.ParamError):
+            scan.export(5)
+
+    def test_export_unwritable_path(self):
+        scan = self.as_connection.scan('test', self.set_name)
+
+        with pytest.raises(e.ClientError) as err_info:
+            scan.export(os.path.join(self.path, 'missing', 'file'))
+
+        assert err_info.value.code == AerospikeStatus.AEROSPIKE_ERR_CLIENT
+
+    def test_export_without_path(self):
+        scan = self.as_connection.scan('test', self.set_name)
+
+        with pytest.raises(TypeError):
+            scan.export()
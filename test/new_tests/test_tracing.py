@@ -0,0 +1,185 @@
+# -*- coding: utf-8 -*-
+
+import gc
+import pytest
+import sys
+import weakref
+from aerospike import exception as e
+
+aerospike = pytest.importorskip("aerospike")
+try:
+    import aerospike
+except:
+    print("Please install aerospike python client.")
+    sys.exit(1)
+
+
+@pytest.mark.usefixtures("as_connection")
+class TestTracing(object):
+
+    @pytest.fixture(autouse=True)
+    def setup(self, request, as_connection):
+        self.keys = [('test', 'demo', 'tracing_%d' % i) for i in range(4)]
+        for key in self.keys:
+            as_connection.put(key, {'a': 1})
+        self.batches = []
+
+        def teardown():
+            as_connection.set_tracer(None)
+            for key in self.keys:
+                try:
+                    as_connection.remove(key)
+                except e.RecordNotFound:
+                    pass
+
+        request.addfinalizer(teardown)
+
+    def spans(self):
+        return [span for batch in self.batches for span in batch]
+
+    def test_every_call_sampled(self):
+        self.as_connection.set_tracer(self.batches.append, sample_rate=1, batch_size=2)
+
+        self.as_connection.get(self.keys[0])
+        self.as_connection.put(self.keys[1], {'a': 2})
+        self.as_connection.exists(self.keys[2])
+
+        assert len(self.batches) == 1
+        get, put = self.batches[0]
+        assert get['operation'] == 'get'
+        assert put['operation'] == 'put'
+        assert get['namespace'] == 'test'
+        assert get['set'] == 'demo'
+        assert get['keys'] == 1
+        assert get['status'] == 0
+        assert get['node'] in self.as_connection.cluster_stats()['nodes']
+        assert get['start_us'] <= get['end_us']
+        assert get['end_us'] - get['start_us'] == \
+            get['convert_us'] + get['network_us'] + get['result_us']
+
+        self.as_connection.flush_spans()
+        assert self.spans()[-1]['operation'] == 'exists'
+
+    def test_sample_rate(self):
+        self.as_connection.set_tracer(self.batches.append, sample_rate=0.25, batch_size=1000)
+
+        for _ in range(10):
+            for key in self.keys:
+                self.as_connection.get(key)
+        self.as_connection.flush_spans()
+
+        assert len(self.spans()) == 10
+
+    def test_batch_span(self):
+        self.as_connection.set_tracer(self.batches.append, sample_rate=1)
+
+        self.as_connection.get_many(self.keys)
+        self.as_connection.flush_spans()
+
+        span, = self.spans()
+        assert span['operation'] == 'get_many'
+        assert span['keys'] == len(self.keys)
+        assert span['node'] is None
+
+    def test_scan_span(self):
+        self.as_connection.set_tracer(self.batches.append, sample_rate=1)
+
+        records = self.as_connection.scan('test', 'demo').results()
+        self.as_connection.flush_spans()
+
+        span, = self.spans()
+        assert span['operation'] == 'scan'
+        assert span['namespace'] == 'test'
+        assert span['set'] == 'demo'
+        assert span['keys'] == len(records)
+        assert span['node'] is None
+
+    def test_many_call_span(self):
+        self.as_connection.set_tracer(self.batches.append, sample_rate=1)
+
+        self.as_connection.list_append_many(self.keys, 'l', 1)
+        self.as_connection.flush_spans()
+
+        span, = self.spans()
+        assert span['operation'] == 'list_append_many'
+        assert span['keys'] == len(self.keys)
+        assert span['status'] == 0
+
+    def test_info_span(self):
+        self.as_connection.set_tracer(self.batches.append, sample_rate=1)
+
+        self.as_connection.info_all('build')
+        self.as_connection.flush_spans()
+
+        span, = self.spans()
+        assert span['operation'] == 'info_all'
+        assert span['namespace'] is None
+        assert span['keys'] == 0
+
+    def test_failed_call_status(self):
+        self.as_connection.set_tracer(self.batches.append, sample_rate=1)
+
+        with pytest.raises(e.RecordNotFound):
+            self.as_connection.get(('test', 'demo', 'tracing_missing'))
+        self.as_connection.flush_spans()
+
+        span, = self.spans()
+        assert span['status'] == 2
+
+    def test_replacing_tracer_flushes(self):
+        self.as_connection.set_tracer(self.batches.append, sample_rate=1)
+        self.as_connection.get(self.keys[0])
+
+        self.as_connection.set_tracer(None)
+        self.as_connection.get(self.keys[0])
+
+        assert len(self.spans()) == 1
+
+    def test_callback_error_does_not_fail_call(self):
+        def callback(spans):
+            raise ValueError("export failed")
+
+        self.as_connection.set_tracer(callback, sample_rate=1, batch_size=1)
+
+        _, _, bins = self.as_connection.get(self.keys[0])
+        assert bins == {'a': 1}
+
+    def test_flush_raises_callback_error(self):
+        def callback(spans):
+            raise ValueError("export failed")
+
+        self.as_connection.set_tracer(callback, sample_rate=1)
+        self.as_connection.get(self.keys[0])
+
+        with pytest.raises(ValueError):
+            self.as_connection.flush_spans()
+
+    def test_tracer_cycle_collected(self):
+        class Collector(object):
+            def __call__(self, spans):
+                pass
+
+        client = aerospike.client({'hosts': [('127.0.0.1', 3000)]})
+        callback = Collector()
+        callback.client = client
+        client.set_tracer(callback)
+        collected = weakref.ref(callback)
+
+        del client, callback
+        gc.collect()
+
+        assert collected() is None
+
+    @pytest.mark.parametrize(
+        "callback, kwargs",
+        [
+            ('not callable', {}),
+            (len, {'sample_rate': 2}),
+            (len, {'sample_rate': -0.5}),
+            (len, {'batch_size': 0}),
+        ],
+        ids=["not callable", "rate above 1", "negative rate", "empty batch"]
+    )
+    def test_invalid_arguments(self, callback, kwargs):
+        with pytest.raises(e.ParamError):
+            self.as_connection.set_tracer(callback, **kwargs)
@@ -0,0 +1,115 @@
+# -*- coding: utf-8 -*-
+
+import pytest
+import sys
+from .as_status_codes import AerospikeStatus
+from .udf_helpers import wait_for_udf_removal
+from aerospike import exception as e
+
+aerospike = pytest.importorskip("aerospike")
+try:
+    import aerospike
+except:
+    print("Please install aerospike python client.")
+    sys.exit(1)
+
+
+@pytest.mark.usefixtures("as_connection")
+class TestWaitForTask(object):
+
+    def setup_class(cls):
+        cls.udf_name = 'example.lua'
+        cls.index_names = ['wait_age_index', 'wait_name_index']
+
+    def teardown_method(self, method):
+        """
+        Teardown method
+        """
+        for index_name in self.index_names:
+            try:
+                self.as_connection.index_remove('test', index_name)
+            except e.AerospikeError:
+                pass
+
+        udf_list = self.as_connection.udf_list({'timeout': 100})
+        for udf in udf_list:
+            if udf['name'] == self.udf_name:
+                self.as_connection.udf_remove(self.udf_name)
+                wait_for_udf_removal(self.as_connection, self.udf_name)
+
+    def test_index_create_no_wait_returns_task(self):
+        task = self.as_connection.index_integer_create(
+            'test', 'demo', 'age', 'wait_age_index', wait=False)
+
+        assert task == {'type': 'index', 'ns': 'test',
+                        'name': 'wait_age_index'}
+        assert self.as_connection.wait_for_task(task, 30000) == 0
+
+    def test_index_create_wait_true_returns_zero(self):
+        status = self.as_connection.index_integer_create(
+            'test', 'demo', 'age', 'wait_age_index', wait=True)
+
+        assert status == 0
+
+    def test_wait_for_list_of_tasks(self):
+        tasks = [
+            self.as_connection.index_integer_create(
+                'test', 'demo', 'age', 'wait_age_index', wait=False),
+            self.as_connection.index_string_create(
+                'test', 'demo', 'name', 'wait_name_index', wait=False),
+            self.as_connection.udf_put(self.udf_name, wait=False)
+        ]
+
+        status = self.as_connection.wait_for_task(
+            tasks, timeout=30000, poll_interval=50)
+
+        assert status == 0
+        udf_names = [udf['name'] for udf in self.as_connection.udf_list()]
+        assert self.udf_name in udf_names
+
+    def test_udf_put_no_wait_returns_task(self):
+        task = self.as_connection.udf_put(self.udf_name, wait=False)
+
+        assert task == {'type': 'udf', 'module': self.udf_name}
+        assert self.as_connection.wait_for_task(task) == 0
+
+    def test_wait_for_empty_task_list(self):
+        assert self.as_connection.wait_for_task([]) == 0
+
+    def test_wait_for_task_timeout(self):
+        task = {'type': 'udf', 'module': 'never_registered.lua'}
+
+        with pytest.raises(e.TimeoutError) as err_info:
+            self.as_connection.wait_for_task(task, timeout=100,
+                                             poll_interval=20)
+
+        assert err_info.value.code == AerospikeStatus.AEROSPIKE_ERR_TIMEOUT
+
+    @pytest.mark.parametrize(
+        "task",
+        [
+            None,
+            {},
+            {'type': 'scan'},
+            {'type': 'index', 'ns': 'test'},
+            {'type': 'udf', 'module': 5},
+            [{'type': 'udf', 'module': 'example.lua'}, 'bad']
+        ],
+        ids=[
+            "not a dict",
+            "missing type",
+            "unknown type",
+            "index missing name",
+            "module not a string",
+            "list with invalid task"
+        ]
+    )
+    def test_wait_for_task_invalid_task(self, task):
+        with pytest.raises(e.ParamError) as err_info:
+            self.as_connection.wait_for_task(task)
+
+        assert err_info.value.code == AerospikeStatus.AEROSPIKE_ERR_PARAM
+
+    def test_wait_for_task_without_task(self):
+        with pytest.raises(TypeError):
+            self.as_connection.wait_for_task()